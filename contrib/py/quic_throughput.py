@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# measures throughput of a belnet quic tcp tunnel.
+#
+# runs a local tcp sink, exposes it with llarp.quic_listener on the server belnet, opens a tunnel to
+# it with llarp.quic_connect on the client belnet and pushes data through the tunnel for a while.
+# the server and client can be the same belnet or two belnets on one machine (e.g. a testnet) to
+# get a loopback measurement.
+#
+# usage: quic_throughput.py [--server rpc] [--client rpc] [--seconds N] [--port P]
+#
+
+import argparse
+import json
+import socket
+import threading
+import time
+
+import zmq
+
+
+class RPC:
+    def __init__(self, ctx, url):
+        self._sock = ctx.socket(zmq.DEALER)
+        self._sock.setsockopt(zmq.CONNECT_TIMEOUT, 5000)
+        self._sock.setsockopt(zmq.HANDSHAKE_IVL, 5000)
+        self._sock.connect(url)
+
+    def __call__(self, method, args, timeout=15000):
+        self._sock.send_multipart([method.encode(), b'tag', json.dumps(args).encode()])
+        if not self._sock.poll(timeout=timeout):
+            raise TimeoutError("no reply to {}".format(method))
+        m = self._sock.recv_multipart()
+        if len(m) < 3 or m[0:2] != [b'REPLY', b'tag']:
+            raise RuntimeError("bad reply to {}: {}".format(method, m))
+        reply = json.loads(m[2].decode())
+        if reply.get('error'):
+            raise RuntimeError("{} failed: {}".format(method, reply['error']))
+        return reply['result']
+
+
+def sink(listener, counter, stop):
+    conn, _ = listener.accept()
+    conn.settimeout(0.5)
+    while not stop.is_set():
+        try:
+            data = conn.recv(65536)
+        except socket.timeout:
+            continue
+        if not data:
+            break
+        counter[0] += len(data)
+    conn.close()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="measure belnet quic tunnel throughput")
+    ap.add_argument("--server", default="ipc://./beldex.sock", help="rpc url of the server belnet")
+    ap.add_argument("--client", default=None, help="rpc url of the client belnet, default: server")
+    ap.add_argument("--seconds", type=float, default=10.0, help="how long to send for")
+    ap.add_argument("--port", type=int, default=0,
+                    help="tcp port of the local sink, which is also the quic port the tunnel "
+                    "connects to; default: any free port")
+    ap.add_argument("--chunk", type=int, default=16384, help="bytes per send() call")
+    args = ap.parse_args()
+
+    ctx = zmq.Context()
+    server = RPC(ctx, args.server)
+    client = RPC(ctx, args.client or args.server)
+
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", args.port))
+    listener.listen(1)
+    sink_port = listener.getsockname()[1]
+
+    srv = server("llarp.quic_listener", {"host": "127.0.0.1", "port": sink_port})
+    print("listening id={} addr={}".format(srv["id"], srv["addr"]))
+    remote = srv["addr"].split(":")[0]
+    tun = client("llarp.quic_connect", {"host": remote, "port": sink_port})
+    print("tunnel id={} local={}".format(tun["id"], tun["addr"]))
+
+    counter = [0]
+    stop = threading.Event()
+    th = threading.Thread(target=sink, args=(listener, counter, stop))
+    th.start()
+
+    host, port = tun["addr"].rsplit(":", 1)
+    out = socket.create_connection((host, int(port)), timeout=30)
+    chunk = b'\0' * args.chunk
+    sent = 0
+    started = time.monotonic()
+    while time.monotonic() - started < args.seconds:
+        out.sendall(chunk)
+        sent += len(chunk)
+    out.close()
+    # give what is in flight a moment to arrive
+    deadline = time.monotonic() + 10
+    while counter[0] < sent and time.monotonic() < deadline:
+        time.sleep(0.1)
+    elapsed = time.monotonic() - started
+    stop.set()
+    th.join()
+
+    client("llarp.quic_connect", {"close": tun["id"]})
+    server("llarp.quic_listener", {"close": srv["id"]})
+
+    print("sent {} bytes, received {} bytes in {:.2f}s".format(sent, counter[0], elapsed))
+    print("throughput: {:.2f} Mbit/s".format(counter[0] * 8 / elapsed / 1e6))
+
+
+if __name__ == '__main__':
+    main()
@@ -54,6 +54,45 @@ extern "C"
   void EXPORT
   belnet_close_stream(int stream_id, struct belnet_context* context);
 
+  /// opaque handle to a stream that is read and written in process, without the localhost tcp
+  /// socket that belnet_outbound_stream maps the remote endpoint to
+  struct belnet_stream;
+
+  /// belnet_stream_poll event bits
+#define BELNET_STREAM_READABLE 1
+#define BELNET_STREAM_WRITABLE 2
+#define BELNET_STREAM_CLOSED 4
+
+  /// open an in process stream to a remote endpoint
+  /// remoteAddr is in the form of "name:port"
+  /// blocks until the remote accepted the stream, at most 10 seconds
+  /// returns NULL on failure and sets *error (if not NULL) to an errno value
+  struct belnet_stream* EXPORT
+  belnet_stream_open(const char* remoteAddr, int* error, struct belnet_context* context);
+
+  /// read up to len bytes of received data into buf, setting *nread to how many were read
+  /// returns 0 on success, where *nread being 0 means the remote finished the stream
+  /// returns EAGAIN if no data has arrived yet, ECONNRESET if the stream was reset
+  int EXPORT
+  belnet_stream_read(struct belnet_stream* stream, void* buf, size_t len, size_t* nread);
+
+  /// queue up to len bytes of buf to be sent, setting *nwritten to how many were queued
+  /// returns 0 on success, EAGAIN if the stream is congested and nothing was queued, EPIPE if
+  /// the stream is closed
+  int EXPORT
+  belnet_stream_write(
+      struct belnet_stream* stream, const void* buf, size_t len, size_t* nwritten);
+
+  /// wait at most timeout_ms milliseconds (forever if negative) for any of the BELNET_STREAM_*
+  /// bits in events to become ready
+  /// returns the ready events, BELNET_STREAM_CLOSED is always reported; 0 on timeout
+  int EXPORT
+  belnet_stream_poll(struct belnet_stream* stream, int events, int timeout_ms);
+
+  /// close the stream once everything written so far is sent and free the handle
+  void EXPORT
+  belnet_stream_free(struct belnet_stream* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,24 @@ extern "C"
     size_t pkt_length, 
     void* flow_userdata);
 
+  /// one datagram of a batch
+  struct belnet_udp_datagram
+  {
+    /// the flow to send on, or the flow it was received on
+    const struct belnet_udp_flowinfo* remote;
+    /// the datagram's payload
+    const char* data;
+    /// the size of the payload
+    size_t len;
+  };
+
+  /// hook function for handling a batch of packets that arrived on one flow
+  typedef void (*belnet_udp_flow_recv_batch_func)(
+      const struct belnet_udp_flowinfo* remote_address,
+      const struct belnet_udp_datagram* pkts,
+      size_t num_pkts,
+      void* flow_userdata);
+
   /// hook function for flow timeout
   typedef void (*belnet_udp_flow_timeout_func)(
     const struct belnet_udp_flowinfo* remote_address, 
@@ -78,6 +96,21 @@ extern "C"
       struct belnet_context* ctx);
 
 
+  /// inbound listen udp socket that delivers packets in batches
+  /// same as belnet_udp_bind except each flow's packets that arrive together are handed to recv
+  /// in a single call instead of one call per packet
+  ///
+  /// @returns nonzero on error in which it is an errno value
+  int EXPORT
+  belnet_udp_bind_batched(
+      uint16_t exposedPort,
+      belnet_udp_flow_filter filter,
+      belnet_udp_flow_recv_batch_func recv,
+      belnet_udp_flow_timeout_func timeout,
+      void* user,
+      struct belnet_udp_bind_result* result,
+      struct belnet_context* ctx);
+
   /// @brief establish a udp flow to remote endpoint
   ///
   /// @param create_flow the callback to create the new flow if we establish one
@@ -114,8 +147,54 @@ extern "C"
       size_t len,
       struct belnet_context* ctx);
 
+  /// @brief send a batch of datagrams, possibly on different flows, with a single hop onto the
+  /// event loop
+  ///
+  /// @param pkts the datagrams to send, each with the flow to send it on
+  ///
+  /// @param num_pkts the number of datagrams in pkts
+  ///
+  /// @param num_sent if not NULL set to how many datagrams, from the start of pkts, were sent
+  ///
+  /// @param ctx the belnet context to use
+  ///
+  /// @returns 0 if all datagrams were sent, otherwise the errno value of the first that was not
+  int EXPORT
+  belnet_udp_flow_send_batch(
+      const struct belnet_udp_datagram* pkts,
+      size_t num_pkts,
+      size_t* num_sent,
+      struct belnet_context* ctx);
+
+  /// a queue of datagrams from one application thread to the event loop for a bound udp socket
+  /// pushing is lock free, the event loop sends everything queued in one go
+  struct belnet_udp_send_queue;
+
+  /// @brief make a send queue for the bound udp socket socket_id holding up to capacity datagrams
+  ///
+  /// @returns NULL on error, including when capacity is 0 or too large to allocate
+  struct belnet_udp_send_queue* EXPORT
+  belnet_udp_send_queue_new(int socket_id, size_t capacity, struct belnet_context* ctx);
+
+  /// @brief queue a datagram to be sent on the flow remote, which must be on the queue's socket
+  /// only one thread may push to a queue
+  ///
+  /// @returns 0 on success, EAGAIN if the queue is full, EHOSTUNREACH if remote is on another
+  /// socket, EBADF once the socket is closed, or another errno value on error
+  int EXPORT
+  belnet_udp_send_queue_push(
+      struct belnet_udp_send_queue* queue,
+      const struct belnet_udp_flowinfo* remote,
+      const void* ptr,
+      size_t len);
+
+  /// @brief free a send queue
+  /// datagrams already pushed are still sent, nothing can be pushed after this returns
+  void EXPORT
+  belnet_udp_send_queue_free(struct belnet_udp_send_queue* queue);
+
   /// @brief close a bound udp socket
-  /// closes all flows immediately
+  /// closes all flows immediately, datagrams still queued on its send queues are dropped
   ///
   /// @param socket_id the bound udp socket's id
   ///
@@ -0,0 +1,123 @@
+#include "network_beldex_belnet_BelnetStream.h"
+#include "belnet_jni_common.hpp"
+#include <llarp.hpp>
+#include <llarp/router/abstractrouter.hpp>
+#include <llarp/service/context.hpp>
+#include <llarp/service/endpoint.hpp>
+#include <llarp/quic/stream_pipe.hpp>
+#include <llarp/quic/tunnel.hpp>
+
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace
+{
+  using Pipe_ptr = std::shared_ptr<llarp::quic::StreamPipe>;
+
+  /// split "name:port"
+  std::optional<std::pair<std::string, uint16_t>>
+  SplitRemote(std::string_view remote)
+  {
+    const auto pos = remote.rfind(':');
+    if (pos == std::string_view::npos)
+      return std::nullopt;
+    try
+    {
+      const auto port = std::stoi(std::string{remote.substr(pos + 1)});
+      if (port <= 0 or port > 65535)
+        return std::nullopt;
+      return std::make_pair(std::string{remote.substr(0, pos)}, static_cast<uint16_t>(port));
+    }
+    catch (...)
+    {
+      return std::nullopt;
+    }
+  }
+}  // namespace
+
+extern "C"
+{
+  JNIEXPORT jobject JNICALL
+  Java_network_beldex_belnet_BelnetStream_Open(
+      JNIEnv* env, jclass, jobject daemon, jstring remote)
+  {
+    auto ctx = GetImpl<llarp::Context>(env, daemon);
+    if (ctx == nullptr or not ctx->IsUp())
+      return nullptr;
+    auto target = VisitStringAsStringView<std::optional<std::pair<std::string, uint16_t>>>(
+        env, remote, [](std::string_view val) { return SplitRemote(val); });
+    if (not target)
+      return nullptr;
+    // the endpoints belong to the event loop, so look ours up there
+    auto router = ctx->router;
+    auto loop = router->loop();
+    auto found = std::make_shared<std::promise<llarp::quic::TunnelManager*>>();
+    auto result = found->get_future();
+    loop->call([router, found] {
+      auto ep = router->hiddenServiceContext().GetEndpointByName("default");
+      found->set_value(ep ? ep->GetQUICTunnel() : nullptr);
+    });
+    if (result.wait_for(std::chrono::seconds{5}) != std::future_status::ready)
+      return nullptr;
+    auto* quic = result.get();
+    if (quic == nullptr)
+      return nullptr;
+    int err = 0;
+    auto pipe = llarp::quic::StreamPipe::open(
+        loop, *quic, target->first, target->second, std::chrono::seconds{10}, err);
+    if (not pipe)
+      return nullptr;
+    return env->NewDirectByteBuffer(new Pipe_ptr{std::move(pipe)}, sizeof(Pipe_ptr));
+  }
+
+  JNIEXPORT void JNICALL
+  Java_network_beldex_belnet_BelnetStream_Free(JNIEnv* env, jclass, jobject buf)
+  {
+    if (auto ptr = FromBuffer<Pipe_ptr>(env, buf))
+    {
+      (*ptr)->close();
+      delete ptr;
+    }
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Read(JNIEnv* env, jobject self, jobject dst)
+  {
+    auto ptr = GetImpl<Pipe_ptr>(env, self);
+    auto* buf = env->GetDirectBufferAddress(dst);
+    if (ptr == nullptr or buf == nullptr)
+      return -1;
+    size_t nread = 0;
+    if (auto err = (*ptr)->read(buf, env->GetDirectBufferCapacity(dst), nread); err == EAGAIN)
+      return 0;
+    else if (err != 0 or nread == 0)
+      return -1;
+    return static_cast<jint>(nread);
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Write(JNIEnv* env, jobject self, jobject src, jint len)
+  {
+    auto ptr = GetImpl<Pipe_ptr>(env, self);
+    auto* buf = env->GetDirectBufferAddress(src);
+    if (ptr == nullptr or buf == nullptr or len < 0 or len > env->GetDirectBufferCapacity(src))
+      return -1;
+    size_t nwritten = 0;
+    if (auto err = (*ptr)->write(buf, len, nwritten); err == EAGAIN)
+      return 0;
+    else if (err != 0)
+      return -1;
+    return static_cast<jint>(nwritten);
+  }
+
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Poll(JNIEnv* env, jobject self, jint events, jint timeout)
+  {
+    auto ptr = GetImpl<Pipe_ptr>(env, self);
+    if (ptr == nullptr)
+      return llarp::quic::StreamPipe::CLOSED;
+    return (*ptr)->poll(events, std::chrono::milliseconds{timeout});
+  }
+}
@@ -0,0 +1,49 @@
+package network.beldex.belnet;
+
+import java.nio.ByteBuffer;
+
+/// a stream to a remote belnet endpoint read and written in process, without going through a
+/// localhost tcp socket
+public class BelnetStream
+{
+  static {
+    System.loadLibrary("belnet-android");
+  }
+
+  /// Poll event bits
+  public static final int READABLE = 1;
+  public static final int WRITABLE = 2;
+  public static final int CLOSED = 4;
+
+  private static native ByteBuffer Open(BelnetDaemon daemon, String remote);
+  private static native void Free(ByteBuffer buf);
+
+  /// read received data into the start of the direct buffer dst, returns the number of bytes
+  /// read, 0 if nothing has arrived yet or -1 once the stream is finished
+  public native int Read(ByteBuffer dst);
+  /// queue the first len bytes of the direct buffer src to be sent, returns the number of bytes
+  /// queued (0 if the stream is congested) or -1 once the stream is closed
+  public native int Write(ByteBuffer src, int len);
+  /// wait at most timeoutMS (forever if negative) for any of events, returns the ready events
+  public native int Poll(int events, int timeoutMS);
+
+  ByteBuffer impl = null;
+
+  /// open a stream to remote, in the form of "name:port", over a running daemon
+  public BelnetStream(BelnetDaemon daemon, String remote)
+  {
+    impl = Open(daemon, remote);
+    if (impl == null)
+      throw new RuntimeException("cannot open belnet stream to " + remote);
+  }
+
+  /// close the stream once everything written is sent
+  public void Close()
+  {
+    if (impl != null)
+    {
+      Free(impl);
+      impl = null;
+    }
+  }
+}
@@ -0,0 +1,60 @@
+/* DO NOT EDIT THIS FILE - it is machine generated */
+#include <jni.h>
+/* Header for class network_beldex_belnet_BelnetStream */
+
+#ifndef _Included_network_beldex_belnet_BelnetStream
+#define _Included_network_beldex_belnet_BelnetStream
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#undef network_beldex_belnet_BelnetStream_READABLE
+#define network_beldex_belnet_BelnetStream_READABLE 1L
+#undef network_beldex_belnet_BelnetStream_WRITABLE
+#define network_beldex_belnet_BelnetStream_WRITABLE 2L
+#undef network_beldex_belnet_BelnetStream_CLOSED
+#define network_beldex_belnet_BelnetStream_CLOSED 4L
+  /*
+   * Class:     network_beldex_belnet_BelnetStream
+   * Method:    Open
+   * Signature: (Lnetwork/beldex/belnet/BelnetDaemon;Ljava/lang/String;)Ljava/nio/ByteBuffer;
+   */
+  JNIEXPORT jobject JNICALL
+  Java_network_beldex_belnet_BelnetStream_Open(JNIEnv*, jclass, jobject, jstring);
+
+  /*
+   * Class:     network_beldex_belnet_BelnetStream
+   * Method:    Free
+   * Signature: (Ljava/nio/ByteBuffer;)V
+   */
+  JNIEXPORT void JNICALL
+  Java_network_beldex_belnet_BelnetStream_Free(JNIEnv*, jclass, jobject);
+
+  /*
+   * Class:     network_beldex_belnet_BelnetStream
+   * Method:    Read
+   * Signature: (Ljava/nio/ByteBuffer;)I
+   */
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Read(JNIEnv*, jobject, jobject);
+
+  /*
+   * Class:     network_beldex_belnet_BelnetStream
+   * Method:    Write
+   * Signature: (Ljava/nio/ByteBuffer;I)I
+   */
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Write(JNIEnv*, jobject, jobject, jint);
+
+  /*
+   * Class:     network_beldex_belnet_BelnetStream
+   * Method:    Poll
+   * Signature: (II)I
+   */
+  JNIEXPORT jint JNICALL
+  Java_network_beldex_belnet_BelnetStream_Poll(JNIEnv*, jobject, jint, jint);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -2,12 +2,14 @@
 
 #include <belnet.h>
 #include <llarp.hpp>
+#include <llarp/belnet_udp.hpp>
 #include <llarp/config/config.hpp>
 #include <llarp/crypto/crypto_libsodium.hpp>
 
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/service/context.hpp>
 #include <llarp/quic/tunnel.hpp>
+#include <llarp/quic/stream_pipe.hpp>
 #include <llarp/nodedb.hpp>
 
 #include <llarp/util/logging.hpp>
@@ -15,10 +17,15 @@
 #include <llarp/util/logging/callback_sink.hpp>
 #include <oxenc/base32z.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <mutex>
 #include <memory>
+#include <new>
 #include <chrono>
 #include <stdexcept>
+#include <vector>
 
 #ifdef _WIN32
 #define EHOSTDOWN ENETDOWN
@@ -38,163 +45,10 @@ namespace
     }
   };
 
-   struct UDPFlow
-  {
-    using Clock_t = std::chrono::steady_clock;
-    void* m_FlowUserData;
-    std::chrono::seconds m_FlowTimeout;
-    std::chrono::time_point<Clock_t> m_ExpiresAt;
-    belnet_udp_flowinfo m_FlowInfo;
-    belnet_udp_flow_recv_func m_Recv;
-
-    /// call timeout hook for this flow
-    void
-    TimedOut(belnet_udp_flow_timeout_func timeout)
-    {
-      timeout(&m_FlowInfo, m_FlowUserData);
-    }
-
-    /// mark this flow as active
-    /// updates the expires at timestamp
-    void
-    MarkActive()
-    {
-      m_ExpiresAt = Clock_t::now() + m_FlowTimeout;
-    }
-
-    /// returns true if we think this flow is expired
-    bool
-    IsExpired() const
-    {
-      return Clock_t::now() >= m_ExpiresAt;
-    }
-
-    void
-    HandlePacket(const llarp::net::IPPacket& pkt)
-    {
-      if (auto maybe = pkt.L4Data())
-      {
-        MarkActive();
-        m_Recv(&m_FlowInfo, maybe->first, maybe->second, m_FlowUserData);
-      }
-    }
-  };
-
-  struct UDPHandler
-  {
-    using AddressVariant_t = llarp::vpn::AddressVariant_t;
-    int m_SocketID;
-    llarp::nuint16_t m_LocalPort;
-    belnet_udp_flow_filter m_Filter;
-    belnet_udp_flow_recv_func m_Recv;
-    belnet_udp_flow_timeout_func m_Timeout;
-    void* m_User;
-    std::weak_ptr<llarp::service::Endpoint> m_Endpoint;
-
-    std::unordered_map<AddressVariant_t, UDPFlow> m_Flows;
-
-    std::mutex m_Access;
-
-    explicit UDPHandler(
-        int socketid,
-        llarp::nuint16_t localport,
-        belnet_udp_flow_filter filter,
-        belnet_udp_flow_recv_func recv,
-        belnet_udp_flow_timeout_func timeout,
-        void* user,
-        std::weak_ptr<llarp::service::Endpoint> ep)
-        : m_SocketID{socketid}
-        , m_LocalPort{localport}
-        , m_Filter{filter}
-        , m_Recv{recv}
-        , m_Timeout{timeout}
-        , m_User{user}
-        , m_Endpoint{std::move(ep)}
-    {}
-
-    void
-    KillAllFlows()
-    {
-      std::unique_lock lock{m_Access};
-      for (auto& item : m_Flows)
-      {
-        item.second.TimedOut(m_Timeout);
-      }
-      m_Flows.clear();
-    }
-
-    void
-    AddFlow(
-        const AddressVariant_t& from,
-        const belnet_udp_flowinfo& flow_addr,
-        void* flow_userdata,
-        int flow_timeoutseconds,
-        std::optional<llarp::net::IPPacket> firstPacket = std::nullopt)
-    {
-      std::unique_lock lock{m_Access};
-      auto& flow = m_Flows[from];
-      flow.m_FlowInfo = flow_addr;
-      flow.m_FlowTimeout = std::chrono::seconds{flow_timeoutseconds};
-      flow.m_FlowUserData = flow_userdata;
-      flow.m_Recv = m_Recv;
-      if (firstPacket)
-        flow.HandlePacket(*firstPacket);
-    }
-
-    void
-    ExpireOldFlows()
-    {
-      std::unique_lock lock{m_Access};
-      for (auto itr = m_Flows.begin(); itr != m_Flows.end();)
-      {
-        if (itr->second.IsExpired())
-        {
-          itr->second.TimedOut(m_Timeout);
-          itr = m_Flows.erase(itr);
-        }
-        else
-          ++itr;
-      }
-    }
-
-    void
-    HandlePacketFrom(AddressVariant_t from, llarp::net::IPPacket pkt)
-    {
-      
-      {
-        std::unique_lock lock{m_Access};
-        if (m_Flows.count(from))
-        {
-          m_Flows[from].HandlePacket(pkt);
-          return;
-        }
-      }
-
-      belnet_udp_flowinfo flow_addr{};
-      // set flow remote address
-      std::string addrstr = var::visit([](auto&& from) { return from.ToString(); }, from);
-
-      std::copy_n(
-          addrstr.data(),
-          std::min(addrstr.size(), sizeof(flow_addr.remote_host)),
-          flow_addr.remote_host);
-      // set socket id
-      flow_addr.socket_id = m_SocketID;
-      // get source port
-      if (const auto srcport = pkt.SrcPort())
-      {
-        flow_addr.remote_port = ToHost(*srcport).h;
-      }
-      else
-        return;  // invalid data so we bail
-      void* flow_userdata = nullptr;
-      int flow_timeoutseconds{};
-      // got a new flow, let's check if we want it
-      if (m_Filter(m_User, &flow_addr, &flow_userdata, &flow_timeoutseconds))
-        return;
-      AddFlow(from, flow_addr, flow_userdata, flow_timeoutseconds, pkt);
-    }
-  };
+  using llarp::libbelnet::OutboundDatagram;
+  using llarp::libbelnet::SendDatagram;
+  using llarp::libbelnet::UDPHandler;
+  using llarp::libbelnet::UDPSendQueue;
 
 }  // namespace
 
@@ -236,6 +90,7 @@ struct belnet_context
       llarp::net::port_t exposePort,
       belnet_udp_flow_filter filter,
       belnet_udp_flow_recv_func recv,
+      belnet_udp_flow_recv_batch_func recvBatch,
       belnet_udp_flow_timeout_func timeout,
       void* user)
   {
@@ -253,7 +108,7 @@ struct belnet_context
 
     std::weak_ptr<llarp::service::Endpoint> weak{ep};
     auto udp = std::make_shared<UDPHandler>(
-        next_socket_id(), exposePort, filter, recv, timeout, user, weak);
+        next_socket_id(), exposePort, filter, recv, recvBatch, timeout, user, weak);
     auto id = udp->m_SocketID;
     std::promise<bool> result;
 
@@ -292,11 +147,14 @@ struct belnet_context
     }
     if (udp)
     {
-      udp->KillAllFlows();
+      udp->Close();
 
       // remove packet handler
       impl->router->loop()->call(
-          [ep = udp->m_Endpoint.lock(), localport = llarp::ToHost(udp->m_LocalPort)]() {
+          [ep = std::dynamic_pointer_cast<llarp::service::Endpoint>(udp->m_Endpoint.lock()),
+           localport = llarp::ToHost(udp->m_LocalPort)]() {
+            if (not ep)
+              return;
             if (auto pkt = ep->EgresPacketRouter())
               pkt->RemoveUDPHandler(localport);
           });
@@ -333,8 +191,36 @@ struct belnet_context
   {
     streams[id] = false;
   }
+
+  /// make a datagram on a bound udp socket, must hold the lock
+  int
+  make_datagram(
+      const belnet_udp_flowinfo* remote, const void* ptr, size_t len, OutboundDatagram& dgram)
+  {
+    if (remote == nullptr)
+      return EINVAL;
+    auto itr = udp_sockets.find(remote->socket_id);
+    if (itr == udp_sockets.end())
+      return EHOSTUNREACH;
+    return llarp::libbelnet::MakeDatagram(
+        itr->second->m_Endpoint.lock(), itr->second->m_LocalPort, remote, ptr, len, dgram);
+  }
+};
+
+struct belnet_udp_send_queue
+{
+  std::shared_ptr<UDPSendQueue> impl;
+};
+
+struct belnet_stream
+{
+  std::shared_ptr<llarp::quic::StreamPipe> pipe;
 };
 
+static_assert(BELNET_STREAM_READABLE == llarp::quic::StreamPipe::READABLE);
+static_assert(BELNET_STREAM_WRITABLE == llarp::quic::StreamPipe::WRITABLE);
+static_assert(BELNET_STREAM_CLOSED == llarp::quic::StreamPipe::CLOSED);
+
 namespace
 {
 
@@ -623,6 +509,10 @@ extern "C"
       return;
     auto lock = ctx->acquire();
 
+    // never started, nothing to stop
+    if (not ctx->runner)
+      return;
+
     if (ctx->impl->IsStopping())
       return;
 
@@ -642,11 +532,18 @@ extern "C"
       const char* local,
       struct belnet_context* ctx)
   {
+    if (result == nullptr)
+      return;
     if (ctx == nullptr)
     {
       stream_error(result, EHOSTDOWN);
       return;
     }
+    if (remote == nullptr)
+    {
+      stream_error(result, EINVAL);
+      return;
+    }
     std::promise<void> promise;
 
     {
@@ -758,6 +655,100 @@ extern "C"
     }
   }
 
+  struct belnet_stream* EXPORT
+  belnet_stream_open(const char* remote, int* error, struct belnet_context* ctx)
+  {
+    int ignored;
+    int& err = error ? *error : ignored;
+    err = 0;
+    if (ctx == nullptr)
+    {
+      err = EHOSTDOWN;
+      return nullptr;
+    }
+    if (remote == nullptr)
+    {
+      err = EINVAL;
+      return nullptr;
+    }
+    std::string remotehost;
+    int remoteport;
+    try
+    {
+      auto [h, p] = split_host_port(remote);
+      remotehost = h;
+      remoteport = p;
+    }
+    catch (int e)
+    {
+      err = e;
+      return nullptr;
+    }
+    catch (std::exception& ex)
+    {
+      err = EINVAL;
+      return nullptr;
+    }
+
+    llarp::EventLoop_ptr loop;
+    llarp::quic::TunnelManager* quic = nullptr;
+    {
+      auto lock = ctx->acquire();
+      if (not ctx->impl->IsUp())
+      {
+        err = EHOSTDOWN;
+        return nullptr;
+      }
+      if (auto ep = ctx->endpoint())
+        quic = ep->GetQUICTunnel();
+      loop = ctx->impl->router->loop();
+    }
+    if (quic == nullptr)
+    {
+      err = ENOTSUP;
+      return nullptr;
+    }
+
+    auto pipe = llarp::quic::StreamPipe::open(
+        std::move(loop), *quic, std::move(remotehost), remoteport, std::chrono::seconds{10}, err);
+    if (not pipe)
+      return nullptr;
+    return new belnet_stream{std::move(pipe)};
+  }
+
+  int EXPORT
+  belnet_stream_read(struct belnet_stream* stream, void* buf, size_t len, size_t* nread)
+  {
+    if (stream == nullptr or nread == nullptr)
+      return EINVAL;
+    return stream->pipe->read(buf, len, *nread);
+  }
+
+  int EXPORT
+  belnet_stream_write(struct belnet_stream* stream, const void* buf, size_t len, size_t* nwritten)
+  {
+    if (stream == nullptr or nwritten == nullptr)
+      return EINVAL;
+    return stream->pipe->write(buf, len, *nwritten);
+  }
+
+  int EXPORT
+  belnet_stream_poll(struct belnet_stream* stream, int events, int timeout_ms)
+  {
+    if (stream == nullptr)
+      return BELNET_STREAM_CLOSED;
+    return stream->pipe->poll(events, std::chrono::milliseconds{timeout_ms});
+  }
+
+  void EXPORT
+  belnet_stream_free(struct belnet_stream* stream)
+  {
+    if (stream == nullptr)
+      return;
+    stream->pipe->close();
+    delete stream;
+  }
+
   int EXPORT
   belnet_inbound_stream(uint16_t port, struct belnet_context* ctx)
   {
@@ -923,7 +914,13 @@ extern "C"
     if (auto ep = ctx->endpoint())
     {
       if (auto maybe = ctx->make_udp_handler(
-              ep, llarp::net::port_t::from_host(exposedPort), filter, recv, timeout, user)) 
+              ep,
+              llarp::net::port_t::from_host(exposedPort),
+              filter,
+              recv,
+              nullptr,
+              timeout,
+              user))
       {
         result->socket_id = *maybe;
         return 0;
@@ -933,6 +930,40 @@ extern "C"
     return EINVAL;
   }
 
+  int EXPORT
+  belnet_udp_bind_batched(
+      uint16_t exposedPort,
+      belnet_udp_flow_filter filter,
+      belnet_udp_flow_recv_batch_func recv,
+      belnet_udp_flow_timeout_func timeout,
+      void* user,
+      struct belnet_udp_bind_result* result,
+      struct belnet_context* ctx)
+  {
+    if (filter == nullptr or recv == nullptr or timeout == nullptr or result == nullptr
+        or ctx == nullptr)
+      return EINVAL;
+
+    auto lock = ctx->acquire();
+    if (auto ep = ctx->endpoint())
+    {
+      if (auto maybe = ctx->make_udp_handler(
+              ep,
+              llarp::net::port_t::from_host(exposedPort),
+              filter,
+              nullptr,
+              recv,
+              timeout,
+              user))
+      {
+        result->socket_id = *maybe;
+        return 0;
+      }
+    }
+
+    return EINVAL;
+  }
+
   void EXPORT
   belnet_udp_close(int socket_id, struct belnet_context* ctx)
   {
@@ -950,48 +981,103 @@ extern "C"
       size_t len,
       struct belnet_context* ctx)
   {
-    if (remote == nullptr or remote->remote_port == 0 or ptr == nullptr or len == 0
-        or ctx == nullptr)
+    if (remote == nullptr or ctx == nullptr)
       return EINVAL;
-    std::shared_ptr<llarp::EndpointBase> ep;
-    llarp::nuint16_t srcport{0};
-    auto dstport = llarp::net::port_t::from_host(remote->remote_port);
+    OutboundDatagram dgram;
     {
       auto lock = ctx->acquire();
-      if (auto itr = ctx->udp_sockets.find(remote->socket_id); itr != ctx->udp_sockets.end())
+      if (auto err = ctx->make_datagram(remote, ptr, len, dgram))
+        return err;
+    }
+    std::promise<int> ret;
+    ctx->impl->router->loop()->call([&dgram, &ret]() { ret.set_value(SendDatagram(dgram)); });
+    return ret.get_future().get();
+  }
+
+  int EXPORT
+  belnet_udp_flow_send_batch(
+      const struct belnet_udp_datagram* pkts,
+      size_t num_pkts,
+      size_t* num_sent,
+      struct belnet_context* ctx)
+  {
+    if (num_sent)
+      *num_sent = 0;
+    if (pkts == nullptr or ctx == nullptr)
+      return EINVAL;
+    // build every datagram before the single hop onto the event loop, stopping at the first bad
+    // one; the ones before it are still sent
+    std::vector<OutboundDatagram> dgrams;
+    dgrams.reserve(num_pkts);
+    int err = 0;
+    {
+      auto lock = ctx->acquire();
+      for (size_t idx = 0; idx < num_pkts and err == 0; ++idx)
       {
-        ep = itr->second->m_Endpoint.lock();
-        srcport = itr->second->m_LocalPort;
+        OutboundDatagram dgram;
+        err = ctx->make_datagram(pkts[idx].remote, pkts[idx].data, pkts[idx].len, dgram);
+        if (err == 0)
+          dgrams.emplace_back(std::move(dgram));
       }
-      else
-        return EHOSTUNREACH;
     }
-    if (auto maybe = llarp::service::ParseAddress(std::string{remote->remote_host}))
-    {
-      llarp::net::IPPacket pkt = llarp::net::IPPacket::UDP(
-          llarp::nuint32_t{0},
-          srcport,
-          llarp::nuint32_t{0},
-          dstport,
-          llarp_buffer_t{reinterpret_cast<const uint8_t*>(ptr), len});
-
-      if (pkt.empty())
-        return EINVAL;
-      std::promise<int> ret;
-      ctx->impl->router->loop()->call([addr = *maybe, pkt = std::move(pkt), ep, &ret]() {
-        if (auto tag = ep->GetBestConvoTagFor(addr))
+    if (dgrams.empty())
+      return err;
+    std::promise<std::pair<size_t, int>> ret;
+    ctx->impl->router->loop()->call([&dgrams, &ret]() {
+      size_t sent = 0;
+      for (const auto& dgram : dgrams)
+      {
+        if (auto senderr = SendDatagram(dgram))
         {
-          if (ep->SendToOrQueue(*tag, pkt.ConstBuffer(), llarp::service::ProtocolType::TrafficV4))
-          {
-            ret.set_value(0);
-            return;
-          }
+          ret.set_value({sent, senderr});
+          return;
         }
-        ret.set_value(ENETUNREACH);
-      });
-      return ret.get_future().get();
+        ++sent;
+      }
+      ret.set_value({sent, 0});
+    });
+    auto [sent, senderr] = ret.get_future().get();
+    if (num_sent)
+      *num_sent = sent;
+    return senderr ? senderr : err;
+  }
+
+  struct belnet_udp_send_queue* EXPORT
+  belnet_udp_send_queue_new(int socket_id, size_t capacity, struct belnet_context* ctx)
+  {
+    if (ctx == nullptr or capacity == 0 or capacity > UDPSendQueue::MaxCapacity)
+      return nullptr;
+    auto lock = ctx->acquire();
+    auto itr = ctx->udp_sockets.find(socket_id);
+    if (itr == ctx->udp_sockets.end())
+      return nullptr;
+    try
+    {
+      return new belnet_udp_send_queue{
+          std::make_shared<UDPSendQueue>(itr->second, ctx->impl->router->loop(), capacity)};
     }
-    return EINVAL;
+    catch (const std::bad_alloc&)
+    {
+      return nullptr;
+    }
+  }
+
+  int EXPORT
+  belnet_udp_send_queue_push(
+      struct belnet_udp_send_queue* queue,
+      const struct belnet_udp_flowinfo* remote,
+      const void* ptr,
+      size_t len)
+  {
+    if (queue == nullptr)
+      return EINVAL;
+    return queue->impl->Push(remote, ptr, len);
+  }
+
+  void EXPORT
+  belnet_udp_send_queue_free(struct belnet_udp_send_queue* queue)
+  {
+    delete queue;
   }
 
   int EXPORT
@@ -0,0 +1,262 @@
+#include "belnet_udp.hpp"
+
+#include <llarp/service/address.hpp>
+#include <llarp/service/protocol_type.hpp>
+
+#include <cerrno>
+#include <string>
+
+namespace llarp::libbelnet
+{
+  void
+  UDPBatch::Deliver() const
+  {
+    std::vector<belnet_udp_datagram> pkts;
+    pkts.reserve(m_Packets.size());
+    for (const auto& pkt : m_Packets)
+    {
+      if (auto maybe = pkt.L4Data())
+        pkts.push_back(belnet_udp_datagram{&m_FlowInfo, maybe->first, maybe->second});
+    }
+    if (not pkts.empty())
+      m_RecvBatch(&m_FlowInfo, pkts.data(), pkts.size(), m_FlowUserData);
+  }
+
+  void
+  UDPFlow::HandlePacket(const net::IPPacket& pkt)
+  {
+    if (m_RecvBatch)
+    {
+      MarkActive();
+      m_Pending.emplace_back(pkt);
+      return;
+    }
+    if (auto maybe = pkt.L4Data())
+    {
+      MarkActive();
+      m_Recv(&m_FlowInfo, maybe->first, maybe->second, m_FlowUserData);
+    }
+  }
+
+  UDPBatch
+  UDPFlow::TakePending()
+  {
+    UDPBatch batch{m_FlowInfo, m_FlowUserData, m_RecvBatch, std::move(m_Pending)};
+    m_Pending.clear();
+    return batch;
+  }
+
+  void
+  UDPHandler::FlushPending()
+  {
+    std::vector<UDPBatch> batches;
+    {
+      std::unique_lock lock{m_Access};
+      m_FlushQueued = false;
+      for (auto& item : m_Flows)
+      {
+        if (not item.second.m_Pending.empty())
+          batches.emplace_back(item.second.TakePending());
+      }
+    }
+    // the hooks are free to call back into belnet, so they run without our lock
+    for (const auto& batch : batches)
+      batch.Deliver();
+  }
+
+  void
+  UDPHandler::QueueFlush(EndpointBase& ep)
+  {
+    if (m_FlushQueued)
+      return;
+    m_FlushQueued = true;
+    ep.Loop()->call_soon([self = weak_from_this()]() {
+      if (auto udp = self.lock())
+        udp->FlushPending();
+    });
+  }
+
+  void
+  UDPHandler::KillAllFlows()
+  {
+    std::unique_lock lock{m_Access};
+    for (auto& item : m_Flows)
+    {
+      item.second.TimedOut(m_Timeout);
+    }
+    m_Flows.clear();
+  }
+
+  void
+  UDPHandler::Close()
+  {
+    m_Closed = true;
+    KillAllFlows();
+  }
+
+  void
+  UDPHandler::AddFlow(
+      const AddressVariant_t& from,
+      const belnet_udp_flowinfo& flow_addr,
+      void* flow_userdata,
+      int flow_timeoutseconds,
+      std::optional<net::IPPacket> firstPacket)
+  {
+    std::unique_lock lock{m_Access};
+    auto& flow = m_Flows[from];
+    flow.m_FlowInfo = flow_addr;
+    flow.m_FlowTimeout = std::chrono::seconds{flow_timeoutseconds};
+    flow.m_FlowUserData = flow_userdata;
+    flow.m_Recv = m_Recv;
+    flow.m_RecvBatch = m_RecvBatch;
+    if (firstPacket)
+      flow.HandlePacket(*firstPacket);
+    if (m_RecvBatch and not flow.m_Pending.empty())
+    {
+      if (auto ep = m_Endpoint.lock())
+        QueueFlush(*ep);
+    }
+  }
+
+  void
+  UDPHandler::ExpireOldFlows()
+  {
+    std::unique_lock lock{m_Access};
+    for (auto itr = m_Flows.begin(); itr != m_Flows.end();)
+    {
+      if (itr->second.IsExpired())
+      {
+        itr->second.TimedOut(m_Timeout);
+        itr = m_Flows.erase(itr);
+      }
+      else
+        ++itr;
+    }
+  }
+
+  void
+  UDPHandler::HandlePacketFrom(AddressVariant_t from, net::IPPacket pkt)
+  {
+    {
+      std::unique_lock lock{m_Access};
+      if (m_Flows.count(from))
+      {
+        m_Flows[from].HandlePacket(pkt);
+        if (m_RecvBatch)
+        {
+          if (auto ep = m_Endpoint.lock())
+            QueueFlush(*ep);
+        }
+        return;
+      }
+    }
+
+    belnet_udp_flowinfo flow_addr{};
+    // set flow remote address
+    std::string addrstr = var::visit([](auto&& from) { return from.ToString(); }, from);
+
+    std::copy_n(
+        addrstr.data(),
+        std::min(addrstr.size(), sizeof(flow_addr.remote_host)),
+        flow_addr.remote_host);
+    // set socket id
+    flow_addr.socket_id = m_SocketID;
+    // get source port
+    if (const auto srcport = pkt.SrcPort())
+    {
+      flow_addr.remote_port = ToHost(*srcport).h;
+    }
+    else
+      return;  // invalid data so we bail
+    void* flow_userdata = nullptr;
+    int flow_timeoutseconds{};
+    // got a new flow, let's check if we want it
+    if (m_Filter(m_User, &flow_addr, &flow_userdata, &flow_timeoutseconds))
+      return;
+    AddFlow(from, flow_addr, flow_userdata, flow_timeoutseconds, pkt);
+  }
+
+  int
+  MakeDatagram(
+      std::shared_ptr<EndpointBase> ep,
+      nuint16_t srcport,
+      const belnet_udp_flowinfo* remote,
+      const void* ptr,
+      size_t len,
+      OutboundDatagram& dgram)
+  {
+    if (remote == nullptr or remote->remote_port == 0 or ptr == nullptr or len == 0)
+      return EINVAL;
+    if (not ep)
+      return EHOSTUNREACH;
+    auto maybe = service::ParseAddress(std::string{remote->remote_host});
+    if (not maybe)
+      return EINVAL;
+    dgram.pkt = net::IPPacket::UDP(
+        nuint32_t{0},
+        srcport,
+        nuint32_t{0},
+        net::port_t::from_host(remote->remote_port),
+        llarp_buffer_t{reinterpret_cast<const uint8_t*>(ptr), len});
+    if (dgram.pkt.empty())
+      return EINVAL;
+    dgram.ep = std::move(ep);
+    dgram.addr = *maybe;
+    return 0;
+  }
+
+  int
+  SendDatagram(const OutboundDatagram& dgram)
+  {
+    if (auto tag = dgram.ep->GetBestConvoTagFor(dgram.addr))
+    {
+      if (dgram.ep->SendToOrQueue(
+              *tag, dgram.pkt.ConstBuffer(), service::ProtocolType::TrafficV4))
+        return 0;
+    }
+    return ENETUNREACH;
+  }
+
+  bool
+  UDPSendQueue::IsClosed() const
+  {
+    auto socket = m_Socket.lock();
+    return not socket or socket->m_Closed;
+  }
+
+  int
+  UDPSendQueue::Push(const belnet_udp_flowinfo* remote, const void* ptr, size_t len)
+  {
+    if (remote == nullptr)
+      return EINVAL;
+    if (IsClosed())
+      return EBADF;
+    // the flow has to be on the socket we send from
+    if (remote->socket_id != m_SocketID)
+      return EHOSTUNREACH;
+    OutboundDatagram dgram;
+    if (auto err = MakeDatagram(m_Endpoint.lock(), m_LocalPort, remote, ptr, len, dgram))
+      return err;
+    if (m_Queue.tryPushBack(std::move(dgram)) != thread::QueueReturn::Success)
+      return EAGAIN;
+    if (not m_DrainQueued.exchange(true))
+    {
+      m_Loop->call_soon([self = shared_from_this()]() { self->Drain(); });
+    }
+    return 0;
+  }
+
+  void
+  UDPSendQueue::Drain()
+  {
+    // clear the flag before draining so a push that lands after we looked at the queue queues
+    // another drain rather than being left behind
+    m_DrainQueued = false;
+    const bool closed = IsClosed();
+    while (auto maybe = m_Queue.tryPopFront())
+    {
+      if (not closed)
+        SendDatagram(*maybe);
+    }
+  }
+}  // namespace llarp::libbelnet
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <belnet/belnet_udp.h>
+#include <llarp/endpoint_base.hpp>
+#include <llarp/net/ip_packet.hpp>
+#include <llarp/net/net_int.hpp>
+#include <llarp/util/thread/queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/// udp sockets of libbelnet, kept apart from the rest of the embedding api so they can be
+/// driven without a running router
+namespace llarp::libbelnet
+{
+  /// packets taken out of a flow to be handed to its batched receive hook, so the hook runs
+  /// without the socket's lock held
+  struct UDPBatch
+  {
+    belnet_udp_flowinfo m_FlowInfo;
+    void* m_FlowUserData;
+    belnet_udp_flow_recv_batch_func m_RecvBatch;
+    std::vector<net::IPPacket> m_Packets;
+
+    /// call the batched receive hook once with all the packets
+    void
+    Deliver() const;
+  };
+
+  struct UDPFlow
+  {
+    using Clock_t = std::chrono::steady_clock;
+    void* m_FlowUserData;
+    std::chrono::seconds m_FlowTimeout;
+    std::chrono::time_point<Clock_t> m_ExpiresAt;
+    belnet_udp_flowinfo m_FlowInfo;
+    belnet_udp_flow_recv_func m_Recv;
+    belnet_udp_flow_recv_batch_func m_RecvBatch = nullptr;
+    /// packets held for the next batched delivery
+    std::vector<net::IPPacket> m_Pending;
+
+    /// call timeout hook for this flow
+    void
+    TimedOut(belnet_udp_flow_timeout_func timeout)
+    {
+      timeout(&m_FlowInfo, m_FlowUserData);
+    }
+
+    /// mark this flow as active
+    /// updates the expires at timestamp
+    void
+    MarkActive()
+    {
+      m_ExpiresAt = Clock_t::now() + m_FlowTimeout;
+    }
+
+    /// returns true if we think this flow is expired
+    bool
+    IsExpired() const
+    {
+      return Clock_t::now() >= m_ExpiresAt;
+    }
+
+    void
+    HandlePacket(const net::IPPacket& pkt);
+
+    /// take the held packets out for delivery
+    UDPBatch
+    TakePending();
+  };
+
+  struct UDPHandler : std::enable_shared_from_this<UDPHandler>
+  {
+    using AddressVariant_t = EndpointBase::AddressVariant_t;
+    int m_SocketID;
+    nuint16_t m_LocalPort;
+    belnet_udp_flow_filter m_Filter;
+    belnet_udp_flow_recv_func m_Recv;
+    belnet_udp_flow_recv_batch_func m_RecvBatch;
+    belnet_udp_flow_timeout_func m_Timeout;
+    void* m_User;
+    std::weak_ptr<EndpointBase> m_Endpoint;
+
+    std::unordered_map<AddressVariant_t, UDPFlow> m_Flows;
+    /// true while a flush of batched packets is queued on the event loop
+    bool m_FlushQueued = false;
+    /// set once the socket is closed, its send queues drop what they still hold
+    std::atomic<bool> m_Closed{false};
+
+    std::mutex m_Access;
+
+    explicit UDPHandler(
+        int socketid,
+        nuint16_t localport,
+        belnet_udp_flow_filter filter,
+        belnet_udp_flow_recv_func recv,
+        belnet_udp_flow_recv_batch_func recvBatch,
+        belnet_udp_flow_timeout_func timeout,
+        void* user,
+        std::weak_ptr<EndpointBase> ep)
+        : m_SocketID{socketid}
+        , m_LocalPort{localport}
+        , m_Filter{filter}
+        , m_Recv{recv}
+        , m_RecvBatch{recvBatch}
+        , m_Timeout{timeout}
+        , m_User{user}
+        , m_Endpoint{std::move(ep)}
+    {}
+
+    /// deliver packets that came in since the last flush, one batch per flow.  we queue this
+    /// behind whatever the event loop is doing so that a burst of packets becomes one batch.
+    void
+    FlushPending();
+
+    /// queue a flush of batched packets on the event loop if we have not already, must hold
+    /// m_Access
+    void
+    QueueFlush(EndpointBase& ep);
+
+    void
+    KillAllFlows();
+
+    /// close the socket: time out all flows and drop datagrams still queued to send from it
+    void
+    Close();
+
+    void
+    AddFlow(
+        const AddressVariant_t& from,
+        const belnet_udp_flowinfo& flow_addr,
+        void* flow_userdata,
+        int flow_timeoutseconds,
+        std::optional<net::IPPacket> firstPacket = std::nullopt);
+
+    void
+    ExpireOldFlows();
+
+    void
+    HandlePacketFrom(AddressVariant_t from, net::IPPacket pkt);
+  };
+
+  /// a udp datagram ready to be sent from the event loop
+  struct OutboundDatagram
+  {
+    std::shared_ptr<EndpointBase> ep;
+    EndpointBase::AddressVariant_t addr;
+    net::IPPacket pkt;
+  };
+
+  /// make a datagram to remote from local port srcport on ep, returns an errno value on error
+  int
+  MakeDatagram(
+      std::shared_ptr<EndpointBase> ep,
+      nuint16_t srcport,
+      const belnet_udp_flowinfo* remote,
+      const void* ptr,
+      size_t len,
+      OutboundDatagram& dgram);
+
+  /// send a datagram, must be called from the event loop, returns an errno value on error
+  int
+  SendDatagram(const OutboundDatagram& dgram);
+
+  /// datagrams pushed by one application thread and sent from the event loop in batches
+  struct UDPSendQueue : std::enable_shared_from_this<UDPSendQueue>
+  {
+    /// most datagrams a queue may hold
+    static constexpr size_t MaxCapacity = std::min(
+        size_t{thread::QueueManager::MAX_CAPACITY},
+        std::numeric_limits<size_t>::max() / sizeof(OutboundDatagram));
+
+    const std::weak_ptr<UDPHandler> m_Socket;
+    const int m_SocketID;
+    EventLoop_ptr m_Loop;
+    std::weak_ptr<EndpointBase> m_Endpoint;
+    nuint16_t m_LocalPort;
+    thread::Queue<OutboundDatagram> m_Queue;
+    /// set while a drain is queued on the event loop
+    std::atomic<bool> m_DrainQueued{false};
+
+    UDPSendQueue(const std::shared_ptr<UDPHandler>& socket, EventLoop_ptr loop, size_t capacity)
+        : m_Socket{socket}
+        , m_SocketID{socket->m_SocketID}
+        , m_Loop{std::move(loop)}
+        , m_Endpoint{socket->m_Endpoint}
+        , m_LocalPort{socket->m_LocalPort}
+        , m_Queue{capacity}
+    {}
+
+    /// true once the socket we send from is closed
+    bool
+    IsClosed() const;
+
+    int
+    Push(const belnet_udp_flowinfo* remote, const void* ptr, size_t len);
+
+    /// send everything queued, or drop it if the socket was closed since it was pushed
+    void
+    Drain();
+  };
+}  // namespace llarp::libbelnet
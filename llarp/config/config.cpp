@@ -769,6 +769,113 @@ namespace llarp
           m_PathAlignmentTimeout = std::chrono::seconds{val};
         });
 
+    conf.defineOption<int>(
+        "network",
+        "multipath",
+        ClientOnly,
+        Default{1},
+        Comment{
+            "Number of paths and remote introductions to stripe traffic over for a single",
+            "session to a remote .bdx address. 1 (the default) sends each session down one path,",
+            "higher values let a single bulk transfer use more than one path's worth of bandwidth.",
+        },
+        [this](int arg) {
+          if (arg < 1 or arg > 8)
+            throw std::invalid_argument("[network]:multipath must be >= 1 and <= 8");
+          m_MultipathWidth = arg;
+        });
+
+    conf.defineOption<int>(
+        "network",
+        "multipath-reorder-window",
+        ClientOnly,
+        Default{0},
+        Comment{
+            "How long, in milliseconds, to hold inbound traffic from a remote that stripes over",
+            "several paths while waiting for an earlier packet to arrive. 0 (the default) delivers",
+            "traffic in the order it arrives; enable this if remotes that talk to us use multipath",
+            "and their streams suffer from out of order delivery.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 1000)
+            throw std::invalid_argument(
+                "[network]:multipath-reorder-window must be >= 0 and <= 1000");
+          m_ReorderWindow = std::chrono::milliseconds{arg};
+        });
+
+    conf.defineOption<int>(
+        "network",
+        "spare-paths",
+        ClientOnly,
+        Default{4},
+        Comment{
+            "Maximum number of spare paths to keep built ahead of time to the routers of .bdx",
+            "and .mnode addresses we recently connected to, so that reconnecting to them does not",
+            "have to wait on a path build. 0 disables the spare path pool.",
+        },
+        [this](int arg) {
+          if (arg < 0 or arg > 16)
+            throw std::invalid_argument("[network]:spare-paths must be >= 0 and <= 16");
+          m_SparePaths = arg;
+        });
+
+    conf.defineOption<std::string>(
+        "network",
+        "quic-congestion-control",
+        ClientOnly,
+        Default{"cubic"},
+        Comment{
+            "Congestion controller for quic tunnels (belnet tcp tunnels made with quic_connect).",
+            "One of cubic (the default), reno or bbr.",
+        },
+        [this](std::string arg) {
+          if (arg != "cubic" and arg != "reno" and arg != "bbr")
+            throw std::invalid_argument{
+                "[network]:quic-congestion-control must be one of cubic, reno or bbr"};
+          m_QUICCongestionControl = std::move(arg);
+        });
+
+    conf.defineOption<int>(
+        "network",
+        "quic-initial-rtt",
+        ClientOnly,
+        Comment{
+            "Initial round trip time in milliseconds for quic tunnels to remotes we have not",
+            "measured the path latency of yet. If unset the quic library default of 333ms is used.",
+        },
+        [this](int arg) {
+          if (arg <= 0)
+            throw std::invalid_argument{"[network]:quic-initial-rtt must be positive"};
+          m_QUICInitialRTT = std::chrono::milliseconds{arg};
+        });
+
+    conf.defineOption<bool>(
+        "network",
+        "quic-window-autotune",
+        ClientOnly,
+        Default{true},
+        Comment{
+            "Grow the flow control windows of quic tunnels when the remote fills them faster",
+            "than the round trip time, so bulk transfers over long paths are not window limited.",
+        },
+        AssignmentAcceptor(m_QUICWindowAutotune));
+
+    conf.defineOption<int>(
+        "network",
+        "quic-max-stream-window",
+        ClientOnly,
+        Default{4096},
+        Comment{
+            "Largest flow control window in KiB that auto-tuning grows a single quic stream to.",
+            "The window of a whole quic connection is allowed to grow to 4 times this.",
+        },
+        [this](int arg) {
+          if (arg < 64 or arg > 65536)
+            throw std::invalid_argument{
+                "[network]:quic-max-stream-window must be >= 64 and <= 65536"};
+          m_QUICMaxStreamWindow = size_t{1024} * arg;
+        });
+
     conf.defineOption<fs::path>(
         "network",
         "persist-addrmap-file",
@@ -1157,6 +1264,21 @@ namespace llarp
             "Recommend localhost-only for security purposes.",
         });
 
+    conf.defineOption<std::string>(
+        "api",
+        "metrics-bind",
+        [this](std::string arg) {
+          if (arg.empty())
+            return;
+          m_metricsBindAddr = SockAddr{arg};
+        },
+        Comment{
+            "IP address and port on which to serve metrics over plain http in the prometheus text",
+            "format, e.g. 127.0.0.1:1191.  Disabled by default; the same metrics are always",
+            "available through the `llarp.metrics` rpc call.",
+            "Recommend localhost-only for security purposes.",
+        });
+
     conf.defineOption<std::string>("api", "authkey", Deprecated);
 
     // TODO: this was from pre-refactor:
@@ -1338,7 +1460,7 @@ namespace llarp
   }
 
   bool
-  PeerSelectionConfig::Acceptable(const std::set<RouterContact>& rcs) const
+  PeerSelectionConfig::Acceptable(const std::vector<const RouterContact*>& rcs) const
   {
     if (m_UniqueHopsNetmaskSize == 0)
       return true;
@@ -1346,7 +1468,7 @@ namespace llarp
     std::set<IPRange> seenRanges;
     for (const auto& hop : rcs)
     {
-      for (const auto& addr : hop.addrs)
+      for (const auto& addr : hop->addrs)
       {
         const auto network_addr = net::In6ToHUInt(addr.ip) & netmask;
         if (auto [it, inserted] = seenRanges.emplace(network_addr, netmask); not inserted)
@@ -101,7 +101,7 @@ namespace llarp
 
     /// return true if this set of router contacts is acceptable against this config
     bool
-    Acceptable(const std::set<RouterContact>& hops) const;
+    Acceptable(const std::vector<const RouterContact*>& hops) const;
   };
 
   struct NetworkConfig
@@ -144,6 +144,24 @@ namespace llarp
 
     std::optional<llarp_time_t> m_PathAlignmentTimeout;
 
+    /// how many paths / remote intros a single session stripes its traffic over
+    size_t m_MultipathWidth = 1;
+
+    /// how long inbound traffic waits on a gap from a striping remote, 0 to not reorder
+    llarp_time_t m_ReorderWindow = 0s;
+
+    /// max number of prebuilt spare paths to recently used remotes
+    size_t m_SparePaths = 4;
+
+    /// congestion controller for quic tunnels: "cubic", "reno" or "bbr"
+    std::string m_QUICCongestionControl = "cubic";
+    /// initial rtt for quic tunnels to remotes we have no path latency for
+    std::optional<llarp_time_t> m_QUICInitialRTT;
+    /// grow quic flow control windows with the bandwidth delay product of the tunnel
+    bool m_QUICWindowAutotune = true;
+    /// largest flow control window of a single quic stream
+    size_t m_QUICMaxStreamWindow = 4 * 1024 * 1024;
+
     std::optional<fs::path> m_AddrMapPersistFile;
 
     bool m_EnableRoutePoker;
@@ -190,6 +208,7 @@ namespace llarp
   {
     bool m_enableRPCServer = false;
     std::string m_rpcBindAddr;
+    std::optional<SockAddr> m_metricsBindAddr;
 
     void
     defineConfigOptions(ConfigDefinition& conf, const ConfigGenParameters& params);
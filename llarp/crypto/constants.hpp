@@ -14,6 +14,7 @@ static constexpr uint32_t HMACSECSIZE = 32;
 static constexpr uint32_t SIGSIZE = 64;
 static constexpr uint32_t TUNNONCESIZE = 32;
 static constexpr uint32_t HMACSIZE = 32;
+static constexpr uint32_t AEADTAGSIZE = 16;
 static constexpr uint32_t PATHIDSIZE = 16;
 
 static constexpr uint32_t PQ_CIPHERTEXTSIZE = crypto_kem_CIPHERTEXTBYTES;
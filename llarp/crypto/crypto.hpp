@@ -36,6 +36,17 @@ namespace llarp
     xchacha20_alt(
         const llarp_buffer_t&, const llarp_buffer_t&, const SharedSecret&, const byte_t*) = 0;
 
+    /// xchacha20-poly1305 aead, encrypts in place and writes the detached tag (AEADTAGSIZE) to
+    /// tag; nonce is NONCESIZE bytes
+    virtual bool
+    xchacha20_poly1305_seal(
+        const llarp_buffer_t&, const SharedSecret&, const byte_t* nonce, byte_t* tag) = 0;
+
+    /// xchacha20-poly1305 aead, checks the detached tag and decrypts in place
+    virtual bool
+    xchacha20_poly1305_open(
+        const llarp_buffer_t&, const SharedSecret&, const byte_t* nonce, const byte_t* tag) = 0;
+
     /// path dh creator's side
     virtual bool
     dh_client(SharedSecret&, const PubKey&, const SecretKey&, const TunnelNonce&) = 0;
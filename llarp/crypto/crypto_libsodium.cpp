@@ -149,6 +149,27 @@ namespace llarp
       return crypto_stream_xchacha20_xor(out.base, in.base, in.sz, n, k.data()) == 0;
     }
 
+    static_assert(AEADTAGSIZE == crypto_aead_xchacha20poly1305_ietf_ABYTES);
+    static_assert(NONCESIZE == crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+
+    bool
+    CryptoLibSodium::xchacha20_poly1305_seal(
+        const llarp_buffer_t& buff, const SharedSecret& k, const byte_t* n, byte_t* tag)
+    {
+      return crypto_aead_xchacha20poly1305_ietf_encrypt_detached(
+                 buff.base, tag, nullptr, buff.base, buff.sz, nullptr, 0, nullptr, n, k.data())
+          == 0;
+    }
+
+    bool
+    CryptoLibSodium::xchacha20_poly1305_open(
+        const llarp_buffer_t& buff, const SharedSecret& k, const byte_t* n, const byte_t* tag)
+    {
+      return crypto_aead_xchacha20poly1305_ietf_decrypt_detached(
+                 buff.base, nullptr, buff.base, buff.sz, tag, nullptr, 0, n, k.data())
+          == 0;
+    }
+
     bool
     CryptoLibSodium::dh_client(
         llarp::SharedSecret& shared, const PubKey& pk, const SecretKey& sk, const TunnelNonce& n)
@@ -29,6 +29,19 @@ namespace llarp
           const SharedSecret&,
           const byte_t*) override;
 
+      /// xchacha20-poly1305 aead seal in place
+      bool
+      xchacha20_poly1305_seal(
+          const llarp_buffer_t&, const SharedSecret&, const byte_t* nonce, byte_t* tag) override;
+
+      /// xchacha20-poly1305 aead open in place
+      bool
+      xchacha20_poly1305_open(
+          const llarp_buffer_t&,
+          const SharedSecret&,
+          const byte_t* nonce,
+          const byte_t* tag) override;
+
       /// path dh creator's side
       bool
       dh_client(SharedSecret&, const PubKey&, const SecretKey&, const TunnelNonce&) override;
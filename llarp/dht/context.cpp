@@ -8,6 +8,7 @@
 #include <llarp/dht/messages/gotintro.hpp>
 #include <llarp/dht/messages/gotrouter.hpp>
 #include <llarp/dht/messages/pubintro.hpp>
+#include <llarp/dht/messages/syncintro.hpp>
 #include "node.hpp"
 #include "publishservicejob.hpp"
 #include "recursiverouterlookup.hpp"
@@ -162,6 +163,11 @@ namespace llarp
       void
       handle_cleaner_timer();
 
+      /// send a summary of our stored intro sets to our closest neighbors so they send back
+      /// what we are missing
+      void
+      SyncIntroSets();
+
       /// explore dht for new routers
       void
       Explore(size_t N = 3);
@@ -171,9 +177,9 @@ namespace llarp
       std::unique_ptr<Bucket<RCNode>> _nodes;
 
       // for introduction sets
-      std::unique_ptr<Bucket<IMNode>> _services;
+      std::unique_ptr<IntroSetStore> _services;
 
-      Bucket<IMNode>*
+      IntroSetStore*
       services() override
       {
         return _services.get();
@@ -225,7 +231,7 @@ namespace llarp
       bool
       GetRCFromNodeDB(const Key_t& k, llarp::RouterContact& rc) const override
       {
-        if (const auto maybe = router->nodedb()->Get(k.as_array()); maybe.has_value())
+        if (const auto maybe = router->nodedb()->Get(k.as_array()))
         {
           rc = *maybe;
           return true;
@@ -354,18 +360,30 @@ namespace llarp
       if (_services)
       {
         // expire intro sets
-        auto& nodes = _services->nodes;
-        auto itr = nodes.begin();
-        while (itr != nodes.end())
-        {
-          if (itr->second.introset.IsExpired(now))
-          {
-            itr = nodes.erase(itr);
-          }
-          else
-            ++itr;
-        }
+        _services->Expire(now);
+      }
+    }
+
+    void
+    Context::SyncIntroSets()
+    {
+      if (not router->IsMasterNode())
+        return;
+      // one more than we sync with, as we are usually the closest to ourselves
+      const auto closest = router->nodedb()->FindManyClosestTo(ourKey, IntroSetSyncPeers + 1);
+      // the same filter goes to every peer this round
+      const auto summary = _services->Summary();
+      size_t sent = 0;
+      for (const auto& rc : closest)
+      {
+        if (sent == IntroSetSyncPeers)
+          break;
+        if (Key_t{rc.pubkey} == ourKey)
+          continue;
+        DHTSendTo(rc.pubkey.as_array(), new SyncIntroSetsMessage(summary, ++ids));
+        ++sent;
       }
+      LogDebug("synced ", _services->size(), " intro sets with ", sent, " peers");
     }
 
     void
@@ -431,10 +449,7 @@ namespace llarp
     std::optional<llarp::service::EncryptedIntroSet>
     Context::GetIntroSetByLocation(const Key_t& key) const
     {
-      auto itr = _services->nodes.find(key);
-      if (itr == _services->nodes.end())
-        return {};
-      return itr->second.introset;
+      return _services->Get(key);
     }
 
     void
@@ -467,11 +482,13 @@ namespace llarp
       router = r;
       ourKey = us;
       _nodes = std::make_unique<Bucket<RCNode>>(ourKey, llarp::randint);
-      _services = std::make_unique<Bucket<IMNode>>(ourKey, llarp::randint);
+      _services = std::make_unique<IntroSetStore>();
       llarp::LogDebug("initialize dht with key ", ourKey);
       // start cleanup timer
       _timer_keepalive = std::make_shared<int>(0);
       router->loop()->call_every(1s, _timer_keepalive, [this] { handle_cleaner_timer(); });
+      router->loop()->call_every(
+          IntroSetSyncInterval, _timer_keepalive, [this] { SyncIntroSets(); });
     }
 
     void
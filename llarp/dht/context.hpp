@@ -3,6 +3,7 @@
 
 #include "bucket.hpp"
 #include "dht.h"
+#include "introset_store.hpp"
 #include "key.hpp"
 #include "message.hpp"
 #include <llarp/dht/messages/findintro.hpp>
@@ -32,6 +33,12 @@ namespace llarp
     static constexpr size_t IntroSetStorageRedundancy =
         (IntroSetRelayRedundancy * IntroSetRequestsPerRelay);
 
+    /// how often relays sync stored intro sets with their dht neighbors
+    static constexpr auto IntroSetSyncInterval = 1min;
+
+    /// number of dht neighbors a relay syncs intro sets with each round
+    static constexpr size_t IntroSetSyncPeers = IntroSetStorageRedundancy;
+
     struct AbstractContext
     {
       using PendingIntrosetLookups = TXHolder<TXOwner, service::EncryptedIntroSet>;
@@ -168,7 +175,7 @@ namespace llarp
       virtual const PendingExploreLookups&
       pendingExploreLookups() const = 0;
 
-      virtual Bucket<IMNode>*
+      virtual IntroSetStore*
       services() = 0;
 
       virtual bool&
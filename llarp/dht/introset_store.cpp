@@ -0,0 +1,249 @@
+#include "introset_store.hpp"
+
+#include <llarp/constants/link_layer.hpp>
+#include <llarp/constants/path.hpp>
+#include <llarp/crypto/crypto.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace llarp
+{
+  namespace dht
+  {
+    namespace
+    {
+      /// splitmix64 finalizer
+      uint64_t
+      Mix(uint64_t x)
+      {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+      }
+
+      uint64_t
+      LoadWord(const byte_t* ptr)
+      {
+        uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        return word;
+      }
+
+      llarp_time_t
+      ExpiresAt(const service::EncryptedIntroSet& introset)
+      {
+        return introset.signedAt + path::default_lifetime;
+      }
+
+      /// the start of the expiry bucket holding expires; a bucket is looked at from its start so
+      /// nothing in it outlives its expiry by more than the time between Expire() calls
+      llarp_time_t
+      ExpiryBucket(llarp_time_t expires)
+      {
+        const auto width =
+            std::chrono::duration_cast<llarp_time_t>(IntroSetStore::ExpiryBucketWidth);
+        return (expires / width) * width;
+      }
+
+      bool
+      BitAt(const Key_t& key, size_t bit)
+      {
+        return key[bit / 8] & (0x80 >> (bit % 8));
+      }
+
+      size_t
+      EncodedSize(const service::EncryptedIntroSet& introset)
+      {
+        std::array<byte_t, MAX_LINK_MSG_SIZE> tmp;
+        llarp_buffer_t buf{tmp};
+        if (not introset.BEncode(&buf))
+          return tmp.size();
+        return buf.cur - buf.base;
+      }
+    }  // namespace
+
+    IntroSetFilter::IntroSetFilter(size_t numElements) : salt{randint()}
+    {
+      const auto bytes = (numElements * BitsPerElement + 7) / 8;
+      bits.resize(std::clamp(bytes, MinBytes, MaxBytes));
+    }
+
+    template <typename Visit>
+    void
+    IntroSetFilter::ForEachBit(const service::EncryptedIntroSet& introset, Visit&& visit) const
+    {
+      // double hashing over two words of the location; intro set locations are public keys so
+      // their bytes are already well spread, the salt and signing time are mixed in
+      const auto* loc = introset.derivedSigningKey.data();
+      const auto numBits = bits.size() * 8;
+      const uint64_t h1 = Mix(LoadWord(loc) ^ salt ^ introset.signedAt.count());
+      const uint64_t h2 = Mix(LoadWord(loc + 8) ^ salt) | 1;
+      for (uint64_t idx = 0; idx < NumHashes; ++idx)
+        visit((h1 + idx * h2) % numBits);
+    }
+
+    void
+    IntroSetFilter::Add(const service::EncryptedIntroSet& introset)
+    {
+      ForEachBit(introset, [this](uint64_t bit) { bits[bit / 8] |= char(1 << (bit % 8)); });
+    }
+
+    bool
+    IntroSetFilter::MaybeContains(const service::EncryptedIntroSet& introset) const
+    {
+      bool found = true;
+      ForEachBit(introset, [this, &found](uint64_t bit) {
+        found = found and (bits[bit / 8] & char(1 << (bit % 8)));
+      });
+      return found;
+    }
+
+    bool
+    IntroSetFilter::IsValid() const
+    {
+      return bits.size() >= MinBytes and bits.size() <= MaxBytes;
+    }
+
+    StorageCandidates::StorageCandidates(std::vector<Key_t> relays, size_t redundancy)
+        : m_Relays{std::move(relays)}, m_Redundancy{redundancy}
+    {
+      std::sort(m_Relays.begin(), m_Relays.end());
+      m_Relays.erase(std::unique(m_Relays.begin(), m_Relays.end()), m_Relays.end());
+    }
+
+    void
+    StorageCandidates::Collect(
+        Iter_t begin,
+        Iter_t end,
+        size_t bit,
+        const Key_t& location,
+        std::vector<Key_t>& closest) const
+    {
+      const size_t want = m_Redundancy - closest.size();
+      if (want == 0 or begin == end)
+        return;
+      if (static_cast<size_t>(end - begin) <= want)
+      {
+        closest.insert(closest.end(), begin, end);
+        return;
+      }
+      // every relay in the range shares the first `bit` bits, so the ones that also match
+      // location's next bit are all closer to it than the ones that don't
+      const auto mid = std::partition_point(
+          begin, end, [bit](const Key_t& relay) { return not BitAt(relay, bit); });
+      if (BitAt(location, bit))
+      {
+        Collect(mid, end, bit + 1, location, closest);
+        Collect(begin, mid, bit + 1, location, closest);
+      }
+      else
+      {
+        Collect(begin, mid, bit + 1, location, closest);
+        Collect(mid, end, bit + 1, location, closest);
+      }
+    }
+
+    std::vector<Key_t>
+    StorageCandidates::Closest(const Key_t& location) const
+    {
+      std::vector<Key_t> closest;
+      closest.reserve(m_Redundancy);
+      Collect(m_Relays.begin(), m_Relays.end(), 0, location, closest);
+      return closest;
+    }
+
+    bool
+    StorageCandidates::IsCandidate(const Key_t& location, const Key_t& relay) const
+    {
+      const auto closest = Closest(location);
+      return std::find(closest.begin(), closest.end(), relay) != closest.end();
+    }
+
+    bool
+    IntroSetStore::Put(const service::EncryptedIntroSet& introset)
+    {
+      const Key_t location{introset.derivedSigningKey.as_array()};
+      auto [itr, inserted] = m_IntroSets.try_emplace(location, introset);
+      if (not inserted)
+      {
+        if (not itr->second.OtherIsNewer(introset))
+          return false;
+        itr->second = introset;
+      }
+      m_Expiry[ExpiryBucket(ExpiresAt(introset))].push_back(location);
+      return true;
+    }
+
+    std::optional<service::EncryptedIntroSet>
+    IntroSetStore::Get(const Key_t& location) const
+    {
+      if (auto itr = m_IntroSets.find(location); itr != m_IntroSets.end())
+        return itr->second;
+      return std::nullopt;
+    }
+
+    void
+    IntroSetStore::Expire(llarp_time_t now)
+    {
+      for (auto bucket = m_Expiry.begin(); bucket != m_Expiry.end() and bucket->first <= now;)
+      {
+        auto& locations = bucket->second;
+        const auto due = [this, now, start = bucket->first](const Key_t& location) {
+          auto itr = m_IntroSets.find(location);
+          // gone, or a newer copy stored since is in a later bucket
+          if (itr == m_IntroSets.end() or ExpiryBucket(ExpiresAt(itr->second)) != start)
+            return true;
+          if (not itr->second.IsExpired(now))
+            return false;
+          m_IntroSets.erase(itr);
+          return true;
+        };
+        locations.erase(
+            std::remove_if(locations.begin(), locations.end(), due), locations.end());
+        // only the bucket now falls in can still hold intro sets that aren't due
+        if (locations.empty())
+          bucket = m_Expiry.erase(bucket);
+        else
+          ++bucket;
+      }
+    }
+
+    IntroSetFilter
+    IntroSetStore::Summary() const
+    {
+      IntroSetFilter filter{m_IntroSets.size()};
+      for (const auto& [location, introset] : m_IntroSets)
+        filter.Add(introset);
+      return filter;
+    }
+
+    std::vector<service::EncryptedIntroSet>
+    IntroSetStore::Missing(
+        const IntroSetFilter& filter, std::function<bool(const Key_t&)> want, size_t maxBytes) const
+    {
+      std::vector<service::EncryptedIntroSet> missing;
+      size_t bytes = 0;
+      for (const auto& [location, introset] : m_IntroSets)
+      {
+        if (filter.MaybeContains(introset) or not want(location))
+          continue;
+        bytes += EncodedSize(introset);
+        if (bytes > maxBytes)
+          break;
+        missing.push_back(introset);
+      }
+      return missing;
+    }
+
+    util::StatusObject
+    IntroSetStore::ExtractStatus() const
+    {
+      util::StatusObject obj{};
+      for (const auto& [location, introset] : m_IntroSets)
+        obj[location.ToString()] = introset.ExtractStatus();
+      return obj;
+    }
+  }  // namespace dht
+}  // namespace llarp
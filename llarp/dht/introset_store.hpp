@@ -0,0 +1,140 @@
+#pragma once
+
+#include "key.hpp"
+#include <llarp/service/intro_set.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// bloom filter summary of the intro sets a relay holds.  elements are keyed by location and
+    /// signing time, so a newer copy of an intro set shows up as missing.  relays send these to
+    /// their dht neighbors, who send back what is missing, without either side listing what it
+    /// has.
+    struct IntroSetFilter
+    {
+      /// hashes per element
+      static constexpr uint64_t NumHashes = 7;
+      /// bits per element, about a 1% false positive rate with NumHashes
+      static constexpr size_t BitsPerElement = 10;
+      static constexpr size_t MinBytes = 64;
+      /// keeps the filter well inside a link message
+      static constexpr size_t MaxBytes = 2048;
+
+      IntroSetFilter() = default;
+
+      /// an empty filter sized for numElements, with a random salt so collisions differ between
+      /// rounds
+      explicit IntroSetFilter(size_t numElements);
+
+      void
+      Add(const service::EncryptedIntroSet& introset);
+
+      bool
+      MaybeContains(const service::EncryptedIntroSet& introset) const;
+
+      /// false if this was decoded from something that can't be a filter of ours
+      bool
+      IsValid() const;
+
+      std::string bits;
+      uint64_t salt = 0;
+
+     private:
+      template <typename Visit>
+      void
+      ForEachBit(const service::EncryptedIntroSet& introset, Visit&& visit) const;
+    };
+
+    /// which relays should store the intro set at a location: the `redundancy` relays closest to
+    /// it by xor distance, as NodeDB::FindManyClosestTo picks them.  built once from a snapshot of
+    /// the relays we know so that checking many locations doesn't sort the nodedb for each one.
+    class StorageCandidates
+    {
+     public:
+      StorageCandidates(std::vector<Key_t> relays, size_t redundancy);
+
+      /// the relays that should store the intro set at location, in no particular order
+      std::vector<Key_t>
+      Closest(const Key_t& location) const;
+
+      bool
+      IsCandidate(const Key_t& location, const Key_t& relay) const;
+
+     private:
+      using Iter_t = std::vector<Key_t>::const_iterator;
+
+      void
+      Collect(
+          Iter_t begin,
+          Iter_t end,
+          size_t bit,
+          const Key_t& location,
+          std::vector<Key_t>& closest) const;
+
+      /// sorted, so the relays sharing any prefix are a contiguous range
+      std::vector<Key_t> m_Relays;
+      size_t m_Redundancy;
+    };
+
+    /// the intro sets a relay stores, hashed by location.  expiry is bucketed by time so
+    /// expiring intro sets only looks at the ones that are due.
+    class IntroSetStore
+    {
+     public:
+      /// granularity of the expiry buckets
+      static constexpr auto ExpiryBucketWidth = 10s;
+
+      /// store introset unless we already hold the same or a newer one for its location; returns
+      /// true if it was stored
+      bool
+      Put(const service::EncryptedIntroSet& introset);
+
+      std::optional<service::EncryptedIntroSet>
+      Get(const Key_t& location) const;
+
+      /// drop the intro sets that expired by now
+      void
+      Expire(llarp_time_t now);
+
+      /// a filter of everything we hold
+      IntroSetFilter
+      Summary() const;
+
+      /// intro sets that filter doesn't have and want(location) accepts, up to maxBytes of them
+      /// bencoded
+      std::vector<service::EncryptedIntroSet>
+      Missing(
+          const IntroSetFilter& filter,
+          std::function<bool(const Key_t&)> want,
+          size_t maxBytes) const;
+
+      size_t
+      size() const
+      {
+        return m_IntroSets.size();
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      std::unordered_map<
+          Key_t,
+          service::EncryptedIntroSet,
+          std::hash<AlignedBuffer<Key_t::SIZE>>>
+          m_IntroSets;
+      /// start of each expiry bucket -> locations whose intro sets expire within it
+      std::map<llarp_time_t, std::vector<Key_t>> m_Expiry;
+    };
+  }  // namespace dht
+}  // namespace llarp
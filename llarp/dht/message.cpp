@@ -9,6 +9,7 @@
 #include <llarp/dht/messages/pubintro.hpp>
 #include <llarp/dht/messages/findname.hpp>
 #include <llarp/dht/messages/gotname.hpp>
+#include <llarp/dht/messages/syncintro.hpp>
 
 namespace llarp
 {
@@ -77,6 +78,11 @@ namespace llarp
                 msg = std::make_unique<GotIntroMessage>(From);
                 break;
               }
+            case 'Y':
+              // relays sync with each other directly, never over a path
+              if (not relayed)
+                msg = std::make_unique<SyncIntroSetsMessage>(From);
+              break;
             default:
               llarp::LogWarn("unknown dht message type: ", (char)*strbuf.base);
               // bad msg type
@@ -107,7 +107,7 @@ namespace llarp
         {
           llarp::LogInfo("we are peer ", index, " so storing instead of propagating");
 
-          dht.services()->PutNode(introset);
+          dht.services()->Put(introset);
           replies.emplace_back(new GotIntroMessage({introset}, txID));
         }
         else
@@ -160,7 +160,7 @@ namespace llarp
               txID,
               " and we are candidate ",
               candidateNumber);
-          dht.services()->PutNode(introset);
+          dht.services()->Put(introset);
           replies.emplace_back(new GotIntroMessage({introset}, txID));
         }
         else
@@ -0,0 +1,142 @@
+#include "syncintro.hpp"
+
+#include <llarp/dht/context.hpp>
+#include <llarp/router/abstractrouter.hpp>
+#include <llarp/router/i_rc_lookup_handler.hpp>
+#include <llarp/nodedb.hpp>
+
+#include <utility>
+
+namespace llarp
+{
+  namespace dht
+  {
+    SyncIntroSetsMessage::SyncIntroSetsMessage(IntroSetFilter f, uint64_t tx)
+        : IMessage({}), filter(std::move(f)), txid(tx)
+    {}
+
+    SyncIntroSetsMessage::SyncIntroSetsMessage(
+        std::vector<service::EncryptedIntroSet> results, uint64_t tx)
+        : IMessage({}), introsets(std::move(results)), txid(tx)
+    {}
+
+    bool
+    SyncIntroSetsMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val)
+    {
+      if (key.startswith("B"))
+      {
+        llarp_buffer_t strbuf;
+        if (not bencode_read_string(val, &strbuf))
+          return false;
+        if (not filter)
+          filter.emplace();
+        filter->bits.assign(reinterpret_cast<const char*>(strbuf.base), strbuf.sz);
+        return true;
+      }
+      if (key.startswith("I"))
+        return BEncodeReadList(introsets, val);
+      if (key.startswith("S"))
+      {
+        if (not filter)
+          filter.emplace();
+        return bencode_read_integer(val, &filter->salt);
+      }
+      bool read = false;
+      if (!BEncodeMaybeReadDictInt("T", txid, read, key, val))
+        return false;
+      if (!BEncodeMaybeReadDictInt("V", version, read, key, val))
+        return false;
+      return read;
+    }
+
+    bool
+    SyncIntroSetsMessage::BEncode(llarp_buffer_t* buf) const
+    {
+      if (!bencode_start_dict(buf))
+        return false;
+      if (!BEncodeWriteDictMsgType(buf, "A", "Y"))
+        return false;
+      if (filter)
+      {
+        if (!BEncodeWriteDictString("B", filter->bits, buf))
+          return false;
+      }
+      if (!BEncodeWriteDictList("I", introsets, buf))
+        return false;
+      if (filter)
+      {
+        if (!BEncodeWriteDictInt("S", filter->salt, buf))
+          return false;
+      }
+      if (!BEncodeWriteDictInt("T", txid, buf))
+        return false;
+      if (!BEncodeWriteDictInt("V", llarp::constants::proto_version, buf))
+        return false;
+      return bencode_end(buf);
+    }
+
+    bool
+    SyncIntroSetsMessage::HandleMessage(
+        llarp_dht_context* ctx, std::vector<std::unique_ptr<IMessage>>& replies) const
+    {
+      auto& dht = *ctx->impl;
+      auto* router = dht.GetRouter();
+      // only relays store intro sets, and only from their neighbors directly
+      if (not pathID.IsZero() or not router->IsMasterNode())
+        return false;
+      // checked before doing any work for the sender
+      if (not router->rcLookupHandler().PathIsAllowed(From.as_array()))
+      {
+        LogWarn("dropping intro set sync from non master node ", From);
+        return false;
+      }
+
+      // one pass over the nodedb for the whole message rather than a closest set per intro set
+      std::vector<Key_t> relays;
+      router->nodedb()->VisitAll([&relays](const auto& rc) { relays.emplace_back(rc.pubkey); });
+      const StorageCandidates candidates{std::move(relays), IntroSetStorageRedundancy};
+      return HandleSync(*dht.services(), candidates, dht.OurKey(), dht.Now(), replies);
+    }
+
+    bool
+    SyncIntroSetsMessage::HandleSync(
+        IntroSetStore& store,
+        const StorageCandidates& candidates,
+        const Key_t& us,
+        llarp_time_t now,
+        std::vector<IMessage::Ptr_t>& replies) const
+    {
+      size_t stored = 0;
+      for (const auto& introset : introsets)
+      {
+        if (not introset.Verify(now))
+        {
+          LogWarn("invalid introset in intro set sync from ", From);
+          return false;
+        }
+        const Key_t location{introset.derivedSigningKey.as_array()};
+        if (candidates.IsCandidate(location, us) and store.Put(introset))
+          ++stored;
+      }
+      if (stored)
+        LogDebug("stored ", stored, " intro sets synced from ", From);
+
+      if (not filter)
+        return true;
+      if (not filter->IsValid())
+      {
+        LogWarn("invalid intro set filter from ", From);
+        return false;
+      }
+      auto missing = store.Missing(
+          *filter,
+          [&candidates, from = From](const Key_t& location) {
+            return candidates.IsCandidate(location, from);
+          },
+          MaxReplyBytes);
+      if (not missing.empty())
+        replies.emplace_back(new SyncIntroSetsMessage(std::move(missing), txid));
+      return true;
+    }
+  }  // namespace dht
+}  // namespace llarp
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <llarp/dht/introset_store.hpp>
+#include <llarp/dht/message.hpp>
+#include <llarp/service/intro_set.hpp>
+
+#include <optional>
+#include <vector>
+
+namespace llarp
+{
+  namespace dht
+  {
+    /// relays periodically send a filter of the intro sets they hold to their dht neighbors, who
+    /// reply with the intro sets the sender should be storing but doesn't have.  a reply carries
+    /// intro sets and no filter.
+    struct SyncIntroSetsMessage final : public IMessage
+    {
+      /// most bytes of intro sets in one reply, leaving room in a link message; the rest go in
+      /// the next round
+      static constexpr size_t MaxReplyBytes = 6 * 1024;
+
+      explicit SyncIntroSetsMessage(const Key_t& from) : IMessage(from)
+      {}
+
+      /// request
+      SyncIntroSetsMessage(IntroSetFilter filter, uint64_t txid);
+
+      /// reply
+      SyncIntroSetsMessage(std::vector<service::EncryptedIntroSet> introsets, uint64_t txid);
+
+      bool
+      BEncode(llarp_buffer_t* buf) const override;
+
+      bool
+      DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* val) override;
+
+      bool
+      HandleMessage(llarp_dht_context* ctx, std::vector<IMessage::Ptr_t>& replies) const override;
+
+      /// stores the intro sets that we, as us, are a candidate for and replies with the ones the
+      /// sender is a candidate for but its filter doesn't have.  the part of handling that needs
+      /// no router; returns false if the message is invalid.
+      bool
+      HandleSync(
+          IntroSetStore& store,
+          const StorageCandidates& candidates,
+          const Key_t& us,
+          llarp_time_t now,
+          std::vector<IMessage::Ptr_t>& replies) const;
+
+      std::optional<IntroSetFilter> filter;
+      std::vector<service::EncryptedIntroSet> introsets;
+      uint64_t txid = 0;
+    };
+  }  // namespace dht
+}  // namespace llarp
@@ -34,34 +34,5 @@ namespace llarp
         return rc.last_updated < other.rc.last_updated;
       }
     };
-
-    struct IMNode
-    {
-      service::EncryptedIntroSet introset;
-
-      Key_t ID;
-
-      IMNode()
-      {
-        ID.Zero();
-      }
-
-      IMNode(service::EncryptedIntroSet other) : introset(std::move(other))
-      {
-        ID = Key_t(introset.derivedSigningKey.as_array());
-      }
-
-      util::StatusObject
-      ExtractStatus() const
-      {
-        return introset.ExtractStatus();
-      }
-
-      bool
-      operator<(const IMNode& other) const
-      {
-        return introset.signedAt < other.introset.signedAt;
-      }
-    };
   }  // namespace dht
 }  // namespace llarp
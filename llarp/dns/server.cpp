@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <utility>
 #include <llarp/ev/udp_handle.hpp>
+#include <llarp/util/metrics.hpp>
 #include <optional>
 #include <memory>
 #include <unbound.h>
@@ -21,6 +22,31 @@ namespace llarp::dns
 {
   static auto logcat = log::Cat("dns");
 
+  namespace
+  {
+    /// dns queries seen by our listeners, for the metrics registry
+    struct QueryMetrics
+    {
+      metrics::Counter& handled;
+      metrics::Counter& unhandled;
+      metrics::Counter& invalid;
+    };
+
+    QueryMetrics&
+    Metrics()
+    {
+      auto& reg = metrics::Registry::Global();
+      constexpr auto name = "belnet_dns_queries_total";
+      constexpr auto help = "dns queries received, by outcome";
+      static QueryMetrics m{
+          reg.GetCounter(name, help, {{"result", "handled"}}),
+          reg.GetCounter(name, help, {{"result", "unhandled"}}),
+          reg.GetCounter(name, help, {{"result", "invalid"}}),
+      };
+      return m;
+    }
+  }  // namespace
+
   void
   QueryJob_Base::Cancel()
   {
@@ -723,6 +749,7 @@ namespace llarp::dns
     if (not maybe)
     {
       log::warning(logcat, "invalid dns message format from {} to dns listener on {}", from, to);
+      Metrics().invalid.Inc();
       return false;
     }
 
@@ -741,6 +768,7 @@ namespace llarp::dns
         msg.AddNXReply();
         // press F to pay respects and send it back where it came from
         ptr->SendTo(from, to, msg.ToBuffer());
+        Metrics().handled.Inc();
         return true;
       }
     }
@@ -752,9 +780,13 @@ namespace llarp::dns
         log::debug(
             logcat, "check resolver {} for dns from {} to {}", res_ptr->ResolverName(), from, to);
         if (res_ptr->MaybeHookDNS(ptr, msg, to, from))
+        {
+          Metrics().handled.Inc();
           return true;
+        }
       }
     }
+    Metrics().unhandled.Inc();
     return false;
   }
 
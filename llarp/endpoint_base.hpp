@@ -119,6 +119,10 @@ namespace llarp
     virtual std::optional<service::ConvoTag>
     GetBestConvoTagFor(AddressVariant_t addr) const = 0;
 
+    /// return true if the remote on the other end of tag told us it supports protocol t
+    virtual bool
+    RemoteSupports(service::ConvoTag tag, service::ProtocolType t) const = 0;
+
     virtual bool
     EnsurePathTo(
         AddressVariant_t addr,
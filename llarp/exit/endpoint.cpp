@@ -4,11 +4,36 @@
 #include <llarp/path/path_context.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/quic/tunnel.hpp>
+#include <llarp/util/metrics.hpp>
 
 namespace llarp
 {
   namespace exit
   {
+    namespace
+    {
+      /// exit traffic summed over all exit sessions, for the metrics registry
+      metrics::Counter&
+      UpstreamBytes()
+      {
+        static auto& counter = metrics::Registry::Global().GetCounter(
+            "belnet_exit_bytes_total",
+            "bytes forwarded by exit sessions",
+            {{"direction", "upstream"}});
+        return counter;
+      }
+
+      metrics::Counter&
+      DownstreamBytes()
+      {
+        static auto& counter = metrics::Registry::Global().GetCounter(
+            "belnet_exit_bytes_total",
+            "bytes forwarded by exit sessions",
+            {{"direction", "downstream"}});
+        return counter;
+      }
+    }  // namespace
+
     Endpoint::Endpoint(
         const llarp::PubKey& remoteIdent,
         const llarp::path::HopHandler_ptr& beginPath,
@@ -119,6 +144,7 @@ namespace llarp
         if (not quic)
           return false;
         m_TxRate += buf.size();
+        UpstreamBytes().Inc(buf.size());
         quic->receive_packet(tag, std::move(buf));
         m_LastActive = m_Parent->Now();
         return true;
@@ -154,6 +180,7 @@ namespace llarp
         return false;
       }
       m_TxRate += pkt.size();
+      UpstreamBytes().Inc(pkt.size());
       m_UpstreamQueue.emplace(std::move(pkt), counter);
       m_LastActive = m_Parent->Now();
       return true;
@@ -227,6 +254,7 @@ namespace llarp
             if (path->SendRoutingMessage(msg, m_Parent->GetRouter()))
             {
               m_RxRate += msg.Size();
+              DownstreamBytes().Inc(msg.Size());
               sent = true;
             }
             queue.pop_front();
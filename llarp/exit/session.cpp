@@ -73,13 +73,13 @@ namespace llarp
       m_MnodeBlacklist.insert(std::move(mnode));
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     BaseSession::GetHopsForBuild()
     {
       if (numHops == 1)
       {
         if (auto maybe = m_router->nodedb()->Get(m_ExitRouter))
-          return std::vector<RouterContact>{*maybe};
+          return std::vector<RouterContact_ptr>{std::move(maybe)};
         return std::nullopt;
       }
       else
@@ -116,6 +116,16 @@ namespace llarp
         llarp::LogError("failed to send exit request");
     }
 
+    bool
+    BaseSession::AdoptSparePath(path::Path_ptr p)
+    {
+      if (not p or p->Endpoint() != m_ExitRouter)
+        return false;
+      LogInfo(Name(), " starting on spare path ", p->ShortName());
+      // HandlePathBuilt asks for the exit on it like on a path we built
+      return AdoptPath(std::move(p));
+    }
+
     void
     BaseSession::AddReadyHook(SessionReadyFunc func)
     {
@@ -201,6 +211,8 @@ namespace llarp
         service::ProtocolType t)
     {
       const service::ConvoTag tag{path->RXID().as_array()};
+      ++m_MessagesRecv;
+      m_LastRecv = m_router->Now();
 
       if (t == service::ProtocolType::QUIC)
       {
@@ -239,6 +251,8 @@ namespace llarp
       // queue overflow
       if (queue.size() >= MaxUpstreamQueueLength)
         return false;
+      ++m_MessagesSent;
+      m_LastSend = m_router->Now();
       if (queue.size() == 0)
       {
         queue.emplace_back();
@@ -286,7 +300,7 @@ namespace llarp
     BaseSession::FlushUpstream()
     {
       auto now = m_router->Now();
-      auto path = PickEstablishedPath(llarp::path::ePathRoleExit);
+      auto path = PickWeightedEstablishedPath(llarp::path::ePathRoleExit);
       if (path)
       {
         for (auto& [i, queue] : m_Upstream)
@@ -311,7 +325,7 @@ namespace llarp
         if (numHops == 1)
         {
           auto r = m_router;
-          if (const auto maybe = r->nodedb()->Get(m_ExitRouter); maybe.has_value())
+          if (const auto maybe = r->nodedb()->Get(m_ExitRouter))
             r->TryConnectAsync(*maybe, 5);
           else
             r->LookupRouter(m_ExitRouter, [r](const std::vector<RouterContact>& results) {
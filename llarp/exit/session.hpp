@@ -80,7 +80,7 @@ namespace llarp
       bool
       CheckPathDead(path::Path_ptr p, llarp_time_t dlt);
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
       bool
@@ -89,6 +89,11 @@ namespace llarp
       void
       HandlePathBuilt(llarp::path::Path_ptr p) override;
 
+      /// start on a prebuilt path ending at our exit router instead of waiting on a build,
+      /// returns false if p ends anywhere else
+      bool
+      AdoptSparePath(path::Path_ptr p);
+
       bool
       QueueUpstreamTraffic(
           llarp::net::IPPacket pkt, const size_t packSize, service::ProtocolType t);
@@ -131,6 +136,32 @@ namespace llarp
       bool
       IsExpired(llarp_time_t now) const;
 
+      /// number of routing messages we sent on this session
+      uint64_t
+      MessagesSent() const
+      {
+        return m_MessagesSent;
+      }
+
+      /// number of routing messages we got on this session
+      uint64_t
+      MessagesRecv() const
+      {
+        return m_MessagesRecv;
+      }
+
+      llarp_time_t
+      LastSendAt() const
+      {
+        return m_LastSend;
+      }
+
+      llarp_time_t
+      LastRecvAt() const
+      {
+        return m_LastRecv;
+      }
+
       bool
       LoadIdentityFromFile(const char* fname);
 
@@ -184,6 +215,10 @@ namespace llarp
 
       uint64_t m_Counter;
       llarp_time_t m_LastUse;
+      uint64_t m_MessagesSent = 0;
+      uint64_t m_MessagesRecv = 0;
+      llarp_time_t m_LastSend = 0s;
+      llarp_time_t m_LastRecv = 0s;
 
       std::vector<SessionReadyFunc> m_PendingCallbacks;
       const bool m_BundleRC;
@@ -40,6 +40,13 @@ namespace llarp
       std::optional<service::ConvoTag>
       GetBestConvoTagFor(AddressVariant_t addr) const override;
 
+      bool
+      RemoteSupports(service::ConvoTag, service::ProtocolType) const override
+      {
+        // we have no introsets for our clients
+        return false;
+      }
+
       bool
       EnsurePathTo(
           AddressVariant_t addr,
@@ -97,18 +97,31 @@ namespace llarp::iwp
     m_Wakeup->Trigger();
   }
 
+  void
+  LinkLayer::WakeupPlaintext(std::weak_ptr<ILinkSession> session)
+  {
+    {
+      std::lock_guard lock{m_PlaintextReadyMutex};
+      m_PlaintextReady.emplace_back(std::move(session));
+    }
+    m_Wakeup->Trigger();
+  }
+
   void
   LinkLayer::HandleWakeupPlaintext()
   {
-    // Copy bare pointers out first because HandlePlaintext can end up removing themselves from the
-    // structures.
-    m_WakingUp.clear();  // Reused to minimize allocations.
-    for (const auto& [router_id, session] : m_AuthedLinks)
-      m_WakingUp.push_back(session.get());
-    for (const auto& [addr, session] : m_Pending)
-      m_WakingUp.push_back(session.get());
-    for (auto* session : m_WakingUp)
-      session->HandlePlaintext();
+    // only the sessions that got plaintext since the last wakeup; m_WakingUp is reused to
+    // minimize allocations
+    {
+      std::lock_guard lock{m_PlaintextReadyMutex};
+      m_WakingUp.swap(m_PlaintextReady);
+    }
+    for (const auto& weak : m_WakingUp)
+    {
+      if (auto session = weak.lock())
+        session->HandlePlaintext();
+    }
+    m_WakingUp.clear();
     PumpDone();
   }
 
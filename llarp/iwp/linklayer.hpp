@@ -8,6 +8,8 @@
 #include <llarp/config/key_manager.hpp>
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <llarp/ev/ev.hpp>
 
@@ -47,6 +49,11 @@ namespace llarp::iwp
     void
     WakeupPlaintext();
 
+    /// queue a session that has decrypted packets to handle and wake up the logic thread to
+    /// handle them; called from the crypto workers
+    void
+    WakeupPlaintext(std::weak_ptr<ILinkSession> session);
+
     std::string
     PrintableName() const;
 
@@ -55,7 +62,9 @@ namespace llarp::iwp
     HandleWakeupPlaintext();
 
     const std::shared_ptr<EventLoopWakeup> m_Wakeup;
-    std::vector<ILinkSession*> m_WakingUp;
+    std::mutex m_PlaintextReadyMutex;
+    std::vector<std::weak_ptr<ILinkSession>> m_PlaintextReady;
+    std::vector<std::weak_ptr<ILinkSession>> m_WakingUp;
     const bool m_Inbound;
   };
 
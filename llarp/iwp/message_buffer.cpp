@@ -11,7 +11,8 @@ namespace llarp
         ILinkSession::Message_t msg,
         llarp_time_t now,
         ILinkSession::CompletionHandler handler,
-        uint16_t priority)
+        uint16_t priority,
+        bool digest)
         : m_Data{std::move(msg)}
         , m_MsgID{msgid}
         , m_Completed{handler}
@@ -19,16 +20,20 @@ namespace llarp
         , m_StartedAt{now}
         , m_ResendPriority{priority}
     {
-      const llarp_buffer_t buf(m_Data);
-      CryptoManager::instance()->shorthash(m_Digest, buf);
+      // sessions protected with aead don't check the digest, it goes out zeroed
+      if (digest)
+      {
+        const llarp_buffer_t buf(m_Data);
+        CryptoManager::instance()->shorthash(m_Digest, buf);
+      }
       m_Acks.set(0);
     }
 
     ILinkSession::Packet_t
-    OutboundMessage::XMIT() const
+    OutboundMessage::XMIT(PacketPool& pool) const
     {
       size_t extra = std::min(m_Data.size(), FragmentSize);
-      auto xmit = CreatePacket(Command::eXMIT, 10 + 32 + extra, 0, 0);
+      auto xmit = CreatePacket(pool, Command::eXMIT, 10 + 32 + extra, 0, 0);
       oxenc::write_host_as_big(
           static_cast<uint16_t>(m_Data.size()), xmit.data() + CommandOverhead + PacketOverhead);
       oxenc::write_host_as_big(m_MsgID, xmit.data() + 2 + CommandOverhead + PacketOverhead);
@@ -62,7 +67,7 @@ namespace llarp
 
     void
     OutboundMessage::FlushUnAcked(
-        std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now)
+        PacketPool& pool, std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now)
     {
       /// overhead for a data packet in plaintext
       static constexpr size_t Overhead = 10;
@@ -73,7 +78,7 @@ namespace llarp
         if (not m_Acks[idx / FragmentSize])
         {
           const size_t fragsz = idx + FragmentSize < datasz ? FragmentSize : datasz - idx;
-          auto frag = CreatePacket(Command::eDATA, fragsz + Overhead, 0, 0);
+          auto frag = CreatePacket(pool, Command::eDATA, fragsz + Overhead, 0, 0);
           oxenc::write_host_as_big(idx, frag.data() + 2 + PacketOverhead);
           oxenc::write_host_as_big(m_MsgID, frag.data() + 4 + PacketOverhead);
           std::copy(
@@ -136,9 +141,9 @@ namespace llarp
     }
 
     ILinkSession::Packet_t
-    InboundMessage::ACKS() const
+    InboundMessage::ACKS(PacketPool& pool) const
     {
-      auto acks = CreatePacket(Command::eACKS, 9);
+      auto acks = CreatePacket(pool, Command::eACKS, 9);
       oxenc::write_host_as_big(m_MsgID, acks.data() + CommandOverhead + PacketOverhead);
       acks[PacketOverhead + 10] = AcksBitmask();
       return acks;
@@ -175,9 +180,10 @@ namespace llarp
     }
 
     void
-    InboundMessage::SendACKS(std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now)
+    InboundMessage::SendACKS(
+        PacketPool& pool, std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now)
     {
-      sendpkt(ACKS());
+      sendpkt(ACKS(pool));
       m_LastACKSent = now;
     }
 
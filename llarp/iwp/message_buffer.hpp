@@ -5,6 +5,7 @@
 #include <llarp/util/aligned.hpp>
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/types.hpp>
+#include "packet_pool.hpp"
 
 namespace llarp
 {
@@ -41,7 +42,8 @@ namespace llarp
           ILinkSession::Message_t data,
           llarp_time_t now,
           ILinkSession::CompletionHandler handler,
-          uint16_t priority);
+          uint16_t priority,
+          bool digest);
 
       ILinkSession::Message_t m_Data;
       uint64_t m_MsgID = 0;
@@ -62,13 +64,16 @@ namespace llarp
       }
 
       ILinkSession::Packet_t
-      XMIT() const;
+      XMIT(PacketPool& pool) const;
 
       void
       Ack(byte_t bitmask);
 
       void
-      FlushUnAcked(std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now);
+      FlushUnAcked(
+          PacketPool& pool,
+          std::function<void(ILinkSession::Packet_t)> sendpkt,
+          llarp_time_t now);
 
       bool
       ShouldFlush(llarp_time_t now) const;
@@ -117,10 +122,13 @@ namespace llarp
       ShouldSendACKS(llarp_time_t now) const;
 
       void
-      SendACKS(std::function<void(ILinkSession::Packet_t)> sendpkt, llarp_time_t now);
+      SendACKS(
+          PacketPool& pool,
+          std::function<void(ILinkSession::Packet_t)> sendpkt,
+          llarp_time_t now);
 
       ILinkSession::Packet_t
-      ACKS() const;
+      ACKS(PacketPool& pool) const;
     };
 
   }  // namespace iwp
@@ -0,0 +1,78 @@
+#include "packet_pool.hpp"
+
+#include <llarp/util/metrics.hpp>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    namespace
+    {
+      metrics::Gauge&
+      PooledBytesGauge()
+      {
+        static auto& gauge = metrics::Registry::Global().GetGauge(
+            "belnet_iwp_pooled_packet_bytes", "bytes held by iwp session packet pools");
+        return gauge;
+      }
+    }  // namespace
+
+    PacketPool::~PacketPool()
+    {
+      PooledBytesGauge().Add(-static_cast<int64_t>(Bytes()));
+    }
+
+    PacketPool::Packet_t
+    PacketPool::Get(size_t sz)
+    {
+      if (m_Free.empty())
+      {
+        std::lock_guard lock{m_ReturnedMutex};
+        m_Free.swap(m_Returned);
+      }
+      if (m_Free.empty())
+        return Packet_t(sz);
+      auto pkt = std::move(m_Free.back());
+      m_Free.pop_back();
+      m_Pooled.fetch_sub(1, std::memory_order_relaxed);
+      m_PooledBytes.fetch_sub(pkt.capacity(), std::memory_order_relaxed);
+      PooledBytesGauge().Add(-static_cast<int64_t>(pkt.capacity()));
+      // zeroed like a fresh buffer, without giving up the capacity
+      pkt.assign(sz, 0);
+      return pkt;
+    }
+
+    PacketPool::Batch_t
+    PacketPool::GetBatch()
+    {
+      std::lock_guard lock{m_ReturnedMutex};
+      if (m_SpareBatches.empty())
+        return {};
+      auto batch = std::move(m_SpareBatches.back());
+      m_SpareBatches.pop_back();
+      return batch;
+    }
+
+    void
+    PacketPool::Recycle(Batch_t batch)
+    {
+      size_t bytes = 0;
+      std::lock_guard lock{m_ReturnedMutex};
+      for (auto& pkt : batch)
+      {
+        if (m_Pooled.load(std::memory_order_relaxed) >= MaxPackets)
+          break;
+        if (pkt.capacity() == 0)
+          continue;
+        bytes += pkt.capacity();
+        m_Returned.emplace_back(std::move(pkt));
+        m_Pooled.fetch_add(1, std::memory_order_relaxed);
+      }
+      m_PooledBytes.fetch_add(bytes, std::memory_order_relaxed);
+      PooledBytesGauge().Add(static_cast<int64_t>(bytes));
+      batch.clear();
+      if (m_SpareBatches.size() < MaxBatches)
+        m_SpareBatches.emplace_back(std::move(batch));
+    }
+  }  // namespace iwp
+}  // namespace llarp
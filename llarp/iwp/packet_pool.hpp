@@ -0,0 +1,76 @@
+#pragma once
+
+#include <llarp/link/session.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace llarp
+{
+  namespace iwp
+  {
+    /// recycles a session's packet buffers and crypto batches between the logic thread and the
+    /// crypto workers.  the logic thread takes buffers from its own free list without locking;
+    /// workers hand sent batches back under a lock and the logic thread swaps the returned
+    /// buffers in whenever its free list runs dry.  at most MaxPackets buffers and MaxBatches
+    /// batches are kept, so a session's idle buffer memory is bounded.
+    class PacketPool
+    {
+     public:
+      using Packet_t = ILinkSession::Packet_t;
+      using Batch_t = std::vector<Packet_t>;
+
+      /// most buffers a session keeps around
+      static constexpr size_t MaxPackets = 32;
+      /// most empty batches a session keeps around, one each for encrypt and decrypt
+      static constexpr size_t MaxBatches = 2;
+
+      PacketPool() = default;
+      PacketPool(const PacketPool&) = delete;
+      PacketPool&
+      operator=(const PacketPool&) = delete;
+
+      ~PacketPool();
+
+      /// a zeroed buffer of sz bytes; logic thread only
+      Packet_t
+      Get(size_t sz);
+
+      /// an empty batch to queue packets into, with the capacity of an earlier batch if there
+      /// is one; logic thread only
+      Batch_t
+      GetBatch();
+
+      /// take back a batch that was sent or handled, its buffers and the batch itself; buffers
+      /// that were moved out are skipped.  any thread
+      void
+      Recycle(Batch_t batch);
+
+      /// how many buffers are pooled
+      size_t
+      Size() const
+      {
+        return m_Pooled.load(std::memory_order_relaxed);
+      }
+
+      /// how many bytes the pooled buffers hold
+      size_t
+      Bytes() const
+      {
+        return m_PooledBytes.load(std::memory_order_relaxed);
+      }
+
+     private:
+      /// logic thread side
+      Batch_t m_Free;
+
+      std::mutex m_ReturnedMutex;
+      Batch_t m_Returned;
+      std::vector<Batch_t> m_SpareBatches;
+
+      std::atomic<size_t> m_Pooled{0};
+      std::atomic<size_t> m_PooledBytes{0};
+    };
+  }  // namespace iwp
+}  // namespace llarp
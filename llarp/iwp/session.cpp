@@ -3,32 +3,143 @@
 #include <llarp/messages/link_intro.hpp>
 #include <llarp/messages/discard.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/router/abstractrouter.hpp>
 
 #include <queue>
+#include <utility>
 
 namespace llarp
 {
   namespace iwp
   {
+    namespace
+    {
+      size_t
+      PacketPad(size_t minpad, size_t variance)
+      {
+        return minpad > 0 ? minpad + (variance > 0 ? randint() % variance : 0) : 0;
+      }
+
+      void
+      FillPacket(ILinkSession::Packet_t& pkt, Command cmd, size_t plainsize, size_t pad)
+      {
+        // randomize pad
+        if (pad)
+        {
+          CryptoManager::instance()->randbytes(
+              pkt.data() + PacketOverhead + CommandOverhead + plainsize, pad);
+        }
+        // randomize nounce
+        CryptoManager::instance()->randbytes(pkt.data() + HMACSIZE, TUNNONCESIZE);
+        pkt[PacketOverhead] = llarp::constants::proto_version;
+        pkt[PacketOverhead + 1] = cmd;
+      }
+    }  // namespace
+
     ILinkSession::Packet_t
     CreatePacket(Command cmd, size_t plainsize, size_t minpad, size_t variance)
     {
-      const size_t pad = minpad > 0 ? minpad + (variance > 0 ? randint() % variance : 0) : 0;
+      const size_t pad = PacketPad(minpad, variance);
       ILinkSession::Packet_t pkt(PacketOverhead + plainsize + pad + CommandOverhead);
-      // randomize pad
-      if (pad)
-      {
-        CryptoManager::instance()->randbytes(
-            pkt.data() + PacketOverhead + CommandOverhead + plainsize, pad);
-      }
-      // randomize nounce
-      CryptoManager::instance()->randbytes(pkt.data() + HMACSIZE, TUNNONCESIZE);
-      pkt[PacketOverhead] = llarp::constants::proto_version;
-      pkt[PacketOverhead + 1] = cmd;
+      FillPacket(pkt, cmd, plainsize, pad);
       return pkt;
     }
 
+    ILinkSession::Packet_t
+    CreatePacket(PacketPool& pool, Command cmd, size_t plainsize, size_t minpad, size_t variance)
+    {
+      const size_t pad = PacketPad(minpad, variance);
+      auto pkt = pool.Get(PacketOverhead + plainsize + pad + CommandOverhead);
+      FillPacket(pkt, cmd, plainsize, pad);
+      return pkt;
+    }
+
+    byte_t
+    AgreedIntroFlags(const ILinkSession::Packet_t& pkt, size_t offset)
+    {
+      return pkt.size() > offset ? pkt[offset] & OurIntroFlags : 0;
+    }
+
+    void
+    EncryptPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      llarp_buffer_t pktbuf{pkt};
+      const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
+      pktbuf.base += PacketOverhead;
+      pktbuf.cur = pktbuf.base;
+      pktbuf.sz -= PacketOverhead;
+      CryptoManager::instance()->xchacha20(pktbuf, key, nonce_ptr);
+      pktbuf.base = pkt.data() + HMACSIZE;
+      pktbuf.sz = pkt.size() - HMACSIZE;
+      CryptoManager::instance()->hmac(pkt.data(), pktbuf, key);
+    }
+
+    bool
+    DecryptPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      if (pkt.size() <= PacketOverhead)
+        return false;
+      llarp_buffer_t curbuf{pkt.data() + ShortHash::SIZE, pkt.size() - ShortHash::SIZE};
+      ShortHash H;
+      if (not CryptoManager::instance()->hmac(H.data(), curbuf, key))
+        return false;
+      if (H != ShortHash{pkt.data()})
+        return false;
+      const TunnelNonce N{curbuf.base};
+      curbuf.base += TunnelNonce::SIZE;
+      curbuf.sz -= TunnelNonce::SIZE;
+      return CryptoManager::instance()->xchacha20(curbuf, key, N);
+    }
+
+    void
+    SealPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      const llarp_buffer_t body{pkt.data() + PacketOverhead, pkt.size() - PacketOverhead};
+      CryptoManager::instance()->xchacha20_poly1305_seal(
+          body, key, pkt.data() + HMACSIZE, pkt.data());
+    }
+
+    bool
+    OpenPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key)
+    {
+      if (pkt.size() <= PacketOverhead)
+        return false;
+      const llarp_buffer_t body{pkt.data() + PacketOverhead, pkt.size() - PacketOverhead};
+      return CryptoManager::instance()->xchacha20_poly1305_open(
+          body, key, pkt.data() + HMACSIZE, pkt.data());
+    }
+
+    namespace
+    {
+      /// link traffic summed over all sessions, for the metrics registry
+      struct LinkMetrics
+      {
+        metrics::Counter& rxPackets;
+        metrics::Counter& rxBytes;
+        metrics::Counter& txPackets;
+        metrics::Counter& txBytes;
+        metrics::Counter& acked;
+        metrics::Counter& dropped;
+      };
+
+      LinkMetrics&
+      Metrics()
+      {
+        auto& reg = metrics::Registry::Global();
+        static LinkMetrics m{
+            reg.GetCounter("belnet_iwp_rx_packets_total", "iwp packets received"),
+            reg.GetCounter("belnet_iwp_rx_bytes_total", "iwp bytes received"),
+            reg.GetCounter("belnet_iwp_tx_packets_total", "iwp packets sent"),
+            reg.GetCounter("belnet_iwp_tx_bytes_total", "iwp bytes sent"),
+            reg.GetCounter("belnet_iwp_messages_acked_total", "iwp messages acked by the remote"),
+            reg.GetCounter(
+                "belnet_iwp_messages_dropped_total", "iwp messages that timed out unacked"),
+        };
+        return m;
+      }
+    }  // namespace
+
     constexpr size_t PlaintextQueueSize = 512;
 
     Session::Session(LinkLayer* p, const RouterContact& rc, const AddressInfo& ai)
@@ -70,6 +181,8 @@ namespace llarp
       m_Parent->SendTo_LL(m_RemoteAddr, pkt);
       m_LastTX = time_now_ms();
       m_TXRate += sz;
+      Metrics().txPackets.Inc();
+      Metrics().txBytes.Inc(sz);
     }
 
     bool
@@ -144,29 +257,45 @@ namespace llarp
       m_EncryptNext.emplace_back(std::move(data));
       TriggerPump();
       if (!IsEstablished())
-      {
-        EncryptWorker(std::move(m_EncryptNext));
-        m_EncryptNext = CryptoQueue_t{};
-      }
+        EncryptWorker(std::exchange(m_EncryptNext, m_Pool.GetBatch()));
     }
 
     void
-    Session::EncryptWorker(CryptoQueue_t msgs)
+    Session::EncryptWorker(CryptoQueue_t msgs, trace::Stamp queued)
     {
+      queued.Lap(trace::Stage::LinkEncryptQueue);
       LogTrace("encrypt worker ", msgs.size(), " messages");
       for (auto& pkt : msgs)
       {
-        llarp_buffer_t pktbuf{pkt};
-        const TunnelNonce nonce_ptr{pkt.data() + HMACSIZE};
-        pktbuf.base += PacketOverhead;
-        pktbuf.cur = pktbuf.base;
-        pktbuf.sz -= PacketOverhead;
-        CryptoManager::instance()->xchacha20(pktbuf, m_SessionKey, nonce_ptr);
-        pktbuf.base = pkt.data() + HMACSIZE;
-        pktbuf.sz = pkt.size() - HMACSIZE;
-        CryptoManager::instance()->hmac(pkt.data(), pktbuf, m_SessionKey);
+        if (m_UseAEAD)
+          SealPacketInPlace(pkt, m_SessionKey);
+        else
+          EncryptPacketInPlace(pkt, m_SessionKey);
         Send_LL(pkt.data(), pkt.size());
       }
+      queued.Record(trace::Stage::LinkEncrypt);
+      m_Pool.Recycle(std::move(msgs));
+    }
+
+    bool
+    Session::OpenMessageInPlace(Packet_t& pkt)
+    {
+      if (pkt.size() <= PacketOverhead)
+      {
+        LogError("packet too small from ", m_RemoteAddr);
+        return false;
+      }
+      if (OpenPacketInPlace(pkt, m_SessionKey))
+        return true;
+      LogDebug(
+          m_Parent->PrintableName(),
+          " aead tag mismatch from ",
+          m_RemoteAddr,
+          " state=",
+          int(m_State),
+          " size=",
+          pkt.size());
+      return false;
     }
 
     void
@@ -198,13 +327,16 @@ namespace llarp
       const auto msgid = m_TXID++;
       const auto bufsz = buf.size();
       auto& msg =
-          m_TXMsgs.emplace(msgid, OutboundMessage{msgid, std::move(buf), now, completed, priority})
+          m_TXMsgs
+              .emplace(
+                  msgid,
+                  OutboundMessage{msgid, std::move(buf), now, completed, priority, not m_UseAEAD})
               .first->second;
       TriggerPump();
-      EncryptAndSend(msg.XMIT());
+      EncryptAndSend(msg.XMIT(m_Pool));
       if (bufsz > FragmentSize)
       {
-        msg.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
+        msg.FlushUnAcked(m_Pool, util::memFn(&Session::EncryptAndSend, this), now);
       }
       m_Stats.totalInFlightTX++;
       LogDebug("send message ", msgid, " to ", m_RemoteAddr);
@@ -220,7 +352,7 @@ namespace llarp
         const auto sz = m_SendMACKs.size();
         const auto max = Session::MaxACKSInMACK;
         auto numAcks = std::min(sz, max);
-        auto mack = CreatePacket(Command::eMACK, 1 + (numAcks * sizeof(uint64_t)));
+        auto mack = CreatePacket(m_Pool, Command::eMACK, 1 + (numAcks * sizeof(uint64_t)));
         mack[PacketOverhead + CommandOverhead] = byte_t{static_cast<byte_t>(numAcks)};
         byte_t* ptr = mack.data() + 3 + PacketOverhead;
         LogTrace("send ", numAcks, " macks to ", m_RemoteAddr);
@@ -239,6 +371,7 @@ namespace llarp
     void
     Session::TriggerPump()
     {
+      m_PumpSchedule.Schedule(*m_Parent, weak_from_this());
       m_Parent->Router()->TriggerPump();
     }
 
@@ -254,7 +387,7 @@ namespace llarp
         {
           if (msg.ShouldSendACKS(now))
           {
-            msg.SendACKS(util::memFn(&Session::EncryptAndSend, this), now);
+            msg.SendACKS(m_Pool, util::memFn(&Session::EncryptAndSend, this), now);
           }
         }
 
@@ -272,22 +405,29 @@ namespace llarp
         if (not to_resend.empty())
         {
           for (auto& msg = to_resend.top(); not to_resend.empty(); to_resend.pop())
-            msg->FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
+            msg->FlushUnAcked(m_Pool, util::memFn(&Session::EncryptAndSend, this), now);
         }
       }
+      // the batches move to the workers and a spare one from the pool takes their place
       if (not m_EncryptNext.empty())
       {
-        m_Parent->QueueWork(
-            [self = shared_from_this(), data = m_EncryptNext] { self->EncryptWorker(data); });
-        m_EncryptNext.clear();
+        m_Parent->QueueWork([self = shared_from_this(),
+                             data = std::exchange(m_EncryptNext, m_Pool.GetBatch()),
+                             queued = trace::Stamp{}]() mutable {
+          self->EncryptWorker(std::move(data), queued);
+        });
       }
 
       if (not m_DecryptNext.empty())
       {
-        m_Parent->QueueWork(
-            [self = shared_from_this(), data = m_DecryptNext] { self->DecryptWorker(data); });
-        m_DecryptNext.clear();
+        m_DecryptNextSince.Record(trace::Stage::LinkRecvPending);
+        m_Parent->QueueWork([self = shared_from_this(),
+                             data = std::exchange(m_DecryptNext, m_Pool.GetBatch()),
+                             queued = trace::Stamp{}]() mutable {
+          self->DecryptWorker(std::move(data), queued);
+        });
       }
+      m_PumpSchedule.Pumped();
     }
 
     bool
@@ -342,9 +482,13 @@ namespace llarp
 
           {"state", StateToString(m_State)},
           {"inbound", m_Inbound},
+          {"aead", m_UseAEAD},
+          {"compactRelay", m_CompactRelay},
           {"replayFilter", m_ReplayFilter.size()},
           {"txMsgQueueSize", m_TXMsgs.size()},
           {"rxMsgQueueSize", m_RXMsgs.size()},
+          {"pooledPackets", m_Pool.Size()},
+          {"pooledBytes", m_Pool.Bytes()},
           {"remoteAddr", m_RemoteAddr.ToString()},
           {"remoteRC", m_RemoteRC.ExtractStatus()},
           {"created", to_json(m_CreatedAt)},
@@ -387,6 +531,9 @@ namespace llarp
         ResetRates();
         m_ResetRatesAt = now + 1s;
       }
+      // retransmits, acks and keepalives come due with time rather than with an event, so we
+      // look for them here and get ourselves pumped if any are
+      bool due = ShouldPing();
       // remove pending outbound messsages that timed out
       // inform waiters
       {
@@ -397,12 +544,16 @@ namespace llarp
           {
             m_Stats.totalDroppedTX++;
             m_Stats.totalInFlightTX--;
+            Metrics().dropped.Inc();
             LogTrace("Dropped unacked packet to ", m_RemoteAddr);
             itr->second.InformTimeout();
             itr = m_TXMsgs.erase(itr);
           }
           else
+          {
+            due = due or itr->second.ShouldFlush(now);
             ++itr;
+          }
         }
       }
       {
@@ -416,7 +567,10 @@ namespace llarp
             itr = m_RXMsgs.erase(itr);
           }
           else
+          {
+            due = due or itr->second.ShouldSendACKS(now);
             ++itr;
+          }
         }
       }
       {
@@ -432,6 +586,8 @@ namespace llarp
             ++itr;
         }
       }
+      if (due and (m_State == State::Ready or m_State == State::LinkIntro))
+        TriggerPump();
     }
 
     using Introduction =
@@ -443,7 +599,8 @@ namespace llarp
       TunnelNonce N;
       N.Randomize();
       {
-        ILinkSession::Packet_t req(Introduction::SIZE + PacketOverhead);
+        // our intro flags go after the signature, where peers that don't know them ignore them
+        ILinkSession::Packet_t req(Introduction::SIZE + PacketOverhead + 1);
         const auto pk = m_Parent->GetOurRC().pubkey;
         const auto e_pk = m_Parent->RouterEncryptionSecret().toPublic();
         auto itr = req.data() + PacketOverhead;
@@ -459,6 +616,7 @@ namespace llarp
             Z.data(),
             Z.size(),
             req.data() + PacketOverhead + (Introduction::SIZE - Signature::SIZE));
+        req[PacketOverhead + Introduction::SIZE] = OurIntroFlags;
         CryptoManager::instance()->randbytes(req.data() + HMACSIZE, TUNNONCESIZE);
         EncryptAndSend(std::move(req));
       }
@@ -543,15 +701,23 @@ namespace llarp
         LogError("failed to transport_dh_server on inbound intro from ", m_RemoteAddr);
         return;
       }
-      Packet_t reply(token.size() + PacketOverhead);
+      // peers that offered intro flags get the ones we agree to after the token
+      const bool offered = pkt.size() > Introduction::SIZE + PacketOverhead;
+      const byte_t agreed = AgreedIntroFlags(pkt, PacketOverhead + Introduction::SIZE);
+      Packet_t reply(token.size() + PacketOverhead + (offered ? 1 : 0));
       // random nonce
       CryptoManager::instance()->randbytes(reply.data() + HMACSIZE, TUNNONCESIZE);
       // set token
       std::copy_n(token.data(), token.size(), reply.data() + PacketOverhead);
+      if (offered)
+        reply[PacketOverhead + token.size()] = agreed;
       m_LastRX = m_Parent->Now();
       EncryptAndSend(std::move(reply));
       LogDebug("sent intro ack to ", m_RemoteAddr);
       m_State = State::Introduction;
+      // the session request still comes with the keyed hash, everything after it with aead
+      m_UseAEAD = agreed & IntroFlagAEAD;
+      m_CompactRelay = agreed & IntroFlagCompactRelay;
     }
 
     void
@@ -578,11 +744,14 @@ namespace llarp
       m_LastRX = m_Parent->Now();
       std::copy_n(pkt.data() + PacketOverhead, token.size(), token.data());
       std::copy_n(token.data(), token.size(), reply.data() + PacketOverhead);
+      const byte_t agreed = AgreedIntroFlags(pkt, PacketOverhead + token.size());
       // random nounce
       CryptoManager::instance()->randbytes(reply.data() + HMACSIZE, TUNNONCESIZE);
       EncryptAndSend(std::move(reply));
       LogDebug("sent session request to ", m_RemoteAddr);
       m_State = State::LinkIntro;
+      m_UseAEAD = agreed & IntroFlagAEAD;
+      m_CompactRelay = agreed & IntroFlagCompactRelay;
     }
 
     bool
@@ -593,38 +762,18 @@ namespace llarp
         LogError("packet too small from ", m_RemoteAddr);
         return false;
       }
-      const llarp_buffer_t buf(pkt);
-      ShortHash H;
-      llarp_buffer_t curbuf(buf.base, buf.sz);
-      curbuf.base += ShortHash::SIZE;
-      curbuf.sz -= ShortHash::SIZE;
-      if (not CryptoManager::instance()->hmac(H.data(), curbuf, m_SessionKey))
-      {
-        LogError("failed to caclulate keyed hash for ", m_RemoteAddr);
-        return false;
-      }
-      const ShortHash expected{buf.base};
-      if (H != expected)
-      {
-        LogDebug(
-            m_Parent->PrintableName(),
-            " keyed hash mismatch ",
-            H,
-            " != ",
-            expected,
-            " from ",
-            m_RemoteAddr,
-            " state=",
-            int(m_State),
-            " size=",
-            buf.sz);
-        return false;
-      }
-      const TunnelNonce N{curbuf.base};
-      curbuf.base += 32;
-      curbuf.sz -= 32;
-      LogTrace("decrypt: ", curbuf.sz, " bytes from ", m_RemoteAddr);
-      return CryptoManager::instance()->xchacha20(curbuf, m_SessionKey, N);
+      LogTrace("decrypt: ", pkt.size() - PacketOverhead, " bytes from ", m_RemoteAddr);
+      if (DecryptPacketInPlace(pkt, m_SessionKey))
+        return true;
+      LogDebug(
+          m_Parent->PrintableName(),
+          " keyed hash mismatch from ",
+          m_RemoteAddr,
+          " state=",
+          int(m_State),
+          " size=",
+          pkt.size());
+      return false;
     }
 
     void
@@ -638,18 +787,21 @@ namespace llarp
     void
     Session::HandleSessionData(Packet_t pkt)
     {
+      if (m_DecryptNext.empty())
+        m_DecryptNextSince = trace::Stamp{};
       m_DecryptNext.emplace_back(std::move(pkt));
       TriggerPump();
     }
 
     void
-    Session::DecryptWorker(CryptoQueue_t msgs)
+    Session::DecryptWorker(CryptoQueue_t msgs, trace::Stamp queued)
     {
+      queued.Lap(trace::Stage::LinkDecryptQueue);
       auto itr = msgs.begin();
       while (itr != msgs.end())
       {
         auto& pkt = *itr;
-        if (not DecryptMessageInPlace(pkt))
+        if (not(m_UseAEAD ? OpenMessageInPlace(pkt) : DecryptMessageInPlace(pkt)))
         {
           itr = msgs.erase(itr);
           LogError("failed to decrypt session data from ", m_RemoteAddr);
@@ -667,9 +819,10 @@ namespace llarp
         }
         ++itr;
       }
-      m_PlaintextRecv.tryPushBack(std::move(msgs));
+      queued.Lap(trace::Stage::LinkDecrypt);
+      m_PlaintextRecv.tryPushBack(PlaintextBatch{std::move(msgs), queued});
       m_PlaintextEmpty.clear();
-      m_Parent->WakeupPlaintext();
+      m_Parent->WakeupPlaintext(weak_from_this());
     }
 
     void
@@ -677,9 +830,10 @@ namespace llarp
     {
       if (m_PlaintextEmpty.test_and_set())
         return;
-      while (auto maybe_queue = m_PlaintextRecv.tryPopFront())
+      while (auto maybe_batch = m_PlaintextRecv.tryPopFront())
       {
-        for (auto& result : *maybe_queue)
+        maybe_batch->decrypted.Record(trace::Stage::LinkPlaintextQueue);
+        for (auto& result : maybe_batch->pkts)
         {
           LogTrace("Command ", int(result[PacketOverhead + 1]), " from ", m_RemoteAddr);
           switch (result[PacketOverhead + 1])
@@ -709,9 +863,9 @@ namespace llarp
               LogError("invalid command ", int(result[PacketOverhead + 1]), " from ", m_RemoteAddr);
           }
         }
+        m_Pool.Recycle(std::move(maybe_batch->pkts));
       }
       SendMACK();
-      m_Parent->WakeupPlaintext();
     }
 
     void
@@ -739,6 +893,7 @@ namespace llarp
         {
           m_Stats.totalAckedTX++;
           m_Stats.totalInFlightTX--;
+          Metrics().acked.Inc();
           itr->second.Completed();
           m_TXMsgs.erase(itr);
         }
@@ -764,7 +919,7 @@ namespace llarp
       auto itr = m_TXMsgs.find(txid);
       if (itr != m_TXMsgs.end())
       {
-        EncryptAndSend(itr->second.XMIT());
+        EncryptAndSend(itr->second.XMIT(m_Pool));
       }
       m_LastRX = m_Parent->Now();
     }
@@ -819,7 +974,9 @@ namespace llarp
                 return;
               }
 
-              if (not itr->second.Verify())
+              // aead already authenticated every fragment, so only keyed hash sessions check the
+              // message digest
+              if (not m_UseAEAD and not itr->second.Verify())
               {
                 LogError("bad short xmit hash from ", m_RemoteAddr);
                 return;
@@ -851,7 +1008,7 @@ namespace llarp
         if (m_ReplayFilter.find(rxid) == m_ReplayFilter.end())
         {
           LogTrace("no rxid=", rxid, " for ", m_RemoteAddr);
-          auto nack = CreatePacket(Command::eNACK, 8);
+          auto nack = CreatePacket(m_Pool, Command::eNACK, 8);
           oxenc::write_host_as_big(rxid, nack.data() + PacketOverhead + CommandOverhead);
           EncryptAndSend(std::move(nack));
         }
@@ -871,7 +1028,7 @@ namespace llarp
 
       if (itr->second.IsCompleted())
       {
-        if (itr->second.Verify())
+        if (m_UseAEAD or itr->second.Verify())
         {
           HandleRecvMsgCompleted(itr->second);
         }
@@ -889,7 +1046,7 @@ namespace llarp
       if (m_ReplayFilter.emplace(rxid, m_Parent->Now()).second)
       {
         m_Parent->HandleMessage(this, msg.m_Data);
-        EncryptAndSend(msg.ACKS());
+        EncryptAndSend(msg.ACKS(m_Pool));
         LogDebug("recv'd message ", rxid, " from ", m_RemoteAddr);
       }
       m_RXMsgs.erase(rxid);
@@ -922,7 +1079,7 @@ namespace llarp
       }
       else
       {
-        itr->second.FlushUnAcked(util::memFn(&Session::EncryptAndSend, this), now);
+        itr->second.FlushUnAcked(m_Pool, util::memFn(&Session::EncryptAndSend, this), now);
       }
     }
 
@@ -944,7 +1101,7 @@ namespace llarp
     {
       if (m_State == State::Ready)
       {
-        EncryptAndSend(CreatePacket(Command::ePING, 0));
+        EncryptAndSend(CreatePacket(m_Pool, Command::ePING, 0));
         return true;
       }
       return false;
@@ -963,6 +1120,8 @@ namespace llarp
 
       // TODO: differentiate between good and bad RX packets here
       m_Stats.totalPacketsRX++;
+      Metrics().rxPackets.Inc();
+      Metrics().rxBytes.Inc(data.size());
       switch (m_State)
       {
         case State::Initial:
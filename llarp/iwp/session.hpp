@@ -3,7 +3,9 @@
 #include <llarp/link/session.hpp>
 #include "linklayer.hpp"
 #include "message_buffer.hpp"
+#include "packet_pool.hpp"
 #include <llarp/net/ip_address.hpp>
+#include <llarp/util/latency_trace.hpp>
 
 #include <map>
 #include <unordered_set>
@@ -18,9 +20,44 @@ namespace llarp
   {
     /// packet crypto overhead size
     static constexpr size_t PacketOverhead = HMACSIZE + TUNNONCESIZE;
+    /// intro handshake flag for protecting session data with xchacha20-poly1305 instead of
+    /// xchacha20 and a keyed hash.  aead packets keep the same layout so every offset past
+    /// PacketOverhead holds: the tag sits at the front of the hmac field and the nonce at the
+    /// front of the nonce field.
+    static constexpr byte_t IntroFlagAEAD = 1 << 0;
+    /// intro handshake flag for sending relay cells in the compact binary framing instead of
+    /// bencoding them
+    static constexpr byte_t IntroFlagCompactRelay = 1 << 1;
+    /// the intro handshake flags we offer and accept
+    static constexpr byte_t OurIntroFlags = IntroFlagAEAD | IntroFlagCompactRelay;
     /// creates a packet with plaintext size + wire overhead + random pad
     ILinkSession::Packet_t
     CreatePacket(Command cmd, size_t plainsize, size_t min_pad = 16, size_t pad_variance = 16);
+    /// as above, reusing a buffer from a session's pool
+    ILinkSession::Packet_t
+    CreatePacket(
+        PacketPool& pool,
+        Command cmd,
+        size_t plainsize,
+        size_t min_pad = 16,
+        size_t pad_variance = 16);
+    /// the intro handshake flags a packet carries at offset, limited to the ones we accept.
+    /// peers that predate the flags send no byte there and get none.
+    byte_t
+    AgreedIntroFlags(const ILinkSession::Packet_t& pkt, size_t offset);
+    /// xchacha20 and keyed hash over a whole packet, used for the handshake and with peers that
+    /// don't do aead
+    void
+    EncryptPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key);
+    /// checks the keyed hash and decrypts; false if the packet is too small or doesn't verify
+    bool
+    DecryptPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key);
+    /// xchacha20-poly1305 for session data once the handshake settled on aead
+    void
+    SealPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key);
+    /// checks the aead tag and decrypts; false if the packet is too small or doesn't verify
+    bool
+    OpenPacketInPlace(ILinkSession::Packet_t& pkt, const SharedSecret& key);
     /// Time how long we try delivery for
     static constexpr std::chrono::milliseconds DeliveryTimeout = 500ms;
     /// Time how long we wait to recieve a message
@@ -48,7 +85,8 @@ namespace llarp
       /// inbound session
       Session(LinkLayer* parent, const SockAddr& from);
 
-      // Signal the event loop that a pump is needed (idempotent)
+      // Puts us on our link's ready list and signals the event loop that a pump is needed
+      // (idempotent)
       void
       TriggerPump();
 
@@ -123,6 +161,12 @@ namespace llarp
       bool
       ShouldPing() const override;
 
+      bool
+      SupportsCompactRelay() const override
+      {
+        return m_CompactRelay;
+      }
+
       SessionStats
       GetSessionStats() const override;
 
@@ -155,6 +199,8 @@ namespace llarp
       StateToString(State state);
       State m_State;
       SessionStats m_Stats;
+      /// are we on our link's ready list
+      PumpSchedule m_PumpSchedule;
 
       /// are we inbound session ?
       const bool m_Inbound;
@@ -170,6 +216,11 @@ namespace llarp
       SharedSecret m_SessionKey;
       /// session token
       AlignedBuffer<24> token;
+      /// protect session data with aead; settled in the intro handshake before any session data
+      /// is sent and fixed after that, so the crypto workers read it without locking
+      bool m_UseAEAD = false;
+      /// the remote reads relay cells in the compact framing, settled alongside m_UseAEAD
+      bool m_CompactRelay = false;
 
       PubKey m_ExpectedIdent;
       PubKey m_RemoteOnionKey;
@@ -199,20 +250,32 @@ namespace llarp
       /// rx messages to send in next round of multiacks
       util::ascending_priority_queue<uint64_t> m_SendMACKs;
 
-      using CryptoQueue_t = std::vector<Packet_t>;
+      using CryptoQueue_t = PacketPool::Batch_t;
+
+      /// recycled packet buffers and batches for the crypto workers
+      PacketPool m_Pool;
 
       CryptoQueue_t m_EncryptNext;
       CryptoQueue_t m_DecryptNext;
+      /// when the oldest packet in m_DecryptNext arrived
+      trace::Stamp m_DecryptNextSince;
+
+      /// a decrypted batch on its way back to the logic thread
+      struct PlaintextBatch
+      {
+        CryptoQueue_t pkts;
+        trace::Stamp decrypted;
+      };
 
       std::atomic_flag m_PlaintextEmpty;
-      llarp::thread::Queue<CryptoQueue_t> m_PlaintextRecv;
+      llarp::thread::Queue<PlaintextBatch> m_PlaintextRecv;
       std::atomic_flag m_SentClosed;
 
       void
-      EncryptWorker(CryptoQueue_t msgs);
+      EncryptWorker(CryptoQueue_t msgs, trace::Stamp queued = {});
 
       void
-      DecryptWorker(CryptoQueue_t msgs);
+      DecryptWorker(CryptoQueue_t msgs, trace::Stamp queued);
 
       void
       HandleGotIntro(Packet_t pkt);
@@ -232,6 +295,9 @@ namespace llarp
       bool
       DecryptMessageInPlace(Packet_t& pkt);
 
+      bool
+      OpenMessageInPlace(Packet_t& pkt);
+
       void
       SendMACK();
 
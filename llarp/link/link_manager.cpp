@@ -389,8 +389,6 @@ namespace llarp
   {
     std::vector<std::pair<RouterID, SessionStats>> statsToUpdate;
 
-    int64_t diffTotalTX = 0;
-
     ForEachPeer([&](ILinkSession* session) {
       // derive RouterID
       RouterID id = RouterID(session->GetRemoteRC().pubkey);
@@ -406,8 +404,6 @@ namespace llarp
       diff.totalAckedTX = sessionStats.totalAckedTX - lastStats.totalAckedTX;
       diff.totalDroppedTX = sessionStats.totalDroppedTX - lastStats.totalDroppedTX;
 
-      diffTotalTX = diff.totalAckedTX + diff.totalDroppedTX + diff.totalInFlightTX;
-
       lastStats = sessionStats;
 
       // TODO: if we have both inbound and outbound session, this will overwrite
@@ -425,8 +421,8 @@ namespace llarp
             stats.peakBandwidthBytesPerSec,
             (double)std::max(diff.currentRateRX, diff.currentRateTX));
         stats.numPacketsDropped += diff.totalDroppedTX;
-        stats.numPacketsSent = diff.totalAckedTX;
-        stats.numPacketsAttempted = diffTotalTX;
+        stats.numPacketsSent += diff.totalAckedTX;
+        stats.numPacketsAttempted += diff.totalAckedTX + diff.totalDroppedTX;
 
         // TODO: others -- we have slight mismatch on what we store
       });
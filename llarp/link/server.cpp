@@ -3,11 +3,13 @@
 #include <llarp/ev/udp_handle.hpp>
 #include <llarp/crypto/crypto.hpp>
 #include <llarp/config/key_manager.hpp>
+#include <algorithm>
 #include <memory>
 #include <llarp/util/fs.hpp>
 #include <utility>
 #include <unordered_set>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/messages/relay.hpp>
 #include <oxenc/variant.h>
 
 static constexpr auto LINK_LAYER_TICK_INTERVAL = 100ms;
@@ -154,66 +156,20 @@ namespace llarp
   void
   ILinkLayer::Pump()
   {
-    std::unordered_set<RouterID> closedSessions;
-    std::vector<std::shared_ptr<ILinkSession>> closedPending;
-    auto _now = Now();
+    // sessions that schedule themselves while we pump them go on the next round
+    m_Pumping.swap(m_ReadySessions);
+    for (const auto& weak : m_Pumping)
     {
-      Lock_t l(m_AuthedLinksMutex);
-      auto itr = m_AuthedLinks.begin();
-      while (itr != m_AuthedLinks.end())
-      {
-        if (not itr->second->TimedOut(_now))
-        {
-          itr->second->Pump();
-          ++itr;
-        }
-        else
-        {
-          llarp::LogInfo("session to ", RouterID(itr->second->GetPubKey()), " timed out");
-          itr->second->Close();
-          closedSessions.emplace(itr->first);
-          UnmapAddr(itr->second->GetRemoteEndpoint());
-          itr = m_AuthedLinks.erase(itr);
-        }
-      }
+      if (auto session = weak.lock())
+        session->Pump();
     }
-    {
-      Lock_t l(m_PendingMutex);
+    m_Pumping.clear();
+  }
 
-      auto itr = m_Pending.begin();
-      while (itr != m_Pending.end())
-      {
-        if (not itr->second->TimedOut(_now))
-        {
-          itr->second->Pump();
-          ++itr;
-        }
-        else
-        {
-          LogInfo("pending session at ", itr->first, " timed out");
-          UnmapAddr(itr->second->GetRemoteEndpoint());
-          // defer call so we can acquire mutexes later
-          closedPending.emplace_back(std::move(itr->second));
-          itr = m_Pending.erase(itr);
-        }
-      }
-    }
-    {
-      Lock_t l(m_AuthedLinksMutex);
-      for (const auto& r : closedSessions)
-      {
-        if (m_AuthedLinks.count(r) == 0)
-        {
-          SessionClosed(r);
-        }
-      }
-    }
-    for (const auto& pending : closedPending)
-    {
-      if (pending->IsInbound())
-        continue;
-      HandleTimeout(pending.get());
-    }
+  void
+  ILinkLayer::ScheduleSession(std::weak_ptr<ILinkSession> session)
+  {
+    m_ReadySessions.emplace_back(std::move(session));
   }
 
   void
@@ -347,16 +303,63 @@ namespace llarp
   void
   ILinkLayer::Tick(const llarp_time_t now)
   {
+    std::unordered_set<RouterID> closedSessions;
+    std::vector<std::shared_ptr<ILinkSession>> closedPending;
     {
       Lock_t l(m_AuthedLinksMutex);
-      for (const auto& [routerid, link] : m_AuthedLinks)
-        link->Tick(now);
+      auto itr = m_AuthedLinks.begin();
+      while (itr != m_AuthedLinks.end())
+      {
+        if (not itr->second->TimedOut(now))
+        {
+          itr->second->Tick(now);
+          ++itr;
+        }
+        else
+        {
+          llarp::LogInfo("session to ", RouterID(itr->second->GetPubKey()), " timed out");
+          itr->second->Close();
+          closedSessions.emplace(itr->first);
+          UnmapAddr(itr->second->GetRemoteEndpoint());
+          itr = m_AuthedLinks.erase(itr);
+        }
+      }
     }
-
     {
       Lock_t l(m_PendingMutex);
-      for (const auto& [addr, link] : m_Pending)
-        link->Tick(now);
+      auto itr = m_Pending.begin();
+      while (itr != m_Pending.end())
+      {
+        if (not itr->second->TimedOut(now))
+        {
+          itr->second->Tick(now);
+          ++itr;
+        }
+        else
+        {
+          LogInfo("pending session at ", itr->first, " timed out");
+          UnmapAddr(itr->second->GetRemoteEndpoint());
+          // defer call so we can acquire mutexes later
+          closedPending.emplace_back(std::move(itr->second));
+          itr = m_Pending.erase(itr);
+        }
+      }
+    }
+    {
+      Lock_t l(m_AuthedLinksMutex);
+      for (const auto& r : closedSessions)
+      {
+        if (m_AuthedLinks.count(r) == 0)
+        {
+          SessionClosed(r);
+        }
+      }
+    }
+    for (const auto& pending : closedPending)
+    {
+      if (pending->IsInbound())
+        continue;
+      HandleTimeout(pending.get());
     }
 
     {
@@ -450,9 +453,21 @@ namespace llarp
         }
       }
     }
-    ILinkSession::Message_t pkt(buf.sz);
-    std::copy_n(buf.base, buf.sz, pkt.begin());
-    return s && s->SendMessageBuffer(std::move(pkt), completed, priority);
+    if (not s)
+      return false;
+    ILinkSession::Message_t pkt;
+    // relay cells come compact; the session knows whether its peer agreed to that
+    if (RelayCellView cell; not s->SupportsCompactRelay() and cell.Decode(buf))
+    {
+      pkt.resize(MAX_LINK_MSG_SIZE);
+      llarp_buffer_t out{pkt};
+      if (not cell.BEncode(&out))
+        return false;
+      pkt.resize(out.cur - out.base);
+    }
+    else
+      pkt.assign(buf.base, buf.base + buf.sz);
+    return s->SendMessageBuffer(std::move(pkt), completed, priority);
   }
 
   bool
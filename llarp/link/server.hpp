@@ -12,6 +12,7 @@
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -28,7 +29,7 @@ namespace llarp
 
   /// handle connection timeout
   ///
-  /// currently called from ILinkLayer::Pump() when an unestablished session times out
+  /// currently called from ILinkLayer::Tick() when an unestablished session times out
   using TimeoutHandler = std::function<void(ILinkSession*)>;
 
   /// get our RC
@@ -117,9 +118,16 @@ namespace llarp
     std::shared_ptr<ILinkSession>
     FindSessionByPubkey(RouterID pk);
 
+    /// pumps the sessions that scheduled themselves since the last pump
     virtual void
     Pump();
 
+    /// queue a session to be pumped on our next Pump().  sessions schedule themselves when they
+    /// have packets to encrypt or decrypt, or acks, retransmits or keepalives come due, so idle
+    /// sessions cost nothing per pump.  must be called from the logic thread.
+    void
+    ScheduleSession(std::weak_ptr<ILinkSession> session);
+
     virtual void
     RecvFrom(const SockAddr& from, ILinkSession::Packet_t pkt) = 0;
 
@@ -272,6 +280,10 @@ namespace llarp
 
    private:
     std::shared_ptr<int> m_repeater_keepalive;
+    /// sessions to pump on the next Pump()
+    std::vector<std::weak_ptr<ILinkSession>> m_ReadySessions;
+    /// the sessions being pumped, kept to reuse the allocation
+    std::vector<std::weak_ptr<ILinkSession>> m_Pumping;
   };
 
   using LinkLayer_ptr = std::shared_ptr<ILinkLayer>;
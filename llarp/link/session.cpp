@@ -1,4 +1,5 @@
 #include "session.hpp"
+#include "server.hpp"
 
 namespace llarp
 {
@@ -8,4 +9,13 @@ namespace llarp
     return GetRemoteRC().IsPublicRouter();
   }
 
+  void
+  PumpSchedule::Schedule(ILinkLayer& link, std::weak_ptr<ILinkSession> session)
+  {
+    if (m_Scheduled)
+      return;
+    m_Scheduled = true;
+    link.ScheduleSession(std::move(session));
+  }
+
 }  // namespace llarp
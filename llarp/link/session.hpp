@@ -7,6 +7,7 @@
 #include <llarp/util/types.hpp>
 
 #include <functional>
+#include <memory>
 
 namespace llarp
 {
@@ -42,11 +43,13 @@ namespace llarp
     virtual void
     OnLinkEstablished(ILinkLayer*){};
 
-    /// called during pumping
+    /// called during pumping, once the session has scheduled itself with
+    /// ILinkLayer::ScheduleSession
     virtual void
     Pump() = 0;
 
-    /// called every timer tick
+    /// called every link layer timer tick on sessions that have not timed out; this is where
+    /// sessions notice work that comes due with time and schedule a pump for it
     virtual void Tick(llarp_time_t) = 0;
 
     /// message delivery result hook function
@@ -125,6 +128,13 @@ namespace llarp
     virtual bool
     ShouldPing() const = 0;
 
+    /// return true if the remote agreed to relay cells in the compact binary framing
+    virtual bool
+    SupportsCompactRelay() const
+    {
+      return false;
+    }
+
     /// return the current stats for this session
     virtual SessionStats
     GetSessionStats() const = 0;
@@ -135,4 +145,30 @@ namespace llarp
     virtual void
     HandlePlaintext() = 0;
   };
+
+  /// whether a session is on its link's ready list; keeps it there at most once per pump round
+  /// however much work it queues
+  struct PumpSchedule
+  {
+    /// put session on link's ready list unless it is on it already
+    void
+    Schedule(ILinkLayer& link, std::weak_ptr<ILinkSession> session);
+
+    /// called at the end of the session's Pump(); anything queued while it pumped was taken by
+    /// that pump, work queued from here on puts it back on the list
+    void
+    Pumped()
+    {
+      m_Scheduled = false;
+    }
+
+    bool
+    IsScheduled() const
+    {
+      return m_Scheduled;
+    }
+
+   private:
+    bool m_Scheduled = false;
+  };
 }  // namespace llarp
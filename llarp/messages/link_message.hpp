@@ -45,6 +45,14 @@ namespace llarp
     virtual bool
     BEncode(llarp_buffer_t* buf) const = 0;
 
+    /// write this message in the compact binary framing used on links that negotiated it,
+    /// returns false without writing anything for messages that are only ever bencoded
+    virtual bool
+    EncodeCompact(llarp_buffer_t*) const
+    {
+      return false;
+    }
+
     virtual bool
     HandleMessage(AbstractRouter* router) const = 0;
 
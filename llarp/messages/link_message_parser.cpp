@@ -123,6 +123,18 @@ namespace llarp
       return false;
     }
 
+    // relay cells in the compact framing are read in place, without the bencode parser
+    if (buf.sz > 0 and buf.base[0] == CompactRelayVersion)
+    {
+      RelayCellView cell;
+      if (not cell.Decode(buf))
+      {
+        llarp::LogWarn("bad compact relay cell from ", src->GetPubKey());
+        return false;
+      }
+      return cell.HandleMessage(src, router);
+    }
+
     from = src;
     firstkey = true;
     ManagedBuffer copy(buf);
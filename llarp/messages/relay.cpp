@@ -4,8 +4,115 @@
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/util/bencode.hpp>
 
+#include <algorithm>
+
 namespace llarp
 {
+  namespace
+  {
+    bool
+    EncodeRelayCell(
+        byte_t type,
+        const PathID_t& pathid,
+        const TunnelNonce& Y,
+        const byte_t* X,
+        size_t sz,
+        llarp_buffer_t* buf)
+    {
+      // check up front so a short buffer is left untouched for the bencoded fallback
+      if (buf->size_left() < CompactRelayHeaderSize + sz)
+        return false;
+      *buf->cur++ = CompactRelayVersion;
+      *buf->cur++ = type;
+      buf->cur = std::copy(pathid.begin(), pathid.end(), buf->cur);
+      buf->cur = std::copy(Y.begin(), Y.end(), buf->cur);
+      buf->cur = std::copy_n(X, sz, buf->cur);
+      return true;
+    }
+
+    bool
+    RelayUpstream(
+        AbstractRouter* r,
+        ILinkSession* session,
+        const PathID_t& pathid,
+        const llarp_buffer_t& X,
+        const TunnelNonce& Y)
+    {
+      auto path = r->pathContext().GetByDownstream(session->GetPubKey(), pathid);
+      if (path)
+      {
+        return path->HandleUpstream(X, Y, r);
+      }
+      return false;
+    }
+
+    bool
+    RelayDownstream(
+        AbstractRouter* r,
+        ILinkSession* session,
+        const PathID_t& pathid,
+        const llarp_buffer_t& X,
+        const TunnelNonce& Y)
+    {
+      auto path = r->pathContext().GetByUpstream(session->GetPubKey(), pathid);
+      if (path)
+      {
+        return path->HandleDownstream(X, Y, r);
+      }
+      llarp::LogWarn("no path for downstream message id=", pathid);
+      return false;
+    }
+  }  // namespace
+
+  bool
+  RelayCellView::Decode(const llarp_buffer_t& buf)
+  {
+    if (buf.sz < CompactRelayHeaderSize or buf.sz > CompactRelayHeaderSize + MaxRelayPayloadSize)
+      return false;
+    if (buf.base[0] != CompactRelayVersion)
+      return false;
+    type = buf.base[1];
+    if (type != 'u' and type != 'd')
+      return false;
+    const byte_t* ptr = buf.base + 2;
+    std::copy_n(ptr, PathID_t::SIZE, pathid.begin());
+    ptr += PathID_t::SIZE;
+    std::copy_n(ptr, TunnelNonce::SIZE, Y.begin());
+    ptr += TunnelNonce::SIZE;
+    payload = ptr;
+    payloadSize = buf.sz - CompactRelayHeaderSize;
+    return true;
+  }
+
+  bool
+  RelayCellView::BEncode(llarp_buffer_t* buf) const
+  {
+    if (!bencode_start_dict(buf))
+      return false;
+    if (!BEncodeWriteDictMsgType(buf, "a", type == 'u' ? "u" : "d"))
+      return false;
+    if (!BEncodeWriteDictEntry("p", pathid, buf))
+      return false;
+    if (!BEncodeWriteDictInt("v", llarp::constants::proto_version, buf))
+      return false;
+    if (!bencode_write_bytestring(buf, "x", 1))
+      return false;
+    if (!bencode_write_bytestring(buf, payload, payloadSize))
+      return false;
+    if (!BEncodeWriteDictEntry("y", Y, buf))
+      return false;
+    return bencode_end(buf);
+  }
+
+  bool
+  RelayCellView::HandleMessage(ILinkSession* from, AbstractRouter* r) const
+  {
+    const llarp_buffer_t X{payload, payloadSize};
+    if (type == 'u')
+      return RelayUpstream(r, from, pathid, X, Y);
+    return RelayDownstream(r, from, pathid, X, Y);
+  }
+
   void
   RelayUpstreamMessage::Clear()
   {
@@ -34,6 +141,12 @@ namespace llarp
     return bencode_end(buf);
   }
 
+  bool
+  RelayUpstreamMessage::EncodeCompact(llarp_buffer_t* buf) const
+  {
+    return EncodeRelayCell('u', pathid, Y, X.data(), X.size(), buf);
+  }
+
   bool
   RelayUpstreamMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf)
   {
@@ -52,12 +165,7 @@ namespace llarp
   bool
   RelayUpstreamMessage::HandleMessage(AbstractRouter* r) const
   {
-    auto path = r->pathContext().GetByDownstream(session->GetPubKey(), pathid);
-    if (path)
-    {
-      return path->HandleUpstream(llarp_buffer_t(X), Y, r);
-    }
-    return false;
+    return RelayUpstream(r, session, pathid, llarp_buffer_t(X), Y);
   }
 
   void
@@ -88,6 +196,12 @@ namespace llarp
     return bencode_end(buf);
   }
 
+  bool
+  RelayDownstreamMessage::EncodeCompact(llarp_buffer_t* buf) const
+  {
+    return EncodeRelayCell('d', pathid, Y, X.data(), X.size(), buf);
+  }
+
   bool
   RelayDownstreamMessage::DecodeKey(const llarp_buffer_t& key, llarp_buffer_t* buf)
   {
@@ -106,12 +220,6 @@ namespace llarp
   bool
   RelayDownstreamMessage::HandleMessage(AbstractRouter* r) const
   {
-    auto path = r->pathContext().GetByUpstream(session->GetPubKey(), pathid);
-    if (path)
-    {
-      return path->HandleDownstream(llarp_buffer_t(X), Y, r);
-    }
-    llarp::LogWarn("no path for downstream message id=", pathid);
-    return false;
+    return RelayDownstream(r, session, pathid, llarp_buffer_t(X), Y);
   }
 }  // namespace llarp
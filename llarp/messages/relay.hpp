@@ -9,9 +9,42 @@
 
 namespace llarp
 {
+  /// first byte of a relay cell in the compact framing, doubling as its version.  bencoded link
+  /// messages always start with 'd' so the two can share a link.
+  static constexpr byte_t CompactRelayVersion = 0x01;
+  /// compact relay cell layout: version, message type ('u' or 'd'), path id, nonce, then the
+  /// encrypted payload running to the end of the link message
+  static constexpr size_t CompactRelayHeaderSize = 2 + PathID_t::SIZE + TunnelNonce::SIZE;
+  /// largest encrypted payload a relay cell carries
+  static constexpr size_t MaxRelayPayloadSize = MAX_LINK_MSG_SIZE - 128;
+
+  /// a relay cell read from the compact framing.  the header fields are copied out, the payload
+  /// still points into the link buffer it was read from and is only valid as long as that is.
+  struct RelayCellView
+  {
+    byte_t type = 0;
+    PathID_t pathid;
+    TunnelNonce Y;
+    const byte_t* payload = nullptr;
+    size_t payloadSize = 0;
+
+    /// read a compact relay cell from buf, returns false if it does not hold a valid one
+    bool
+    Decode(const llarp_buffer_t& buf);
+
+    /// write the cell as the bencoded relay message it stands for, for peers without the
+    /// compact framing
+    bool
+    BEncode(llarp_buffer_t* buf) const;
+
+    /// hand the payload straight to the path it belongs to
+    bool
+    HandleMessage(ILinkSession* from, AbstractRouter* router) const;
+  };
+
   struct RelayUpstreamMessage : public ILinkMessage
   {
-    Encrypted<MAX_LINK_MSG_SIZE - 128> X;
+    Encrypted<MaxRelayPayloadSize> X;
     TunnelNonce Y;
 
     bool
@@ -20,6 +53,9 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    bool
+    EncodeCompact(llarp_buffer_t* buf) const override;
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -40,7 +76,7 @@ namespace llarp
 
   struct RelayDownstreamMessage : public ILinkMessage
   {
-    Encrypted<MAX_LINK_MSG_SIZE - 128> X;
+    Encrypted<MaxRelayPayloadSize> X;
     TunnelNonce Y;
 
     bool
@@ -49,6 +85,9 @@ namespace llarp
     bool
     BEncode(llarp_buffer_t* buf) const override;
 
+    bool
+    EncodeCompact(llarp_buffer_t* buf) const override;
+
     bool
     HandleMessage(AbstractRouter* router) const override;
 
@@ -478,11 +478,15 @@ namespace llarp
     // copy frames so we own them
     auto frameDecrypt = std::make_shared<LRCMFrameDecrypt>(context, std::move(decrypter), this);
 
-    // decrypt frames async
+    const RouterID from{session->GetPubKey()};
+    bool admitted = true;
+    // decrypt frames async, once the admission queue lets us
     frameDecrypt->decrypter->AsyncDecrypt(
-        frameDecrypt->frames[0], frameDecrypt, [r = context->Router()](auto func) {
-          r->QueueWork(std::move(func));
+        frameDecrypt->frames[0], frameDecrypt, [context, from, &admitted](auto func) {
+          admitted = context->AdmitTransitBuild(from, std::move(func));
         });
+    if (not admitted)
+      LogDebug("shed LRCM from ", from);
     return true;
   }
 }  // namespace llarp
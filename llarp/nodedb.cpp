@@ -23,7 +23,22 @@ namespace llarp
 
   static auto logcat = log::Cat("nodedb");
 
-  NodeDB::Entry::Entry(RouterContact value) : rc(std::move(value)), insertedAt(llarp::time_now_ms())
+  namespace
+  {
+    /// drop the spare capacity decoding leaves in an rc's containers and put it in one shared
+    /// allocation with its ref count
+    RouterContact_ptr
+    Pack(RouterContact rc)
+    {
+      rc.addrs.shrink_to_fit();
+      rc.srvRecords.shrink_to_fit();
+      rc.signed_bt_dict.shrink_to_fit();
+      return std::make_shared<const RouterContact>(std::move(rc));
+    }
+  }  // namespace
+
+  NodeDB::Entry::Entry(RouterContact value)
+      : rc{Pack(std::move(value))}, insertedAt{llarp::time_now_ms()}
   {}
 
   static void
@@ -78,8 +93,9 @@ namespace llarp
     if (now > m_NextFlushAt)
     {
       m_NextFlushAt += FlushInterval;
-      // make copy of all rcs
-      std::vector<RouterContact> copy;
+      // share all rcs with the disk job, they are immutable
+      std::vector<RouterContact_ptr> copy;
+      copy.reserve(m_Entries.size());
       for (const auto& item : m_Entries)
         copy.push_back(item.second.rc);
       // flush them to disk in one big job
@@ -87,7 +103,7 @@ namespace llarp
       disk([this, data = std::move(copy)]() {
         for (const auto& rc : data)
         {
-          rc.Write(GetPathForPubkey(rc.pubkey));
+          rc->Write(GetPathForPubkey(rc->pubkey));
         }
       });
     }
@@ -152,7 +168,10 @@ namespace llarp
         // validate signature and purge entries with invalid signatures
         // load ones with valid signatures
         if (rc.VerifySignature())
-          m_Entries.emplace(rc.pubkey, rc);
+        {
+          const RouterID pk{rc.pubkey};
+          m_Entries.emplace(pk, std::move(rc));
+        }
         else
           purge.emplace(f);
 
@@ -177,7 +196,7 @@ namespace llarp
 
     for (const auto& item : m_Entries)
     {
-      item.second.rc.Write(GetPathForPubkey(item.first));
+      item.second.rc->Write(GetPathForPubkey(item.first));
     }
   }
 
@@ -188,13 +207,13 @@ namespace llarp
     return m_Entries.find(pk) != m_Entries.end();
   }
 
-  std::optional<RouterContact>
+  RouterContact_ptr
   NodeDB::Get(RouterID pk) const
   {
     util::NullLock lock{m_Access};
     const auto itr = m_Entries.find(pk);
     if (itr == m_Entries.end())
-      return std::nullopt;
+      return nullptr;
     return itr->second.rc;
   }
 
@@ -214,9 +233,9 @@ namespace llarp
     auto itr = m_Entries.begin();
     while (itr != m_Entries.end())
     {
-      if (itr->second.insertedAt < cutoff and keep.count(itr->second.rc.pubkey) == 0)
+      if (itr->second.insertedAt < cutoff and keep.count(itr->first) == 0)
       {
-        removed.insert(itr->second.rc.pubkey);
+        removed.insert(itr->first);
         itr = m_Entries.erase(itr);
       }
       else
@@ -230,8 +249,9 @@ namespace llarp
   NodeDB::Put(RouterContact rc)
   {
     util::NullLock lock{m_Access};
-    m_Entries.erase(rc.pubkey);
-    m_Entries.emplace(rc.pubkey, rc);
+    const RouterID pk{rc.pubkey};
+    m_Entries.erase(pk);
+    m_Entries.emplace(pk, std::move(rc));
   }
 
   size_t
@@ -246,13 +266,14 @@ namespace llarp
   {
     util::NullLock lock{m_Access};
     auto itr = m_Entries.find(rc.pubkey);
-    if (itr == m_Entries.end() or itr->second.rc.OtherIsNewer(rc))
+    if (itr == m_Entries.end() or itr->second.rc->OtherIsNewer(rc))
     {
       // delete if existing
       if (itr != m_Entries.end())
         m_Entries.erase(itr);
       // add new entry
-      m_Entries.emplace(rc.pubkey, rc);
+      const RouterID pk{rc.pubkey};
+      m_Entries.emplace(pk, std::move(rc));
     }
   }
 
@@ -278,20 +299,21 @@ namespace llarp
   NodeDB::FindClosestTo(llarp::dht::Key_t location) const
   {
     util::NullLock lock{m_Access};
-    llarp::RouterContact rc;
+    const llarp::RouterContact* closest = nullptr;
     const llarp::dht::XorMetric compare(location);
-    VisitAll([&rc, compare](const auto& otherRC) {
-      if (rc.pubkey.IsZero())
+    VisitAll([&closest, compare](const auto& otherRC) {
+      if (closest == nullptr or closest->pubkey.IsZero())
       {
-        rc = otherRC;
+        closest = &otherRC;
         return;
       }
       if (compare(
               llarp::dht::Key_t{otherRC.pubkey.as_array()},
-              llarp::dht::Key_t{rc.pubkey.as_array()}))
-        rc = otherRC;
+              llarp::dht::Key_t{closest->pubkey.as_array()}))
+        closest = &otherRC;
     });
-    return rc;
+    // copied once, not at every step of the search
+    return closest ? *closest : llarp::RouterContact{};
   }
 
   std::vector<RouterContact>
@@ -305,7 +327,7 @@ namespace llarp
     all.reserve(entries.size());
     for (auto& entry : entries)
     {
-      all.push_back(&entry.second.rc);
+      all.push_back(entry.second.rc.get());
     }
 
     auto it_mid = numRouters < all.size() ? all.begin() + numRouters : all.end();
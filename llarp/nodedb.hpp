@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <utility>
 #include <atomic>
+#include <memory>
 #include <algorithm>
 
 namespace llarp
@@ -23,7 +24,8 @@ namespace llarp
   {
     struct Entry
     {
-      const RouterContact rc;
+      /// packed when stored, so entries don't keep the slack of decoding
+      const RouterContact_ptr rc;
       llarp_time_t insertedAt;
       explicit Entry(RouterContact rc);
     };
@@ -81,12 +83,12 @@ namespace llarp
     bool
     Has(RouterID pk) const;
 
-    /// maybe get an rc by its ident pubkey
-    std::optional<RouterContact>
+    /// maybe get an rc by its ident pubkey; the rc is shared, not copied
+    RouterContact_ptr
     Get(RouterID pk) const;
 
     template <typename Filter>
-    std::optional<RouterContact>
+    RouterContact_ptr
     GetRandom(Filter visit) const
     {
       util::NullLock lock{m_Access};
@@ -99,11 +101,11 @@ namespace llarp
 
       for (const auto entry : entries)
       {
-        if (visit(entry->second.rc))
+        if (visit(*entry->second.rc))
           return entry->second.rc;
       }
 
-      return std::nullopt;
+      return nullptr;
     }
 
     /// visit all entries
@@ -114,7 +116,7 @@ namespace llarp
       util::NullLock lock{m_Access};
       for (const auto& item : m_Entries)
       {
-        visit(item.second.rc);
+        visit(*item.second.rc);
       }
     }
 
@@ -127,7 +129,7 @@ namespace llarp
       for (const auto& item : m_Entries)
       {
         if (item.second.insertedAt < insertedBefore)
-          visit(item.second.rc);
+          visit(*item.second.rc);
       }
     }
 
@@ -145,9 +147,9 @@ namespace llarp
       auto itr = m_Entries.begin();
       while (itr != m_Entries.end())
       {
-        if (visit(itr->second.rc))
+        if (visit(*itr->second.rc))
         {
-          removed.insert(itr->second.rc.pubkey);
+          removed.insert(itr->first);
           itr = m_Entries.erase(itr);
         }
         else
@@ -0,0 +1,134 @@
+#include "build_admission.hpp"
+
+#include <algorithm>
+
+namespace llarp
+{
+  namespace path
+  {
+    TokenBucket::TokenBucket(double rate, double burst)
+        : m_Rate{rate}, m_Burst{burst}, m_Tokens{burst}
+    {}
+
+    double
+    TokenBucket::Available(llarp_time_t now) const
+    {
+      if (now <= m_LastRefill)
+        return m_Tokens;
+      const double elapsed = std::chrono::duration<double>(now - m_LastRefill).count();
+      return std::min(m_Burst, m_Tokens + elapsed * m_Rate);
+    }
+
+    bool
+    TokenBucket::Take(llarp_time_t now)
+    {
+      m_Tokens = Available(now);
+      m_LastRefill = std::max(now, m_LastRefill);
+      if (m_Tokens < 1.0)
+        return false;
+      m_Tokens -= 1.0;
+      return true;
+    }
+
+    void
+    TokenBucket::Refund()
+    {
+      m_Tokens = std::min(m_Burst, m_Tokens + 1.0);
+    }
+
+    BuildAdmission::BuildAdmission() : m_Global{BuildRate, BuildBurst}
+    {}
+
+    bool
+    BuildAdmission::Offer(const RouterID& from, Work_t work, llarp_time_t now)
+    {
+      auto& peer = m_Peers[from];
+      peer.lastSeen = now;
+      // charge the peer first so a flooding peer can't drain the global budget, but don't
+      // bill it for a build we shed because everyone else used up the global budget
+      if (not peer.bucket.Take(now))
+      {
+        ++m_ShedRate;
+        return false;
+      }
+      if (not m_Global.Take(now))
+      {
+        peer.bucket.Refund();
+        ++m_ShedRate;
+        return false;
+      }
+      if (m_Queued >= MaxQueued and not MakeRoomFor(peer))
+      {
+        ++m_ShedQueue;
+        return false;
+      }
+      if (peer.queue.empty())
+        m_Ready.emplace_back(from);
+      peer.queue.emplace_back(std::move(work));
+      ++m_Queued;
+      ++m_Admitted;
+      return true;
+    }
+
+    bool
+    BuildAdmission::MakeRoomFor(const Peer& peer)
+    {
+      auto longest = m_Peers.end();
+      for (auto itr = m_Peers.begin(); itr != m_Peers.end(); ++itr)
+      {
+        if (longest == m_Peers.end() or itr->second.queue.size() > longest->second.queue.size())
+          longest = itr;
+      }
+      if (longest == m_Peers.end() or longest->second.queue.size() <= peer.queue.size() + 1)
+        return false;
+      longest->second.queue.pop_front();
+      --m_Queued;
+      ++m_ShedQueue;
+      return true;
+    }
+
+    std::vector<BuildAdmission::Work_t>
+    BuildAdmission::NextBatch()
+    {
+      std::vector<Work_t> batch;
+      while (batch.size() < BatchSize and not m_Ready.empty())
+      {
+        const RouterID from = m_Ready.front();
+        m_Ready.pop_front();
+        auto itr = m_Peers.find(from);
+        if (itr == m_Peers.end() or itr->second.queue.empty())
+          continue;
+        auto& queue = itr->second.queue;
+        batch.emplace_back(std::move(queue.front()));
+        queue.pop_front();
+        --m_Queued;
+        if (not queue.empty())
+          m_Ready.emplace_back(from);
+      }
+      return batch;
+    }
+
+    void
+    BuildAdmission::Decay(llarp_time_t now)
+    {
+      for (auto itr = m_Peers.begin(); itr != m_Peers.end();)
+      {
+        if (itr->second.queue.empty() and now - itr->second.lastSeen >= PeerTimeout)
+          itr = m_Peers.erase(itr);
+        else
+          ++itr;
+      }
+    }
+
+    util::StatusObject
+    BuildAdmission::ExtractStatus() const
+    {
+      return util::StatusObject{
+          {"queued", uint64_t{m_Queued}},
+          {"peers", uint64_t{m_Peers.size()}},
+          {"admitted", m_Admitted},
+          {"shedOverRate", m_ShedRate},
+          {"shedQueueFull", m_ShedQueue}};
+    }
+  }  // namespace path
+}  // namespace llarp
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <llarp/router_id.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace llarp
+{
+  namespace path
+  {
+    /// a token bucket, refills at rate tokens per second up to burst tokens
+    struct TokenBucket
+    {
+      TokenBucket(double rate, double burst);
+
+      /// take a token at time now, returns false if the bucket is empty
+      bool
+      Take(llarp_time_t now);
+
+      /// number of tokens available at time now
+      double
+      Available(llarp_time_t now) const;
+
+      /// give back a token taken for work that was then turned away elsewhere
+      void
+      Refund();
+
+     private:
+      double m_Rate;
+      double m_Burst;
+      double m_Tokens;
+      llarp_time_t m_LastRefill = 0s;
+    };
+
+    /// admission stage for transit path builds (LRCM) on relays.
+    ///
+    /// decrypting a commit record costs an x25519 dh, so we decide whether to do that work
+    /// before doing any of it.  every build is charged to the peer that sent it and to a router
+    /// wide budget; builds over either budget are shed right away.  admitted builds wait in a
+    /// queue per peer and batches are taken from the peers round robin, so one peer flooding us
+    /// with builds only delays its own.  when the queue is full the peer with the most queued
+    /// builds loses its oldest one.
+    struct BuildAdmission
+    {
+      using Work_t = std::function<void(void)>;
+
+      /// builds per second we take from a single peer
+      static constexpr double PeerBuildRate = 20.0;
+      /// how many builds a single peer may burst
+      static constexpr double PeerBuildBurst = 50.0;
+      /// builds per second we take in total
+      static constexpr double BuildRate = 1000.0;
+      /// how many builds we may burst in total
+      static constexpr double BuildBurst = 2000.0;
+      /// most builds we hold waiting on a worker
+      static constexpr size_t MaxQueued = 4096;
+      /// most builds handed to a worker in one job
+      static constexpr size_t BatchSize = 32;
+      /// forget peers we have not heard from in this long
+      static constexpr auto PeerTimeout = 1min;
+
+      BuildAdmission();
+
+      /// offer the decryption work of a build from peer, returns false if it was shed
+      bool
+      Offer(const RouterID& from, Work_t work, llarp_time_t now);
+
+      /// take up to BatchSize queued builds, one from each peer in turn
+      std::vector<Work_t>
+      NextBatch();
+
+      /// forget idle peers
+      void
+      Decay(llarp_time_t now);
+
+      /// number of builds waiting on a worker
+      size_t
+      Queued() const
+      {
+        return m_Queued;
+      }
+
+      /// number of builds shed because a peer or we were over budget
+      uint64_t
+      ShedOverRate() const
+      {
+        return m_ShedRate;
+      }
+
+      /// number of builds shed because the queue was full
+      uint64_t
+      ShedQueueFull() const
+      {
+        return m_ShedQueue;
+      }
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      struct Peer
+      {
+        Peer() : bucket{PeerBuildRate, PeerBuildBurst}
+        {}
+
+        TokenBucket bucket;
+        std::deque<Work_t> queue;
+        llarp_time_t lastSeen = 0s;
+      };
+
+      /// drop the oldest build of the peer with the most queued builds to make room for a build
+      /// from peer, returns false if peer itself is the one that should be shed
+      bool
+      MakeRoomFor(const Peer& peer);
+
+      std::unordered_map<RouterID, Peer> m_Peers;
+      /// peers with queued builds, in the order we serve them
+      std::deque<RouterID> m_Ready;
+      TokenBucket m_Global;
+      size_t m_Queued = 0;
+      uint64_t m_Admitted = 0;
+      uint64_t m_ShedRate = 0;
+      uint64_t m_ShedQueue = 0;
+    };
+  }  // namespace path
+}  // namespace llarp
@@ -9,6 +9,8 @@ namespace llarp
     bool
     IHopHandler::HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter* r)
     {
+      if (m_UpstreamQueue.empty())
+        m_UpstreamPending = trace::Stamp{};
       auto& pkt = m_UpstreamQueue.emplace_back();
       pkt.first.resize(X.sz);
       std::copy_n(X.base, X.sz, pkt.first.begin());
@@ -21,6 +23,8 @@ namespace llarp
     bool
     IHopHandler::HandleDownstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter* r)
     {
+      if (m_DownstreamQueue.empty())
+        m_DownstreamPending = trace::Stamp{};
       auto& pkt = m_DownstreamQueue.emplace_back();
       pkt.first.resize(X.sz);
       std::copy_n(X.base, X.sz, pkt.first.begin());
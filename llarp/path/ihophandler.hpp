@@ -4,6 +4,7 @@
 #include <llarp/util/types.hpp>
 #include <llarp/crypto/encrypted_frame.hpp>
 #include <llarp/util/decaying_hashset.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include <llarp/messages/relay.hpp>
 #include <vector>
 
@@ -75,6 +76,9 @@ namespace llarp
       uint64_t m_SequenceNum = 0;
       TrafficQueue_t m_UpstreamQueue;
       TrafficQueue_t m_DownstreamQueue;
+      /// when the oldest cell in each queue arrived
+      trace::Stamp m_UpstreamPending;
+      trace::Stamp m_DownstreamPending;
       util::DecayingHashSet<TunnelNonce> m_UpstreamReplayFilter;
       util::DecayingHashSet<TunnelNonce> m_DownstreamReplayFilter;
 
@@ -14,6 +14,7 @@
 #include <llarp/routing/path_latency_message.hpp>
 #include <llarp/routing/transfer_traffic_message.hpp>
 #include <llarp/util/buffer.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include <llarp/tooling/path_event.hpp>
 
 #include <oxenc/endian.h>
@@ -26,7 +27,7 @@ namespace llarp
   namespace path
   {
     Path::Path(
-        const std::vector<RouterContact>& h,
+        const std::vector<RouterContact_ptr>& h,
         std::weak_ptr<PathSet> pathset,
         PathRole startingRoles,
         std::string shortName)
@@ -37,7 +38,7 @@ namespace llarp
       size_t hsz = h.size();
       for (size_t idx = 0; idx < hsz; ++idx)
       {
-        hops[idx].rc = h[idx];
+        hops[idx].rc = *h[idx];
         do
         {
           hops[idx].txID.Randomize();
@@ -361,7 +362,8 @@ namespace llarp
           {"rxRateCurrent", m_LastRXRate},
           {"replayTX", m_UpstreamReplayFilter.Size()},
           {"replayRX", m_DownstreamReplayFilter.Size()},
-          {"hasExit", SupportsAnyRoles(ePathRoleExit)}};
+          {"hasExit", SupportsAnyRoles(ePathRoleExit)},
+          {"latency", m_Latency.ExtractStatus()}};
 
       std::vector<util::StatusObject> hopsObj;
       std::transform(
@@ -403,9 +405,9 @@ namespace llarp
     {
       if (auto parent = m_PathSet.lock())
       {
-        std::vector<RouterContact> newHops;
+        std::vector<RouterContact_ptr> newHops;
         for (const auto& hop : hops)
-          newHops.emplace_back(hop.rc);
+          newHops.emplace_back(std::make_shared<const RouterContact>(hop.rc));
         LogInfo(Name(), " rebuilding on ", ShortName());
         parent->Build(newHops);
       }
@@ -436,6 +438,9 @@ namespace llarp
 
       m_LastRXRate = m_RXRate;
       m_LastTXRate = m_TXRate;
+      if (m_LastRateTick > 0s and now > m_LastRateTick)
+        m_Latency.AddRate(m_RXRate * 1000 / (now - m_LastRateTick).count());
+      m_LastRateTick = now;
 
       m_RXRate = 0;
       m_TXRate = 0;
@@ -464,9 +469,14 @@ namespace llarp
         {
           SendLatencyMessage(r);
           // latency test FEC
-          r->loop()->call_later(2s, [self = shared_from_this(), r]() {
-            if (self->m_LastLatencyTestID)
+          const auto probe = m_LastLatencyTestID;
+          r->loop()->call_later(m_Latency.ProbeTimeout(), [self = shared_from_this(), r, probe]() {
+            if (probe and self->m_LastLatencyTestID == probe)
+            {
+              // no reply to the first probe yet, count it as lost
+              self->m_Latency.MarkLost();
               self->SendLatencyMessage(r);
+            }
           });
           return;
         }
@@ -532,9 +542,15 @@ namespace llarp
     {
       if (not m_UpstreamQueue.empty())
       {
+        m_UpstreamPending.Record(trace::Stage::RelayCellPending);
         r->QueueWork([self = shared_from_this(),
                       data = std::exchange(m_UpstreamQueue, {}),
-                      r]() mutable { self->UpstreamWork(std::move(data), r); });
+                      r,
+                      queued = trace::Stamp{}]() mutable {
+          queued.Lap(trace::Stage::RelayCryptoQueue);
+          self->UpstreamWork(std::move(data), r);
+          queued.Record(trace::Stage::RelayCrypto);
+        });
       }
     }
 
@@ -543,9 +559,15 @@ namespace llarp
     {
       if (not m_DownstreamQueue.empty())
       {
+        m_DownstreamPending.Record(trace::Stage::RelayCellPending);
         r->QueueWork([self = shared_from_this(),
                       data = std::exchange(m_DownstreamQueue, {}),
-                      r]() mutable { self->DownstreamWork(std::move(data), r); });
+                      r,
+                      queued = trace::Stamp{}]() mutable {
+          queued.Lap(trace::Stage::RelayCryptoQueue);
+          self->DownstreamWork(std::move(data), r);
+          queued.Record(trace::Stage::RelayCrypto);
+        });
       }
     }
 
@@ -728,33 +750,17 @@ namespace llarp
       return false;
     }
 
-    template <typename Samples_t>
-    static llarp_time_t
-    computeLatency(const Samples_t& samps)
-    {
-      llarp_time_t mean = 0s;
-      if (samps.empty())
-        return mean;
-      for (const auto& samp : samps)
-        mean += samp;
-      return mean / samps.size();
-    }
-
-    constexpr auto MaxLatencySamples = 8;
-
     bool
-    Path::HandlePathLatencyMessage(const routing::PathLatencyMessage&, AbstractRouter* r)
+    Path::HandlePathLatencyMessage(const routing::PathLatencyMessage& msg, AbstractRouter* r)
     {
       const auto now = r->Now();
       MarkActive(now);
-      if (m_LastLatencyTestID)
+      // only time replies to the probe we have out, a late reply to one we gave up on would
+      // count the resend's wait as rtt
+      if (m_LastLatencyTestID and msg.L == m_LastLatencyTestID)
       {
-        m_LatencySamples.emplace_back(now - m_LastLatencyTestTime);
-
-        while (m_LatencySamples.size() > MaxLatencySamples)
-          m_LatencySamples.pop_front();
-
-        intro.latency = computeLatency(m_LatencySamples);
+        m_Latency.AddSample(now - m_LastLatencyTestTime);
+        intro.latency = std::max(m_Latency.RTT(), 1ms);
         m_LastLatencyTestID = 0;
         EnterState(ePathEstablished, now);
         if (m_BuiltHook)
@@ -5,6 +5,7 @@
 #include <llarp/crypto/types.hpp>
 #include <llarp/messages/relay.hpp>
 #include "ihophandler.hpp"
+#include "path_latency.hpp"
 #include "path_types.hpp"
 #include "pathbuilder.hpp"
 #include "pathset.hpp"
@@ -94,7 +95,7 @@ namespace llarp
       llarp_time_t buildStarted = 0s;
 
       Path(
-          const std::vector<RouterContact>& routers,
+          const std::vector<RouterContact_ptr>& routers,
           std::weak_ptr<PathSet> parent,
           PathRole startingRoles,
           std::string shortName);
@@ -201,6 +202,20 @@ namespace llarp
         return _status;
       }
 
+      /// measured rtt / jitter / loss of this path
+      const LatencyEstimator&
+      Latency() const
+      {
+        return m_Latency;
+      }
+
+      /// relative weight of this path for load spreading, 0 if unmeasured
+      double
+      SelectionWeight() const
+      {
+        return m_Latency.Weight();
+      }
+
       // handle data in upstream direction
       bool
       HandleUpstream(const llarp_buffer_t& X, const TunnelNonce& Y, AbstractRouter*) override;
@@ -427,7 +442,8 @@ namespace llarp
       uint64_t m_RXRate = 0;
       uint64_t m_LastTXRate = 0;
       uint64_t m_TXRate = 0;
-      std::deque<llarp_time_t> m_LatencySamples;
+      llarp_time_t m_LastRateTick = 0s;
+      LatencyEstimator m_Latency;
       const std::string m_shortName;
     };
   }  // namespace path
@@ -5,11 +5,16 @@
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/router/i_outbound_message_handler.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace llarp
 {
   namespace path
   {
     static constexpr auto DefaultPathBuildLimit = 500ms;
+    /// most path build key exchanges we do in one worker job
+    static constexpr size_t BuildBatchSize = 16;
 
     PathContext::PathContext(AbstractRouter* router)
         : m_Router(router), m_AllowTransit(false), m_PathLimits(DefaultPathBuildLimit)
@@ -42,6 +47,72 @@ namespace llarp
 #endif
     }
 
+    void
+    PathContext::QueueBuildWork(std::function<void(void)> work)
+    {
+      const bool first = m_PendingBuildWork.empty();
+      m_PendingBuildWork.emplace_back(std::move(work));
+      if (first)
+        loop()->call_soon([this]() { FlushBuildWork(); });
+    }
+
+    void
+    PathContext::FlushBuildWork()
+    {
+      auto pending = std::move(m_PendingBuildWork);
+      m_PendingBuildWork.clear();
+      // split into batches so a burst of builds still spreads over several workers
+      for (auto itr = pending.begin(); itr != pending.end();)
+      {
+        const auto end = itr + std::min<std::ptrdiff_t>(BuildBatchSize, pending.end() - itr);
+        std::vector<std::function<void(void)>> batch{
+            std::make_move_iterator(itr), std::make_move_iterator(end)};
+        m_Router->QueueWork([batch = std::move(batch)]() {
+          for (const auto& work : batch)
+            work();
+        });
+        itr = end;
+      }
+    }
+
+    bool
+    PathContext::AdmitTransitBuild(const RouterID& from, std::function<void(void)> work)
+    {
+      if (not m_BuildAdmission.Offer(from, std::move(work), m_Router->Now()))
+        return false;
+      PumpTransitBuilds();
+      return true;
+    }
+
+    void
+    PathContext::PumpTransitBuilds()
+    {
+      // keep the backlog here rather than on the worker pool so we decide the order it runs in
+      while (m_TransitBuildBatches < MaxTransitBuildBatches)
+      {
+        auto batch = m_BuildAdmission.NextBatch();
+        if (batch.empty())
+          return;
+        ++m_TransitBuildBatches;
+        m_Router->QueueWork([this, batch = std::move(batch)]() {
+          for (const auto& work : batch)
+            work();
+          loop()->call([this]() {
+            --m_TransitBuildBatches;
+            PumpTransitBuilds();
+          });
+        });
+      }
+    }
+
+    util::StatusObject
+    PathContext::ExtractStatus() const
+    {
+      auto obj = m_BuildAdmission.ExtractStatus();
+      obj["batchesInFlight"] = uint64_t{m_TransitBuildBatches};
+      return obj;
+    }
+
     const EventLoop_ptr&
     PathContext::loop()
     {
@@ -349,6 +420,7 @@ namespace llarp
     {
       // decay limits
       m_PathLimits.Decay(now);
+      m_BuildAdmission.Decay(now);
 
       {
         SyncTransitMap_t::Lock_t lock(m_TransitPaths.first);
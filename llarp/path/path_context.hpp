@@ -2,6 +2,7 @@
 
 #include <llarp/crypto/encrypted_frame.hpp>
 #include <llarp/net/ip_address.hpp>
+#include "build_admission.hpp"
 #include "ihophandler.hpp"
 #include "path_types.hpp"
 #include "pathset.hpp"
@@ -12,8 +13,10 @@
 #include <llarp/util/decaying_hashset.hpp>
 #include <llarp/util/types.hpp>
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -53,6 +56,16 @@ namespace llarp
       bool
       CheckPathLimitHitByIP(const IpAddress& ip);
 
+      /// offer the decryption of a transit path build we got from a peer to the admission
+      /// queue, it is run in a worker batched with other builds unless it gets shed.
+      /// returns false if it was shed.  must be called from the event loop.
+      bool
+      AdmitTransitBuild(const RouterID& from, std::function<void(void)> work);
+
+      /// status of the transit build admission queue
+      util::StatusObject
+      ExtractStatus() const;
+
       bool
       AllowingTransit() const;
 
@@ -177,12 +190,32 @@ namespace llarp
       uint64_t
       CurrentOwnedPaths(path::PathStatus status = path::PathStatus::ePathEstablished);
 
+      /// queue the key exchange of a path build to run in a worker.  builds queued in the same
+      /// event loop cycle are batched together so that many builds cost a handful of worker jobs
+      /// instead of one job per build.  must be called from the event loop.
+      void
+      QueueBuildWork(std::function<void(void)> work);
+
      private:
+      /// most batches of transit build decryption we have on the worker pool at once
+      static constexpr size_t MaxTransitBuildBatches = 4;
+
+      /// hand all queued build work to the worker pool
+      void
+      FlushBuildWork();
+
+      /// hand admitted transit builds to the worker pool
+      void
+      PumpTransitBuilds();
+
       AbstractRouter* m_Router;
+      std::vector<std::function<void(void)>> m_PendingBuildWork;
       SyncTransitMap_t m_TransitPaths;
       SyncOwnedPathsMap_t m_OurPaths;
       bool m_AllowTransit;
       util::DecayingHashSet<IpAddress> m_PathLimits;
+      BuildAdmission m_BuildAdmission;
+      size_t m_TransitBuildBatches = 0;
     };
   }  // namespace path
 }  // namespace llarp
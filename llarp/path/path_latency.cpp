@@ -0,0 +1,86 @@
+#include "path_latency.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace llarp
+{
+  namespace path
+  {
+    void
+    LatencyEstimator::AddSample(llarp_time_t rtt)
+    {
+      const double sample = rtt.count();
+      if (m_Samples == 0)
+      {
+        m_SRTT = sample;
+        m_RTTVar = sample / 2.0;
+      }
+      else
+      {
+        m_RTTVar = (1.0 - JitterGain) * m_RTTVar + JitterGain * std::abs(m_SRTT - sample);
+        m_SRTT = (1.0 - RTTGain) * m_SRTT + RTTGain * sample;
+      }
+      m_Loss *= (1.0 - LossGain);
+      ++m_Samples;
+    }
+
+    void
+    LatencyEstimator::MarkLost()
+    {
+      m_Loss = (1.0 - LossGain) * m_Loss + LossGain;
+    }
+
+    void
+    LatencyEstimator::AddRate(uint64_t bytesPerSecond)
+    {
+      m_Capacity = std::max(static_cast<double>(bytesPerSecond), m_Capacity * CapacityDecay);
+    }
+
+    llarp_time_t
+    LatencyEstimator::ProbeTimeout() const
+    {
+      if (m_Samples == 0)
+        return DefaultProbeTimeout;
+      return std::clamp(RTT() + 4 * Jitter(), MinProbeTimeout, MaxProbeTimeout);
+    }
+
+    llarp_time_t
+    LatencyEstimator::RTT() const
+    {
+      return llarp_time_t{static_cast<int64_t>(std::lround(m_SRTT))};
+    }
+
+    llarp_time_t
+    LatencyEstimator::Jitter() const
+    {
+      return llarp_time_t{static_cast<int64_t>(std::lround(m_RTTVar))};
+    }
+
+    double
+    LatencyEstimator::Weight() const
+    {
+      if (m_Samples == 0)
+        return 0.0;
+      // a conservative rtt bound (srtt + 2 * rttvar) so that jittery paths get less traffic, scaled
+      // down by the fraction of traffic we expect to actually arrive.  paths that have carried
+      // more get up to twice the weight; unproven ones keep their latency weight so they still
+      // get traffic to show what they can carry.
+      const double bound = std::max(1.0, m_SRTT + 2.0 * m_RTTVar);
+      const double capacity = 1.0 + std::min(1.0, m_Capacity / CapacityReference);
+      return (1.0 - m_Loss) * capacity * 1000.0 / bound;
+    }
+
+    util::StatusObject
+    LatencyEstimator::ExtractStatus() const
+    {
+      return util::StatusObject{
+          {"rtt", to_json(RTT())},
+          {"jitter", to_json(Jitter())},
+          {"loss", m_Loss},
+          {"capacity", m_Capacity},
+          {"samples", m_Samples},
+          {"weight", Weight()}};
+    }
+  }  // namespace path
+}  // namespace llarp
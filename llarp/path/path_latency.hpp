@@ -0,0 +1,93 @@
+#pragma once
+
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+namespace llarp
+{
+  namespace path
+  {
+    /// smoothed round trip time, jitter, loss and capacity tracking for a single path.
+    /// rtt and jitter use the rfc 6298 estimator (srtt / rttvar), loss is an ewma over latency
+    /// probes that went unanswered and capacity is the decaying peak of the rate we received at.
+    struct LatencyEstimator
+    {
+      /// gain for srtt updates
+      static constexpr double RTTGain = 1.0 / 8.0;
+      /// gain for rttvar (jitter) updates
+      static constexpr double JitterGain = 1.0 / 4.0;
+      /// gain for loss ratio updates
+      static constexpr double LossGain = 1.0 / 8.0;
+      /// how much of the peak rate survives each rate sample that doesn't beat it
+      static constexpr double CapacityDecay = 0.95;
+      /// received bytes/sec at which a path gets the full capacity bonus in Weight()
+      static constexpr double CapacityReference = 1024.0 * 1024.0;
+      /// how long to wait for a probe reply before we have any rtt samples
+      static constexpr llarp_time_t DefaultProbeTimeout = 2s;
+      /// bounds on the probe timeout once we have rtt samples
+      static constexpr llarp_time_t MinProbeTimeout = 1s;
+      static constexpr llarp_time_t MaxProbeTimeout = 10s;
+
+      /// add an rtt sample from a reply we got
+      void
+      AddSample(llarp_time_t rtt);
+
+      /// record that a probe we sent got no reply
+      void
+      MarkLost();
+
+      /// add the rate in bytes/sec we received at over the last tick
+      void
+      AddRate(uint64_t bytesPerSecond);
+
+      /// how long to wait for a probe reply before counting it lost: srtt + 4 * rttvar like an
+      /// rfc 6298 rto, so slow paths aren't marked lossy just for being slow
+      llarp_time_t
+      ProbeTimeout() const;
+
+      /// smoothed round trip time, 0s if we have no samples yet
+      llarp_time_t
+      RTT() const;
+
+      /// smoothed rtt variance
+      llarp_time_t
+      Jitter() const;
+
+      /// estimated fraction of probes lost in [0.0, 1.0]
+      double
+      LossRatio() const
+      {
+        return m_Loss;
+      }
+
+      /// number of rtt samples we have taken
+      uint64_t
+      Samples() const
+      {
+        return m_Samples;
+      }
+
+      /// decaying peak of the received rate in bytes/sec
+      double
+      Capacity() const
+      {
+        return m_Capacity;
+      }
+
+      /// relative capacity of this path for weighted selection, higher is better.
+      /// returns 0 if we have never measured this path.
+      double
+      Weight() const;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      double m_SRTT = 0.0;
+      double m_RTTVar = 0.0;
+      double m_Loss = 0.0;
+      double m_Capacity = 0.0;
+      uint64_t m_Samples = 0;
+    };
+  }  // namespace path
+}  // namespace llarp
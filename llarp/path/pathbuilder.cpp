@@ -33,21 +33,20 @@ namespace llarp
     using Handler = std::function<void(std::shared_ptr<AsyncPathKeyExchangeContext>)>;
 
     Handler result;
-    size_t idx = 0;
     AbstractRouter* router = nullptr;
-    WorkerFunc_t work;
     EventLoop_ptr loop;
     LR_CommitMessage LRCM;
+    /// set if key exchange for every hop went through
+    bool ok = false;
 
-    void
-    GenerateNextKey()
+    /// generate the keys for and encrypt the commit record of hop idx
+    bool
+    GenerateKey(size_t idx, Crypto* crypto)
     {
       // current hop
       auto& hop = path->hops[idx];
       auto& frame = LRCM.frames[idx];
 
-      auto crypto = CryptoManager::instance();
-
       // generate key
       crypto->encryption_keygen(hop.commkey);
       hop.nonce.Randomize();
@@ -55,13 +54,12 @@ namespace llarp
       if (!crypto->dh_client(hop.shared, hop.rc.enckey, hop.commkey, hop.nonce))
       {
         LogError(pathset->Name(), " Failed to generate shared key for path build");
-        return;
+        return false;
       }
       // generate nonceXOR valueself->hop->pathKey
       crypto->shorthash(hop.nonceXOR, llarp_buffer_t(hop.shared));
-      ++idx;
 
-      bool isFarthestHop = idx == path->hops.size();
+      const bool isFarthestHop = idx + 1 == path->hops.size();
 
       LR_CommitRecord record;
       if (isFarthestHop)
@@ -70,8 +68,8 @@ namespace llarp
       }
       else
       {
-        hop.upstream = path->hops[idx].rc.pubkey;
-        record.nextRC = std::make_unique<RouterContact>(path->hops[idx].rc);
+        hop.upstream = path->hops[idx + 1].rc.pubkey;
+        record.nextRC = std::make_unique<RouterContact>(path->hops[idx + 1].rc);
       }
       // build record
       record.lifetime = path::default_lifetime;
@@ -90,7 +88,7 @@ namespace llarp
         // failed to encode?
         LogError(pathset->Name(), " Failed to generate Commit Record");
         DumpBuffer(buf);
-        return;
+        return false;
       }
       // use ephemeral keypair for frame
       SecretKey framekey;
@@ -98,23 +96,24 @@ namespace llarp
       if (!frame.EncryptInPlace(framekey, hop.rc.enckey))
       {
         LogError(pathset->Name(), " Failed to encrypt LRCR");
-        return;
+        return false;
       }
+      return true;
+    }
 
-      if (isFarthestHop)
-      {
-        // farthest hop
-        // TODO: encrypt junk frames because our public keys are not eligator
-        loop->call([self = shared_from_this()] {
-          self->result(self);
-          self->result = nullptr;
-        });
-      }
-      else
-      {
-        // next hop
-        work([self = shared_from_this()] { self->GenerateNextKey(); });
-      }
+    /// generate the keys for every hop in one go, runs in a worker
+    void
+    GenerateKeys()
+    {
+      auto crypto = CryptoManager::instance();
+      ok = true;
+      for (size_t idx = 0; ok and idx < path->hops.size(); ++idx)
+        ok = GenerateKey(idx, crypto);
+      // TODO: encrypt junk frames because our public keys are not eligator
+      loop->call([self = shared_from_this()] {
+        self->result(self);
+        self->result = nullptr;
+      });
     }
 
     /// Generate all keys asynchronously and call handler when done
@@ -124,20 +123,19 @@ namespace llarp
       path = p;
       loop = std::move(l);
       result = func;
-      work = worker;
 
       for (size_t i = 0; i < path::max_len; ++i)
       {
         LRCM.frames[i].Randomize();
       }
-      work([self = shared_from_this()] { self->GenerateNextKey(); });
+      worker([self = shared_from_this()] { self->GenerateKeys(); });
     }
   };
 
   static void
   PathBuilderKeysGenerated(std::shared_ptr<AsyncPathKeyExchangeContext> ctx)
   {
-    if (ctx->pathset->IsStopped())
+    if (ctx->pathset->IsStopped() or not ctx->ok)
       return;
 
     ctx->router->NotifyRouterEvent<tooling::PathAttemptEvent>(ctx->router->pubkey(), ctx->path);
@@ -224,6 +222,7 @@ namespace llarp
     {
       util::StatusObject obj{
           {"buildStats", m_BuildStats.ExtractStatus()},
+          {"buildsInFlight", uint64_t{NumBuildsInFlight()}},
           {"numHops", uint64_t{numHops}},
           {"numPaths", uint64_t{numDesiredPaths}}};
       std::transform(
@@ -234,36 +233,37 @@ namespace llarp
       return obj;
     }
 
-    std::optional<RouterContact>
+    RouterContact_ptr
     Builder::SelectFirstHop(const std::set<RouterID>& exclude) const
     {
-      std::optional<RouterContact> found = std::nullopt;
+      RouterContact_ptr found;
       m_router->ForEachPeer(
           [&](const ILinkSession* s, bool isOutbound) {
-            if (s && s->IsEstablished() && isOutbound && not found.has_value())
+            if (s && s->IsEstablished() && isOutbound && not found)
             {
-              const RouterContact rc = s->GetRemoteRC();
+              const RouterID pubkey{s->GetPubKey()};
 #ifndef TESTNET
-              if (m_router->IsBootstrapNode(rc.pubkey))
+              if (m_router->IsBootstrapNode(pubkey))
                 return;
 #endif
-              if (exclude.count(rc.pubkey))
+              if (exclude.count(pubkey))
                 return;
 
-              if (BuildCooldownHit(rc.pubkey))
+              if (BuildCooldownHit(pubkey))
                 return;
 
-              if (m_router->routerProfiling().IsBadForPath(rc.pubkey))
+              if (m_router->routerProfiling().IsBadForPath(pubkey))
                 return;
 
-              found = rc;
+              // only the peer we pick gets its rc copied
+              found = std::make_shared<const RouterContact>(s->GetRemoteRC());
             }
           },
           true);
       return found;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Builder::GetHopsForBuild()
     {
       auto filter = [r = m_router](const auto& rc) -> bool {
@@ -316,7 +316,16 @@ namespace llarp
     bool
     Builder::BuildCooldownHit(llarp_time_t now) const
     {
-      return now < lastBuild + buildIntervalLimit;
+      // only space out builds while backing off
+      if (buildIntervalLimit > PATH_BUILD_RATE and now < lastBuild + buildIntervalLimit)
+        return true;
+      return NumBuildsInFlight() >= MAX_CONCURRENT_BUILDS;
+    }
+
+    size_t
+    Builder::NumBuildsInFlight() const
+    {
+      return m_PendingBuilds + NumInStatus(ePathBuilding);
     }
 
     bool
@@ -342,28 +351,22 @@ namespace llarp
       return buildIntervalLimit > MIN_PATH_BUILD_INTERVAL * 4;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Builder::GetHopsAlignedToForBuild(RouterID endpoint, const std::set<RouterID>& exclude)
     {
-      const auto pathConfig = m_router->GetConfig()->paths;
-
-      std::vector<RouterContact> hops;
-      {
-        const auto maybe = SelectFirstHop(exclude);
-        if (not maybe.has_value())
-        {
-          log::warning(log_path, "{} has no first hop candidate", Name());
-          return std::nullopt;
-        }
-        hops.emplace_back(*maybe);
-      };
+      const auto& pathConfig = m_router->GetConfig()->paths;
 
-      RouterContact endpointRC;
-      if (const auto maybe = m_router->nodedb()->Get(endpoint))
+      std::vector<RouterContact_ptr> hops;
+      if (auto first = SelectFirstHop(exclude))
+        hops.emplace_back(std::move(first));
+      else
       {
-        endpointRC = *maybe;
+        log::warning(log_path, "{} has no first hop candidate", Name());
+        return std::nullopt;
       }
-      else
+
+      const auto endpointRC = m_router->nodedb()->Get(endpoint);
+      if (not endpointRC)
         return std::nullopt;
 
       for (size_t idx = hops.size(); idx < numHops; ++idx)
@@ -374,33 +377,34 @@ namespace llarp
         }
         else
         {
-          auto filter =
-              [&hops, r = m_router, endpointRC, pathConfig, exclude](const auto& rc) -> bool {
+          // runs for every candidate the nodedb tries, so it only looks at the shared rcs
+          auto filter = [&hops, r = m_router, &endpointRC, &pathConfig, &exclude](
+                            const auto& rc) -> bool {
             if (exclude.count(rc.pubkey))
               return false;
 
-            std::set<RouterContact> hopsSet;
-            hopsSet.insert(endpointRC);
-            hopsSet.insert(hops.begin(), hops.end());
-
             if (r->routerProfiling().IsBadForPath(rc.pubkey, 1))
               return false;
-            for (const auto& hop : hopsSet)
+            if (rc.pubkey == endpointRC->pubkey)
+              return false;
+            for (const auto& hop : hops)
             {
-              if (hop.pubkey == rc.pubkey)
+              if (hop->pubkey == rc.pubkey)
                 return false;
             }
 
-            hopsSet.insert(rc);
 #ifndef TESTNET
+            std::vector<const RouterContact*> hopsSet{endpointRC.get(), &rc};
+            for (const auto& hop : hops)
+              hopsSet.push_back(hop.get());
             if (not pathConfig.Acceptable(hopsSet))
               return false;
 #endif
-            return rc.pubkey != endpointRC.pubkey;
+            return true;
           };
 
-          if (const auto maybe = m_router->nodedb()->GetRandom(filter))
-            hops.emplace_back(*maybe);
+          if (auto rc = m_router->nodedb()->GetRandom(filter))
+            hops.emplace_back(std::move(rc));
           else
             return std::nullopt;
         }
@@ -427,12 +431,12 @@ namespace llarp
     }
 
     void
-    Builder::Build(std::vector<RouterContact> hops, PathRole roles)
+    Builder::Build(std::vector<RouterContact_ptr> hops, PathRole roles)
     {
       if (IsStopped())
         return;
       lastBuild = Now();
-      const RouterID edge{hops[0].pubkey};
+      const RouterID edge{hops[0]->pubkey};
       if (not m_router->pathBuildLimiter().Attempt(edge))
       {
         LogWarn(Name(), " building too fast to edge router ", edge);
@@ -449,11 +453,15 @@ namespace llarp
       LogInfo(Name(), " build ", path->ShortName(), ": ", path->HopsString());
 
       path->SetBuildResultHook([self](Path_ptr p) { self->HandlePathBuilt(p); });
+      ++m_PendingBuilds;
       ctx->AsyncGenerateKeys(
           path,
           m_router->loop(),
-          [r = m_router](auto func) { r->QueueWork(std::move(func)); },
-          &PathBuilderKeysGenerated);
+          [r = m_router](auto func) { r->pathContext().QueueBuildWork(std::move(func)); },
+          [this, self](auto ctx) {
+            --m_PendingBuilds;
+            PathBuilderKeysGenerated(std::move(ctx));
+          });
     }
 
     void
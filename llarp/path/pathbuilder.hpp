@@ -14,6 +14,9 @@ namespace llarp
     // milliseconds waiting between builds on a path per router
     static constexpr auto MIN_PATH_BUILD_INTERVAL = 500ms;
     static constexpr auto PATH_BUILD_RATE = 100ms;
+    /// how many builds a path builder may have in flight at once, counting builds waiting on
+    /// key exchange and builds waiting on the remote
+    static constexpr size_t MAX_CONCURRENT_BUILDS = 4;
 
     /// limiter for path builds
     /// prevents overload and such
@@ -56,12 +59,15 @@ namespace llarp
       void
       DoPathBuildBackoff();
 
+      /// builds that are waiting on key exchange in a worker
+      size_t m_PendingBuilds = 0;
+
      public:
       AbstractRouter* const m_router;
       SecretKey enckey;
       size_t numHops;
       llarp_time_t lastBuild = 0s;
-      llarp_time_t buildIntervalLimit = MIN_PATH_BUILD_INTERVAL;
+      llarp_time_t buildIntervalLimit = PATH_BUILD_RATE;
 
       /// construct
       Builder(AbstractRouter* p_router, size_t numDesiredPaths, size_t numHops);
@@ -81,10 +87,16 @@ namespace llarp
       void
       ResetInternalState() override;
 
-      /// return true if we hit our soft limit for building paths too fast
+      /// return true if we hit our soft limit for building paths too fast, builds are only spaced
+      /// out in time while we are backing off from failed builds, otherwise we are limited by the
+      /// number of builds in flight
       bool
       BuildCooldownHit(llarp_time_t now) const;
 
+      /// number of builds we started that have not yet succeeded or failed
+      size_t
+      NumBuildsInFlight() const;
+
       /// get roles for this path builder
       virtual PathRole
       GetRoles() const
@@ -119,17 +131,17 @@ namespace llarp
       bool
       BuildOneAlignedTo(const RouterID endpoint) override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsAlignedToForBuild(RouterID endpoint, const std::set<RouterID>& exclude = {});
 
       void
-      Build(std::vector<RouterContact> hops, PathRole roles = ePathRoleAny) override;
+      Build(std::vector<RouterContact_ptr> hops, PathRole roles = ePathRoleAny) override;
 
-      /// pick a first hop
-      std::optional<RouterContact>
+      /// pick a first hop, or nullptr if no peer will do
+      RouterContact_ptr
       SelectFirstHop(const std::set<RouterID>& exclude = {}) const;
 
-      virtual std::optional<std::vector<RouterContact>>
+      virtual std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
       void
@@ -4,13 +4,33 @@
 #include "path.hpp"
 #include <llarp/routing/dht_message.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/crypto/crypto.hpp>
 
+#include <algorithm>
 #include <random>
 
 namespace llarp
 {
   namespace path
   {
+    /// weight given to a ready path we have no latency samples for yet, so it still gets probed
+    static constexpr double UnmeasuredPathWeight = 0.01;
+
+    /// pick one of the paths at random with probability proportional to their selection weight
+    static Path_ptr
+    PickWeighted(const std::vector<Path_ptr>& paths)
+    {
+      if (paths.empty())
+        return nullptr;
+      std::vector<double> weights;
+      weights.reserve(paths.size());
+      for (const auto& path : paths)
+        weights.push_back(std::max(path->SelectionWeight(), UnmeasuredPathWeight));
+      std::discrete_distribution<size_t> dist{weights.begin(), weights.end()};
+      CSRNG rng{};
+      return paths[dist(rng)];
+    }
+
     PathSet::PathSet(size_t num) : numDesiredPaths(num)
     {}
 
@@ -222,6 +242,20 @@ namespace llarp
       return chosen[idx];
     }
 
+    Path_ptr
+    PathSet::GetWeightedPathByRouter(RouterID id, PathRole roles) const
+    {
+      Lock_t l(m_PathsMutex);
+      std::vector<Path_ptr> chosen;
+      for (const auto& item : m_Paths)
+      {
+        if (item.second->IsReady() and item.second->SupportsAnyRoles(roles)
+            and item.second->Endpoint() == id)
+          chosen.emplace_back(item.second);
+      }
+      return PickWeighted(chosen);
+    }
+
     Path_ptr
     PathSet::GetByEndpointWithID(RouterID ep, PathID_t id) const
     {
@@ -299,6 +333,17 @@ namespace llarp
       }
     }
 
+    bool
+    PathSet::AdoptPath(Path_ptr path)
+    {
+      if (not path or not path->IsReady())
+        return false;
+      path->m_PathSet = GetWeak();
+      AddPath(path);
+      HandlePathBuilt(path);
+      return true;
+    }
+
     Path_ptr
     PathSet::GetByUpstream(RouterID remote, PathID_t rxid) const
     {
@@ -423,6 +468,19 @@ namespace llarp
       return nullptr;
     }
 
+    Path_ptr
+    PathSet::PickWeightedEstablishedPath(PathRole roles) const
+    {
+      std::vector<Path_ptr> established;
+      Lock_t l(m_PathsMutex);
+      for (const auto& item : m_Paths)
+      {
+        if (item.second->IsReady() and item.second->SupportsAnyRoles(roles))
+          established.push_back(item.second);
+      }
+      return PickWeighted(established);
+    }
+
     Path_ptr
     PathSet::PickEstablishedPath(PathRole roles) const
     {
@@ -2,6 +2,7 @@
 
 #include "path_types.hpp"
 #include "service/protocol_type.hpp"
+#include <llarp/router_contact.hpp>
 #include <llarp/router_id.hpp>
 #include <llarp/routing/message.hpp>
 #include <llarp/service/intro_set.hpp>
@@ -120,7 +121,7 @@ namespace llarp
 
       /// manual build on these hops
       virtual void
-      Build(std::vector<RouterContact> hops, PathRole roles = ePathRoleAny) = 0;
+      Build(std::vector<RouterContact_ptr> hops, PathRole roles = ePathRoleAny) = 0;
 
       /// tick owned paths
       virtual void
@@ -152,6 +153,11 @@ namespace llarp
       void
       AddPath(Path_ptr path);
 
+      /// take over an established path that was built by another path set.
+      /// the caller must have removed it from its previous owner already.
+      bool
+      AdoptPath(Path_ptr path);
+
       Path_ptr
       GetByUpstream(RouterID remote, PathID_t rxid) const;
 
@@ -248,6 +254,11 @@ namespace llarp
       Path_ptr
       PickRandomEstablishedPath(PathRole roles = ePathRoleAny) const;
 
+      /// pick a ready path at random, weighted by its measured rtt, jitter and loss so that load
+      /// is spread over all paths in proportion to how well they perform
+      Path_ptr
+      PickWeightedEstablishedPath(PathRole roles = ePathRoleAny) const;
+
       Path_ptr
       GetPathByRouter(RouterID router, PathRole roles = ePathRoleAny) const;
 
@@ -257,6 +268,10 @@ namespace llarp
       Path_ptr
       GetRandomPathByRouter(RouterID router, PathRole roles = ePathRoleAny) const;
 
+      /// like PickWeightedEstablishedPath but only considers paths ending at router
+      Path_ptr
+      GetWeightedPathByRouter(RouterID router, PathRole roles = ePathRoleAny) const;
+
       Path_ptr
       GetPathByID(PathID_t id) const;
 
@@ -283,7 +298,7 @@ namespace llarp
       virtual void
       SendPacketToRemote(const llarp_buffer_t& pkt, service::ProtocolType t) = 0;
 
-      virtual std::optional<std::vector<RouterContact>>
+      virtual std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() = 0;
 
       void
@@ -14,13 +14,50 @@
 #include <llarp/routing/path_transfer_message.hpp>
 #include <llarp/routing/handler.hpp>
 #include <llarp/util/buffer.hpp>
+#include <llarp/util/latency_trace.hpp>
+#include <llarp/util/metrics.hpp>
 
 #include <oxenc/endian.h>
 namespace llarp
 {
   namespace path
   {
-    
+    namespace
+    {
+      /// traffic relayed by transit hops, for the metrics registry
+      struct RelayMetrics
+      {
+        metrics::Counter& upstreamMessages;
+        metrics::Counter& upstreamBytes;
+        metrics::Counter& downstreamMessages;
+        metrics::Counter& downstreamBytes;
+      };
+
+      RelayMetrics&
+      Metrics()
+      {
+        auto& reg = metrics::Registry::Global();
+        static RelayMetrics m{
+            reg.GetCounter(
+                "belnet_transit_relayed_messages_total",
+                "messages relayed by transit hops",
+                {{"direction", "upstream"}}),
+            reg.GetCounter(
+                "belnet_transit_relayed_bytes_total",
+                "bytes relayed by transit hops",
+                {{"direction", "upstream"}}),
+            reg.GetCounter(
+                "belnet_transit_relayed_messages_total",
+                "messages relayed by transit hops",
+                {{"direction", "downstream"}}),
+            reg.GetCounter(
+                "belnet_transit_relayed_bytes_total",
+                "bytes relayed by transit hops",
+                {{"direction", "downstream"}}),
+        };
+        return m;
+      }
+    }  // namespace
 
     std::string
     TransitHopInfo::ToString() const
@@ -199,6 +236,8 @@ namespace llarp
               " to ",
               info.upstream);
           r->SendToOrQueue(info.upstream, msg);
+          Metrics().upstreamMessages.Inc();
+          Metrics().upstreamBytes.Inc(msg.X.size());
         }
       }
       r->TriggerPump();
@@ -217,6 +256,8 @@ namespace llarp
             " to ",
             info.downstream);
         r->SendToOrQueue(info.downstream, msg);
+        Metrics().downstreamMessages.Inc();
+        Metrics().downstreamBytes.Inc(msg.X.size());
       }
       r->TriggerPump();
     }
@@ -226,9 +267,15 @@ namespace llarp
     {
       if (not m_UpstreamQueue.empty())
       {
+        m_UpstreamPending.Record(trace::Stage::RelayCellPending);
         r->QueueWork([self = shared_from_this(),
                       data = std::exchange(m_UpstreamQueue, {}),
-                      r]() mutable { self->UpstreamWork(std::move(data), r); });
+                      r,
+                      queued = trace::Stamp{}]() mutable {
+          queued.Lap(trace::Stage::RelayCryptoQueue);
+          self->UpstreamWork(std::move(data), r);
+          queued.Record(trace::Stage::RelayCrypto);
+        });
       }
     }
 
@@ -237,9 +284,15 @@ namespace llarp
     {
       if (not m_DownstreamQueue.empty())
       {
+        m_DownstreamPending.Record(trace::Stage::RelayCellPending);
         r->QueueWork([self = shared_from_this(),
                       data = std::exchange(m_DownstreamQueue, {}),
-                      r]() mutable { self->DownstreamWork(std::move(data), r); });
+                      r,
+                      queued = trace::Stamp{}]() mutable {
+          queued.Lap(trace::Stage::RelayCryptoQueue);
+          self->DownstreamWork(std::move(data), r);
+          queued.Record(trace::Stage::RelayCrypto);
+        });
       }
     }
 
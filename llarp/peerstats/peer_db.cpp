@@ -4,6 +4,8 @@
 #include <llarp/util/status.hpp>
 #include <llarp/util/str.hpp>
 
+#include <thread>
+
 namespace llarp
 {
 
@@ -23,6 +25,12 @@ namespace llarp
       throw std::runtime_error("Reloading database not supported");  // TODO
 
     m_peerStats.clear();
+    m_dirty.clear();
+    for (auto& shard : m_deltaShards)
+    {
+      std::lock_guard shardGuard(shard.lock);
+      shard.deltas.clear();
+    }
 
     // sqlite_orm treats empty-string as an indicator to load a memory-backed database, which we'll
     // use if file is an empty-optional
@@ -47,7 +55,6 @@ namespace llarp
       // we cleared m_peerStats, and the database should enforce that routerId is unique...
       assert(m_peerStats.find(stats.routerId) == m_peerStats.end());
 
-      stats.stale = false;
       m_peerStats[stats.routerId] = stats;
     }
   }
@@ -57,44 +64,55 @@ namespace llarp
   {
     LogDebug("flushing PeerDb...");
 
-    auto start = time_now_ms();
-    if (not shouldFlush(start))
+    if (not m_storage)
+      throw std::runtime_error("Cannot flush database before it has been loaded");
+
+    if (m_flushing.test_and_set())
     {
       LogWarn("Call to flushDatabase() while already in progress, ignoring");
       return;
     }
 
-    if (not m_storage)
-      throw std::runtime_error("Cannot flush database before it has been loaded");
+    auto start = time_now_ms();
 
-    std::vector<PeerStats> staleStats;
+    std::vector<PeerStats> dirtyStats;
 
     {
       std::lock_guard guard(m_statsLock);
+      mergeDeltas();
 
-      // copy all stale entries
-      for (auto& entry : m_peerStats)
-      {
-        if (entry.second.stale)
-        {
-          staleStats.push_back(entry.second);
-          entry.second.stale = false;
-        }
-      }
+      dirtyStats.reserve(m_dirty.size());
+      for (const auto& id : m_dirty)
+        dirtyStats.push_back(m_peerStats.at(id));
+      m_dirty.clear();
     }
 
-    LogDebug("Updating ", staleStats.size(), " stats");
+    LogDebug("Updating ", dirtyStats.size(), " stats");
 
+    try
     {
       auto guard = m_storage->transaction_guard();
 
-      for (const auto& stats : staleStats)
+      for (auto itr = dirtyStats.begin(); itr != dirtyStats.end();)
       {
-        m_storage->replace(stats);
+        auto batchEnd = itr + std::min<size_t>(FlushBatchSize, dirtyStats.end() - itr);
+        m_storage->replace_range(itr, batchEnd);
+        itr = batchEnd;
       }
 
       guard.commit();
     }
+    catch (...)
+    {
+      // put them back so the next flush tries again
+      {
+        std::lock_guard guard(m_statsLock);
+        for (const auto& stats : dirtyStats)
+          m_dirty.insert(stats.routerId);
+      }
+      m_flushing.clear();
+      throw;
+    }
 
     auto end = time_now_ms();
 
@@ -102,6 +120,72 @@ namespace llarp
     LogDebug("PeerDb flush took about ", elapsed, " seconds");
 
     m_lastFlush.store(end);
+    m_flushing.clear();
+  }
+
+  PeerDb::DeltaShard&
+  PeerDb::localShard()
+  {
+    static thread_local const size_t shard =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) % NumDeltaShards;
+    return m_deltaShards[shard];
+  }
+
+  void
+  PeerDb::mergeDeltas()
+  {
+    for (auto& shard : m_deltaShards)
+    {
+      std::unordered_map<RouterID, PeerStats> deltas;
+      {
+        std::lock_guard shardGuard(shard.lock);
+        if (shard.deltas.empty())
+          continue;
+        deltas.swap(shard.deltas);
+      }
+      for (const auto& [routerId, delta] : deltas)
+      {
+        auto [itr, inserted] = m_peerStats.try_emplace(routerId, delta);
+        if (not inserted)
+          itr->second += delta;
+        m_dirty.insert(routerId);
+      }
+    }
+  }
+
+  std::optional<PeerStats>
+  PeerDb::pendingStats(const RouterID& routerId) const
+  {
+    std::optional<PeerStats> stats;
+    if (auto itr = m_peerStats.find(routerId); itr != m_peerStats.end())
+      stats = itr->second;
+    for (auto& shard : m_deltaShards)
+    {
+      std::lock_guard shardGuard(shard.lock);
+      auto itr = shard.deltas.find(routerId);
+      if (itr == shard.deltas.end())
+        continue;
+      if (stats)
+        *stats += itr->second;
+      else
+        stats = itr->second;
+    }
+    return stats;
+  }
+
+  void
+  PeerDb::addPendingDeltas(std::unordered_map<RouterID, PeerStats>& stats) const
+  {
+    for (auto& shard : m_deltaShards)
+    {
+      std::lock_guard shardGuard(shard.lock);
+      for (const auto& [routerId, delta] : shard.deltas)
+      {
+        auto [itr, inserted] = stats.try_emplace(routerId, delta);
+        if (not inserted)
+          itr->second += delta;
+      }
+    }
   }
 
   void
@@ -111,47 +195,40 @@ namespace llarp
       throw std::invalid_argument{
           fmt::format("routerId {} doesn't match {}", routerId, delta.routerId)};
 
-    std::lock_guard guard(m_statsLock);
-    auto itr = m_peerStats.find(routerId);
-    if (itr == m_peerStats.end())
-      itr = m_peerStats.insert({routerId, delta}).first;
-    else
+    auto& shard = localShard();
+    std::lock_guard guard(shard.lock);
+    auto [itr, inserted] = shard.deltas.try_emplace(routerId, delta);
+    if (not inserted)
       itr->second += delta;
-
-    itr->second.stale = true;
   }
 
   void
   PeerDb::modifyPeerStats(const RouterID& routerId, std::function<void(PeerStats&)> callback)
   {
-    std::lock_guard guard(m_statsLock);
+    auto& shard = localShard();
+    std::lock_guard guard(shard.lock);
 
-    PeerStats& stats = m_peerStats[routerId];
-    stats.routerId = routerId;
-    stats.stale = true;
-    callback(stats);
+    callback(shard.deltas.try_emplace(routerId, routerId).first->second);
   }
 
   std::optional<PeerStats>
   PeerDb::getCurrentPeerStats(const RouterID& routerId) const
   {
     std::lock_guard guard(m_statsLock);
-    auto itr = m_peerStats.find(routerId);
-    if (itr == m_peerStats.end())
-      return std::nullopt;
-    else
-      return itr->second;
+    return pendingStats(routerId);
   }
 
   std::vector<PeerStats>
   PeerDb::listAllPeerStats() const
   {
     std::lock_guard guard(m_statsLock);
+    auto current = m_peerStats;
+    addPendingDeltas(current);
 
     std::vector<PeerStats> statsList;
-    statsList.reserve(m_peerStats.size());
+    statsList.reserve(current.size());
 
-    for (const auto& [routerId, stats] : m_peerStats)
+    for (const auto& [routerId, stats] : current)
     {
       statsList.push_back(stats);
     }
@@ -169,9 +246,8 @@ namespace llarp
 
     for (const auto& id : ids)
     {
-      const auto itr = m_peerStats.find(id);
-      if (itr != m_peerStats.end())
-        statsList.push_back(itr->second);
+      if (auto stats = pendingStats(id))
+        statsList.push_back(std::move(*stats));
     }
 
     return statsList;
@@ -228,6 +304,8 @@ namespace llarp
   PeerDb::handleGossipedRC(const RouterContact& rc, llarp_time_t now)
   {
     std::lock_guard guard(m_statsLock);
+    // fold in pending deltas first so the rc fields below see everything recorded so far
+    mergeDeltas();
 
     RouterID id(rc.pubkey);
     auto& stats = m_peerStats[id];
@@ -255,7 +333,7 @@ namespace llarp
       }
 
       stats.lastRCUpdated = rc.last_updated;
-      stats.stale = true;
+      m_dirty.insert(id);
     }
   }
 
@@ -278,6 +356,8 @@ namespace llarp
   PeerDb::ExtractStatus() const
   {
     std::lock_guard guard(m_statsLock);
+    auto current = m_peerStats;
+    addPendingDeltas(current);
 
     bool loaded = (m_storage.get() != nullptr);
     util::StatusObject dbFile = nullptr;
@@ -285,8 +365,8 @@ namespace llarp
       dbFile = m_storage->filename();
 
     std::vector<util::StatusObject> statsObjs;
-    statsObjs.reserve(m_peerStats.size());
-    for (const auto& pair : m_peerStats)
+    statsObjs.reserve(current.size());
+    for (const auto& pair : current)
     {
       statsObjs.push_back(pair.second.toJson());
     }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <llarp/util/fs.hpp>
 #include <llarp/config/config.hpp>
@@ -20,6 +24,11 @@ namespace llarp
   /// This uses a sqlite3 database behind the scenes as persistance, but this database is
   /// periodically flushed to, meaning that it will become stale as PeerDb accumulates stats without
   /// a flush.
+  ///
+  /// Updates from accumulatePeerStats() and modifyPeerStats() land in per-thread delta shards so
+  /// that threads recording stats don't contend on one lock; the deltas are merged into the stats
+  /// whenever stats are read and before each flush.  Only peers changed since the last flush are
+  /// written out.
   struct PeerDb
   {
     /// Constructor
@@ -41,7 +50,8 @@ namespace llarp
 
     /// Flushes the database. Must be called after loadDatabase(). This call will block during I/O
     /// and should be called in an appropriate threading context. However, it will make a temporary
-    /// copy of the peer stats so as to avoid sitting on a mutex lock during disk I/O.
+    /// copy of the changed peer stats so as to avoid sitting on a mutex lock during disk I/O, and
+    /// writes them in batched statements inside one transaction.  Concurrent calls are ignored.
     ///
     /// @throws if the database could not be written to (esp. if loadDatabase() has not been called)
     void
@@ -63,15 +73,17 @@ namespace llarp
     void
     accumulatePeerStats(const RouterID& routerId, const PeerStats& delta);
 
-    /// Allows write-access to the stats for a given peer while appropriate mutex lock is held. This
-    /// is an alternative means of incrementing peer stats that is suitable for one-off
-    /// modifications.
+    /// Allows write-access to a delta of the stats for a given peer. This is an alternative means
+    /// of incrementing peer stats that is suitable for one-off modifications.
     ///
-    /// Note that this holds m_statsLock during the callback invocation, so the callback should
-    /// return as quickly as possible.
+    /// The callback is given this thread's pending delta for the peer (all zero unless it was
+    /// already modified since the last merge), which is later added to the peer's stats the same
+    /// way accumulatePeerStats() does. It should therefore only increment counters or raise
+    /// watermarks. The callback is called with this thread's shard lock held, so it should return
+    /// as quickly as possible.
     ///
     /// @param routerId is the id of the router whose stats should be modified.
-    /// @param callback is a function which will be called immediately with mutex held
+    /// @param callback is a function which will be called immediately with the shard lock held
     void
     modifyPeerStats(const RouterID& routerId, std::function<void(PeerStats&)> callback);
 
@@ -129,12 +141,44 @@ namespace llarp
 
 #ifdef BELNET_PEERSTATS_BACKEND
    private:
+    /// Most rows we write per REPLACE statement; keeps the bound parameters under sqlite's limit
+    static constexpr size_t FlushBatchSize = 64;
+
+    struct DeltaShard
+    {
+      std::mutex lock;
+      std::unordered_map<RouterID, PeerStats> deltas;
+    };
+    static constexpr size_t NumDeltaShards = 16;
+
+    /// the delta shard for the calling thread
+    DeltaShard&
+    localShard();
+
+    /// Moves all pending deltas into m_peerStats; must hold m_statsLock
+    void
+    mergeDeltas();
+
+    /// The stats for a peer with its pending deltas added, without merging them; must hold
+    /// m_statsLock
+    std::optional<PeerStats>
+    pendingStats(const RouterID& routerId) const;
+
+    /// Adds all pending deltas to stats, without merging them; must hold m_statsLock
+    void
+    addPendingDeltas(std::unordered_map<RouterID, PeerStats>& stats) const;
+
+    mutable std::array<DeltaShard, NumDeltaShards> m_deltaShards;
+
     std::unordered_map<RouterID, PeerStats> m_peerStats;
+    /// peers changed since the last flush
+    std::unordered_set<RouterID> m_dirty;
     mutable std::mutex m_statsLock;
 
     std::unique_ptr<PeerDbStorage> m_storage;
 
     std::atomic<llarp_time_t> m_lastFlush;
+    std::atomic_flag m_flushing = ATOMIC_FLAG_INIT;
 #endif
   };
 
@@ -35,9 +35,6 @@ namespace llarp
     llarp_time_t leastRCRemainingLifetime = 0ms;
     llarp_time_t lastRCUpdated = 0ms;
 
-    // not serialized
-    bool stale = true;
-
     PeerStats();
     PeerStats(const RouterID& routerId);
 
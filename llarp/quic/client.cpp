@@ -11,10 +11,12 @@
 
 namespace llarp::quic
 {
-  Client::Client(EndpointBase& ep, const SockAddr& remote, uint16_t pseudo_port) : Endpoint{ep}
+  Client::Client(
+      EndpointBase& ep, const SockAddr& remote, uint16_t pseudo_port, TransportSettings transport)
+      : Endpoint{ep, std::move(transport)}
   {
-    default_stream_buffer_size =
-        0;  // We steal uvw's provided buffers so don't need an outgoing data buffer
+    // Tunnel tcp reads land directly in the stream ring buffer
+    default_stream_buffer_size = tunnel::STREAM_BUFFER_SIZE;
 
     // *Our* port; we stuff this in the llarp quic header so it knows how to target quic packets
     // back to *this* client.
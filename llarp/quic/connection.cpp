@@ -38,6 +38,18 @@ namespace llarp::quic
     return oxenc::to_hex(data, data + datalen);
   }
 
+  std::optional<ngtcp2_cc_algo>
+  parse_cc_algo(std::string_view name)
+  {
+    if (name == "cubic")
+      return NGTCP2_CC_ALGO_CUBIC;
+    if (name == "reno")
+      return NGTCP2_CC_ALGO_RENO;
+    if (name == "bbr")
+      return NGTCP2_CC_ALGO_BBR;
+    return std::nullopt;
+  }
+
   ConnectionID
   ConnectionID::random(size_t size)
   {
@@ -402,8 +414,11 @@ namespace llarp::quic
     settings.initial_ts = get_timestamp();
     // FIXME: IPv6
     settings.max_udp_payload_size = Endpoint::max_pkt_size_v4;
-    settings.cc_algo = NGTCP2_CC_ALGO_CUBIC;
-    // settings.initial_rtt = ???; # NGTCP2's default is 333ms
+    settings.cc_algo = endpoint.transport.cc_algo;
+    // Start from what we know about the paths to the remote rather than NGTCP2's default of 333ms,
+    // which is far off for onion paths either way
+    if (auto rtt = endpoint.initial_rtt(path.remote))
+      settings.initial_rtt = std::chrono::nanoseconds{*rtt}.count();
 
     ngtcp2_transport_params_default(&tparams);
 
@@ -554,6 +569,9 @@ namespace llarp::quic
 
     send_pkt_info = {};
 
+    // Everything we send this round goes to the service endpoint as few payloads as possible
+    Endpoint::packet_batch batch{endpoint};
+
     auto add_stream_data =
         [&](StreamID stream_id, const ngtcp2_vec* datav, size_t datalen, uint32_t flags = 0) {
           std::array<ngtcp2_ssize, 2> result;
@@ -757,6 +775,31 @@ namespace llarp::quic
     retransmit_timer->start(expires_in, 0ms);
   }
 
+  uint64_t
+  Connection::consume_window(flow_window& window, uint64_t consumed, uint64_t max_size)
+  {
+    if (not endpoint.transport.autotune_windows)
+      return 0;
+    window.consumed += consumed;
+    if (window.consumed < window.size)
+      return 0;
+
+    const auto now = get_time();
+    ngtcp2_conn_stat cstat;
+    ngtcp2_conn_get_conn_stat(*this, &cstat);
+    const std::chrono::nanoseconds rtt{cstat.smoothed_rtt};
+    uint64_t growth = 0;
+    if (now - window.started < 2 * rtt and window.size < max_size)
+    {
+      growth = std::min(window.size, max_size - window.size);
+      window.size += growth;
+      LogDebug("Flow control window grown to ", window.size, "B");
+    }
+    window.consumed = 0;
+    window.started = now;
+    return growth;
+  }
+
   int
   Connection::stream_opened(StreamID id)
   {
@@ -830,14 +873,28 @@ namespace llarp::quic
       LogTrace("Stream ", str->id(), " closed by remote");
       // Don't cleanup here; stream_closed is going to be called right away to deal with that
     }
-    else
+    else if (not str->defer_consumed)
     {
-      ngtcp2_conn_extend_max_stream_offset(*this, id.id, data.size());
-      ngtcp2_conn_extend_max_offset(*this, data.size());
+      stream_consumed(id, data.size());
     }
     return 0;
   }
 
+  void
+  Connection::stream_consumed(StreamID id, size_t bytes)
+  {
+    if (not streams.count(id))
+      return;  // closed while the application held the data
+    auto [window, inserted] = stream_windows.try_emplace(id.id, flow_window{STREAM_BUFFER});
+    ngtcp2_conn_extend_max_stream_offset(
+        *this,
+        id.id,
+        bytes + consume_window(window->second, bytes, endpoint.transport.max_stream_window));
+    ngtcp2_conn_extend_max_offset(
+        *this,
+        bytes + consume_window(conn_window, bytes, endpoint.transport.max_connection_window));
+  }
+
   void
   Connection::stream_closed(StreamID id, uint64_t app_code)
   {
@@ -860,6 +917,7 @@ namespace llarp::quic
 
     LogDebug("Erasing stream ", id, " from ", (void*)it->second.get());
     streams.erase(it);
+    stream_windows.erase(id.id);
 
     if (!ngtcp2_conn_is_local_stream(*this, id.id))
       ngtcp2_conn_extend_max_streams_bidi(*this, 1);
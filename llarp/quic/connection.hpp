@@ -8,7 +8,9 @@
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <map>
 
@@ -36,6 +38,25 @@ namespace llarp::quic
   // Max number of simultaneous streams we support over one connection
   constexpr uint64_t STREAM_LIMIT = 32;
 
+  // Transport settings for the connections of an endpoint
+  struct TransportSettings
+  {
+    // Congestion controller
+    ngtcp2_cc_algo cc_algo = NGTCP2_CC_ALGO_CUBIC;
+    // Initial rtt to assume when we have no latency measurement for the paths to the remote; if
+    // unset we use ngtcp2's default (333ms)
+    std::optional<std::chrono::milliseconds> initial_rtt;
+    // Grow flow control windows when the remote is limited by them rather than by the path
+    bool autotune_windows = true;
+    // Upper limits for auto-tuned windows
+    uint64_t max_stream_window = 4 * 1024 * 1024;
+    uint64_t max_connection_window = 16 * 1024 * 1024;
+  };
+
+  // Parses a congestion controller name ("cubic", "reno" or "bbr"); returns nullopt if unknown.
+  std::optional<ngtcp2_cc_algo>
+  parse_cc_algo(std::string_view name);
+
   using bstring_view = std::basic_string_view<std::byte>;
 
   class Endpoint;
@@ -156,6 +177,23 @@ namespace llarp::quic
     // The port the client wants to connect to on the server
     uint16_t tunnel_port = 0;
 
+    // A receive flow control window we auto-tune
+    struct flow_window
+    {
+      uint64_t size;
+      // bytes consumed since `started`
+      uint64_t consumed = 0;
+      std::chrono::steady_clock::time_point started = get_time();
+    };
+    flow_window conn_window{CONNECTION_BUFFER};
+    std::unordered_map<int64_t, flow_window> stream_windows;
+
+    // Called when we consumed `consumed` bytes of a window; once a full window has been consumed
+    // in less than two round trips the remote was held back by the window rather than the path,
+    // so we double it (up to `max_size`).  Returns the number of bytes to extend the window by.
+    uint64_t
+    consume_window(flow_window& window, uint64_t consumed, uint64_t max_size);
+
    public:
     // The endpoint that owns this connection
     Endpoint& endpoint;
@@ -260,6 +298,10 @@ namespace llarp::quic
     int
     stream_receive(StreamID id, bstring_view data, bool fin);
 
+    // Extends the stream and connection receive windows by `bytes` the application is done with
+    void
+    stream_consumed(StreamID id, size_t bytes);
+
     // Called when a stream is closed
     void
     stream_closed(StreamID id, uint64_t app_error_code);
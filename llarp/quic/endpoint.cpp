@@ -22,7 +22,8 @@ extern "C"
 
 namespace llarp::quic
 {
-  Endpoint::Endpoint(EndpointBase& ep) : service_endpoint{ep}
+  Endpoint::Endpoint(EndpointBase& ep, TransportSettings transport_)
+      : service_endpoint{ep}, transport{std::move(transport_)}
   {
     randombytes_buf(static_secret.data(), static_secret.size());
 
@@ -40,6 +41,17 @@ namespace llarp::quic
       expiry_timer->close();
   }
 
+  std::optional<std::chrono::milliseconds>
+  Endpoint::initial_rtt(const Address& remote) const
+  {
+    if (auto addr = service_endpoint.GetEndpointWithConvoTag(remote))
+    {
+      if (auto stat = service_endpoint.GetStatFor(*addr); stat and stat->estimatedRTT > 0s)
+        return stat->estimatedRTT;
+    }
+    return transport.initial_rtt;
+  }
+
   std::shared_ptr<uvw::Loop>
   Endpoint::get_loop()
   {
@@ -179,6 +191,42 @@ namespace llarp::quic
   {
     assert(service_endpoint.Loop()->inEventLoop());
 
+    const service::ConvoTag tag{to};
+    // older belnets warn about the announcement, so we only announce to remotes whose introset says
+    // they understand it; everyone else hears from us once they announced to us
+    if (not coalesce_announced.count(tag)
+        and service_endpoint.RemoteSupports(tag, service::ProtocolType::QUICCoalesced))
+      announce_coalescing(to);
+    if (batch_depth == 0 or not coalesce_peers.count(tag))
+      return send_one(to, data, ecn);
+
+    if (pending_coalesced)
+    {
+      const auto& pending = *pending_coalesced;
+      if (static_cast<SockAddr>(pending.to) != static_cast<SockAddr>(to) or pending.ecn != ecn
+          or pending.data.size() + 2 + data.size() > max_coalesced_size)
+        send_coalesced();
+    }
+    if (not pending_coalesced)
+    {
+      auto& pending = pending_coalesced.emplace();
+      pending.to = to;
+      pending.ecn = ecn;
+      pending.data.reserve(max_coalesced_size);
+      pending.data.resize(write_packet_header(to.port(), ecn));
+    }
+    auto& pending = *pending_coalesced;
+    const auto len = static_cast<uint16_t>(data.size());
+    pending.data.push_back(static_cast<std::byte>(len >> 8));
+    pending.data.push_back(static_cast<std::byte>(len & 0xff));
+    pending.data.insert(pending.data.end(), data.begin(), data.end());
+    ++pending.packets;
+    return {};
+  }
+
+  io_result
+  Endpoint::send_one(const Address& to, bstring_view data, uint8_t ecn)
+  {
     size_t header_size = write_packet_header(to.port(), ecn);
     size_t outgoing_len = header_size + data.size();
     assert(outgoing_len <= buf_.size());
@@ -197,6 +245,96 @@ namespace llarp::quic
     return {};
   }
 
+  void
+  Endpoint::send_coalesced()
+  {
+    if (not pending_coalesced)
+      return;
+    auto pending = std::move(*pending_coalesced);
+    pending_coalesced.reset();
+
+    const size_t header_size = write_packet_header(pending.to.port(), pending.ecn);
+    if (pending.packets == 1)
+    {
+      // nothing to save, send it as a plain packet
+      bstring_view data{pending.data.data(), pending.data.size()};
+      send_one(pending.to, data.substr(header_size + 2), pending.ecn);
+      return;
+    }
+    std::memcpy(pending.data.data(), buf_.data(), header_size);
+    pending.data[0] |= COALESCED;
+
+    if (service_endpoint.SendToOrQueue(
+            pending.to,
+            llarp_buffer_t{pending.data.data(), pending.data.size()},
+            service::ProtocolType::QUIC))
+    {
+      LogTrace("[", pending.to, "]: sent ", pending.packets, " coalesced packets");
+    }
+    else
+    {
+      LogDebug(
+          "Failed to send to quic endpoint ",
+          pending.to,
+          "; was sending ",
+          pending.packets,
+          " coalesced packets");
+    }
+  }
+
+  void
+  Endpoint::start_batch()
+  {
+    ++batch_depth;
+  }
+
+  void
+  Endpoint::end_batch()
+  {
+    assert(batch_depth > 0);
+    if (--batch_depth == 0)
+      send_coalesced();
+  }
+
+  void
+  Endpoint::announce_coalescing(const Address& to)
+  {
+    if (not coalesce_announced.emplace(service::ConvoTag{to}).second)
+      return;
+    size_t header_size = write_packet_header(to.port(), 0);
+    buf_[0] |= COALESCED;
+    service_endpoint.SendToOrQueue(
+        to, llarp_buffer_t{buf_.data(), header_size}, service::ProtocolType::QUIC);
+  }
+
+  void
+  Endpoint::receive_coalesced(const SockAddr& src, uint8_t ecn, bstring_view data)
+  {
+    if (coalesce_peers.emplace(service::ConvoTag{Address{src}}).second)
+    {
+      LogDebug("[", src, "]: remote can unpack coalesced quic packets");
+      announce_coalescing(Address{src});
+    }
+
+    while (not data.empty())
+    {
+      if (data.size() < 2)
+      {
+        LogWarn("Truncated coalesced quic payload from ", src, "; dropping the rest");
+        return;
+      }
+      const size_t len = (static_cast<size_t>(data[0]) << 8) | static_cast<size_t>(data[1]);
+      data.remove_prefix(2);
+      if (len == 0 or len > data.size())
+      {
+        LogWarn("Bad packet length in coalesced quic payload from ", src, "; dropping the rest");
+        return;
+      }
+      receive_packet(src, ecn, data.substr(0, len));
+      data.remove_prefix(len);
+    }
+  }
+
   void
   Endpoint::send_version_negotiation(const version_info& vi, const Address& source)
   {
@@ -350,6 +488,13 @@ namespace llarp::quic
 
     bool primary = std::holds_alternative<primary_conn_ptr>(it->second);
     LogDebug("Deleting ", primary ? "primary" : "alias", " connection ", cid);
+    if (primary)
+    {
+      // Forget whether the remote can unpack coalesced payloads; it tells us again if it comes back
+      const service::ConvoTag tag{std::get<primary_conn_ptr>(it->second)->path.remote};
+      coalesce_peers.erase(tag);
+      coalesce_announced.erase(tag);
+    }
     conns.erase(it);
     if (primary)
       clean_alias_conns();
@@ -12,7 +12,9 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <uvw/async.h>
@@ -31,6 +33,9 @@ namespace llarp::quic
 
   inline constexpr std::byte CLIENT_TO_SERVER{1};
   inline constexpr std::byte SERVER_TO_CLIENT{2};
+  // Flag or'ed into the packet type when the payload carries several quic packets, each prefixed
+  // with its u16 length (network order), rather than a single packet.
+  inline constexpr std::byte COALESCED{0x80};
 
   /// QUIC Tunnel Endpoint; this is the class that implements either end of a quic tunnel for both
   /// servers and clients.
@@ -45,6 +50,12 @@ namespace llarp::quic
     void
     receive_packet(const SockAddr& src, uint8_t ecn, bstring_view data);
 
+    /// Called via TunnelManager to deliver an incoming coalesced payload; unpacks it and hands
+    /// each packet to receive_packet().  An empty payload is a remote telling us that it can unpack
+    /// coalesced payloads itself.
+    void
+    receive_coalesced(const SockAddr& src, uint8_t ecn, bstring_view data);
+
     /// Returns a shared pointer to the uvw loop.
     std::shared_ptr<uvw::Loop>
     get_loop();
@@ -66,6 +77,9 @@ namespace llarp::quic
     // Max size of a UDP packet that we'll send
     static constexpr size_t max_pkt_size_v4 = NGTCP2_MAX_UDP_PAYLOAD_SIZE;
     static constexpr size_t max_pkt_size_v6 = NGTCP2_MAX_UDP_PAYLOAD_SIZE;
+    // Max size of a coalesced payload; this has to leave room for the protocol message overhead
+    // within service::MAX_PROTOCOL_MESSAGE_SIZE.
+    static constexpr size_t max_coalesced_size = 3000;
 
     using primary_conn_ptr = std::shared_ptr<Connection>;
     using alias_conn_ptr = std::weak_ptr<Connection>;
@@ -105,7 +119,12 @@ namespace llarp::quic
 
     friend class Connection;
 
-    explicit Endpoint(EndpointBase& service_endpoint_);
+    Endpoint(EndpointBase& service_endpoint_, TransportSettings transport_);
+
+    // Initial rtt for a new connection to `remote`: the latency of our paths to it if we have
+    // measured it, otherwise whatever the transport settings say.
+    std::optional<std::chrono::milliseconds>
+    initial_rtt(const Address& remote) const;
 
     virtual ~Endpoint();
 
@@ -187,6 +206,60 @@ namespace llarp::quic
     void
     send_version_negotiation(const version_info& vi, const Address& source);
 
+    // Starts a batch: until the matching end_batch() call, packets passed to send_packet() for
+    // remotes that can unpack coalesced payloads are collected into coalesced payloads instead of
+    // each being handed to the service endpoint on its own.  Batches nest; packets are sent when
+    // the outermost batch ends.
+    void
+    start_batch();
+
+    void
+    end_batch();
+
+    // Starts a batch for as long as it is alive.
+    struct packet_batch
+    {
+      explicit packet_batch(Endpoint& ep) : ep{ep}
+      {
+        ep.start_batch();
+      }
+
+      ~packet_batch()
+      {
+        ep.end_batch();
+      }
+
+      Endpoint& ep;
+    };
+
+    // Hands a single packet to the service endpoint.
+    io_result
+    send_one(const Address& to, bstring_view data, uint8_t ecn);
+
+    // Hands the pending coalesced payload, if any, to the service endpoint.
+    void
+    send_coalesced();
+
+    // Tells `to` that we can unpack coalesced payloads, if we haven't already.
+    void
+    announce_coalescing(const Address& to);
+
+    // Remotes that told us they can unpack coalesced payloads, and remotes we told that we can.
+    std::unordered_set<service::ConvoTag> coalesce_peers;
+    std::unordered_set<service::ConvoTag> coalesce_announced;
+
+    // The coalesced payload being collected by the current batch.  `data` starts with room for the
+    // belnet packet header which is filled in when we send it.
+    struct coalesced_payload
+    {
+      Address to;
+      uint8_t ecn;
+      std::vector<std::byte> data;
+      size_t packets = 0;
+    };
+    std::optional<coalesced_payload> pending_coalesced;
+    int batch_depth = 0;
+
     // Looks up a connection. Returns a shared_ptr (either copied for a primary connection, or
     // locked from an alias's weak pointer) if the connection was found or nullptr if not; and a
     // bool indicating whether this connection ID was an alias (true) or not (false).  [Note: the
@@ -246,6 +319,9 @@ namespace llarp::quic
     // Default stream buffer size for streams opened through this endpoint.
     size_t default_stream_buffer_size = 64 * 1024;
 
+    // Transport settings for connections of this endpoint
+    const TransportSettings transport;
+
     // Packet buffer we use when constructing custom packets to fire over belnet
     std::array<std::byte, net::IPPacket::MaxSize> buf_;
 
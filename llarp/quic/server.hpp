@@ -11,10 +11,9 @@ namespace llarp::quic
    public:
     using stream_open_callback_t = std::function<bool(Stream& stream, uint16_t port)>;
 
-    Server(EndpointBase& service_endpoint) : Endpoint{service_endpoint}
-    {
-      default_stream_buffer_size = 0;  // We don't currently use the endpoint ring buffer
-    }
+    Server(EndpointBase& service_endpoint, TransportSettings transport = {})
+        : Endpoint{service_endpoint, std::move(transport)}
+    {}
 
     // Stream callback: takes the server, the (just-created) stream, and the connection port.
     // Returns true if the stream should be allowed or false to reject the stream.  The callback
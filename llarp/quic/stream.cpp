@@ -157,6 +157,27 @@ namespace llarp::quic
     return data.size();
   }
 
+  std::pair<std::byte*, size_t>
+  Stream::writable()
+  {
+    if (available() == 0)
+      return {nullptr, 0};
+    // The free space is [wpos, start) if the used region wraps, otherwise [wpos, end) (and the
+    // remaining [0, start) only becomes contiguous after a commit moves wpos back to 0).
+    size_t wpos = (start + size) % buffer.size();
+    size_t end = wpos < start ? start : buffer.size();
+    return {buffer.data() + wpos, end - wpos};
+  }
+
+  void
+  Stream::commit(size_t bytes)
+  {
+    assert(bytes <= writable().second);
+    size += bytes;
+    LogTrace("Committed ", bytes, " bytes; stream buffer: ", size, "/", buffer.size());
+    conn.io_ready();
+  }
+
   void
   Stream::append_buffer(const std::byte* buffer, size_t length)
   {
@@ -210,7 +231,7 @@ namespace llarp::quic
       }
     }
 
-    if (!unblocked_callbacks.empty())
+    if (!unblocked_callbacks.empty() || drained_callback)
       available_ready();
   }
 
@@ -285,6 +306,12 @@ namespace llarp::quic
       else
         assert(available() == 0);
     }
+    if (drained_callback && (buffer.empty() || available() > 0))
+    {
+      // Call through a copy so that the callback can safely replace or clear itself
+      auto drained = drained_callback;
+      drained(*this);
+    }
     conn.io_ready();
   }
 
@@ -294,6 +321,15 @@ namespace llarp::quic
     conn.io_ready();
   }
 
+  void
+  Stream::consumed(size_t bytes)
+  {
+    if (bytes == 0)
+      return;
+    conn.stream_consumed(stream_id, bytes);
+    conn.io_ready();
+  }
+
   void
   Stream::available_ready()
   {
@@ -10,6 +10,7 @@
 #include <oxenc/variant.h>
 #include <vector>
 #include <optional>
+#include <utility>
 #include <uvw/async.h>
 
 #include <llarp/util/formattable.hpp>
@@ -189,6 +190,18 @@ namespace llarp::quic
     void
     append_buffer(const std::byte* buf, size_t length);
 
+    // Returns the largest contiguous free region of the outgoing ring buffer so that a producer
+    // (e.g. a socket read) can write into it directly instead of copying in via `append`.  After
+    // writing, call `commit()` with the number of bytes actually written.  The region is empty if
+    // the buffer is full, the stream is closing, or we are in user-provided buffer mode.
+    std::pair<std::byte*, size_t>
+    writable();
+
+    // Marks `bytes` written into the start of the region returned by `writable()` as pending
+    // outgoing data.
+    void
+    commit(size_t bytes);
+
     // Starting closing the stream and prevent any more outgoing data from being appended.  If
     // `error_code` is provided then we close immediately with the given code; if std::nullopt (the
     // default) we close gracefully by sending a FIN bit.
@@ -218,6 +231,15 @@ namespace llarp::quic
     // size of the data, just that this will always be called in sequential order.
     data_callback_t data_callback;
 
+    // If true, data passed to data_callback is not given back to the remote's flow control window
+    // when the callback returns; the application calls consumed() once it is done with the data.
+    // This lets a consumer that buffers received data stop the remote while it catches up.
+    bool defer_consumed = false;
+
+    // Gives `bytes` received bytes back to the flow control windows; only for defer_consumed.
+    void
+    consumed(size_t bytes);
+
     // Callback to invoke when the connection has closed.  If the close was an abrupt stream close
     // initiated by the remote then `error_code` will be set to whatever code the remote side
     // provided; for graceful closing or locally initiated closing the error code will be null.
@@ -240,6 +262,12 @@ namespace llarp::quic
     void
     when_available(unblocked_callback_t unblocked_cb);
 
+    // Callback invoked (in batches, like when_available callbacks) each time acknowledgements
+    // free up buffer space.  Unlike when_available callbacks this is not consumed by being called:
+    // it is meant for producers that stop filling the buffer when it fills up and want to decide
+    // from buffer occupancy when to resume.  The callback may replace or clear itself.
+    std::function<void(Stream&)> drained_callback;
+
     // Calls io_ready() on the stream's connection to scheduling sending outbound data
     void
     io_ready();
@@ -0,0 +1,264 @@
+#include "stream_pipe.hpp"
+#include "tunnel.hpp"
+
+#include <llarp/util/logging.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+namespace llarp::quic
+{
+  StreamPipe::StreamPipe(EventLoop_ptr loop) : loop{std::move(loop)}
+  {}
+
+  std::shared_ptr<StreamPipe>
+  StreamPipe::open(
+      EventLoop_ptr loop,
+      TunnelManager& tunnels,
+      std::string remote,
+      uint16_t port,
+      std::chrono::milliseconds timeout,
+      int& error)
+  {
+    std::shared_ptr<StreamPipe> pipe{new StreamPipe{loop}};
+    auto opened = std::make_shared<std::promise<int>>();
+    auto result = opened->get_future();
+
+    loop->call([pipe, opened, &tunnels, remote = std::move(remote), port] {
+      try
+      {
+        tunnels.open_stream(remote, port, [pipe, opened](std::shared_ptr<Stream> stream) {
+          if (not stream)
+          {
+            opened->set_value(ECONNREFUSED);
+            return;
+          }
+          pipe->attach(std::move(stream));
+          opened->set_value(0);
+        });
+      }
+      catch (const std::invalid_argument&)
+      {
+        opened->set_value(EINVAL);
+      }
+      catch (const std::exception& e)
+      {
+        LogWarn("Failed to open in-process stream to ", remote, ":", port, ": ", e.what());
+        opened->set_value(ECANCELED);
+      }
+    });
+
+    if (result.wait_for(timeout) != std::future_status::ready)
+    {
+      // attach() closes the stream if it still shows up
+      pipe->close();
+      error = ETIMEDOUT;
+      return nullptr;
+    }
+    if (error = result.get(); error != 0)
+      return nullptr;
+    return pipe;
+  }
+
+  int
+  StreamPipe::ready_events() const
+  {
+    int events = 0;
+    if (inbound_size != 0 or finished)
+      events |= READABLE;
+    if (outbound.size() < MAX_PENDING_WRITE and not finished and not closing)
+      events |= WRITABLE;
+    if (finished)
+      events |= CLOSED;
+    return events;
+  }
+
+  int
+  StreamPipe::read(void* buf, size_t len, size_t& nread)
+  {
+    nread = 0;
+    if (buf == nullptr and len > 0)
+      return EINVAL;
+    std::unique_lock lock{mutex};
+    auto* out = static_cast<char*>(buf);
+    while (nread < len and not inbound.empty())
+    {
+      const auto& front = inbound.front();
+      const size_t n = std::min(len - nread, front.size() - inbound_offset);
+      std::memcpy(out + nread, front.data() + inbound_offset, n);
+      nread += n;
+      inbound_offset += n;
+      if (inbound_offset == front.size())
+      {
+        inbound.pop_front();
+        inbound_offset = 0;
+      }
+    }
+    inbound_size -= nread;
+    if (nread == 0)
+    {
+      if (reset)
+        return ECONNRESET;
+      return finished or len == 0 ? 0 : EAGAIN;
+    }
+    if (held_credit != 0 and inbound_size < MAX_PENDING_READ and not release_queued)
+    {
+      release_queued = true;
+      loop->call_soon([self = shared_from_this()] { self->release_credit(); });
+    }
+    return 0;
+  }
+
+  int
+  StreamPipe::write(const void* buf, size_t len, size_t& nwritten)
+  {
+    nwritten = 0;
+    if (buf == nullptr and len > 0)
+      return EINVAL;
+    std::unique_lock lock{mutex};
+    if (finished or closing)
+      return EPIPE;
+    if (outbound.size() >= MAX_PENDING_WRITE)
+      return EAGAIN;
+    nwritten = std::min(len, MAX_PENDING_WRITE - outbound.size());
+    outbound.append(static_cast<const char*>(buf), nwritten);
+    if (not flush_queued)
+    {
+      flush_queued = true;
+      loop->call_soon([self = shared_from_this()] { self->flush(); });
+    }
+    return 0;
+  }
+
+  int
+  StreamPipe::poll(int events, std::chrono::milliseconds timeout)
+  {
+    events |= CLOSED;
+    std::unique_lock lock{mutex};
+    auto ready = [this, events] { return (ready_events() & events) != 0; };
+    if (timeout.count() < 0)
+      cv.wait(lock, ready);
+    else
+      cv.wait_for(lock, timeout, ready);
+    return ready_events() & events;
+  }
+
+  void
+  StreamPipe::close()
+  {
+    {
+      std::unique_lock lock{mutex};
+      if (closing)
+        return;
+      closing = true;
+      inbound.clear();
+      inbound_offset = 0;
+      inbound_size = 0;
+    }
+    loop->call_soon([self = shared_from_this()] {
+      // unread data is gone, so don't keep the remote waiting on credit for it
+      self->release_credit();
+      self->flush();
+    });
+  }
+
+  void
+  StreamPipe::attach(std::shared_ptr<Stream> s)
+  {
+    std::weak_ptr<StreamPipe> self = weak_from_this();
+    s->defer_consumed = true;
+    s->data_callback = [self](Stream& str, bstring_view data) {
+      auto pipe = self.lock();
+      if (not pipe or pipe->on_data(data))
+        str.consumed(data.size());
+    };
+    s->close_callback = [self](Stream&, std::optional<uint64_t> error_code) {
+      if (auto pipe = self.lock())
+        pipe->on_close(error_code);
+    };
+    stream = s;
+    flush();
+  }
+
+  bool
+  StreamPipe::on_data(bstring_view data)
+  {
+    bool credit = true;
+    {
+      std::unique_lock lock{mutex};
+      if (not closing)
+      {
+        inbound.emplace_back(reinterpret_cast<const char*>(data.data()), data.size());
+        inbound_size += data.size();
+        if (held_credit != 0 or inbound_size > MAX_PENDING_READ)
+        {
+          held_credit += data.size();
+          credit = false;
+        }
+      }
+    }
+    cv.notify_all();
+    return credit;
+  }
+
+  void
+  StreamPipe::release_credit()
+  {
+    size_t credit = 0;
+    {
+      std::unique_lock lock{mutex};
+      release_queued = false;
+      credit = std::exchange(held_credit, 0);
+    }
+    if (auto s = stream.lock())
+      s->consumed(credit);
+  }
+
+  void
+  StreamPipe::on_close(std::optional<uint64_t> error_code)
+  {
+    {
+      std::unique_lock lock{mutex};
+      finished = true;
+      reset = error_code.has_value();
+    }
+    cv.notify_all();
+  }
+
+  void
+  StreamPipe::flush()
+  {
+    auto s = stream.lock();
+    if (not s)
+      return;  // not attached yet (attach() flushes) or already gone
+    bool close_now = false;
+    {
+      std::unique_lock lock{mutex};
+      flush_queued = false;
+      if (not outbound.empty() and not s->closing())
+        outbound.erase(0, s->append_any(std::string_view{outbound}));
+      if (outbound.empty())
+      {
+        s->drained_callback = nullptr;
+        close_now = closing;
+      }
+      else
+      {
+        // The stream's buffer is full; carry on once acks free up some of it
+        std::weak_ptr<StreamPipe> self = weak_from_this();
+        s->drained_callback = [self](Stream&) {
+          if (auto pipe = self.lock())
+            pipe->flush();
+        };
+      }
+    }
+    cv.notify_all();
+    if (close_now and not s->closing())
+      s->close();
+  }
+
+}  // namespace llarp::quic
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "stream.hpp"
+
+#include <llarp/ev/ev.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace llarp::quic
+{
+  class TunnelManager;
+
+  // Thread-safe, in-process end of a tunnel stream for embedders (libbelnet's stream API and the
+  // JNI binding) that want to read and write the stream's data directly rather than through a
+  // localhost TCP socket.  All quic work happens on the event loop; application threads read and
+  // write through buffers guarded by a mutex.
+  //
+  // Received data is copied once, out of ngtcp2's receive buffer (which is only valid during the
+  // callback), and written data once into the stream's ring buffer.  Once more than
+  // MAX_PENDING_READ received bytes are waiting to be read we stop giving the remote flow control
+  // credit for them, so a reader that falls behind stalls the sender instead of growing the buffer.
+  class StreamPipe : public std::enable_shared_from_this<StreamPipe>
+  {
+   public:
+    // poll() event bits
+    static constexpr int READABLE = 1;
+    static constexpr int WRITABLE = 2;
+    static constexpr int CLOSED = 4;
+
+    // Most written-but-not-yet-buffered bytes we hold before write() reports EAGAIN.  This sits in
+    // front of the stream's own ring buffer, which holds the unacked data.
+    static constexpr size_t MAX_PENDING_WRITE = 256 * 1024;
+
+    // Most received-but-unread bytes we give flow control credit for.  The remote can still send
+    // what is left of the window it already has, so this is a high-water mark, not a hard cap.
+    static constexpr size_t MAX_PENDING_READ = 256 * 1024;
+
+    // Opens a stream to the tunneled `port` on `remote` (a belnet address or ONS name), waiting
+    // up to `timeout` for the remote to accept it.  On failure returns nullptr and sets `error` to
+    // an errno value.  Must not be called from the event loop thread.
+    static std::shared_ptr<StreamPipe>
+    open(
+        EventLoop_ptr loop,
+        TunnelManager& tunnels,
+        std::string remote,
+        uint16_t port,
+        std::chrono::milliseconds timeout,
+        int& error);
+
+    // Reads up to `len` received bytes into `buf`, setting `nread`.  Returns 0 on success
+    // (`nread` == 0 means the remote finished the stream), EAGAIN if nothing has arrived yet,
+    // ECONNRESET if the stream was reset, or EINVAL if `buf` is null and `len` is not 0.
+    int
+    read(void* buf, size_t len, size_t& nread);
+
+    // Queues up to `len` bytes from `buf` to be sent, setting `nwritten`.  Returns 0 on success,
+    // EAGAIN if the stream is congested and nothing could be queued, EPIPE once the stream is
+    // closed, or EINVAL if `buf` is null and `len` is not 0.
+    int
+    write(const void* buf, size_t len, size_t& nwritten);
+
+    // Waits up to `timeout` (forever if negative) until any of `events` is ready and returns the
+    // ready events, 0 on timeout.  CLOSED is always reported, even if not requested.
+    int
+    poll(int events, std::chrono::milliseconds timeout);
+
+    // Closes the stream once everything written so far has been handed to it.  Any unread data
+    // is discarded.
+    void
+    close();
+
+    // Event loop side, driven by the stream once attached.  A pipe that is never attached only
+    // buffers, which is how it is tested.
+    explicit StreamPipe(EventLoop_ptr loop);
+
+    // Buffers received data for read(); returns false if the remote should not get flow control
+    // credit for it yet because the reader is too far behind.
+    bool
+    on_data(bstring_view data);
+    void
+    on_close(std::optional<uint64_t> error_code);
+
+   private:
+    // Ready events; must hold `mutex`
+    int
+    ready_events() const;
+
+    void
+    attach(std::shared_ptr<Stream> stream);
+    // Gives the stream back the flow control credit held while the reader was behind
+    void
+    release_credit();
+    // Moves queued writes into the stream's ring buffer
+    void
+    flush();
+
+    EventLoop_ptr loop;
+    std::weak_ptr<Stream> stream;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    // Received chunks; the first `inbound_offset` bytes of the front chunk have been read
+    std::deque<std::string> inbound;
+    size_t inbound_offset = 0;
+    size_t inbound_size = 0;
+    // Received bytes we haven't given flow control credit for yet
+    size_t held_credit = 0;
+    bool release_queued = false;
+    std::string outbound;
+    bool flush_queued = false;
+    bool finished = false;  // remote finished (or reset) the stream
+    bool reset = false;
+    bool closing = false;  // close() was called
+  };
+
+}  // namespace llarp::quic
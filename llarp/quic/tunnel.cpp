@@ -8,6 +8,7 @@
 #include <llarp/util/logging.hpp>
 #include <llarp/util/str.hpp>
 #include <llarp/ev/libuv.hpp>
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -16,39 +17,127 @@ namespace llarp::quic
 {
   namespace
   {
-    // Takes data from the tcp connection and pushes it down the quic tunnel
+    // Shuts down the quic stream on an error from the local tcp socket
     void
-    on_outgoing_data(uvw::DataEvent& event, uvw::TCPHandle& client)
+    on_tcp_error(uvw::TCPHandle& tcp, const char* name, const char* what)
     {
+      LogError(
+          "ErrorEvent[",
+          name,
+          ": ",
+          what,
+          "] on connection with ",
+          tcp.peer().ip,
+          ":",
+          tcp.peer().port,
+          ", shutting down quic stream");
+      if (auto stream = tcp.data<Stream>())
+      {
+        stream->close(tunnel::ERROR_TCP);
+        stream->data(nullptr);
+        tcp.data(nullptr);
+      }
+    }
+
+    void
+    start_reading(uvw::TCPHandle& tcp);
+
+    // Resumes reading from the local tcp socket once acks have freed enough of the stream buffer
+    void
+    resume_when_drained(Stream& stream)
+    {
+      if (stream.available() < tunnel::RESUME_SIZE)
+        return;
+      stream.drained_callback = nullptr;
+      if (auto tcp = stream.data<uvw::TCPHandle>())
+      {
+        LogDebug("quic tunnel is no longer congested; resuming tcp connection reading");
+        start_reading(*tcp);
+      }
+    }
+
+    // Stops reading from the local tcp socket until the stream buffer drains
+    void
+    pause_reading(uvw::TCPHandle& tcp, Stream& stream)
+    {
+      LogDebug(
+          "quic tunnel is congested (have ",
+          stream.used(),
+          " bytes in flight); pausing local tcp connection reads");
+      tcp.stop();
+      stream.drained_callback = resume_when_drained;
+    }
+
+    // libuv asks us where to put the next read: we hand it the free space of the stream's ring
+    // buffer so that data goes from the socket into the buffer ngtcp2 sends from without copies.
+    void
+    alloc_stream_space(uv_handle_t* handle, size_t /*suggested*/, uv_buf_t* buf)
+    {
+      buf->base = nullptr;
+      buf->len = 0;
+      if (auto stream = static_cast<uvw::TCPHandle*>(handle->data)->data<Stream>())
+      {
+        auto [ptr, len] = stream->writable();
+        buf->base = reinterpret_cast<char*>(ptr);
+        buf->len = len;
+      }
+    }
+
+    // Takes data read from the tcp connection into the stream buffer and queues it down the quic
+    // tunnel
+    void
+    on_outgoing_data(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf)
+    {
+      auto& client = *static_cast<uvw::TCPHandle*>(handle->data);
       auto stream = client.data<Stream>();
-      assert(stream);
-      std::string_view data{event.data.get(), event.length};
-      auto peer = client.peer();
-      LogTrace(peer.ip, ":", peer.port, " → belnet ", buffer_printer{data});
-      // Steal the buffer from the DataEvent's unique_ptr<char[]>:
-      stream->append_buffer(reinterpret_cast<const std::byte*>(event.data.release()), event.length);
-      if (stream->used() >= tunnel::PAUSE_SIZE)
+      if (nread == 0)
+        return;  // EAGAIN, nothing read
+      if (nread == UV_EOF)
+      {
+        // Most likely because the other side of the TCP connection closed it.
+        LogInfo("EOF on connection to ", client.peer().ip, ":", client.peer().port);
+        client.close();
+        return;
+      }
+      if (not stream)
       {
-        LogDebug(
-            "quic tunnel is congested (have ",
-            stream->used(),
-            " bytes in flight); pausing local tcp connection reads");
         client.stop();
-        stream->when_available([](Stream& s) {
-          auto client = s.data<uvw::TCPHandle>();
-          if (s.used() < tunnel::PAUSE_SIZE)
-          {
-            LogDebug("quic tunnel is no longer congested; resuming tcp connection reading");
-            client->read();
-            return true;
-          }
-          return false;
-        });
+        return;
       }
-      else
+      if (nread == UV_ENOBUFS)
       {
-        LogDebug("Queued ", event.length, " bytes");
+        // alloc_stream_space found the ring buffer full
+        pause_reading(client, *stream);
+        return;
       }
+      if (nread < 0)
+      {
+        auto err = static_cast<int>(nread);
+        on_tcp_error(client, uv_err_name(err), uv_strerror(err));
+        return;
+      }
+
+      LogTrace(
+          client.peer().ip,
+          ":",
+          client.peer().port,
+          " → belnet ",
+          buffer_printer{std::string_view{buf->base, static_cast<size_t>(nread)}});
+      stream->commit(nread);
+      if (stream->available() == 0)
+        pause_reading(client, *stream);
+      else
+        LogDebug("Queued ", nread, " bytes");
+    }
+
+    // Starts (or resumes) reading from the local tcp socket straight into its stream's buffer.  We
+    // bypass uvw's DataEvent here because it always reads into a freshly allocated buffer.
+    void
+    start_reading(uvw::TCPHandle& tcp)
+    {
+      auto* handle = reinterpret_cast<uv_stream_t*>(tcp.raw());
+      if (int err = uv_read_start(handle, alloc_stream_space, on_outgoing_data); err != 0)
+        on_tcp_error(tcp, uv_err_name(err), uv_strerror(err));
     }
 
     // Received data from the quic tunnel and sends it to the TCP connection
@@ -109,31 +198,10 @@ namespace llarp::quic
         }
         c.data(nullptr);
       });
-      tcp.on<uvw::EndEvent>([](auto&, uvw::TCPHandle& c) {
-        // This fires on eof, most likely because the other side of the TCP connection closed it.
-        LogInfo("EOF on connection to ", c.peer().ip, ":", c.peer().port);
-        c.close();
-      });
+      // EOF and read errors are handled in on_outgoing_data; this catches write errors.
       tcp.on<uvw::ErrorEvent>([](const uvw::ErrorEvent& e, uvw::TCPHandle& tcp) {
-        LogError(
-            "ErrorEvent[",
-            e.name(),
-            ": ",
-            e.what(),
-            "] on connection with ",
-            tcp.peer().ip,
-            ":",
-            tcp.peer().port,
-            ", shutting down quic stream");
-        if (auto stream = tcp.data<Stream>())
-        {
-          stream->close(tunnel::ERROR_TCP);
-          stream->data(nullptr);
-          tcp.data(nullptr);
-        }
-        // tcp.closeReset();
+        on_tcp_error(tcp, e.name(), e.what());
       });
-      tcp.on<uvw::DataEvent>(on_outgoing_data);
       stream.data_callback = on_incoming_data;
       stream.close_callback = close_tcp_pair;
     }
@@ -156,8 +224,8 @@ namespace llarp::quic
       if (auto b0 = bdata[0]; b0 == tunnel::CONNECT_INIT)
       {
         // Set up callbacks, which replaces both of these initial callbacks
-        client.read();  // Unfreeze (we stop() before putting into pending)
         install_stream_forwarding(client, stream);
+        start_reading(client);  // Unfreeze (we stop() before putting into pending)
 
         if (bdata.size() > 1)
         {
@@ -202,6 +270,50 @@ namespace llarp::quic
         client.close();
     }
 
+    // Initial data handler for in-process streams (see TunnelManager::open_stream): once the
+    // remote confirms its end of the tunnel we hand the stream over to the caller's callback,
+    // which installs its own handlers, and forward it anything that came after CONNECT_INIT.
+    void
+    initial_stream_data_handler(
+        std::shared_ptr<TunnelManager::StreamOpenCallback> on_open,
+        Stream& stream,
+        bstring_view bdata)
+    {
+      if (bdata.empty())
+        return;
+      stream.data_callback = nullptr;
+      stream.close_callback = nullptr;
+      if (bdata[0] != tunnel::CONNECT_INIT)
+      {
+        LogWarn(
+            "Remote connection returned invalid initial byte (0x",
+            oxenc::to_hex(bdata.begin(), bdata.begin() + 1),
+            "); dropping stream");
+        stream.close(tunnel::ERROR_BAD_INIT);
+        (*on_open)(nullptr);
+        return;
+      }
+      (*on_open)(stream.shared_from_this());
+      if (bdata.size() > 1 and stream.data_callback)
+      {
+        bdata.remove_prefix(1);
+        stream.data_callback(stream, bdata);
+      }
+    }
+
+    void
+    initial_stream_close_handler(
+        std::shared_ptr<TunnelManager::StreamOpenCallback> on_open,
+        Stream&,
+        std::optional<uint64_t> error_code)
+    {
+      LogDebug(
+          "In-process stream closed ",
+          error_code ? "with error " + std::to_string(*error_code) : "gracefully",
+          " before the remote end was established");
+      (*on_open)(nullptr);
+    }
+
   }  // namespace
 
   TunnelManager::TunnelManager(EndpointBase& se) : service_endpoint_{se}
@@ -209,6 +321,7 @@ namespace llarp::quic
     // Cleanup callback to clear out closed tunnel connections
     service_endpoint_.Loop()->call_every(500ms, timer_keepalive_, [this] {
       LogTrace("Checking quic tunnels for finished connections");
+      const auto now = service_endpoint_.Loop()->time_now();
       for (auto ctit = client_tunnels_.begin(); ctit != client_tunnels_.end();)
       {
         // Clear any accepted connections that have been closed:
@@ -227,11 +340,27 @@ namespace llarp::quic
             ++it;
         }
 
-        // If there are not accepted connections left *and* we stopped listening for new ones then
-        // destroy the whole thing.
-        if (ct.conns.empty() and (not ct.tcp or not ct.tcp->active()))
+        ct.streams.erase(
+            std::remove_if(
+                ct.streams.begin(),
+                ct.streams.end(),
+                [](const auto& stream) { return stream.expired(); }),
+            ct.streams.end());
+
+        // If there are not accepted connections or in-process streams left *and* we stopped
+        // listening for new ones then destroy the whole thing.
+        if (ct.conns.empty() and ct.streams.empty() and ct.pending_streams.empty()
+            and (not ct.tcp or not ct.tcp->active()))
         {
+          if (keep_pooled(port, ct, now))
+          {
+            ++ctit;
+            continue;
+          }
           LogDebug("All sockets closed on quic:", port, ", destroying tunnel data");
+          if (auto it = connection_pool_.find(ct.pool_key);
+              it != connection_pool_.end() and it->second == port)
+            connection_pool_.erase(it);
           ctit = client_tunnels_.erase(ctit);
         }
         else
@@ -246,7 +375,9 @@ namespace llarp::quic
   {
     // auto loop = get_loop();
 
-    server_ = std::make_unique<Server>(service_endpoint_);
+    server_ = std::make_unique<Server>(service_endpoint_, transport_settings);
+    // Tunnel tcp reads land directly in the stream ring buffer
+    server_->default_stream_buffer_size = tunnel::STREAM_BUFFER_SIZE;
     server_->stream_open_callback = [this](Stream& stream, uint16_t port) -> bool {
       stream.close_callback = close_tcp_pair;
 
@@ -296,8 +427,8 @@ namespace llarp::quic
             assert(stream->used() == 0);
 
             // Send the magic byte, and start reading from the tcp tunnel in the logic thread
-            stream->append_buffer(new std::byte[1]{tunnel::CONNECT_INIT}, 1);
-            tcp.read();
+            stream->append(bstring_view{&tunnel::CONNECT_INIT, 1});
+            start_reading(tcp);
           });
 
       tcp->connect(*tunnel_to->operator const sockaddr*());
@@ -419,7 +550,8 @@ namespace llarp::quic
     if (!step_success)
     {
       LogWarn("QUIC tunnel to ", addr, " failed during ", step_name, "; aborting tunnel");
-      it->second.tcp->close();
+      if (it->second.tcp)
+        it->second.tcp->close();
       if (it->second.open_cb)
         it->second.open_cb(false);
       client_tunnels_.erase(it);
@@ -427,6 +559,40 @@ namespace llarp::quic
     return step_success;
   }
 
+  std::shared_ptr<Client>
+  TunnelManager::pooled_client(const std::string& key)
+  {
+    auto it = connection_pool_.find(key);
+    if (it == connection_pool_.end())
+      return nullptr;
+    if (auto ct = client_tunnels_.find(it->second);
+        ct != client_tunnels_.end() and ct->second.client)
+    {
+      auto conn = ct->second.client->get_connection();
+      if (conn and not conn->closing and not conn->draining)
+        return ct->second.client;
+    }
+    connection_pool_.erase(it);
+    return nullptr;
+  }
+
+  bool
+  TunnelManager::keep_pooled(uint16_t pseudo_port, ClientTunnel& ct, llarp_time_t now)
+  {
+    auto it = connection_pool_.find(ct.pool_key);
+    if (it == connection_pool_.end() or it->second != pseudo_port)
+      return false;
+    // Other tunnels still have streams on our connection, and its packets are routed through us
+    if (ct.client.use_count() > 1)
+    {
+      ct.idle_since.reset();
+      return true;
+    }
+    if (not ct.idle_since)
+      ct.idle_since = now;
+    return now - *ct.idle_since < pool_linger and pooled_client(ct.pool_key);
+  }
+
   std::pair<SockAddr, uint16_t>
   TunnelManager::open(
       std::string_view remote_address, uint16_t port, OpenCallback on_open, SockAddr bind_addr)
@@ -436,13 +602,7 @@ namespace llarp::quic
     std::pair<SockAddr, uint16_t> result;
     auto& [saddr, pport] = result;
 
-    auto maybe_remote = service::ParseAddress(remote_addr);
-    if (!maybe_remote)
-    {
-      if (not service::NameIsValid(remote_addr))
-        throw std::invalid_argument{"Invalid remote belnet name/address"};
-      // Otherwise it's a valid ONS name, so we'll initiate an ONS lookup below
-    }
+    check_remote(remote_addr);
 
     // Open the TCP tunnel right away; it will just block new incoming connections until the quic
     // connection is established, but this still allows the caller to connect right away and queue
@@ -486,13 +646,7 @@ namespace llarp::quic
     auto bound = tcp_tunnel->sock();
     saddr = SockAddr{bound.ip, huint16_t{static_cast<uint16_t>(bound.port)}};
 
-    // Find the first unused psuedo-port value starting from next_pseudo_port_.
-    if (auto p = find_unused_key(client_tunnels_, next_pseudo_port_))
-      pport = *p;
-    else
-      throw std::runtime_error{
-          "Unable to open an outgoing quic connection: too many existing connections"};
-    (next_pseudo_port_ = pport)++;
+    pport = claim_pseudo_port();
 
     LogInfo("Bound TCP tunnel ", saddr, " for quic client :", pport);
 
@@ -506,6 +660,49 @@ namespace llarp::quic
     // accept handler, and to let the accept handler know that `this` is still safe to use.
     ct.tcp->data(std::make_shared<uint16_t>(pport));
 
+    connect_tunnel(pport, std::move(remote_addr), port);
+    return result;
+  }
+
+  void
+  TunnelManager::check_remote(const std::string& remote_addr)
+  {
+    // Anything that isn't a belnet address has to be a valid ONS name, which connect_tunnel will
+    // look up
+    if (not service::ParseAddress(remote_addr) and not service::NameIsValid(remote_addr))
+      throw std::invalid_argument{"Invalid remote belnet name/address"};
+  }
+
+  uint16_t
+  TunnelManager::claim_pseudo_port()
+  {
+    // Find the first unused psuedo-port value starting from next_pseudo_port_.
+    uint16_t pport;
+    if (auto p = find_unused_key(client_tunnels_, next_pseudo_port_))
+      pport = *p;
+    else
+      throw std::runtime_error{
+          "Unable to open an outgoing quic connection: too many existing connections"};
+    (next_pseudo_port_ = pport)++;
+    return pport;
+  }
+
+  void
+  TunnelManager::connect_tunnel(uint16_t pport, std::string remote_addr, uint16_t port)
+  {
+    auto& ct = client_tunnels_.at(pport);
+    ct.pool_key = fmt::format("{}:{}", remote_addr, port);
+
+    if (auto client = pooled_client(ct.pool_key))
+    {
+      LogInfo("Reusing pooled quic connection to ", ct.pool_key, " for quic client :", pport);
+      ct.client = std::move(client);
+      flush_pending_incoming(ct);
+      return;
+    }
+
+    auto maybe_remote = service::ParseAddress(remote_addr);
+
     auto after_path = [this, port, pport = pport, remote_addr](auto maybe_convo) {
       if (not continue_connecting(pport, (bool)maybe_convo, "path build", remote_addr))
         return;
@@ -530,7 +727,7 @@ namespace llarp::quic
             service_endpoint_.MarkAddressOutbound(*maybe_remote);
             service_endpoint_.EnsurePathTo(*maybe_remote, after_path, open_timeout);
           });
-      return result;
+      return;
     }
 
     auto& remote = *maybe_remote;
@@ -543,14 +740,27 @@ namespace llarp::quic
       service_endpoint_.MarkAddressOutbound(remote);
       service_endpoint_.EnsurePathTo(remote, after_path, open_timeout);
     }
+  }
 
-    return result;
+  void
+  TunnelManager::open_stream(std::string_view remote_address, uint16_t port, StreamOpenCallback cb)
+  {
+    assert(cb);
+    std::string remote_addr = lowercase_ascii_string(std::string{remote_address});
+    check_remote(remote_addr);
+
+    auto pport = claim_pseudo_port();
+    LogInfo("Opening in-process stream to ", remote_addr, ":", port, " on quic client :", pport);
+    auto& ct = client_tunnels_[pport];
+    ct.pending_streams.push(std::move(cb));
+
+    connect_tunnel(pport, std::move(remote_addr), port);
   }
 
   void
   TunnelManager::close(int id)
   {
-    if (auto it = client_tunnels_.find(id); it != client_tunnels_.end())
+    if (auto it = client_tunnels_.find(id); it != client_tunnels_.end() and it->second.tcp)
     {
       it->second.tcp->close();
       it->second.tcp->data(nullptr);
@@ -579,6 +789,12 @@ namespace llarp::quic
       }
       pending_incoming.pop();
     }
+
+    while (not pending_streams.empty())
+    {
+      pending_streams.front()(nullptr);
+      pending_streams.pop();
+    }
   }
 
   void
@@ -587,13 +803,17 @@ namespace llarp::quic
     assert(remote.getPort() > 0);
     auto& [pport, tunnel] = row;
     assert(not tunnel.client);
-    tunnel.client = std::make_unique<Client>(service_endpoint_, remote, pport);
+    tunnel.client = std::make_shared<Client>(service_endpoint_, remote, pport, transport_settings);
     auto conn = tunnel.client->get_connection();
+    if (not tunnel.pool_key.empty() and not pooled_client(tunnel.pool_key))
+      connection_pool_[tunnel.pool_key] = pport;
 
-    conn->on_stream_available = [this, id = row.first](Connection&) {
+    conn->on_stream_available = [this, id = row.first, client = tunnel.client.get()](Connection&) {
       LogDebug("QUIC connection :", id, " established; streams now available");
-      if (auto it = client_tunnels_.find(id); it != client_tunnels_.end())
-        flush_pending_incoming(it->second);
+      // Flush every tunnel sharing this connection, not just the one that created it
+      for (auto& [id, ct] : client_tunnels_)
+        if (ct.client.get() == client)
+          flush_pending_incoming(ct);
     };
   }
 
@@ -633,17 +853,49 @@ namespace llarp::quic
       LogTrace("Set up new stream");
       conn.io_ready();
     }
+
+    while (available > 0 and not ct.pending_streams.empty())
+    {
+      auto on_open =
+          std::make_shared<StreamOpenCallback>(std::move(ct.pending_streams.front()));
+      ct.pending_streams.pop();
+      try
+      {
+        auto str = conn.open_stream(
+            [on_open](auto&&... args) {
+              initial_stream_data_handler(on_open, std::forward<decltype(args)>(args)...);
+            },
+            [on_open](auto&&... args) {
+              initial_stream_close_handler(on_open, std::forward<decltype(args)>(args)...);
+            });
+        ct.streams.push_back(str);
+        available--;
+      }
+      catch (const std::exception& e)
+      {
+        LogWarn("Opening quic stream failed: ", e.what());
+        (*on_open)(nullptr);
+      }
+      conn.io_ready();
+    }
   }
 
   void
   TunnelManager::receive_packet(const service::ConvoTag& tag, const llarp_buffer_t& buf)
   {
-    if (buf.sz <= 4)
+    if (buf.sz < 4)
     {
       LogWarn("invalid quic packet: packet size (", buf.sz, ") too small");
       return;
     }
     auto type = static_cast<std::byte>(buf.base[0]);
+    const bool coalesced = (type & COALESCED) != std::byte{0};
+    type &= ~COALESCED;
+    if (buf.sz == 4 and not coalesced)
+    {
+      LogWarn("invalid quic packet: packet size (", buf.sz, ") too small");
+      return;
+    }
     nuint16_t pseudo_port_n;
     std::memcpy(&pseudo_port_n.n, &buf.base[1], 2);
     uint16_t pseudo_port = ToHost(pseudo_port_n).h;
@@ -695,6 +947,9 @@ namespace llarp::quic
       LogWarn("Invalid incoming quic packet type ", type, "; dropping packet");
       return;
     }
-    ep->receive_packet(remote, ecn, data);
+    if (coalesced)
+      ep->receive_coalesced(remote, ecn, data);
+    else
+      ep->receive_packet(remote, ecn, data);
   }
 }  // namespace llarp::quic
@@ -8,8 +8,12 @@
 
 #include <charconv>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <queue>
+#include <vector>
 
 #include <uvw/tcp.h>
 
@@ -31,9 +35,13 @@ namespace llarp::quic
     // failure)
     inline constexpr uint64_t ERROR_TCP{0x5471909};
 
-    // We pause reading from the local TCP socket if we have more than this amount of outstanding
-    // unacked data in the quic tunnel, then resume once it drops below this.
-    inline constexpr size_t PAUSE_SIZE = 64 * 1024;
+    // Local TCP reads go straight into the quic stream's ring buffer, so this bounds how much
+    // unacked data a tunnel connection can have in flight.
+    inline constexpr size_t STREAM_BUFFER_SIZE = 256 * 1024;
+
+    // We pause reading from the local TCP socket when its stream buffer is full, then resume once
+    // acks have freed at least this much of it.
+    inline constexpr size_t RESUME_SIZE = 64 * 1024;
   }  // namespace tunnel
 
   /// Manager class for incoming and outgoing QUIC tunnels.
@@ -49,6 +57,13 @@ namespace llarp::quic
     // includes the resolution time.
     std::chrono::milliseconds open_timeout = 4s;
 
+    // Transport settings for the quic connections of tunnels created from now on
+    TransportSettings transport_settings;
+
+    // How long we keep a quic connection open for reuse by later `open()` calls to the same remote
+    // and port after the last tunnel using it has closed.
+    std::chrono::milliseconds pool_linger = 60s;
+
     TunnelManager(EndpointBase& endpoint);
 
     /// Adds an incoming listener callback.  When a new incoming quic connection is initiated to us
@@ -98,6 +113,9 @@ namespace llarp::quic
     /// established.
     ///
     /// Each connection to the local TCP socket establishes a new stream over the QUIC connection.
+    /// If we already have a (live or still handshaking) QUIC connection to the same remote and port
+    /// from an earlier `open()` then the new tunnel opens its streams on that connection rather
+    /// than making a new one.
     ///
     /// \return a pair:
     /// - SockAddr containing the just-opened localhost socket that tunnels to the remote.  This is
@@ -117,6 +135,19 @@ namespace llarp::quic
         OpenCallback on_open = {},
         SockAddr bind_addr = {127, 0, 0, 1});
 
+    /// Called when `open_stream` finishes: with the stream once the remote has accepted it, or with
+    /// nullptr if the stream could not be opened.  On success the callback should set the stream's
+    /// data_callback and close_callback.
+    using StreamOpenCallback = std::function<void(std::shared_ptr<Stream>)>;
+
+    /// Opens a stream to the tunneled port `port` of a remote without a local TCP socket, for
+    /// in-process users of the stream (such as libbelnet's stream API) that want to read and write
+    /// its data directly.  Otherwise this works like `open()`, including reusing a pooled
+    /// connection to the same remote and port.  Should only be called from the event loop thread;
+    /// throws std::invalid_argument if `remote_addr` is not a valid address or ONS name.
+    void
+    open_stream(std::string_view remote_addr, uint16_t port, StreamOpenCallback on_open);
+
     /// Start closing an outgoing tunnel; takes the ID returned by `open()`.  Note that an existing
     /// established tunneled connections will not be forcibly closed; this simply stops accepting
     /// new tunnel connections.
@@ -143,8 +174,14 @@ namespace llarp::quic
 
     struct ClientTunnel
     {
-      // quic endpoint
-      std::unique_ptr<Client> client;
+      // quic endpoint; shared with later tunnels to the same remote and port, which open their
+      // streams on its connection
+      std::shared_ptr<Client> client;
+      // `remote:port` this tunnel connects to, if its client is in the connection pool
+      std::string pool_key;
+      // When the tunnel last became idle (no listener, connections or sharing tunnels); used to
+      // expire pooled connections after `pool_linger`.
+      std::optional<llarp_time_t> idle_since;
       // Callback to invoke on quic connection established (true argument) or failed (false arg)
       OpenCallback open_cb;
       // TCP listening socket
@@ -154,6 +191,9 @@ namespace llarp::quic
       // Queue of incoming connections that are waiting for a stream to become available (either
       // because we are still handshaking, or we reached the stream limit).
       std::queue<std::weak_ptr<uvw::TCPHandle>> pending_incoming;
+      // In-process streams (from open_stream) waiting to be opened, and those we opened
+      std::queue<StreamOpenCallback> pending_streams;
+      std::vector<std::weak_ptr<Stream>> streams;
 
       ~ClientTunnel();
     };
@@ -162,7 +202,33 @@ namespace llarp::quic
     // right quic endpoint); pseudo-ports start at 1.
     std::map<uint16_t, ClientTunnel> client_tunnels_;
 
+    // `remote:port` -> pseudo-port of the tunnel that owns the pooled connection to it.  Incoming
+    // quic packets for a pooled connection are routed to that tunnel's pseudo-port.
+    std::unordered_map<std::string, uint16_t> connection_pool_;
+
+    // Returns the pooled client for `key` if it still has a usable connection
+    std::shared_ptr<Client>
+    pooled_client(const std::string& key);
+
+    // Returns true if an otherwise finished tunnel should be kept because it owns a pooled
+    // connection that is still shared or has not lingered for `pool_linger` yet.
+    bool
+    keep_pooled(uint16_t pseudo_port, ClientTunnel& ct, llarp_time_t now);
+
     uint16_t next_pseudo_port_ = 0;
+
+    // Throws std::invalid_argument if remote_addr is neither a belnet address nor an ONS name
+    void
+    check_remote(const std::string& remote_addr);
+
+    // Returns the next free pseudo-port; throws if they are all in use
+    uint16_t
+    claim_pseudo_port();
+
+    // Connects the (already emplaced) tunnel at `pseudo_port` to `port` on the remote, resolving
+    // ONS names and building paths as needed, or attaches it to a pooled connection.
+    void
+    connect_tunnel(uint16_t pseudo_port, std::string remote_addr, uint16_t port);
     // bool pport_wrapped_ = false;
 
     bool
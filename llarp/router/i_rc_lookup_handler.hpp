@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace llarp
@@ -22,6 +23,32 @@ namespace llarp
   using RCRequestCallback =
       std::function<void(const RouterID&, const RouterContact* const, const RCRequestResult)>;
 
+  /// which of the master node lists a registered router belongs on
+  enum class MasterNodeStatus
+  {
+    /// active; the whitelist
+    Active,
+    /// funded but decommissioned; the greylist
+    Decommissioned,
+    /// registered but not yet fully funded; the greenlist
+    Unfunded
+  };
+
+  /// changes to the master node lists since the previous update
+  struct MasterNodeListUpdate
+  {
+    /// routers that are newly registered or whose status changed, with their new status
+    std::vector<std::pair<RouterID, MasterNodeStatus>> changed;
+    /// routers that are no longer registered
+    std::vector<RouterID> removed;
+
+    bool
+    empty() const
+    {
+      return changed.empty() and removed.empty();
+    }
+  };
+
   struct I_RCLookupHandler
   {
     virtual ~I_RCLookupHandler() = default;
@@ -38,6 +65,10 @@ namespace llarp
         const std::vector<RouterID>& greylist,
         const std::vector<RouterID>& greenlist) = 0;
 
+    /// applies the changes in update to the lists set by SetRouterWhitelist
+    virtual void
+    UpdateRouterWhitelist(const MasterNodeListUpdate& update) = 0;
+
     virtual void
     GetRC(const RouterID& router, RCRequestCallback callback, bool forceLookup = false) = 0;
 
@@ -4,6 +4,7 @@
 #include "router.hpp"
 #include <llarp/constants/link_layer.hpp>
 #include <llarp/util/meta/memfn.hpp>
+#include <llarp/util/metrics.hpp>
 #include <llarp/util/status.hpp>
 
 #include <algorithm>
@@ -13,6 +14,32 @@ namespace llarp
 {
   const PathID_t OutboundMessageHandler::zeroID;
 
+  namespace
+  {
+    /// m_queueStats as exported to the metrics registry
+    struct QueueMetrics
+    {
+      metrics::Counter& queued;
+      metrics::Counter& dropped;
+      metrics::Counter& sent;
+      metrics::Gauge& depth;
+    };
+
+    QueueMetrics&
+    Metrics()
+    {
+      auto& reg = metrics::Registry::Global();
+      static QueueMetrics m{
+          reg.GetCounter("belnet_outbound_messages_queued_total", "link messages queued to send"),
+          reg.GetCounter(
+              "belnet_outbound_messages_dropped_total", "link messages dropped by congestion"),
+          reg.GetCounter("belnet_outbound_messages_sent_total", "link messages handed to links"),
+          reg.GetGauge("belnet_outbound_queue_depth", "link messages waiting in the shared queue"),
+      };
+      return m;
+    }
+  }  // namespace
+
   using namespace std::chrono_literals;
 
   OutboundMessageHandler::OutboundMessageHandler(size_t maxQueueSize)
@@ -81,6 +108,7 @@ namespace llarp
   void
   OutboundMessageHandler::Pump()
   {
+    trace::ScopedTimer timer{trace::Stage::OutboundPump};
     m_Killer.TryAccess([this]() {
       recentlyRemovedPaths.Decay();
       ProcessOutboundQueue();
@@ -175,7 +203,8 @@ namespace llarp
   bool
   OutboundMessageHandler::EncodeBuffer(const ILinkMessage& msg, llarp_buffer_t& buf)
   {
-    if (!msg.BEncode(&buf))
+    // messages without a compact form fall back to bencode
+    if (!msg.EncodeCompact(&buf) and !msg.BEncode(&buf))
     {
       LogWarn("failed to encode outbound message, buffer size left: ", buf.size_left());
       return false;
@@ -191,7 +220,9 @@ namespace llarp
   OutboundMessageHandler::Send(const MessageQueueEntry& ent)
   {
     const llarp_buffer_t buf{ent.message};
+    ent.queued.Record(trace::Stage::OutboundQueue);
     m_queueStats.sent++;
+    Metrics().sent.Inc();
     SendStatusHandler callback = ent.inform;
     return _router->linkManager().SendTo(
         ent.router,
@@ -227,12 +258,15 @@ namespace llarp
     if (outboundQueue.tryPushBack(std::move(entry)) != llarp::thread::QueueReturn::Success)
     {
       m_queueStats.dropped++;
+      Metrics().dropped.Inc();
       DoCallback(callback, SendStatus::Congestion);
     }
     else
     {
       m_queueStats.queued++;
       uint32_t queueSize = outboundQueue.size();
+      Metrics().queued.Inc();
+      Metrics().depth.Set(queueSize);
       m_queueStats.queueWatermark = std::max(queueSize, m_queueStats.queueWatermark);
     }
 
@@ -270,8 +304,10 @@ namespace llarp
       {
         DoCallback(entry.inform, SendStatus::Congestion);
         m_queueStats.dropped++;
+        Metrics().dropped.Inc();
       }
     }
+    Metrics().depth.Set(0);
   }
 
   bool
@@ -5,6 +5,7 @@
 #include <llarp/ev/ev.hpp>
 #include <llarp/util/thread/queue.hpp>
 #include <llarp/util/decaying_hashset.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include <llarp/path/path_types.hpp>
 #include <llarp/util/priority_queue.hpp>
 #include <llarp/router_id.hpp>
@@ -81,6 +82,9 @@ namespace llarp
     struct MessageQueueEntry
     {
       uint16_t priority;
+      /// when the message was queued; an empty struct without latency tracing, which fits in the
+      /// padding after priority, but 8 more bytes per entry with it
+      trace::Stamp queued;
       std::vector<byte_t> message;
       SendStatusHandler inform;
       PathID_t pathid;
@@ -123,6 +127,8 @@ namespace llarp
     void
     QueueSessionCreation(const RouterID& remote);
 
+    /// encode msg into buf, in the compact relay framing if msg has one; the link layer turns
+    /// that back into bencode for sessions that didn't agree to it
     bool
     EncodeBuffer(const ILinkMessage& msg, llarp_buffer_t& buf);
 
@@ -56,6 +56,48 @@ namespace llarp
     LogInfo("belnet master node list now has ", whitelistRouters.size(), " active routers");
   }
 
+  void
+  RCLookupHandler::UpdateRouterWhitelist(const MasterNodeListUpdate& update)
+  {
+    if (update.empty())
+      return;
+    util::Lock l(_mutex);
+
+    for (const auto& router : update.removed)
+    {
+      whitelistRouters.erase(router);
+      greylistRouters.erase(router);
+      greenlistRouters.erase(router);
+    }
+    for (const auto& [router, status] : update.changed)
+    {
+      whitelistRouters.erase(router);
+      greylistRouters.erase(router);
+      greenlistRouters.erase(router);
+      switch (status)
+      {
+        case MasterNodeStatus::Active:
+          whitelistRouters.insert(router);
+          break;
+        case MasterNodeStatus::Decommissioned:
+          greylistRouters.insert(router);
+          break;
+        case MasterNodeStatus::Unfunded:
+          greenlistRouters.insert(router);
+          break;
+      }
+    }
+
+    LogInfo(
+        "belnet master node list now has ",
+        whitelistRouters.size(),
+        " active routers (",
+        update.changed.size(),
+        " changed, ",
+        update.removed.size(),
+        " removed)");
+  }
+
   bool
   RCLookupHandler::HaveReceivedWhitelist() const
   {
@@ -69,7 +111,7 @@ namespace llarp
     RouterContact remoteRC;
     if (not forceLookup)
     {
-      if (const auto maybe = _nodedb->Get(router); maybe.has_value())
+      if (const auto maybe = _nodedb->Get(router))
       {
         remoteRC = *maybe;
         if (callback)
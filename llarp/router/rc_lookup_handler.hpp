@@ -48,6 +48,9 @@ namespace llarp
 
         ) override EXCLUDES(_mutex);
 
+    void
+    UpdateRouterWhitelist(const MasterNodeListUpdate& update) override EXCLUDES(_mutex);
+
     bool
     HaveReceivedWhitelist() const override;
 
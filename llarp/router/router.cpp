@@ -15,6 +15,7 @@
 #include <stdexcept>
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/logging.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include <llarp/util/meta/memfn.hpp>
 #include <llarp/util/str.hpp>
 #include <llarp/ev/ev.hpp>
@@ -84,6 +85,7 @@ namespace llarp
     llarp::LogTrace("Router::PumpLL() start");
     if (_stopping.load())
       return;
+    trace::ScopedTimer timer{trace::Stage::RouterPump};
     paths.PumpDownstream();
     paths.PumpUpstream();
     _hiddenServiceContext.Pump();
@@ -105,6 +107,7 @@ namespace llarp
         {"services", _hiddenServiceContext.ExtractStatus()},
         {"exit", _exitContext.ExtractStatus()},
         {"links", _linkManager.ExtractStatus()},
+        {"transitBuilds", pathContext().ExtractStatus()},
         {"outboundMessages", _outboundMessageHandler.ExtractStatus()}};
   }
 
@@ -429,6 +432,7 @@ namespace llarp
 
     if (enableRPCServer)
       rpcBindAddr = oxenmq::address(conf.api.m_rpcBindAddr);
+    metricsBindAddr = conf.api.m_metricsBindAddr;
 
     log::debug(logcat, "Starting RPC server");
     if (not StartRpcServer())
@@ -1172,7 +1176,7 @@ namespace llarp
     LogInfo("Session to ", remote, " fully closed");
     if (IsMasterNode())
       return;
-    if (const auto maybe = nodedb()->Get(remote); maybe.has_value())
+    if (const auto maybe = nodedb()->Get(remote))
     {
       for (const auto& addr : maybe->addrs)
         m_RoutePoker->DelRoute(addr.IPv4());
@@ -1268,6 +1272,11 @@ namespace llarp
       m_RPCServer->AsyncServeRPC(rpcBindAddr);
       LogInfo("Bound RPC server to ", rpcBindAddr.full_address());
     }
+    if (metricsBindAddr)
+    {
+      m_MetricsServer = std::make_unique<rpc::MetricsServer>();
+      m_MetricsServer->Start(_loop, *metricsBindAddr);
+    }
 
     return true;
   }
@@ -1524,6 +1533,7 @@ namespace llarp
   Router::StopLinks()
   {
     _linkManager.Stop();
+    m_MetricsServer.reset();
   }
 
   void
@@ -27,6 +27,7 @@
 #include <llarp/routing/message_parser.hpp>
 #include <llarp/rpc/beldexd_rpc_client.hpp>
 #include <llarp/rpc/rpc_server.hpp>
+#include <llarp/rpc/metrics_server.hpp>
 #include <llarp/service/context.hpp>
 #include <stdexcept>
 #include <llarp/util/buffer.hpp>
@@ -302,6 +303,8 @@ namespace llarp
     bool enableRPCServer = false;
     oxenmq::address rpcBindAddr = DefaultRPCBindAddr;
     std::unique_ptr<rpc::RpcServer> m_RPCServer;
+    std::optional<SockAddr> metricsBindAddr;
+    std::unique_ptr<rpc::MetricsServer> m_MetricsServer;
 
     const llarp_time_t _randomStartDelay;
 
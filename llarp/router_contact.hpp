@@ -12,6 +12,7 @@
 #include "llarp/dns/srv_data.hpp"
 
 #include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <vector>
 
@@ -222,6 +223,9 @@ namespace llarp
   constexpr inline bool IsToStringFormattable<RouterContact> = true;
 
   using RouterLookupHandler = std::function<void(const std::vector<RouterContact>&)>;
+
+  /// an immutable rc shared between the nodedb and whoever looked it up
+  using RouterContact_ptr = std::shared_ptr<const RouterContact>;
 }  // namespace llarp
 
 namespace std
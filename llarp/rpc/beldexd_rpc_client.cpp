@@ -9,6 +9,8 @@
 
 #include <oxenc/bt.h>
 
+#include <algorithm>
+
 #include <oxenc/hex.h>
 
 #include <llarp/util/time.hpp>
@@ -118,22 +120,11 @@ namespace llarp
       if (m_UpdatingList.exchange(true))
         return;  // update already in progress
 
-      nlohmann::json request{
-          {"fields",
-           {
-               {"pubkey_ed25519", true},
-               {"master_node_pubkey", true},
-               {"funded", true},
-               {"active", true},
-               {"block_hash", true},
-           }},
-      };
-      if (!m_LastUpdateHash.empty())
-        request["fields"]["poll_block_hash"] = m_LastUpdateHash;
+      // A bt-encoded request gets a bt-encoded reply, which is much cheaper to produce and
+      // consume than json for a few thousand master nodes.
       Request(
           "rpc.get_master_nodes",
           [self = shared_from_this()](bool success, std::vector<std::string> data) {
-
             if (not success)
               LogWarn("failed to update master node list");
             else if (data.size() < 2)
@@ -142,20 +133,14 @@ namespace llarp
             {
               try
               {
-                auto json = nlohmann::json::parse(std::move(data[1]));
-                if (json.at("status") != "OK")
-                  throw std::runtime_error{"get_master_nodes did not return 'OK' status"};
-                if (auto it = json.find("unchanged");
-                    it != json.end() and it->is_boolean() and it->get<bool>())
-                  LogDebug("master node list unchanged");
-                else
+                std::string blockHash;
+                if (auto entries = MasterNodeList::ParseReply(data[1], blockHash))
                 {
-                  self->HandleNewMasterNodeList(json.at("master_node_states"));
-                  if (auto it = json.find("block_hash"); it != json.end() and it->is_string())
-                    self->m_LastUpdateHash = it->get<std::string>();
-                  else
-                    self->m_LastUpdateHash.clear();
+                  self->HandleNewMasterNodeList(std::move(*entries));
+                  self->m_LastUpdateHash = std::move(blockHash);
                 }
+                else
+                  LogDebug("master node list unchanged");
               }
               catch (const std::exception& ex)
               {
@@ -166,7 +151,7 @@ namespace llarp
             // with the previous update; and 2) so that m_UpdatingList also guards m_LastUpdateHash
             self->m_UpdatingList = false;
           },
-          request.dump());
+          MasterNodeList::MakeRequest(m_LastUpdateHash));
     }
 
     void
@@ -210,6 +195,12 @@ namespace llarp
         // reason (e.g. beldexd restarts and loses the subscription); we poll using the last known
         // hash so that the poll is very cheap (basically empty) if the block hasn't advanced.
         self->UpdateMasterNodeList();
+        // the diffs alone never undo whitelist changes made elsewhere, so periodically push
+        // the whole list even if beldexd has nothing new for us.
+        r->loop()->call([self, r]() {
+          if (self->m_MasterNodes.Resync(r->rcLookupHandler(), r->Now()))
+            LogDebug("resynced full master node list");
+        });
       };
       // Fire one ping off right away to get things going.
       makePingRequest();
@@ -217,63 +208,23 @@ namespace llarp
     }
 
     void
-    BeldexdRpcClient::HandleNewMasterNodeList(const nlohmann::json& j)
+    BeldexdRpcClient::HandleNewMasterNodeList(std::vector<MasterNodeList::Entry> entries)
     {
-      std::unordered_map<RouterID, PubKey> keymap;
-      std::vector<RouterID> activeNodeList, decommNodeList, unfundedNodeList;
-      if (not j.is_array())
-        throw std::runtime_error{
-            "Invalid master node list: expected array of master node states"};
-
-      for (auto& mnode : j)
-      {
-        const auto ed_itr = mnode.find("pubkey_ed25519");
-        if (ed_itr == mnode.end() or not ed_itr->is_string())
-          continue;
-        const auto svc_itr = mnode.find("master_node_pubkey");
-        if (svc_itr == mnode.end() or not svc_itr->is_string())
-          continue;
-        const auto active_itr = mnode.find("active");
-        if (active_itr == mnode.end() or not active_itr->is_boolean())
-          continue;
-        const bool active = active_itr->get<bool>();
-
-        const auto funded_itr = mnode.find("funded");
-        if (funded_itr == mnode.end() or not funded_itr->is_boolean())
-          continue;
-        const bool funded = funded_itr->get<bool>();
-
-        RouterID rid;
-        PubKey pk;
-        if (not rid.FromHex(ed_itr->get<std::string_view>())
-            or not pk.FromHex(svc_itr->get<std::string_view>()))
-          continue;
-
-        keymap[rid] = pk;
-        (active       ? activeNodeList
-             : funded ? decommNodeList
-                      : unfundedNodeList)
-            .push_back(std::move(rid));
-      }
-
-      if (activeNodeList.empty())
+      if (std::none_of(entries.begin(), entries.end(), [](const auto& entry) {
+            return entry.status == MasterNodeStatus::Active;
+          }))
       {
         LogWarn("got empty master node list, ignoring.");
         return;
       }
 
-      // inform router about the new list
+      // inform router about the changes; the diff is made on the router's loop, which also owns
+      // m_MasterNodes for InformConnection
       if (auto router = m_Router.lock())
       {
         auto& loop = router->loop();
-        loop->call([this,
-                    active = std::move(activeNodeList),
-                    decomm = std::move(decommNodeList),
-                    unfunded = std::move(unfundedNodeList),
-                    keymap = std::move(keymap),
-                    router = std::move(router)]() mutable {
-          m_KeyMap = std::move(keymap);
-          router->SetRouterWhitelist(active, decomm, unfunded);
+        loop->call([this, entries = std::move(entries), router = std::move(router)]() {
+          m_MasterNodes.Apply(entries, router->rcLookupHandler(), router->Now());
         });
       }
       else
@@ -286,10 +237,10 @@ namespace llarp
       if (auto r = m_Router.lock())
       {
         r->loop()->call([router, success, this]() {
-          if (auto itr = m_KeyMap.find(router); itr != m_KeyMap.end())
+          if (auto masterKey = m_MasterNodes.MasterKey(router))
           {
             const nlohmann::json request = {
-                {"passed", success}, {"pubkey", itr->second.ToHex()}, {"type", "belnet"}};
+                {"passed", success}, {"pubkey", masterKey->ToHex()}, {"type", "belnet"}};
             Request(
                 "admin.report_peer_status",
                 [self = shared_from_this()](bool success, std::vector<std::string>) {
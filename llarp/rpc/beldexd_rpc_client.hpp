@@ -7,6 +7,7 @@
 #include <llarp/crypto/types.hpp>
 #include <llarp/dht/key.hpp>
 #include <llarp/service/name.hpp>
+#include "master_node_list.hpp"
 
 namespace llarp
 {
@@ -74,10 +75,9 @@ namespace llarp
         m_lokiMQ->request(*m_Connection, std::move(cmd), std::move(func));
       }
 
-      // Handles a master node list update; takes the "master_node_states" object of an beldexd
-      // "get_master_nodes" rpc request.
+      // Handles a new, non-empty master node listing
       void
-      HandleNewMasterNodeList(const nlohmann::json& json);
+      HandleNewMasterNodeList(std::vector<MasterNodeList::Entry> entries);
 
       // Handles request from beldexd for peer stats on a specific peer
       void
@@ -94,7 +94,8 @@ namespace llarp
       std::atomic<bool> m_UpdatingList;
       std::string m_LastUpdateHash;
 
-      std::unordered_map<RouterID, PubKey> m_KeyMap;
+      /// only accessed on the router's loop
+      MasterNodeList m_MasterNodes;
 
       uint64_t m_BlockHeight;
     };
@@ -0,0 +1,171 @@
+#include "master_node_list.hpp"
+
+#include <oxenc/bt_serialize.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace llarp::rpc
+{
+  namespace
+  {
+    template <typename Key_t>
+    bool
+    ParseKey(std::string_view str, Key_t& key)
+    {
+      if (str.size() == key.size())
+      {
+        std::memcpy(key.data(), str.data(), str.size());
+        return true;
+      }
+      return key.FromHex(str);
+    }
+  }  // namespace
+
+  std::string
+  MasterNodeList::MakeRequest(const std::string& pollBlockHash)
+  {
+    oxenc::bt_dict request{
+        {"fields",
+         oxenc::bt_dict{
+             {"active", uint64_t{1}},
+             {"block_hash", uint64_t{1}},
+             {"funded", uint64_t{1}},
+             {"master_node_pubkey", uint64_t{1}},
+             {"pubkey_ed25519", uint64_t{1}},
+         }},
+    };
+    if (not pollBlockHash.empty())
+      request["poll_block_hash"] = pollBlockHash;
+    return oxenc::bt_serialize(request);
+  }
+
+  std::optional<std::vector<MasterNodeList::Entry>>
+  MasterNodeList::ParseReply(std::string_view reply, std::string& blockHash)
+  {
+    oxenc::bt_dict_consumer dict{reply};
+    if (dict.skip_until("block_hash"))
+      blockHash = dict.consume_string();
+    std::optional<std::vector<Entry>> entries;
+    if (dict.skip_until("master_node_states"))
+      entries = ParseStates(dict.consume_list_consumer());
+    if (not dict.skip_until("status") or dict.consume_string_view() != "OK")
+      throw std::runtime_error{"get_master_nodes did not return 'OK' status"};
+    if (dict.skip_until("unchanged") and dict.consume_integer<int>() != 0)
+      return std::nullopt;
+    if (not entries)
+      throw std::runtime_error{"get_master_nodes reply has no master_node_states"};
+    return entries;
+  }
+
+  std::vector<MasterNodeList::Entry>
+  MasterNodeList::ParseStates(oxenc::bt_list_consumer states)
+  {
+    std::vector<Entry> entries;
+    while (not states.is_finished())
+    {
+      if (not states.is_dict())
+      {
+        states.skip_value();
+        continue;
+      }
+      auto mnode = states.consume_dict_consumer();
+
+      // keys in the order beldexd sorts them
+      if (not mnode.skip_until("active"))
+        continue;
+      const bool active = mnode.consume_integer<int>() != 0;
+      if (not mnode.skip_until("funded"))
+        continue;
+      const bool funded = mnode.consume_integer<int>() != 0;
+
+      Entry entry;
+      if (not mnode.skip_until("master_node_pubkey")
+          or not ParseKey(mnode.consume_string_view(), entry.masterKey))
+        continue;
+      if (not mnode.skip_until("pubkey_ed25519")
+          or not ParseKey(mnode.consume_string_view(), entry.router))
+        continue;
+
+      entry.status = active ? MasterNodeStatus::Active
+          : funded          ? MasterNodeStatus::Decommissioned
+                            : MasterNodeStatus::Unfunded;
+      entries.push_back(std::move(entry));
+    }
+    return entries;
+  }
+
+  MasterNodeListUpdate
+  MasterNodeList::Update(const std::vector<Entry>& entries)
+  {
+    MasterNodeListUpdate update;
+    const auto generation = ++m_Generation;
+
+    for (const auto& entry : entries)
+    {
+      auto [itr, inserted] = m_Nodes.try_emplace(entry.router);
+      auto& node = itr->second;
+      if (inserted or node.status != entry.status)
+        update.changed.emplace_back(entry.router, entry.status);
+      node.masterKey = entry.masterKey;
+      node.status = entry.status;
+      node.generation = generation;
+    }
+    // anything we didn't just see has been deregistered
+    for (auto itr = m_Nodes.begin(); itr != m_Nodes.end();)
+    {
+      if (itr->second.generation == generation)
+      {
+        ++itr;
+        continue;
+      }
+      update.removed.push_back(itr->first);
+      itr = m_Nodes.erase(itr);
+    }
+    return update;
+  }
+
+  void
+  MasterNodeList::Apply(
+      const std::vector<Entry>& entries, I_RCLookupHandler& handler, llarp_time_t now)
+  {
+    const auto update = Update(entries);
+    if (not Resync(handler, now))
+      handler.UpdateRouterWhitelist(update);
+  }
+
+  bool
+  MasterNodeList::Resync(I_RCLookupHandler& handler, llarp_time_t now)
+  {
+    if (m_Nodes.empty() or (m_LastFullSync and now - *m_LastFullSync < FullSyncInterval))
+      return false;
+
+    std::vector<RouterID> whitelist, greylist, greenlist;
+    for (const auto& [router, node] : m_Nodes)
+    {
+      switch (node.status)
+      {
+        case MasterNodeStatus::Active:
+          whitelist.push_back(router);
+          break;
+        case MasterNodeStatus::Decommissioned:
+          greylist.push_back(router);
+          break;
+        case MasterNodeStatus::Unfunded:
+          greenlist.push_back(router);
+          break;
+      }
+    }
+    handler.SetRouterWhitelist(whitelist, greylist, greenlist);
+    m_LastFullSync = now;
+    return true;
+  }
+
+  std::optional<PubKey>
+  MasterNodeList::MasterKey(const RouterID& router) const
+  {
+    if (auto itr = m_Nodes.find(router); itr != m_Nodes.end())
+      return itr->second.masterKey;
+    return std::nullopt;
+  }
+}  // namespace llarp::rpc
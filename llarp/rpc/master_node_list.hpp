@@ -0,0 +1,96 @@
+#pragma once
+
+#include <llarp/crypto/types.hpp>
+#include <llarp/router/i_rc_lookup_handler.hpp>
+#include <llarp/router_id.hpp>
+#include <llarp/util/time.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace oxenc
+{
+  class bt_list_consumer;
+}
+
+namespace llarp::rpc
+{
+  /// the master node registry as last reported by beldexd.  each new listing is turned into the
+  /// changes since the previous one so that the router only has to touch the routers that
+  /// actually changed.  every FullSyncInterval the complete lists are pushed instead, which
+  /// undoes any drift from AddValidRouter/RemoveValidRouter calls made outside of the diffs.
+  class MasterNodeList
+  {
+   public:
+    /// how often Apply/Resync replace the lookup handler's lists outright
+    static constexpr auto FullSyncInterval = 10min;
+
+    struct Entry
+    {
+      RouterID router;
+      PubKey masterKey;
+      MasterNodeStatus status;
+    };
+
+    /// makes the bt-encoded `rpc.get_master_nodes` request for the fields we use; beldexd replies
+    /// `unchanged` if pollBlockHash is non-empty and still the current block hash.
+    static std::string
+    MakeRequest(const std::string& pollBlockHash);
+
+    /// parses the bt-encoded reply to a `rpc.get_master_nodes` request, setting blockHash to the
+    /// reply's block hash.  returns nullopt if beldexd says the list is unchanged since the
+    /// poll_block_hash we sent.
+    ///
+    /// throws if the reply is malformed or not successful.
+    static std::optional<std::vector<Entry>>
+    ParseReply(std::string_view reply, std::string& blockHash);
+
+    /// parses the `master_node_states` list of a bt-encoded get_master_nodes reply.  keys may be
+    /// either raw 32 byte strings (as beldexd sends them in bt replies) or hex.  entries that are
+    /// missing fields or have bad keys are skipped.
+    ///
+    /// throws if the list itself is malformed.
+    static std::vector<Entry>
+    ParseStates(oxenc::bt_list_consumer states);
+
+    /// replaces the registry with the given listing and returns what changed since the last
+    /// call.  the first call returns every entry as changed.
+    MasterNodeListUpdate
+    Update(const std::vector<Entry>& entries);
+
+    /// updates the registry with a new listing and hands the result to handler: the changes
+    /// since the last listing, or the full lists if a full sync is due at now.
+    void
+    Apply(const std::vector<Entry>& entries, I_RCLookupHandler& handler, llarp_time_t now);
+
+    /// pushes the full lists to handler if we have a listing and the last full sync was at least
+    /// FullSyncInterval before now.  returns true if it did.
+    bool
+    Resync(I_RCLookupHandler& handler, llarp_time_t now);
+
+    /// the master node pubkey of a registered router
+    std::optional<PubKey>
+    MasterKey(const RouterID& router) const;
+
+    size_t
+    size() const
+    {
+      return m_Nodes.size();
+    }
+
+   private:
+    struct Node
+    {
+      PubKey masterKey;
+      MasterNodeStatus status;
+      /// the Update() that last listed this node
+      uint64_t generation;
+    };
+    std::unordered_map<RouterID, Node> m_Nodes;
+    uint64_t m_Generation = 0;
+    std::optional<llarp_time_t> m_LastFullSync;
+  };
+}  // namespace llarp::rpc
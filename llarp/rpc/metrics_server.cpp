@@ -0,0 +1,72 @@
+#include "metrics_server.hpp"
+
+#include <llarp/util/logging.hpp>
+#include <llarp/util/metrics.hpp>
+
+#include <uvw/tcp.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace llarp::rpc
+{
+  namespace
+  {
+    constexpr auto HttpHeader = "HTTP/1.0 200 OK\r\n"
+                                "Content-Type: text/plain; version=0.0.4\r\n"
+                                "Connection: close\r\n\r\n";
+
+    void
+    Respond(uvw::TCPHandle& client)
+    {
+      const std::string body = HttpHeader + metrics::Registry::Global().PrometheusText();
+      auto data = std::make_unique<char[]>(body.size());
+      std::memcpy(data.get(), body.data(), body.size());
+      client.once<uvw::WriteEvent>([](auto&, uvw::TCPHandle& client) { client.close(); });
+      client.write(std::move(data), body.size());
+    }
+  }  // namespace
+
+  MetricsServer::~MetricsServer()
+  {
+    if (m_Listener)
+      m_Listener->close();
+  }
+
+  void
+  MetricsServer::Start(const EventLoop_ptr& loop, const SockAddr& addr)
+  {
+    auto uv = loop->MaybeGetUVWLoop();
+    if (not uv)
+      throw std::runtime_error{"metrics server requires a libuv-based event loop"};
+
+    m_Listener = uv->resource<uvw::TCPHandle>();
+    const char* failed = nullptr;
+    auto err_handler =
+        m_Listener->once<uvw::ErrorEvent>([&failed](auto& evt, auto&) { failed = evt.what(); });
+    m_Listener->bind(*addr.operator const sockaddr*());
+    m_Listener->on<uvw::ListenEvent>([](const uvw::ListenEvent&, uvw::TCPHandle& listener) {
+      auto client = listener.loop().resource<uvw::TCPHandle>();
+      client->on<uvw::ErrorEvent>([](auto&, uvw::TCPHandle& client) { client.close(); });
+      client->on<uvw::EndEvent>([](auto&, uvw::TCPHandle& client) { client.close(); });
+      // we don't care what was asked for, the first bytes of the request are enough to answer
+      client->once<uvw::DataEvent>([](auto&, uvw::TCPHandle& client) {
+        client.stop();
+        Respond(client);
+      });
+      listener.accept(*client);
+      client->read();
+    });
+    m_Listener->listen();
+    m_Listener->erase(err_handler);
+
+    if (failed)
+    {
+      m_Listener->close();
+      m_Listener.reset();
+      throw std::runtime_error{
+          fmt::format("Failed to bind/listen metrics http socket on {}: {}", addr, failed)};
+    }
+    LogInfo("Serving metrics over http on ", addr);
+  }
+}  // namespace llarp::rpc
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <llarp/ev/ev.hpp>
+#include <llarp/net/sock_addr.hpp>
+
+#include <memory>
+
+namespace uvw
+{
+  class TCPHandle;
+}
+
+namespace llarp::rpc
+{
+  /// minimal http responder that serves the metrics registry in the prometheus text format to
+  /// whatever connects, for scraping without going through the lmq rpc.  it answers every request
+  /// with the metrics and closes the connection, so it is meant for localhost only.
+  struct MetricsServer
+  {
+    ~MetricsServer();
+
+    /// bind and start listening on the loop; throws std::runtime_error if we can't bind
+    void
+    Start(const EventLoop_ptr& loop, const SockAddr& addr);
+
+   private:
+    std::shared_ptr<uvw::TCPHandle> m_Listener;
+  };
+}  // namespace llarp::rpc
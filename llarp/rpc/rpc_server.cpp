@@ -12,6 +12,7 @@
 #include <llarp/service/name.hpp>
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/dns/dns.hpp>
+#include <llarp/util/metrics.hpp>
 #include <oxenmq/fmt.h>
 
 namespace
@@ -164,6 +165,12 @@ namespace llarp::rpc
                   {"version", llarp::VERSION_FULL}, {"uptime", to_json(r->Uptime())}};
               msg.send_reply(CreateJSONResponse(result));
             })
+        .add_request_command(
+            "metrics",
+            [](oxenmq::Message& msg) {
+              // metrics are read lock free from any thread, no need to hop onto the router loop
+              msg.send_reply(CreateJSONResponse(metrics::Registry::Global().ExtractStatus()));
+            })
         .add_request_command(
             "status",
             [&](oxenmq::Message& msg) {
@@ -21,6 +21,7 @@
 #include "hidden_service_address_lookup.hpp"
 #include "net/ip.hpp"
 #include "outbound_context.hpp"
+#include "path_pool.hpp"
 #include "protocol.hpp"
 #include "service/info.hpp"
 #include "service/protocol_type.hpp"
@@ -30,8 +31,8 @@
 #include <llarp/link/link_manager.hpp>
 #include <llarp/tooling/dht_event.hpp>
 #include <llarp/quic/tunnel.hpp>
-#include <llarp/util/priority_queue.hpp>
 
+#include <algorithm>
 #include <optional>
 #include <utility>
 
@@ -88,6 +89,19 @@ namespace llarp
         m_StartupLNSMappings[name] = std::make_pair(range, auth);
       });
 
+      m_PathPool = std::make_shared<PathPool>(this, conf.m_SparePaths);
+
+      if (m_quic)
+      {
+        auto& transport = m_quic->transport_settings;
+        if (auto algo = quic::parse_cc_algo(conf.m_QUICCongestionControl))
+          transport.cc_algo = *algo;
+        transport.initial_rtt = conf.m_QUICInitialRTT;
+        transport.autotune_windows = conf.m_QUICWindowAutotune;
+        transport.max_stream_window = conf.m_QUICMaxStreamWindow;
+        transport.max_connection_window = 4 * conf.m_QUICMaxStreamWindow;
+      }
+
       return m_state->Configure(conf);
     }
 
@@ -148,6 +162,7 @@ namespace llarp
       {
         if (quic->hasListeners())
           introSet().supportedProtocols.push_back(ProtocolType::QUIC);
+        introSet().supportedProtocols.push_back(ProtocolType::QUICCoalesced);
       }
 
       introSet().intros.clear();
@@ -217,6 +232,25 @@ namespace llarp
       return std::nullopt;
     }
 
+    bool
+    Endpoint::RemoteSupports(ConvoTag tag, ProtocolType t) const
+    {
+      const auto maybe = GetEndpointWithConvoTag(tag);
+      if (not maybe)
+        return false;
+      const auto* addr = std::get_if<Address>(&*maybe);
+      if (not addr)
+        return false;
+      const auto range = m_state->m_RemoteSessions.equal_range(*addr);
+      for (auto itr = range.first; itr != range.second; ++itr)
+      {
+        const auto& protos = itr->second->GetCurrentIntroSet().supportedProtocols;
+        if (std::find(protos.begin(), protos.end(), t) != protos.end())
+          return true;
+      }
+      return false;
+    }
+
     void
     Endpoint::LookupServiceAsync(
         std::string name,
@@ -318,6 +352,8 @@ namespace llarp
         authCodes[service.ToString()] = info.token;
       }
       obj["authCodes"] = authCodes;
+      if (m_PathPool)
+        obj["pathPool"] = m_PathPool->ExtractStatus();
 
       return m_state->ExtractStatus(obj);
     }
@@ -327,6 +363,9 @@ namespace llarp
     {
       const auto now = llarp::time_now_ms();
       path::Builder::Tick(now);
+      // keep spare paths built
+      if (m_PathPool)
+        m_PathPool->Tick(now);
       // publish descriptors
       if (ShouldPublishDescriptors(now))
       {
@@ -342,6 +381,8 @@ namespace llarp
       EndpointUtil::ExpirePendingTx(now, m_state->m_PendingLookups);
       // expire pending router lookups
       EndpointUtil::ExpirePendingRouterLookups(now, m_state->m_PendingRouters);
+      // forget response times of relays we no longer use
+      m_state->lookupTimes.Decay(now);
 
       // deregister dead sessions
       EndpointUtil::DeregisterDeadSessions(now, m_state->m_DeadSessions);
@@ -350,6 +391,14 @@ namespace llarp
           now, m_state->m_RemoteSessions, m_state->m_DeadSessions, Sessions());
       // expire convotags
       EndpointUtil::ExpireConvoSessions(now, Sessions());
+      // drop reorder state for convotags that went away
+      for (auto itr = m_InboundReorder.begin(); itr != m_InboundReorder.end();)
+      {
+        if (Sessions().count(itr->first))
+          ++itr;
+        else
+          itr = m_InboundReorder.erase(itr);
+      }
 
       if (NumInStatus(path::ePathEstablished) > 1)
       {
@@ -385,6 +434,8 @@ namespace llarp
       // stop mnode sessions
       log::debug(logcat, "Endpoint stopping mnode sessions.");
       EndpointUtil::StopMnodeSessions(m_state->m_MNodeSessions);
+      if (m_PathPool)
+        m_PathPool->Stop();
       log::debug(logcat, "Endpoint stopping its path builder.");
       return path::Builder::Stop();
     }
@@ -801,7 +852,7 @@ namespace llarp
       m_state->m_LastPublish = now;
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Endpoint::GetHopsForBuild()
     {
       std::unordered_set<RouterID> exclude;
@@ -811,12 +862,12 @@ namespace llarp
             return exclude.count(rc.pubkey) == 0
                 and not r->routerProfiling().IsBadForPath(rc.pubkey);
           });
-      if (not maybe.has_value())
+      if (not maybe)
         return std::nullopt;
       return GetHopsForBuildWithEndpoint(maybe->pubkey);
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     Endpoint::GetHopsForBuildWithEndpoint(RouterID endpoint)
     {
       return path::Builder::GetHopsAlignedToForBuild(endpoint, MnodeBlacklist());
@@ -839,7 +890,24 @@ namespace llarp
 
       if (remoteSessions.count(addr) < MaxOutboundContextPerRemote)
       {
-        remoteSessions.emplace(addr, std::make_shared<OutboundContext>(introset, this));
+        auto ctx = std::make_shared<OutboundContext>(introset, this);
+        if (m_PathPool)
+        {
+          // start on a spare path to one of their intros if we have one
+          const auto now = Now();
+          std::unordered_set<RouterID> routers;
+          for (const auto& intro : introset.intros)
+          {
+            if (not intro.ExpiresSoon(now))
+              routers.emplace(intro.router);
+          }
+          if (auto spare = m_PathPool->Take(routers, path::ePathRoleOutboundHS, now))
+            ctx->AdoptSparePath(std::move(spare));
+          // and keep spares to them for next time
+          for (const auto& router : routers)
+            m_PathPool->Want(router, path::ePathRoleOutboundHS, now);
+        }
+        remoteSessions.emplace(addr, std::move(ctx));
         LogInfo("Created New outbound context for ", addr.ToString());
       }
 
@@ -1106,12 +1174,34 @@ namespace llarp
           m_router->NotifyRouterEvent<tooling::FindRouterSentEvent>(m_router->pubkey(), *dhtMsg);
 
           routers.emplace(router, std::move(job));
+          // ask another relay too if the closest one is slow to answer
+          Loop()->call_later(
+              m_state->lookupTimes.HedgeDelay(),
+              [weak = GetWeak(), router, txid, asked = path->Endpoint()] {
+                if (auto self = std::static_pointer_cast<Endpoint>(weak.lock()))
+                  self->HedgeRouterLookup(router, txid, asked);
+              });
           return true;
         }
       }
       return false;
     }
 
+    void
+    Endpoint::HedgeRouterLookup(const RouterID& router, uint64_t txid, const RouterID& asked)
+    {
+      if (not HasPendingRouterLookup(router))
+        return;
+      auto path = GetEstablishedPathClosestTo(router, {asked});
+      if (not path or path->Endpoint() == asked)
+        return;
+      routing::DHTMessage msg;
+      msg.M.emplace_back(std::make_unique<dht::FindRouterMessage>(txid, router));
+      msg.S = path->NextSeqNo();
+      if (path->SendRoutingMessage(msg, Router()))
+        LogDebug(Name(), " hedged lookup for ", router, " via ", path->Endpoint());
+    }
+
     void
     Endpoint::HandlePathBuilt(path::Path_ptr p)
     {
@@ -1190,10 +1280,50 @@ namespace llarp
     }
 
     std::optional<EndpointBase::SendStat>
-    Endpoint::GetStatFor(AddressVariant_t) const
+    Endpoint::GetStatFor(AddressVariant_t remote) const
     {
-      // TODO: implement me
-      return std::nullopt;
+      SendStat stat{};
+      bool found = false;
+      if (auto ptr = std::get_if<Address>(&remote))
+      {
+        for (const auto& [tag, session] : Sessions())
+        {
+          if (session.Addr() != *ptr)
+            continue;
+          found = true;
+          ++stat.numTotalConvos;
+          stat.messagesSend += session.messagesSend;
+          stat.messagesRecv += session.messagesRecv;
+          stat.lastSendAt = std::max(stat.lastSendAt, session.lastSend);
+          stat.lastRecvAt = std::max(stat.lastRecvAt, session.lastRecv);
+        }
+        auto [itr, end] = m_state->m_RemoteSessions.equal_range(*ptr);
+        for (; itr != end; ++itr)
+        {
+          found = true;
+          const auto rtt = itr->second->estimatedRTT;
+          if (rtt > 0s and (stat.estimatedRTT == 0s or rtt < stat.estimatedRTT))
+            stat.estimatedRTT = rtt;
+        }
+      }
+      else if (auto ptr = std::get_if<RouterID>(&remote))
+      {
+        if (auto itr = m_state->m_MNodeSessions.find(*ptr); itr != m_state->m_MNodeSessions.end())
+        {
+          found = true;
+          const auto& session = itr->second;
+          stat.numTotalConvos = 1;
+          stat.messagesSend = session->MessagesSent();
+          stat.messagesRecv = session->MessagesRecv();
+          stat.lastSendAt = session->LastSendAt();
+          stat.lastRecvAt = session->LastRecvAt();
+          if (auto path = session->GetPathByRouter(*ptr))
+            stat.estimatedRTT = path->intro.latency;
+        }
+      }
+      if (not found)
+        return std::nullopt;
+      return stat;
     }
 
     std::unordered_set<EndpointBase::AddressVariant_t>
@@ -1309,6 +1439,7 @@ namespace llarp
     Endpoint::RemoveConvoTag(const ConvoTag& t)
     {
       Sessions().erase(t);
+      m_InboundReorder.erase(t);
     }
 
     void
@@ -1373,7 +1504,8 @@ namespace llarp
         std::optional<IntroSet> introset,
         const RouterID& endpoint,
         llarp_time_t timeLeft,
-        uint64_t relayOrder)
+        uint64_t relayOrder,
+        llarp_time_t elapsed)
     {
       // tell all our existing remote sessions about this introset update
 
@@ -1415,25 +1547,26 @@ namespace llarp
             " order=",
             relayOrder);
         fails[endpoint] = fails[endpoint] + 1;
-
-        const auto pendingForAddr = std::count_if(
-            m_state->m_PendingLookups.begin(),
-            m_state->m_PendingLookups.end(),
-            [addr](const auto& item) -> bool { return item.second->IsFor(addr); });
-
-        // inform all if we have no more pending lookups for this address
-        if (pendingForAddr == 0)
-        {
-          auto range = lookups.equal_range(addr);
-          auto itr = range.first;
-          while (itr != range.second)
-          {
-            itr->second(addr, nullptr);
-            itr = lookups.erase(itr);
-          }
-        }
+        EndpointUtil::IntroSetLookupFailed(
+            addr,
+            endpoint,
+            now,
+            m_state->lookupTimes,
+            m_state->m_HedgedLookups,
+            m_state->m_PendingLookups,
+            lookups,
+            IntroSetLookupSender(addr));
         return false;
       }
+      EndpointUtil::IntroSetLookupAnswered(
+          addr,
+          endpoint,
+          elapsed,
+          now,
+          m_state->lookupTimes,
+          m_state->m_HedgedLookups,
+          m_state->m_PendingLookups);
+
       // check for established outbound context
 
       if (m_state->m_RemoteSessions.count(addr) > 0)
@@ -1482,9 +1615,10 @@ namespace llarp
       }
 
       /// how many routers to use for lookups
-      static constexpr size_t NumParallelLookups = 2;
-      /// how many requests per router
-      static constexpr size_t RequestsPerLookup = 2;
+      static constexpr size_t NumParallelLookups = 3;
+      /// how many of them to ask right away; a single relay that is down or slow would leave a
+      /// lookup waiting on the hedge delay, which is longest before we have measured anyone
+      static constexpr size_t NumInitialLookups = 2;
 
       // add response hook to list for address.
       m_state->m_PendingServiceLookups.emplace(remote, hook);
@@ -1507,50 +1641,92 @@ namespace llarp
       if (not m_IntrosetLookupFilter.Insert(remote))
         return true;
 
-      const auto paths = GetManyPathsWithUniqueEndpoints(this, NumParallelLookups);
+      const auto unique = GetManyPathsWithUniqueEndpoints(this, NumParallelLookups);
+      std::vector<path::Path_ptr> paths{unique.begin(), unique.end()};
+      if (paths.empty())
+        return false;
+      m_state->lookupTimes.SortFastestFirst(paths);
+
+      // ask the relays we expect to answer fastest now and the rest only if they are slow to
+      const auto initial = std::next(paths.begin(), std::min(paths.size(), NumInitialLookups));
+      HedgedIntroSetLookup hedge{{initial, paths.end()}, 0, timeout};
+      bool sent = false;
+      for (auto itr = paths.begin(); itr != initial; ++itr)
+      {
+        if (SendIntroSetLookup(remote, *itr, hedge.order, timeout))
+          sent = true;
+      }
+      if (hedge.paths.empty())
+        return sent;
+      m_state->m_HedgedLookups[remote] = std::move(hedge);
+      // nothing is out to wait on, ask the rest now
+      if (not sent)
+        return SendHedgedLookups(remote);
+      const auto delay = m_state->lookupTimes.HedgeDelay();
+      Loop()->call_later(delay, [weak = GetWeak(), remote] {
+        if (auto self = std::static_pointer_cast<Endpoint>(weak.lock()))
+          self->SendHedgedLookups(remote);
+      });
+      return true;
+    }
+
+    bool
+    Endpoint::SendIntroSetLookup(
+        const Address& remote, path::Path_ptr path, uint64_t& order, llarp_time_t timeout)
+    {
+      /// how many requests per router
+      static constexpr size_t RequestsPerLookup = 2;
 
-      using namespace std::placeholders;
       const dht::Key_t location = remote.ToKey();
-      uint64_t order = 0;
+      bool sent = false;
+      for (size_t count = 0; count < RequestsPerLookup; ++count)
+      {
+        const auto relayOrder = order++ % dht::IntroSetStorageRedundancy;
+        HiddenServiceAddressLookup* job = new HiddenServiceAddressLookup(
+            this,
+            [this, sentAt = Now()](auto addr, auto result, auto from, auto left, auto order) {
+              return OnLookup(addr, result, from, left, order, Now() - sentAt);
+            },
+            location,
+            PubKey{remote.as_array()},
+            path->Endpoint(),
+            relayOrder,
+            GenTXID(),
+            timeout + (2 * path->intro.latency) + IntrosetLookupGraceInterval);
+        LogInfo(
+            "doing lookup for ",
+            remote,
+            " via ",
+            path->Endpoint(),
+            " at ",
+            location,
+            " order=",
+            relayOrder);
+        if (job->SendRequestViaPath(path, Router()))
+          sent = true;
+        else
+          LogError(Name(), " send via path failed for lookup");
+      }
+      return sent;
+    }
 
-      // flag to only add callback to list of callbacks for
-      // address once.
-      bool hookAdded = false;
+    EndpointUtil::SendIntroSetLookup_t
+    Endpoint::IntroSetLookupSender(const Address& remote)
+    {
+      return [this, remote](const path::Path_ptr& path, uint64_t& order, llarp_time_t timeout) {
+        return path->IsReady() and SendIntroSetLookup(remote, path, order, timeout);
+      };
+    }
 
-      for (const auto& path : paths)
-      {
-        for (size_t count = 0; count < RequestsPerLookup; ++count)
-        {
-          HiddenServiceAddressLookup* job = new HiddenServiceAddressLookup(
-              this,
-              [this](auto addr, auto result, auto from, auto left, auto order) {
-                return OnLookup(addr, result, from, left, order);
-              },
-              location,
-              PubKey{remote.as_array()},
-              path->Endpoint(),
-              order,
-              GenTXID(),
-              timeout + (2 * path->intro.latency) + IntrosetLookupGraceInterval);
-          LogInfo(
-              "doing lookup for ",
-              remote,
-              " via ",
-              path->Endpoint(),
-              " at ",
-              location,
-              " order=",
-              order);
-          order++;
-          if (job->SendRequestViaPath(path, Router()))
-          {
-            hookAdded = true;
-          }
-          else
-            LogError(Name(), " send via path failed for lookup");
-        }
-      }
-      return hookAdded;
+    bool
+    Endpoint::SendHedgedLookups(const Address& remote)
+    {
+      return EndpointUtil::SendHedgedLookups(
+          remote,
+          m_state->m_HedgedLookups,
+          m_state->m_PendingLookups,
+          m_state->m_PendingServiceLookups,
+          IntroSetLookupSender(remote));
     }
 
     void
@@ -1596,6 +1772,13 @@ namespace llarp
             numHops,
             false,
             this);
+        if (m_PathPool)
+        {
+          const auto now = Now();
+          if (auto spare = m_PathPool->Take({mnode}, path::ePathRoleSVC, now))
+            session->AdoptSparePath(std::move(spare));
+          m_PathPool->Want(mnode, path::ePathRoleSVC, now);
+        }
         m_state->m_MNodeSessions[mnode] = session;
       }
       EnsureRouterIsKnown(mnode);
@@ -1683,15 +1866,16 @@ namespace llarp
         session->FlushDownstream();
 
       // handle inbound traffic sorted
-      util::ascending_priority_queue<ProtocolMessage> queue;
+      std::vector<ProtocolMessage> inbound;
       while (not m_InboundTrafficQueue.empty())
       {
         // succ it out
-        queue.emplace(std::move(*m_InboundTrafficQueue.popFront()));
+        inbound.emplace_back(std::move(*m_InboundTrafficQueue.popFront()));
       }
-      while (not queue.empty())
-      {
-        const auto& msg = queue.top();
+      std::sort(inbound.begin(), inbound.end(), [](const auto& left, const auto& right) {
+        return left.seqno < right.seqno;
+      });
+      auto deliver = [this](ProtocolMessage&& msg) {
         LogDebug(
             Name(),
             " handle inbound packet on ",
@@ -1708,7 +1892,22 @@ namespace llarp
         {
           LogWarn("Failed to handle inbound message");
         }
-        queue.pop();
+      };
+      if (const auto window = m_state->m_ReorderWindow; window > 0s)
+      {
+        for (auto& msg : inbound)
+        {
+          const auto tag = msg.tag;
+          m_InboundReorder.try_emplace(tag, window).first->second.Put(std::move(msg), now, deliver);
+        }
+        // release anything that waited too long on a gap
+        for (auto& [tag, reorder] : m_InboundReorder)
+          reorder.Expire(now, deliver);
+      }
+      else
+      {
+        for (auto& msg : inbound)
+          deliver(std::move(msg));
       }
 
       auto router = Router();
@@ -2024,6 +2223,12 @@ namespace llarp
       return itr->second.seqno++;
     }
 
+    size_t
+    Endpoint::MultipathWidth() const
+    {
+      return m_state->m_MultipathWidth;
+    }
+
     bool
     Endpoint::ShouldBuildMore(llarp_time_t now) const
     {
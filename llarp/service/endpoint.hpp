@@ -16,11 +16,13 @@
 #include "session.hpp"
 #include "lookup.hpp"
 #include <llarp/util/compare_ptr.hpp>
+#include <llarp/util/reorder_buffer.hpp>
 #include <optional>
 #include <unordered_map>
 #include <variant>
 #include <oxenc/variant.h>
 #include "endpoint_types.hpp"
+#include "endpoint_util.hpp"
 #include "llarp/endpoint_base.hpp"
 
 #include "auth.hpp"
@@ -45,6 +47,7 @@ namespace llarp
   {
     struct AsyncKeyExchange;
     struct Context;
+    struct PathPool;
     struct EndpointState;
     struct OutboundContext;
 
@@ -110,6 +113,9 @@ namespace llarp
       std::optional<ConvoTag>
       GetBestConvoTagFor(std::variant<Address, RouterID> addr) const override;
 
+      bool
+      RemoteSupports(ConvoTag tag, ProtocolType t) const override;
+
       /// get our ifaddr if it is set
       virtual huint128_t
       GetIfAddr() const
@@ -324,6 +330,10 @@ namespace llarp
       bool
       ShouldBuildMore(llarp_time_t now) const override;
 
+      /// how many paths / remote intros an outbound session stripes its traffic over
+      size_t
+      MultipathWidth() const;
+
       virtual llarp_time_t
       PathAlignmentTimeout() const
       {
@@ -419,10 +429,10 @@ namespace llarp
       bool
       HasExit() const;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuildWithEndpoint(RouterID endpoint);
 
       virtual void
@@ -497,13 +507,34 @@ namespace llarp
       void
       HandleVerifyGotRouter(dht::GotRouterMessage_constptr msg, RouterID id, bool valid);
 
+      /// send one relay the lookups for remote's intro set, advancing order by the relay
+      /// orders used; returns true if any were sent
+      bool
+      SendIntroSetLookup(
+          const Address& remote, path::Path_ptr path, uint64_t& order, llarp_time_t timeout);
+
+      /// look router up through a relay other than asked if the lookup is still pending
+      void
+      HedgeRouterLookup(const RouterID& router, uint64_t txid, const RouterID& asked);
+
+      /// sends intro set lookups for remote through ready paths
+      EndpointUtil::SendIntroSetLookup_t
+      IntroSetLookupSender(const Address& remote);
+
+      /// send the held back lookups for remote to the rest of the relays, if there are any;
+      /// returns true if any went out
+      bool
+      SendHedgedLookups(const Address& remote);
+
+      /// elapsed is how long after sending the lookup its reply came
       bool
       OnLookup(
           const service::Address& addr,
           std::optional<IntroSet> i,
           const RouterID& endpoint,
           llarp_time_t timeLeft,
-          uint64_t relayOrder);
+          uint64_t relayOrder,
+          llarp_time_t elapsed);
 
       bool
       DoNetworkIsolation(bool failed);
@@ -539,6 +570,8 @@ namespace llarp
       std::shared_ptr<IAuthPolicy> m_AuthPolicy;
       std::unordered_map<Address, AuthInfo> m_RemoteAuthInfos;
       std::unique_ptr<quic::TunnelManager> m_quic;
+      /// spare paths to recently used remotes
+      std::shared_ptr<PathPool> m_PathPool;
 
       /// (lns name, optional exit range, optional auth info) for looking up on startup
       std::unordered_map<std::string, std::pair<std::optional<IPRange>, std::optional<AuthInfo>>>
@@ -546,6 +579,10 @@ namespace llarp
 
       RecvPacketQueue_t m_InboundTrafficQueue;
 
+      /// puts inbound traffic from senders striping over several paths back in order, only used
+      /// with [network]:multipath-reorder-window set
+      std::unordered_map<ConvoTag, util::ReorderBuffer<ProtocolMessage>> m_InboundReorder;
+
      public:
       SendMessageQueue_t m_SendQueue;
 
@@ -16,6 +16,8 @@ namespace llarp
         m_Keyfile = conf.m_keyfile->string();
       m_MnodeBlacklist = conf.m_mnodeBlacklist;
       m_ExitEnabled = conf.m_AllowExit;
+      m_MultipathWidth = conf.m_MultipathWidth;
+      m_ReorderWindow = conf.m_ReorderWindow;
 
       for (const auto& record : conf.m_SRVRecords)
       {
@@ -66,6 +68,7 @@ namespace llarp
       }
 
       obj["converstations"] = sessionObj;
+      obj["lookupTimes"] = lookupTimes.ExtractStatus();
       return obj;
     }
   }  // namespace service
@@ -10,6 +10,7 @@
 #include <llarp/util/decaying_hashtable.hpp>
 #include <llarp/util/status.hpp>
 #include "lns_tracker.hpp"
+#include "lookup_times.hpp"
 
 #include <memory>
 #include <queue>
@@ -31,6 +32,8 @@ namespace llarp
       std::string m_Name;
       std::string m_NetNS;
       bool m_ExitEnabled = false;
+      size_t m_MultipathWidth = 1;
+      llarp_time_t m_ReorderWindow = 0s;
 
       PendingTraffic m_PendingTraffic;
 
@@ -41,11 +44,14 @@ namespace llarp
 
       MNodeSessions m_MNodeSessions;
 
-      std::unordered_multimap<Address, PathEnsureHook> m_PendingServiceLookups;
+      PendingServiceLookups m_PendingServiceLookups;
       std::unordered_map<Address, llarp_time_t> m_LastServiceLookupTimes;
 
       std::unordered_map<RouterID, uint32_t> m_ServiceLookupFails;
 
+      /// intro set lookups not yet sent to all relays, by address
+      HedgedLookups m_HedgedLookups;
+
       PendingRouters m_PendingRouters;
 
       llarp_time_t m_LastPublish = 0s;
@@ -67,6 +73,9 @@ namespace llarp
 
       LNSLookupTracker lnsTracker;
 
+      /// how fast relays answer our lookups
+      LookupTimes lookupTimes;
+
       bool
       Configure(const NetworkConfig& conf);
 
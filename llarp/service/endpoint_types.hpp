@@ -10,6 +10,7 @@
 #include <memory>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 namespace llarp
 {
@@ -50,6 +51,18 @@ namespace llarp
 
     using PathEnsureHook = std::function<void(Address, OutboundContext*)>;
 
+    using PendingServiceLookups = std::unordered_multimap<Address, PathEnsureHook>;
+
+    /// the rest of an intro set lookup, sent to more relays if the first ones are slow to answer
+    struct HedgedIntroSetLookup
+    {
+      std::vector<path::Path_ptr> paths;
+      uint64_t order;
+      llarp_time_t timeout;
+    };
+
+    using HedgedLookups = std::unordered_map<Address, HedgedIntroSetLookup>;
+
     using LNSNameCache = std::unordered_map<std::string, std::pair<Address, llarp_time_t>>;
 
   }  // namespace service
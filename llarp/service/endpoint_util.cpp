@@ -56,6 +56,96 @@ namespace llarp
       }
     }
 
+    void
+    EndpointUtil::CancelPendingLookupsFor(const Address& addr, PendingLookups& lookups)
+    {
+      for (auto itr = lookups.begin(); itr != lookups.end();)
+      {
+        if (itr->second->IsFor(addr))
+          itr = lookups.erase(itr);
+        else
+          ++itr;
+      }
+    }
+
+    bool
+    EndpointUtil::FailServiceLookupsIfDone(
+        const Address& addr, const PendingLookups& lookups, PendingServiceLookups& hooks)
+    {
+      for (const auto& item : lookups)
+      {
+        if (item.second->IsFor(addr))
+          return false;
+      }
+      auto range = hooks.equal_range(addr);
+      auto itr = range.first;
+      while (itr != range.second)
+      {
+        itr->second(addr, nullptr);
+        itr = hooks.erase(itr);
+      }
+      return true;
+    }
+
+    bool
+    EndpointUtil::SendHedgedLookups(
+        const Address& addr,
+        HedgedLookups& hedged,
+        const PendingLookups& lookups,
+        PendingServiceLookups& hooks,
+        const SendIntroSetLookup_t& send)
+    {
+      auto itr = hedged.find(addr);
+      if (itr == hedged.end())
+        return false;
+      auto hedge = std::move(itr->second);
+      hedged.erase(itr);
+      LogInfo("hedging lookup for ", addr, " to ", hedge.paths.size(), " more relays");
+      bool sent = false;
+      for (const auto& path : hedge.paths)
+      {
+        if (send(path, hedge.order, hedge.timeout))
+          sent = true;
+      }
+      if (not sent)
+        FailServiceLookupsIfDone(addr, lookups, hooks);
+      return sent;
+    }
+
+    void
+    EndpointUtil::IntroSetLookupAnswered(
+        const Address& addr,
+        const RouterID& relay,
+        llarp_time_t elapsed,
+        llarp_time_t now,
+        LookupTimes& times,
+        HedgedLookups& hedged,
+        PendingLookups& lookups)
+    {
+      times.Answered(relay, elapsed, now);
+      hedged.erase(addr);
+      CancelPendingLookupsFor(addr, lookups);
+    }
+
+    void
+    EndpointUtil::IntroSetLookupFailed(
+        const Address& addr,
+        const RouterID& relay,
+        llarp_time_t now,
+        LookupTimes& times,
+        HedgedLookups& hedged,
+        const PendingLookups& lookups,
+        PendingServiceLookups& hooks,
+        const SendIntroSetLookup_t& send)
+    {
+      times.Failed(relay, now);
+      // no reason to wait on the other relays any longer
+      if (hedged.count(addr))
+        SendHedgedLookups(addr, hedged, lookups, hooks, send);
+      else
+        FailServiceLookupsIfDone(addr, lookups, hooks);
+    }
+
     void
     EndpointUtil::ExpirePendingRouterLookups(llarp_time_t now, PendingRouters& routers)
     {
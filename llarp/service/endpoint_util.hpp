@@ -1,6 +1,7 @@
 #pragma once
 
 #include "endpoint_types.hpp"
+#include "lookup_times.hpp"
 
 namespace llarp
 {
@@ -14,6 +15,56 @@ namespace llarp
       static void
       ExpirePendingTx(llarp_time_t now, PendingLookups& lookups);
 
+      /// drop the pending lookups for addr without informing them
+      static void
+      CancelPendingLookupsFor(const Address& addr, PendingLookups& lookups);
+
+      /// sends an intro set lookup via a path, returns true if it went out
+      using SendIntroSetLookup_t =
+          std::function<bool(const path::Path_ptr&, uint64_t& order, llarp_time_t timeout)>;
+
+      /// tell the hooks waiting on addr there is no path to it, unless a lookup for it is still
+      /// out; returns true if they were told
+      static bool
+      FailServiceLookupsIfDone(
+          const Address& addr, const PendingLookups& lookups, PendingServiceLookups& hooks);
+
+      /// send the held back lookups for addr, if they are still held back; if none of them went
+      /// out fail the hooks waiting on it as FailServiceLookupsIfDone does. returns true if any
+      /// were sent
+      static bool
+      SendHedgedLookups(
+          const Address& addr,
+          HedgedLookups& hedged,
+          const PendingLookups& lookups,
+          PendingServiceLookups& hooks,
+          const SendIntroSetLookup_t& send);
+
+      /// relay answered a lookup for addr with a usable introset; the first good answer wins so
+      /// drop the lookups still out and held back for addr
+      static void
+      IntroSetLookupAnswered(
+          const Address& addr,
+          const RouterID& relay,
+          llarp_time_t elapsed,
+          llarp_time_t now,
+          LookupTimes& times,
+          HedgedLookups& hedged,
+          PendingLookups& lookups);
+
+      /// a lookup for addr via relay timed out or found nothing usable; backs the relay off and
+      /// sends the held back lookups right away instead of waiting on the hedge delay
+      static void
+      IntroSetLookupFailed(
+          const Address& addr,
+          const RouterID& relay,
+          llarp_time_t now,
+          LookupTimes& times,
+          HedgedLookups& hedged,
+          const PendingLookups& lookups,
+          PendingServiceLookups& hooks,
+          const SendIntroSetLookup_t& send);
+
       static void
       ExpirePendingRouterLookups(llarp_time_t now, PendingRouters& routers);
 
@@ -61,7 +112,7 @@ namespace llarp
         }
         else
         {
-          path = ep->PickRandomEstablishedPath();
+          path = ep->PickWeightedEstablishedPath();
         }
         if (path and path->IsReady())
         {
@@ -63,6 +63,13 @@ namespace llarp
         return now - (m_created + m_timeout);
       }
 
+      /// how long ago this request was made
+      llarp_time_t
+      Elapsed(llarp_time_t now) const
+      {
+        return now > m_created ? now - m_created : 0s;
+      }
+
       /// build request message for service lookup
       virtual std::shared_ptr<routing::IMessage>
       BuildRequestMessage() = 0;
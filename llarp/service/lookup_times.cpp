@@ -0,0 +1,87 @@
+#include "lookup_times.hpp"
+
+#include <llarp/path/path.hpp>
+
+#include <algorithm>
+
+namespace llarp::service
+{
+  void
+  LookupTimes::Estimate::Sample(llarp_time_t value, llarp_time_t now)
+  {
+    // the same smoothing as tcp's retransmit timer (rfc 6298)
+    if (sampled)
+    {
+      const auto delta = value > smoothed ? value - smoothed : smoothed - value;
+      variation = (variation * 3 + delta) / 4;
+      smoothed = (smoothed * 7 + value) / 8;
+    }
+    else
+    {
+      smoothed = value;
+      variation = value / 2;
+      sampled = true;
+    }
+    failures = 0;
+    lastSeen = now;
+  }
+
+  void
+  LookupTimes::Answered(const RouterID& relay, llarp_time_t elapsed, llarp_time_t now)
+  {
+    m_Relays[relay].Sample(elapsed, now);
+    m_Overall.Sample(elapsed, now);
+  }
+
+  void
+  LookupTimes::Failed(const RouterID& relay, llarp_time_t now)
+  {
+    auto& estimate = m_Relays[relay];
+    estimate.failures = std::min(estimate.failures + 1, MaxFailures);
+    estimate.lastSeen = now;
+  }
+
+  llarp_time_t
+  LookupTimes::Expected(const RouterID& relay) const
+  {
+    if (auto itr = m_Relays.find(relay); itr != m_Relays.end())
+      return itr->second.BackedOff();
+    return DefaultResponseTime;
+  }
+
+  llarp_time_t
+  LookupTimes::HedgeDelay() const
+  {
+    return std::clamp<llarp_time_t>(
+        m_Overall.smoothed + m_Overall.variation * 4, MinHedgeDelay, MaxHedgeDelay);
+  }
+
+  void
+  LookupTimes::SortFastestFirst(std::vector<path::Path_ptr>& paths) const
+  {
+    std::stable_sort(paths.begin(), paths.end(), [this](const auto& lhs, const auto& rhs) {
+      return Expected(lhs->Endpoint()) < Expected(rhs->Endpoint());
+    });
+  }
+
+  void
+  LookupTimes::Decay(llarp_time_t now)
+  {
+    for (auto itr = m_Relays.begin(); itr != m_Relays.end();)
+    {
+      if (itr->second.lastSeen + ForgetAfter <= now)
+        itr = m_Relays.erase(itr);
+      else
+        ++itr;
+    }
+  }
+
+  util::StatusObject
+  LookupTimes::ExtractStatus() const
+  {
+    util::StatusObject relays{};
+    for (const auto& [relay, estimate] : m_Relays)
+      relays[relay.ToString()] = to_json(estimate.BackedOff());
+    return util::StatusObject{{"hedgeDelay", to_json(HedgeDelay())}, {"relays", relays}};
+  }
+}  // namespace llarp::service
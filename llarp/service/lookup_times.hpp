@@ -0,0 +1,80 @@
+#pragma once
+
+#include <llarp/path/pathset.hpp>
+#include <llarp/router_id.hpp>
+#include <llarp/util/status.hpp>
+#include <llarp/util/time.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace llarp::service
+{
+  /// keeps smoothed dht lookup response times per relay, so lookups go to the relays that
+  /// answer fastest first and we know how long to wait on them before asking others too
+  class LookupTimes
+  {
+   public:
+    /// never hedge sooner than this
+    static constexpr auto MinHedgeDelay = 250ms;
+    /// always hedge by this long
+    static constexpr auto MaxHedgeDelay = 4s;
+    /// what we expect of a relay we have not heard from
+    static constexpr auto DefaultResponseTime = 1s;
+    /// forget relays we have not heard from in this long
+    static constexpr auto ForgetAfter = 30min;
+    /// each failure in a row doubles what we expect of a relay, up to this many times
+    static constexpr uint32_t MaxFailures = 4;
+
+    /// relay answered a lookup elapsed after we sent it
+    void
+    Answered(const RouterID& relay, llarp_time_t elapsed, llarp_time_t now);
+
+    /// relay timed out or did not have what we asked for.  backs the relay off until it answers
+    /// again without counting the failure as a response time, so the estimates stay what
+    /// answering relays actually take.
+    void
+    Failed(const RouterID& relay, llarp_time_t now);
+
+    /// smoothed response time of relay, doubled for each failure since it last answered
+    llarp_time_t
+    Expected(const RouterID& relay) const;
+
+    /// how long to wait for an answer before asking more relays: the smoothed response time
+    /// over all relays plus four times its variation, so only slow outliers are hedged
+    llarp_time_t
+    HedgeDelay() const;
+
+    /// order paths by the expected response time of their endpoints, fastest first
+    void
+    SortFastestFirst(std::vector<path::Path_ptr>& paths) const;
+
+    void
+    Decay(llarp_time_t now);
+
+    util::StatusObject
+    ExtractStatus() const;
+
+   private:
+    struct Estimate
+    {
+      llarp_time_t smoothed = DefaultResponseTime;
+      llarp_time_t variation = DefaultResponseTime / 2;
+      llarp_time_t lastSeen = 0s;
+      uint32_t failures = 0;
+      bool sampled = false;
+
+      void
+      Sample(llarp_time_t value, llarp_time_t now);
+
+      llarp_time_t
+      BackedOff() const
+      {
+        return smoothed * (1 << failures);
+      }
+    };
+
+    std::unordered_map<RouterID, Estimate> m_Relays;
+    Estimate m_Overall;
+  };
+}  // namespace llarp::service
@@ -86,6 +86,21 @@ namespace llarp
 
     OutboundContext::~OutboundContext() = default;
 
+    bool
+    OutboundContext::AdoptSparePath(path::Path_ptr p)
+    {
+      for (const auto& intro : currentIntroSet.intros)
+      {
+        if (intro.router != p->Endpoint())
+          continue;
+        // align to the intro on the spare path's router so HandlePathBuilt swaps onto it
+        m_NextIntro = intro;
+        LogInfo(Name(), " starting on spare path ", p->ShortName());
+        return AdoptPath(std::move(p));
+      }
+      return false;
+    }
+
     /// actually swap intros
     void
     OutboundContext::SwapIntros()
@@ -464,7 +479,7 @@ namespace llarp
       m_ReadyHooks.push_back(hook);
     }
 
-    std::optional<std::vector<RouterContact>>
+    std::optional<std::vector<RouterContact_ptr>>
     OutboundContext::GetHopsForBuild()
     {
       if (m_NextIntro.router.IsZero())
@@ -473,9 +488,50 @@ namespace llarp
       }
       if (m_NextIntro.router.IsZero())
         return std::nullopt;
+      const auto width = m_Endpoint->MultipathWidth();
+      if (width > 1 and GetPathByRouter(m_NextIntro.router))
+      {
+        // when striping, align builds to the intro routers we have no path to yet
+        const auto now = Now();
+        size_t considered = 1;
+        for (const auto& intro : currentIntroSet.intros)
+        {
+          if (considered >= width)
+            break;
+          if (intro.router == m_NextIntro.router or intro.ExpiresSoon(now)
+              or m_Endpoint->MnodeBlacklist().count(intro.router))
+            continue;
+          ++considered;
+          if (not GetPathByRouter(intro.router))
+            return GetHopsAlignedToForBuild(intro.router, m_Endpoint->MnodeBlacklist());
+        }
+      }
       return GetHopsAlignedToForBuild(m_NextIntro.router, m_Endpoint->MnodeBlacklist());
     }
 
+    std::vector<Introduction>
+    OutboundContext::StripeIntros() const
+    {
+      std::vector<Introduction> intros{remoteIntro};
+      const auto width = m_Endpoint->MultipathWidth();
+      if (width <= 1)
+        return intros;
+      const auto now = Now();
+      std::unordered_set<RouterID> routers{remoteIntro.router};
+      for (const auto& intro : currentIntroSet.intros)
+      {
+        if (intros.size() >= width)
+          break;
+        if (intro.ExpiresSoon(now) or routers.count(intro.router))
+          continue;
+        if (not GetPathByRouter(intro.router))
+          continue;
+        routers.emplace(intro.router);
+        intros.emplace_back(intro);
+      }
+      return intros;
+    }
+
     bool
     OutboundContext::ShouldBuildMore(llarp_time_t now) const
     {
@@ -497,7 +553,8 @@ namespace llarp
             havePathToNextIntro = true;
         }
       });
-      return numValidPaths < numDesiredPaths or not havePathToNextIntro;
+      const auto wantPaths = std::max(numDesiredPaths, m_Endpoint->MultipathWidth());
+      return numValidPaths < wantPaths or not havePathToNextIntro;
     }
 
     void
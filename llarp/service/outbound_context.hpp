@@ -75,9 +75,16 @@ namespace llarp
       void
       MarkCurrentIntroBad(llarp_time_t now) override;
 
+      std::vector<Introduction>
+      StripeIntros() const override;
+
       void
       MarkIntroBad(const Introduction& marked, llarp_time_t now);
 
+      /// start out using an already built spare path to one of the remote's intro routers
+      bool
+      AdoptSparePath(path::Path_ptr p);
+
       /// return true if we are ready to send
       bool
       ReadyToSend() const;
@@ -120,7 +127,7 @@ namespace llarp
       void
       HandlePathBuildFailedAt(path::Path_ptr path, RouterID hop) override;
 
-      std::optional<std::vector<RouterContact>>
+      std::optional<std::vector<RouterContact_ptr>>
       GetHopsForBuild() override;
 
       bool
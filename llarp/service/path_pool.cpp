@@ -0,0 +1,166 @@
+#include "path_pool.hpp"
+
+#include "endpoint.hpp"
+#include <llarp/path/path.hpp>
+
+namespace llarp
+{
+  namespace service
+  {
+    void
+    SpareDemand::Want(const RouterID& router, path::PathRole roles, llarp_time_t now)
+    {
+      m_Demand[router] = Demand{roles, now};
+      if (m_Demand.size() <= MaxDemandTargets)
+        return;
+      // forget the router we wanted least recently
+      auto oldest = m_Demand.begin();
+      for (auto itr = m_Demand.begin(); itr != m_Demand.end(); ++itr)
+      {
+        if (itr->second.lastWanted < oldest->second.lastWanted)
+          oldest = itr;
+      }
+      m_Demand.erase(oldest);
+    }
+
+    void
+    SpareDemand::Expire(llarp_time_t now)
+    {
+      for (auto itr = m_Demand.begin(); itr != m_Demand.end();)
+      {
+        if (now - itr->second.lastWanted >= DemandTimeout)
+          itr = m_Demand.erase(itr);
+        else
+          ++itr;
+      }
+    }
+
+    void
+    SpareDemand::Taken(bool hit, const std::unordered_set<RouterID>& routers)
+    {
+      if (hit)
+      {
+        ++hits;
+        return;
+      }
+      for (const auto& router : routers)
+      {
+        if (Wanted(router))
+        {
+          ++misses;
+          return;
+        }
+      }
+      ++cold;
+    }
+
+    PathPool::PathPool(Endpoint* parent, size_t maxSpares)
+        : path::Builder{parent->Router(), 0, parent->numHops}
+        , m_Parent{parent}
+        , m_MaxSpares{maxSpares}
+    {}
+
+    std::string
+    PathPool::Name() const
+    {
+      return m_Parent->Name() + ":pool";
+    }
+
+    void
+    PathPool::Want(const RouterID& router, path::PathRole roles, llarp_time_t now)
+    {
+      if (m_MaxSpares == 0)
+        return;
+      m_Demand.Want(router, roles, now);
+    }
+
+    path::Path_ptr
+    PathPool::Take(
+        const std::unordered_set<RouterID>& routers, path::PathRole roles, llarp_time_t now)
+    {
+      Lock_t l{m_PathsMutex};
+      for (auto itr = m_Paths.begin(); itr != m_Paths.end(); ++itr)
+      {
+        const auto& p = itr->second;
+        if (not routers.count(p->Endpoint()) or not p->IsReady())
+          continue;
+        if (not p->SupportsAllRoles(roles))
+          continue;
+        if (p->ExpiresSoon(now, MinSpareLifetime))
+          continue;
+        auto taken = p;
+        m_Paths.erase(itr);
+        m_Demand.Taken(true, routers);
+        LogInfo(Name(), " handing out spare path ", taken->ShortName(), " to ", taken->Endpoint());
+        return taken;
+      }
+      if (m_MaxSpares > 0)
+        m_Demand.Taken(false, routers);
+      return nullptr;
+    }
+
+    size_t
+    PathPool::NumSparesTo(const RouterID& router, llarp_time_t now) const
+    {
+      size_t num = 0;
+      ForEachPath([&num, &router, now](const path::Path_ptr& p) {
+        if (p->Endpoint() != router)
+          return;
+        if (p->Status() == path::ePathBuilding
+            or (p->IsReady() and not p->ExpiresSoon(now, MinSpareLifetime)))
+          ++num;
+      });
+      return num;
+    }
+
+    std::optional<std::pair<RouterID, path::PathRole>>
+    PathPool::NextTarget(llarp_time_t now) const
+    {
+      return m_Demand.Next([this, now](const RouterID& router) {
+        return m_Parent->MnodeBlacklist().count(router) == 0 and NumSparesTo(router, now) == 0;
+      });
+    }
+
+    bool
+    PathPool::ShouldBuildMore(llarp_time_t now) const
+    {
+      if (IsStopped() or BuildCooldownHit(now))
+        return false;
+      const auto spares = NumInStatus(path::ePathBuilding) + NumInStatus(path::ePathEstablished);
+      if (spares >= m_MaxSpares)
+        return false;
+      return NextTarget(now).has_value();
+    }
+
+    void
+    PathPool::BuildOne(path::PathRole)
+    {
+      const auto maybe = NextTarget(Now());
+      if (not maybe)
+        return;
+      const auto& [router, roles] = *maybe;
+      if (auto hops = GetHopsAlignedToForBuild(router, m_Parent->MnodeBlacklist()))
+        Build(*hops, roles);
+    }
+
+    void
+    PathPool::Tick(llarp_time_t now)
+    {
+      m_Demand.Expire(now);
+      path::Builder::Tick(now);
+    }
+
+    util::StatusObject
+    PathPool::ExtractStatus() const
+    {
+      auto obj = path::Builder::ExtractStatus();
+      obj["maxSpares"] = uint64_t{m_MaxSpares};
+      obj["wanted"] = uint64_t{m_Demand.Size()};
+      obj["hits"] = m_Demand.hits;
+      obj["misses"] = m_Demand.misses;
+      obj["cold"] = m_Demand.cold;
+      return obj;
+    }
+
+  }  // namespace service
+}  // namespace llarp
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <llarp/constants/path.hpp>
+#include <llarp/path/pathbuilder.hpp>
+#include <llarp/router_id.hpp>
+#include <llarp/util/status.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace llarp
+{
+  namespace service
+  {
+    struct Endpoint;
+
+    /// the routers an endpoint recently wanted paths to, and how often a spare was there for them
+    struct SpareDemand
+    {
+      /// how long a router stays wanted after we last asked for it
+      static constexpr auto DemandTimeout = 10min;
+      /// the most routers we remember demand for
+      static constexpr size_t MaxDemandTargets = 32;
+
+      /// note that we just wanted a path ending at router with the given roles
+      void
+      Want(const RouterID& router, path::PathRole roles, llarp_time_t now);
+
+      /// true if we wanted a path to router recently
+      bool
+      Wanted(const RouterID& router) const
+      {
+        return m_Demand.count(router) > 0;
+      }
+
+      /// forget routers we haven't wanted for DemandTimeout
+      void
+      Expire(llarp_time_t now);
+
+      /// record the outcome of looking for a spare to any of routers.  a lookup for routers we
+      /// never wanted before is a cold start, not a miss, as we had no reason to have a spare.
+      void
+      Taken(bool hit, const std::unordered_set<RouterID>& routers);
+
+      /// the most recently wanted router that accept(router) agrees to build a spare to
+      template <typename Accept_t>
+      std::optional<std::pair<RouterID, path::PathRole>>
+      Next(Accept_t&& accept) const
+      {
+        std::optional<std::pair<RouterID, path::PathRole>> target;
+        llarp_time_t newest = 0s;
+        for (const auto& [router, demand] : m_Demand)
+        {
+          if (demand.lastWanted <= newest or not accept(router))
+            continue;
+          newest = demand.lastWanted;
+          target = std::make_pair(router, demand.roles);
+        }
+        return target;
+      }
+
+      size_t
+      Size() const
+      {
+        return m_Demand.size();
+      }
+
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t cold = 0;
+
+     private:
+      struct Demand
+      {
+        path::PathRole roles;
+        llarp_time_t lastWanted;
+      };
+
+      std::unordered_map<RouterID, Demand> m_Demand;
+    };
+
+    /// a pool of spare paths built ahead of time for an endpoint.
+    ///
+    /// a path to a remote hidden service or mnode has to end at a specific router, so we can only
+    /// prebuild paths to routers we expect to need.  every time the endpoint opens an outbound
+    /// session it tells us the routers it wanted (the remote's intro routers or the mnode itself)
+    /// and we keep a spare path to each of the most recently wanted ones.  new outbound contexts
+    /// and mnode sessions take their first path from here instead of waiting on a build.
+    struct PathPool final : public path::Builder, public std::enable_shared_from_this<PathPool>
+    {
+      /// spare paths must have at least this much lifetime left to be handed out
+      static constexpr auto MinSpareLifetime = path::default_lifetime / 2;
+
+      PathPool(Endpoint* parent, size_t maxSpares);
+
+      path::PathSet_ptr
+      GetSelf() override
+      {
+        return shared_from_this();
+      }
+
+      std::weak_ptr<path::PathSet>
+      GetWeak() override
+      {
+        return weak_from_this();
+      }
+
+      std::string
+      Name() const override;
+
+      /// note that we just wanted a path ending at router with the given roles
+      void
+      Want(const RouterID& router, path::PathRole roles, llarp_time_t now);
+
+      /// take a ready spare path ending at any of the routers out of the pool, records a hit, a
+      /// miss or a cold start.  call before Want() for the same routers.
+      path::Path_ptr
+      Take(const std::unordered_set<RouterID>& routers, path::PathRole roles, llarp_time_t now);
+
+      bool
+      ShouldBuildMore(llarp_time_t now) const override;
+
+      void
+      BuildOne(path::PathRole roles = path::ePathRoleAny) override;
+
+      bool
+      ShouldBundleRC() const override
+      {
+        return false;
+      }
+
+      void
+      BlacklistMNode(const RouterID) override
+      {}
+
+      void
+      SendPacketToRemote(const llarp_buffer_t&, ProtocolType) override
+      {}
+
+      void
+      HandlePathDied(path::Path_ptr) override
+      {}
+
+      void
+      Tick(llarp_time_t now) override;
+
+      util::StatusObject
+      ExtractStatus() const;
+
+      uint64_t
+      Hits() const
+      {
+        return m_Demand.hits;
+      }
+
+      uint64_t
+      Misses() const
+      {
+        return m_Demand.misses;
+      }
+
+     private:
+      /// the router we should build our next spare path to, if any
+      std::optional<std::pair<RouterID, path::PathRole>>
+      NextTarget(llarp_time_t now) const;
+
+      /// number of spare paths we have or are building to router
+      size_t
+      NumSparesTo(const RouterID& router, llarp_time_t now) const;
+
+      Endpoint* const m_Parent;
+      const size_t m_MaxSpares;
+      SpareDemand m_Demand;
+    };
+
+  }  // namespace service
+}  // namespace llarp
@@ -3,6 +3,7 @@
 #include <llarp/routing/handler.hpp>
 #include <llarp/util/buffer.hpp>
 #include <llarp/util/mem.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include <llarp/util/meta/memfn.hpp>
 #include "endpoint.hpp"
 #include <llarp/router/abstractrouter.hpp>
@@ -464,7 +465,13 @@ namespace llarp
         }
       };
       handler->Router()->QueueWork(
-          [v, msg = std::move(msg), recvPath = std::move(recvPath), callback, handler]() {
+          [v,
+           msg = std::move(msg),
+           recvPath = std::move(recvPath),
+           callback,
+           handler,
+           queued = trace::Stamp{}]() mutable {
+            queued.Lap(trace::Stage::ServiceDecryptQueue);
             auto resetTag = [handler, tag = v->frame.T, from = v->frame.F, path = recvPath]() {
               handler->ResetConvoTag(tag, path, from);
             };
@@ -481,6 +488,7 @@ namespace llarp
               handler->Loop()->call_soon(resetTag);
               return;
             }
+            queued.Record(trace::Stage::ServiceDecrypt);
             callback(msg);
             RecvDataEvent ev;
             ev.fromPath = std::move(recvPath);
@@ -2,6 +2,7 @@
 
 #include <llarp/router/abstractrouter.hpp>
 #include <llarp/routing/path_transfer_message.hpp>
+#include <llarp/util/latency_trace.hpp>
 #include "endpoint.hpp"
 #include <utility>
 #include <unordered_set>
@@ -26,10 +27,17 @@ namespace llarp
 
     bool
     SendContext::Send(std::shared_ptr<ProtocolFrame> msg, path::Path_ptr path)
+    {
+      return Send(std::move(msg), std::move(path), remoteIntro);
+    }
+
+    bool
+    SendContext::Send(
+        std::shared_ptr<ProtocolFrame> msg, path::Path_ptr path, const Introduction& remote)
     {
       if (path->IsReady()
           and m_SendQueue.tryPushBack(std::make_pair(
-                  std::make_shared<routing::PathTransferMessage>(*msg, remoteIntro.pathID), path))
+                  std::make_shared<routing::PathTransferMessage>(*msg, remote.pathID), path))
               == thread::QueueReturn::Success)
       {
         m_Endpoint->Router()->TriggerPump();
@@ -79,7 +87,17 @@ namespace llarp
       f->T = currentConvoTag;
       f->S = ++sequenceNo;
 
-      auto path = m_PathSet->GetPathByRouter(remoteIntro.router);
+      // stripe over the remote intros round robin, falling back to the current intro
+      Introduction remote = remoteIntro;
+      if (const auto intros = StripeIntros(); intros.size() > 1)
+        remote = intros[stripeIndex++ % intros.size()];
+
+      auto path = m_PathSet->GetWeightedPathByRouter(remote.router);
+      if (not path and remote.router != remoteIntro.router)
+      {
+        remote = remoteIntro;
+        path = m_PathSet->GetWeightedPathByRouter(remote.router);
+      }
       if (!path)
       {
         ShiftIntroRouter(remoteIntro.router);
@@ -94,9 +112,16 @@ namespace llarp
         return;
       }
 
+      // replies stick to one of our paths until it rotates out, whichever path this frame takes
+      if (not replyPath or not replyPath->IsReady()
+          or replyPath->intro.ExpiresSoon(m_Endpoint->Now()))
+      {
+        replyPath = path;
+      }
+
       auto m = std::make_shared<ProtocolMessage>();
       m_DataHandler->PutIntroFor(f->T, remoteIntro);
-      m_DataHandler->PutReplyIntroFor(f->T, path->intro);
+      m_DataHandler->PutReplyIntroFor(f->T, replyPath->intro);
       m->proto = t;
       if (auto maybe = m_Endpoint->GetSeqNoForConvo(f->T))
       {
@@ -107,19 +132,22 @@ namespace llarp
         LogWarn(m_PathSet->Name(), " could not get sequence number for session T=", f->T);
         return;
       }
-      m->introReply = path->intro;
+      m->introReply = replyPath->intro;
       f->F = m->introReply.pathID;
       m->sender = m_Endpoint->GetIdentity().pub;
       m->tag = f->T;
       m->PutBuffer(payload);
-      m_Endpoint->Router()->QueueWork([f, m, shared, path, this] {
-        if (not f->EncryptAndSign(*m, shared, m_Endpoint->GetIdentity()))
-        {
-          LogError(m_PathSet->Name(), " failed to sign message");
-          return;
-        }
-        Send(f, path);
-      });
+      m_Endpoint->Router()->QueueWork(
+          [f, m, shared, path, remote, this, queued = trace::Stamp{}]() mutable {
+            queued.Lap(trace::Stage::ServiceEncryptQueue);
+            if (not f->EncryptAndSign(*m, shared, m_Endpoint->GetIdentity()))
+            {
+              LogError(m_PathSet->Name(), " failed to sign message");
+              return;
+            }
+            Send(f, path, remote);
+            queued.Record(trace::Stage::ServiceEncrypt);
+          });
     }
 
     void
@@ -30,6 +30,10 @@ namespace llarp
       bool
       Send(std::shared_ptr<ProtocolFrame> f, path::Path_ptr path);
 
+      /// queue send a fully encrypted hidden service frame via a path to the given remote intro
+      bool
+      Send(std::shared_ptr<ProtocolFrame> f, path::Path_ptr path, const Introduction& remote);
+
       /// flush upstream traffic when in router thread
       void
       FlushUpstream();
@@ -49,6 +53,10 @@ namespace llarp
       llarp_time_t shiftTimeout = (path::build_timeout * 5) / 2;
       llarp_time_t estimatedRTT = 0s;
       bool markedBad = false;
+      /// round robin position over the intros we stripe over
+      uint64_t stripeIndex = 0;
+      /// the path we ask the remote to reply on, kept across frames until it rotates out
+      path::Path_ptr replyPath;
       using Msg_ptr = std::shared_ptr<routing::PathTransferMessage>;
       using SendEvent_t = std::pair<Msg_ptr, path::Path_ptr>;
 
@@ -66,6 +74,14 @@ namespace llarp
       virtual void
       ShiftIntroRouter(const RouterID) = 0;
 
+      /// the remote intros we can send on right now, remoteIntro first.
+      /// more than one means we are striping traffic over several paths.
+      virtual std::vector<Introduction>
+      StripeIntros() const
+      {
+        return {remoteIntro};
+      }
+
       virtual void
       UpdateIntroSet() = 0;
 
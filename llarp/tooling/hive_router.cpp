@@ -27,6 +27,24 @@ namespace tooling
     m_disableGossiping = false;
   }
 
+  void
+  HiveRouter::QueueWork(std::function<void(void)> func)
+  {
+    if (m_hive->IsVirtual())
+      func();
+    else
+      Router::QueueWork(std::move(func));
+  }
+
+  void
+  HiveRouter::QueueDiskIO(std::function<void(void)> func)
+  {
+    if (m_hive->IsVirtual())
+      func();
+    else
+      Router::QueueDiskIO(std::move(func));
+  }
+
   void
   HiveRouter::HandleRouterEvent(RouterEventPtr event) const
   {
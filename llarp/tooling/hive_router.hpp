@@ -27,6 +27,14 @@ namespace tooling
     void
     enableGossiping();
 
+    /// on a virtual network work runs inline, so the simulated clock can't move on before it
+    /// is done
+    void
+    QueueWork(std::function<void(void)> func) override;
+
+    void
+    QueueDiskIO(std::function<void(void)> func) override;
+
    protected:
     bool m_disableGossiping = false;
     RouterHive* m_hive = nullptr;
@@ -12,6 +12,56 @@ using namespace std::chrono_literals;
 
 namespace tooling
 {
+  void
+  RouterHive::UseVirtualNetwork(size_t threads, uint64_t seed)
+  {
+    if (not relays.empty() or not clients.empty())
+      throw std::logic_error{"virtual network must be set up before adding routers"};
+    virtualNetwork = std::make_unique<VirtualNetwork>(threads, seed);
+  }
+
+  void
+  RouterHive::RunFor(llarp_time_t duration)
+  {
+    if (virtualNetwork)
+      virtualNetwork->RunFor(duration);
+    else
+      std::this_thread::sleep_for(duration);
+  }
+
+  llarp_time_t
+  RouterHive::Now() const
+  {
+    if (virtualNetwork)
+      return virtualNetwork->Now();
+    return llarp::time_now_ms();
+  }
+
+  std::optional<std::chrono::nanoseconds>
+  RouterHive::RouterCPUTime(const llarp::RouterID& id)
+  {
+    std::lock_guard guard{routerMutex};
+    if (virtualNetwork)
+    {
+      for (const auto* container : {&relays, &clients})
+      {
+        if (auto itr = container->find(id); itr != container->end())
+        {
+          if (auto loop = std::dynamic_pointer_cast<VirtualLoop>(itr->second->loop))
+            return loop->CPUTime();
+        }
+      }
+      return std::nullopt;
+    }
+    auto itr = routerCPUClocks.find(id);
+    if (itr == routerCPUClocks.end())
+      return std::nullopt;
+    timespec ts{};
+    if (clock_gettime(itr->second, &ts) != 0)
+      return std::nullopt;
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+  }
+
   void
   RouterHive::AddRouter(const std::shared_ptr<llarp::Config>& config, bool isMNode)
   {
@@ -21,6 +71,8 @@ namespace tooling
     opts.isMNode = isMNode;
 
     Context_ptr context = std::make_shared<HiveContext>(this);
+    if (virtualNetwork)
+      context->loop = virtualNetwork->MakeLoop();
     context->Configure(config);
     context->Setup(opts);
 
@@ -46,10 +98,32 @@ namespace tooling
   {
     auto& container = (isRelay ? relays : clients);
 
+    if (virtualNetwork)
+    {
+      // no threads to start, the network runs the routers' loops
+      for (const auto& [routerId, ctx] : container)
+      {
+        ctx->loop->call_soon([ctx = ctx]() {
+          if (not ctx->router->Run())
+            llarp::LogError("hive router failed to start");
+        });
+      }
+      virtualNetwork->RunFor(0s);
+      return;
+    }
+
     for (const auto& [routerId, ctx] : container)
     {
-      routerMainThreads.emplace_back([ctx = ctx, isRelay = isRelay]() {
+      routerMainThreads.emplace_back([this, routerId = routerId, ctx = ctx, isRelay = isRelay]() {
+        clockid_t clock;
+        if (pthread_getcpuclockid(pthread_self(), &clock) == 0)
+        {
+          std::lock_guard guard{routerMutex};
+          routerCPUClocks[routerId] = clock;
+        }
         ctx->Run(llarp::RuntimeOptions{false, false, isRelay});
+        std::lock_guard guard{routerMutex};
+        routerCPUClocks.erase(routerId);
       });
       std::this_thread::sleep_for(2ms);
     }
@@ -85,17 +159,26 @@ namespace tooling
     {
       while (ctx->IsUp())
       {
-        std::this_thread::sleep_for(10ms);
+        RunFor(10ms);
       }
     }
     for (auto [routerId, ctx] : clients)
     {
       while (ctx->IsUp())
       {
-        std::this_thread::sleep_for(10ms);
+        RunFor(10ms);
       }
     }
 
+    if (virtualNetwork)
+    {
+      // what Context::Run does once its loop returns
+      for (auto& [routerId, ctx] : relays)
+        ctx->Close();
+      for (auto& [routerId, ctx] : clients)
+        ctx->Close();
+    }
+
     llarp::LogInfo("Joining all router threads");
     for (auto& thread : routerMainThreads)
     {
@@ -198,7 +281,7 @@ namespace tooling
       if (read_done_count == relays.size())
         break;
 
-      std::this_thread::sleep_for(100ms);
+      RunFor(100ms);
     }
     return results;
   }
@@ -5,11 +5,15 @@
 #include <llarp.hpp>
 #include <config/config.hpp>
 #include <tooling/hive_context.hpp>
+#include <tooling/virtual_network.hpp>
 
 #include <vector>
 #include <deque>
 #include <thread>
 #include <mutex>
+#include <optional>
+
+#include <pthread.h>
 
 struct llarp_config;
 struct llarp_main;
@@ -41,6 +45,32 @@ namespace tooling
    public:
     RouterHive() = default;
 
+    /// run the hive on an in-process virtual network with a simulated clock, instead of real
+    /// sockets and a thread per router; work routers queue runs inline.  call before adding
+    /// routers.
+    void
+    UseVirtualNetwork(size_t threads, uint64_t seed);
+
+    bool
+    IsVirtual() const
+    {
+      return virtualNetwork != nullptr;
+    }
+
+    /// let the hive run for duration: advances the clock of a virtual network, sleeps
+    /// otherwise
+    void
+    RunFor(llarp_time_t duration);
+
+    /// the hive's clock: simulated time on a virtual network, llarp::time_now_ms otherwise
+    llarp_time_t
+    Now() const;
+
+    /// cpu time a router's event loop thread has used, or nullopt if it isn't running.  on a
+    /// virtual network this includes the work the router queued, which runs inline there.
+    std::optional<std::chrono::nanoseconds>
+    RouterCPUTime(const llarp::RouterID& id);
+
     void
     AddRelay(const std::shared_ptr<llarp::Config>& conf);
 
@@ -82,11 +112,17 @@ namespace tooling
     std::vector<llarp::RouterContact>
     GetRelayRCs();
 
+    /// declared before the routers so it outlives them: their udp handles unbind from it as
+    /// they are destroyed
+    std::unique_ptr<VirtualNetwork> virtualNetwork;
+
     std::mutex routerMutex;
     std::unordered_map<llarp::RouterID, Context_ptr> relays;
     std::unordered_map<llarp::RouterID, Context_ptr> clients;
 
     std::vector<std::thread> routerMainThreads;
+    /// cpu clocks of the router main threads, while they run
+    std::unordered_map<llarp::RouterID, clockid_t> routerCPUClocks;
 
     std::mutex eventQueueMutex;
     std::deque<RouterEventPtr> eventQueue;
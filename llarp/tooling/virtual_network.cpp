@@ -0,0 +1,520 @@
+#include "virtual_network.hpp"
+
+#include <llarp/util/logging.hpp>
+
+#include <algorithm>
+
+#include <time.h>
+
+namespace tooling
+{
+  namespace
+  {
+    std::chrono::nanoseconds
+    ThreadCPUTime()
+    {
+      timespec ts{};
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+      return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+    }
+
+    /// the loop whose round this thread is running, if any
+    thread_local const VirtualLoop* current_loop = nullptr;
+
+    /// how many batches of call_soon calls a loop runs per round; calls queued after that wait
+    /// for the next round
+    constexpr size_t MaxCallBatches = 64;
+  }  // namespace
+
+  class VirtualUDPHandle final : public llarp::UDPHandle,
+                                 public std::enable_shared_from_this<VirtualUDPHandle>
+  {
+   public:
+    VirtualUDPHandle(VirtualLoop& loop, ReceiveFunc on_recv)
+        : llarp::UDPHandle{std::move(on_recv)}, m_Loop{loop}
+    {}
+
+    ~VirtualUDPHandle() override
+    {
+      close();
+    }
+
+    bool
+    listen(const llarp::SockAddr& addr) override
+    {
+      close();
+      m_Addr = m_Loop.m_Net.Bind(addr, weak_from_this(), m_Loop.m_ID);
+      return m_Addr.has_value();
+    }
+
+    bool
+    send(const llarp::SockAddr& dest, const llarp_buffer_t& buf) override
+    {
+      // like a socket that was never bound, pick an address on first send
+      if (not m_Addr and not listen(llarp::SockAddr{"127.0.0.1:0"}))
+        return false;
+      auto& net = m_Loop.m_Net;
+      auto peer = net.Lookup(dest);
+      const auto at = m_Loop.Transmit(*m_Addr, dest, buf.sz);
+      if (not peer or not at)
+      {
+        net.m_Dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      m_Loop.Schedule(
+          peer->second,
+          *at,
+          [handle = peer->first,
+           src = *m_Addr,
+           data = std::vector<byte_t>{buf.base, buf.base + buf.sz},
+           &net] {
+            if (auto ptr = handle.lock())
+            {
+              net.m_Delivered.fetch_add(1, std::memory_order_relaxed);
+              ptr->on_recv(*ptr, src, llarp::OwnedBuffer{data.data(), data.size()});
+            }
+          });
+      return true;
+    }
+
+    void
+    close() override
+    {
+      if (m_Addr)
+        m_Loop.m_Net.Unbind(*m_Addr);
+      m_Addr.reset();
+    }
+
+    std::optional<llarp::SockAddr>
+    LocalAddr() const override
+    {
+      return m_Addr;
+    }
+
+   private:
+    VirtualLoop& m_Loop;
+    std::optional<llarp::SockAddr> m_Addr;
+  };
+
+  namespace
+  {
+    class VirtualWakeup final : public llarp::EventLoopWakeup,
+                                public std::enable_shared_from_this<VirtualWakeup>
+    {
+     public:
+      VirtualWakeup(VirtualLoop& loop, std::function<void()> callback)
+          : m_Loop{loop}, m_Callback{std::move(callback)}
+      {}
+
+      void
+      Trigger() override
+      {
+        if (m_Pending.exchange(true))
+          return;
+        m_Loop.call_soon([weak = weak_from_this()] {
+          if (auto self = weak.lock())
+          {
+            self->m_Pending = false;
+            self->m_Callback();
+          }
+        });
+      }
+
+     private:
+      VirtualLoop& m_Loop;
+      std::function<void()> m_Callback;
+      std::atomic<bool> m_Pending{false};
+    };
+
+    class VirtualRepeater final : public llarp::EventLoopRepeater,
+                                  public std::enable_shared_from_this<VirtualRepeater>
+    {
+     public:
+      explicit VirtualRepeater(VirtualLoop& loop) : m_Loop{loop}
+      {}
+
+      void
+      start(llarp_time_t every, std::function<void()> task) override
+      {
+        m_Every = every;
+        m_Task = std::move(task);
+        Arm();
+      }
+
+     private:
+      void
+      Arm()
+      {
+        m_Loop.call_later(m_Every, [weak = weak_from_this()] {
+          if (auto self = weak.lock())
+          {
+            self->Arm();
+            self->m_Task();
+          }
+        });
+      }
+
+      VirtualLoop& m_Loop;
+      llarp_time_t m_Every;
+      std::function<void()> m_Task;
+    };
+  }  // namespace
+
+  VirtualLoop::VirtualLoop(VirtualNetwork& net, size_t id, uint64_t seed)
+      : m_Net{net}, m_ID{id}, m_Rand{seed}
+  {}
+
+  void
+  VirtualLoop::run()
+  {
+    std::unique_lock lock{m_StopMutex};
+    m_StopCV.wait(lock, [this] { return m_Stopped.load(); });
+  }
+
+  bool
+  VirtualLoop::running() const
+  {
+    return not m_Stopped;
+  }
+
+  llarp_time_t
+  VirtualLoop::time_now() const
+  {
+    return m_Net.Now();
+  }
+
+  void
+  VirtualLoop::call_soon(std::function<void(void)> f)
+  {
+    std::lock_guard lock{m_CallsMutex};
+    m_Calls.emplace_back(std::move(f));
+  }
+
+  void
+  VirtualLoop::call_later(llarp_time_t delay_ms, std::function<void(void)> callback)
+  {
+    Schedule(m_ID, m_Net.Now() + delay_ms, std::move(callback));
+  }
+
+  bool
+  VirtualLoop::add_network_interface(
+      std::shared_ptr<llarp::vpn::NetworkInterface>, std::function<void(llarp::net::IPPacket)>)
+  {
+    llarp::LogError("network interfaces are not supported on a virtual network");
+    return false;
+  }
+
+  bool
+  VirtualLoop::add_ticker(std::function<void(void)> ticker)
+  {
+    m_Tickers.emplace_back(std::move(ticker));
+    return true;
+  }
+
+  void
+  VirtualLoop::stop()
+  {
+    {
+      std::lock_guard lock{m_StopMutex};
+      m_Stopped = true;
+    }
+    m_StopCV.notify_all();
+  }
+
+  std::shared_ptr<llarp::UDPHandle>
+  VirtualLoop::make_udp(UDPReceiveFunc on_recv)
+  {
+    return std::make_shared<VirtualUDPHandle>(*this, std::move(on_recv));
+  }
+
+  std::shared_ptr<llarp::EventLoopWakeup>
+  VirtualLoop::make_waker(std::function<void()> callback)
+  {
+    return std::make_shared<VirtualWakeup>(*this, std::move(callback));
+  }
+
+  std::shared_ptr<llarp::EventLoopRepeater>
+  VirtualLoop::make_repeater()
+  {
+    return std::make_shared<VirtualRepeater>(*this);
+  }
+
+  bool
+  VirtualLoop::inEventLoop() const
+  {
+    return current_loop == this;
+  }
+
+  void
+  VirtualLoop::wakeup()
+  {
+    // nothing to wake, the network checks for queued calls before moving the clock
+  }
+
+  bool
+  VirtualLoop::HasCalls() const
+  {
+    std::lock_guard lock{m_CallsMutex};
+    return not m_Calls.empty();
+  }
+
+  void
+  VirtualLoop::RunRound(std::vector<std::function<void()>> due)
+  {
+    if (m_Stopped)
+      return;
+    const auto started = ThreadCPUTime();
+    current_loop = this;
+    for (auto& fn : due)
+      fn();
+    for (size_t batch = 0; batch < MaxCallBatches; ++batch)
+    {
+      std::vector<std::function<void()>> calls;
+      {
+        std::lock_guard lock{m_CallsMutex};
+        calls.swap(m_Calls);
+      }
+      if (calls.empty())
+        break;
+      for (auto& fn : calls)
+        fn();
+    }
+    for (auto& ticker : m_Tickers)
+      ticker();
+    current_loop = nullptr;
+    m_CPUTime += (ThreadCPUTime() - started).count();
+  }
+
+  void
+  VirtualLoop::Schedule(size_t target, llarp_time_t at, std::function<void()> fn)
+  {
+    if (current_loop == this)
+      m_Outbox.push_back(Outgoing{target, at, std::move(fn)});
+    else
+      m_Net.ScheduleForeign(target, at, std::move(fn));
+  }
+
+  std::optional<llarp_time_t>
+  VirtualLoop::Transmit(const llarp::SockAddr& src, const llarp::SockAddr& dest, size_t size)
+  {
+    const auto& link = m_Net.Link(src, dest);
+    if (link.loss > 0 and std::uniform_real_distribution<double>{0, 1}(m_Rand) < link.loss)
+      return std::nullopt;
+    auto sent = m_Net.Now();
+    if (link.bandwidth)
+    {
+      // the datagram goes out after the ones still on the link
+      auto& busy = m_LinkBusyUntil[dest];
+      busy = std::max<std::chrono::microseconds>(sent, busy)
+          + std::chrono::microseconds{size * 1'000'000 / link.bandwidth};
+      sent = std::chrono::ceil<llarp_time_t>(busy);
+    }
+    return sent + link.latency;
+  }
+
+  std::atomic<VirtualNetwork*> VirtualNetwork::s_Active{nullptr};
+  std::atomic<int64_t> VirtualNetwork::s_Now{0};
+
+  VirtualNetwork::VirtualNetwork(size_t threads, uint64_t seed) : m_Seed{seed}
+  {
+    if (VirtualNetwork* none = nullptr; not s_Active.compare_exchange_strong(none, this))
+      throw std::logic_error{"only one virtual network can exist at a time"};
+    s_Now = llarp::time_now_ms().count();
+    llarp::set_time_source(&VirtualNetwork::ActiveNow);
+    // the thread calling RunFor works too
+    for (size_t idx = 1; idx < threads; ++idx)
+      m_Workers.emplace_back([this] { Worker(); });
+  }
+
+  VirtualNetwork::~VirtualNetwork()
+  {
+    {
+      std::lock_guard lock{m_PoolMutex};
+      m_Quit = true;
+    }
+    m_PoolCV.notify_all();
+    for (auto& worker : m_Workers)
+      worker.join();
+    for (auto& loop : m_Loops)
+      loop->stop();
+    llarp::set_time_source(nullptr);
+    s_Active = nullptr;
+  }
+
+  llarp_time_t
+  VirtualNetwork::ActiveNow()
+  {
+    return llarp_time_t{s_Now.load(std::memory_order_relaxed)};
+  }
+
+  std::shared_ptr<VirtualLoop>
+  VirtualNetwork::MakeLoop()
+  {
+    auto loop = std::make_shared<VirtualLoop>(*this, m_Loops.size(), m_Seed + m_Loops.size());
+    m_Loops.push_back(loop);
+    return loop;
+  }
+
+  void
+  VirtualNetwork::SetDefaultLink(LinkParams params)
+  {
+    m_DefaultLink = params;
+  }
+
+  void
+  VirtualNetwork::SetLink(const llarp::SockAddr& from, const llarp::SockAddr& to, LinkParams params)
+  {
+    m_Links[{from, to}] = params;
+  }
+
+  const LinkParams&
+  VirtualNetwork::Link(const llarp::SockAddr& from, const llarp::SockAddr& to) const
+  {
+    if (auto itr = m_Links.find({from, to}); itr != m_Links.end())
+      return itr->second;
+    return m_DefaultLink;
+  }
+
+  void
+  VirtualNetwork::ScheduleForeign(size_t loop, llarp_time_t at, std::function<void()> fn)
+  {
+    std::lock_guard lock{m_ForeignMutex};
+    m_Foreign.push_back(Event{at, 0, loop, std::move(fn)});
+  }
+
+  std::optional<llarp::SockAddr>
+  VirtualNetwork::Bind(llarp::SockAddr addr, std::weak_ptr<VirtualUDPHandle> handle, size_t loop)
+  {
+    // there is only one host: wildcard binds are reachable on loopback
+    if (const auto host = addr.hostString(); host == "0.0.0.0" or host == "::")
+      addr.setIPv4(127, 0, 0, 1);
+    std::lock_guard lock{m_BindMutex};
+    if (addr.getPort() == 0)
+    {
+      do
+      {
+        addr.setPort(m_NextPort++);
+      } while (m_Bound.count(addr));
+    }
+    if (not m_Bound.emplace(addr, std::make_pair(std::move(handle), loop)).second)
+      return std::nullopt;
+    return addr;
+  }
+
+  void
+  VirtualNetwork::Unbind(const llarp::SockAddr& addr)
+  {
+    std::lock_guard lock{m_BindMutex};
+    m_Bound.erase(addr);
+  }
+
+  std::optional<std::pair<std::weak_ptr<VirtualUDPHandle>, size_t>>
+  VirtualNetwork::Lookup(const llarp::SockAddr& addr) const
+  {
+    std::lock_guard lock{m_BindMutex};
+    if (auto itr = m_Bound.find(addr); itr != m_Bound.end())
+      return itr->second;
+    return std::nullopt;
+  }
+
+  void
+  VirtualNetwork::RunFor(llarp_time_t duration)
+  {
+    const auto until = Now() + duration;
+    while (true)
+    {
+      {
+        std::lock_guard lock{m_ForeignMutex};
+        for (auto& ev : m_Foreign)
+        {
+          ev.seq = m_NextSeq++;
+          m_Events.push(std::move(ev));
+        }
+        m_Foreign.clear();
+      }
+
+      // gather everything due now, keyed by loop id so rounds go in a fixed order
+      std::map<size_t, std::vector<std::function<void()>>> due;
+      while (not m_Events.empty() and m_Events.top().at <= Now())
+      {
+        auto& ev = const_cast<Event&>(m_Events.top());
+        due[ev.loop].emplace_back(std::move(ev.fn));
+        m_Events.pop();
+      }
+      for (const auto& loop : m_Loops)
+      {
+        if (not loop->m_Stopped and loop->HasCalls())
+          due[loop->m_ID];
+      }
+
+      if (due.empty())
+      {
+        // nothing left to do now, move the clock to the next thing due
+        if (m_Events.empty() or m_Events.top().at > until)
+        {
+          s_Now = std::max(Now(), until).count();
+          return;
+        }
+        s_Now = m_Events.top().at.count();
+        continue;
+      }
+
+      std::vector<std::pair<VirtualLoop*, std::vector<std::function<void()>>>> work;
+      work.reserve(due.size());
+      for (auto& [id, fns] : due)
+        work.emplace_back(m_Loops[id].get(), std::move(fns));
+      RunRound(work);
+
+      for (const auto& [loop, fns] : work)
+      {
+        for (auto& out : loop->m_Outbox)
+          m_Events.push(Event{std::max(out.at, Now()), m_NextSeq++, out.target, std::move(out.fn)});
+        loop->m_Outbox.clear();
+      }
+    }
+  }
+
+  void
+  VirtualNetwork::RunRound(
+      std::vector<std::pair<VirtualLoop*, std::vector<std::function<void()>>>>& work)
+  {
+    std::atomic<size_t> next{0};
+    auto drain = [&work, &next] {
+      for (size_t idx; (idx = next.fetch_add(1)) < work.size();)
+        work[idx].first->RunRound(std::move(work[idx].second));
+    };
+    {
+      std::lock_guard lock{m_PoolMutex};
+      m_Job = drain;
+      m_Busy = m_Workers.size();
+      ++m_Generation;
+    }
+    m_PoolCV.notify_all();
+    drain();
+    std::unique_lock lock{m_PoolMutex};
+    m_DoneCV.wait(lock, [this] { return m_Busy == 0; });
+    m_Job = nullptr;
+  }
+
+  void
+  VirtualNetwork::Worker()
+  {
+    uint64_t seen = 0;
+    while (true)
+    {
+      std::function<void()> job;
+      {
+        std::unique_lock lock{m_PoolMutex};
+        m_PoolCV.wait(lock, [this, seen] { return m_Quit or m_Generation != seen; });
+        if (m_Quit)
+          return;
+        seen = m_Generation;
+        job = m_Job;
+      }
+      job();
+      std::lock_guard lock{m_PoolMutex};
+      if (--m_Busy == 0)
+        m_DoneCV.notify_one();
+    }
+  }
+}  // namespace tooling
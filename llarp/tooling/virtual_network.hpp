@@ -0,0 +1,276 @@
+#pragma once
+
+#include <llarp/ev/ev.hpp>
+#include <llarp/ev/udp_handle.hpp>
+#include <llarp/net/sock_addr.hpp>
+#include <llarp/util/time.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace tooling
+{
+  /// how datagrams travel between two addresses on a virtual network
+  struct LinkParams
+  {
+    /// one way delay
+    llarp_time_t latency = 10ms;
+    /// chance that a datagram is dropped, 0 to 1
+    double loss = 0;
+    /// bytes per second in each direction, 0 for no limit; datagrams queue behind each other
+    uint64_t bandwidth = 0;
+  };
+
+  class VirtualNetwork;
+  class VirtualUDPHandle;
+
+  /// the event loop of one router on a virtual network.  it has no thread of its own: the
+  /// network runs whatever is due on it from its thread pool, never on two threads at once.
+  class VirtualLoop final : public llarp::EventLoop,
+                            public std::enable_shared_from_this<VirtualLoop>
+  {
+   public:
+    VirtualLoop(VirtualNetwork& net, size_t id, uint64_t seed);
+
+    /// blocks until stop(); the network does the running
+    void
+    run() override;
+
+    bool
+    running() const override;
+
+    llarp_time_t
+    time_now() const override;
+
+    void
+    call_soon(std::function<void(void)> f) override;
+
+    void
+    call_later(llarp_time_t delay_ms, std::function<void(void)> callback) override;
+
+    bool
+    add_network_interface(
+        std::shared_ptr<llarp::vpn::NetworkInterface> netif,
+        std::function<void(llarp::net::IPPacket)> packetHandler) override;
+
+    bool
+    add_ticker(std::function<void(void)> ticker) override;
+
+    void
+    stop() override;
+
+    std::shared_ptr<llarp::UDPHandle>
+    make_udp(UDPReceiveFunc on_recv) override;
+
+    std::shared_ptr<llarp::EventLoopWakeup>
+    make_waker(std::function<void()> callback) override;
+
+    std::shared_ptr<llarp::EventLoopRepeater>
+    make_repeater() override;
+
+    bool
+    inEventLoop() const override;
+
+    void
+    wakeup() override;
+
+    /// cpu time spent running this loop, including work its router queued
+    std::chrono::nanoseconds
+    CPUTime() const
+    {
+      return std::chrono::nanoseconds{m_CPUTime.load(std::memory_order_relaxed)};
+    }
+
+   private:
+    friend class VirtualNetwork;
+    friend class VirtualUDPHandle;
+
+    /// run the timers and deliveries in due, then everything queued with call_soon
+    void
+    RunRound(std::vector<std::function<void()>> due);
+
+    bool
+    HasCalls() const;
+
+    /// queue fn to run on the loop with id target at the given time; from within a round it
+    /// goes out when the round is over, so the order things are scheduled in doesn't depend on
+    /// thread timing
+    void
+    Schedule(size_t target, llarp_time_t at, std::function<void()> fn);
+
+    /// when a datagram of size bytes sent to dest now arrives, or nullopt if it is lost
+    std::optional<llarp_time_t>
+    Transmit(const llarp::SockAddr& src, const llarp::SockAddr& dest, size_t size);
+
+    VirtualNetwork& m_Net;
+    const size_t m_ID;
+
+    mutable std::mutex m_CallsMutex;
+    std::vector<std::function<void()>> m_Calls;
+
+    std::vector<std::function<void()>> m_Tickers;
+    std::atomic<bool> m_Stopped{false};
+    std::mutex m_StopMutex;
+    std::condition_variable m_StopCV;
+
+    struct Outgoing
+    {
+      size_t target;
+      llarp_time_t at;
+      std::function<void()> fn;
+    };
+    /// scheduled during the current round, only touched by the thread running it
+    std::vector<Outgoing> m_Outbox;
+    /// when each link out of this loop is free to send again, for bandwidth limits; finer than
+    /// the clock so small datagrams on a fast link don't each take a whole millisecond
+    std::unordered_map<llarp::SockAddr, std::chrono::microseconds> m_LinkBusyUntil;
+    std::mt19937_64 m_Rand;
+    std::atomic<int64_t> m_CPUTime{0};
+  };
+
+  /// an in-process datagram network for the router hive.  routers get a VirtualLoop each and
+  /// bind virtual udp sockets on it instead of real ones, and all of them follow one simulated
+  /// clock that only moves on once every router is done with what was due, on a small thread
+  /// pool, so a hive can hold far more routers than it has threads.  the seed fixes losses and
+  /// the order things happen in at each step, but not what the routers draw from libsodium or
+  /// randint for keys, path hops and the like, so runs with the same seed can still differ.
+  ///
+  /// only one virtual network may exist at a time, as it takes over llarp::time_now_ms.
+  class VirtualNetwork
+  {
+   public:
+    explicit VirtualNetwork(size_t threads, uint64_t seed = 0);
+
+    ~VirtualNetwork();
+
+    VirtualNetwork(const VirtualNetwork&) = delete;
+    VirtualNetwork&
+    operator=(const VirtualNetwork&) = delete;
+
+    /// a new router's event loop
+    std::shared_ptr<VirtualLoop>
+    MakeLoop();
+
+    /// link parameters for pairs without their own
+    void
+    SetDefaultLink(LinkParams params);
+
+    /// link parameters from one address to another
+    void
+    SetLink(const llarp::SockAddr& from, const llarp::SockAddr& to, LinkParams params);
+
+    /// simulated time
+    llarp_time_t
+    Now() const
+    {
+      return llarp_time_t{s_Now.load(std::memory_order_relaxed)};
+    }
+
+    /// run everything due until the clock reaches Now() + duration.  a duration of zero runs
+    /// just what is due now.
+    void
+    RunFor(llarp_time_t duration);
+
+    /// datagrams delivered and dropped so far
+    uint64_t
+    Delivered() const
+    {
+      return m_Delivered.load(std::memory_order_relaxed);
+    }
+
+    uint64_t
+    Dropped() const
+    {
+      return m_Dropped.load(std::memory_order_relaxed);
+    }
+
+   private:
+    friend class VirtualLoop;
+    friend class VirtualUDPHandle;
+
+    struct Event
+    {
+      llarp_time_t at;
+      uint64_t seq;
+      size_t loop;
+      std::function<void()> fn;
+
+      bool
+      operator>(const Event& other) const
+      {
+        return std::tie(at, seq) > std::tie(other.at, other.seq);
+      }
+    };
+
+    /// schedule from outside a round, any thread
+    void
+    ScheduleForeign(size_t loop, llarp_time_t at, std::function<void()> fn);
+
+    /// bind handle at addr, picking a port if it has none; returns the bound address
+    std::optional<llarp::SockAddr>
+    Bind(llarp::SockAddr addr, std::weak_ptr<VirtualUDPHandle> handle, size_t loop);
+
+    void
+    Unbind(const llarp::SockAddr& addr);
+
+    /// the handle bound at addr and the loop it belongs to
+    std::optional<std::pair<std::weak_ptr<VirtualUDPHandle>, size_t>>
+    Lookup(const llarp::SockAddr& addr) const;
+
+    const LinkParams&
+    Link(const llarp::SockAddr& from, const llarp::SockAddr& to) const;
+
+    /// run loops on the thread pool, with their due events
+    void
+    RunRound(std::vector<std::pair<VirtualLoop*, std::vector<std::function<void()>>>>& work);
+
+    void
+    Worker();
+
+    static llarp_time_t
+    ActiveNow();
+
+    const uint64_t m_Seed;
+    uint64_t m_NextSeq = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> m_Events;
+    std::vector<std::shared_ptr<VirtualLoop>> m_Loops;
+
+    std::mutex m_ForeignMutex;
+    std::vector<Event> m_Foreign;
+
+    mutable std::mutex m_BindMutex;
+    std::unordered_map<llarp::SockAddr, std::pair<std::weak_ptr<VirtualUDPHandle>, size_t>>
+        m_Bound;
+    uint16_t m_NextPort = 40000;
+
+    LinkParams m_DefaultLink;
+    std::map<std::pair<llarp::SockAddr, llarp::SockAddr>, LinkParams> m_Links;
+
+    std::atomic<uint64_t> m_Delivered{0};
+    std::atomic<uint64_t> m_Dropped{0};
+
+    std::mutex m_PoolMutex;
+    std::condition_variable m_PoolCV;
+    std::condition_variable m_DoneCV;
+    std::function<void()> m_Job;
+    uint64_t m_Generation = 0;
+    size_t m_Busy = 0;
+    bool m_Quit = false;
+    std::vector<std::thread> m_Workers;
+
+    static std::atomic<VirtualNetwork*> s_Active;
+    /// simulated time, outside the network so time_now_ms never reads a network that is being
+    /// torn down; it stays at the last simulated time until the next network starts
+    static std::atomic<int64_t> s_Now;
+  };
+}  // namespace tooling
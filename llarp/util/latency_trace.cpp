@@ -0,0 +1,82 @@
+#include "latency_trace.hpp"
+#include "metrics.hpp"
+
+#include <array>
+
+namespace llarp::trace
+{
+  const char*
+  StageName(Stage stage)
+  {
+    switch (stage)
+    {
+      case Stage::LinkRecvPending:
+        return "link_recv_pending";
+      case Stage::LinkDecryptQueue:
+        return "link_decrypt_queue";
+      case Stage::LinkDecrypt:
+        return "link_decrypt";
+      case Stage::LinkPlaintextQueue:
+        return "link_plaintext_queue";
+      case Stage::RelayCellPending:
+        return "relay_cell_pending";
+      case Stage::RelayCryptoQueue:
+        return "relay_crypto_queue";
+      case Stage::RelayCrypto:
+        return "relay_crypto";
+      case Stage::ServiceDecryptQueue:
+        return "service_decrypt_queue";
+      case Stage::ServiceDecrypt:
+        return "service_decrypt";
+      case Stage::ServiceEncryptQueue:
+        return "service_encrypt_queue";
+      case Stage::ServiceEncrypt:
+        return "service_encrypt";
+      case Stage::OutboundQueue:
+        return "outbound_queue";
+      case Stage::LinkEncryptQueue:
+        return "link_encrypt_queue";
+      case Stage::LinkEncrypt:
+        return "link_encrypt";
+      case Stage::OutboundPump:
+        return "outbound_pump";
+      case Stage::RouterPump:
+        return "router_pump";
+      case Stage::NumStages:
+        break;
+    }
+    return "unknown";
+  }
+
+#ifdef BELNET_LATENCY_TRACE
+  namespace
+  {
+    constexpr auto NumStages = static_cast<size_t>(Stage::NumStages);
+
+    std::array<metrics::Histogram*, NumStages>
+    MakeHistograms()
+    {
+      std::array<metrics::Histogram*, NumStages> hists;
+      // 1us to ~1s
+      const auto bounds = metrics::Histogram::ExponentialBounds(1 << 20);
+      for (size_t idx = 0; idx < NumStages; ++idx)
+      {
+        hists[idx] = &metrics::Registry::Global().GetHistogram(
+            "belnet_hot_path_latency_seconds",
+            "time spent queued or working in each stage of the packet hot path",
+            bounds,
+            1e-6,
+            {{"stage", StageName(static_cast<Stage>(idx))}});
+      }
+      return hists;
+    }
+  }  // namespace
+
+  void
+  Record(Stage stage, uint64_t usec)
+  {
+    static const auto hists = MakeHistograms();
+    hists[static_cast<size_t>(stage)]->Observe(usec);
+  }
+#endif
+}  // namespace llarp::trace
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace llarp
+{
+  /// optional latency tracing of the packet hot path.  batches of packets and queued messages
+  /// carry a Stamp from one stage to the next; each hop records the time since the stamp into a
+  /// per-stage histogram in the metrics registry, split into time spent waiting in a queue and
+  /// time spent doing the work.
+  ///
+  /// tracing is compiled in with -DWITH_LATENCY_TRACE=ON (which defines BELNET_LATENCY_TRACE).
+  /// without it a Stamp is an empty struct and every call below is an inline no-op.
+  namespace trace
+  {
+    enum class Stage
+    {
+      /// session data waiting on the session for the next pump to queue it for decryption
+      LinkRecvPending,
+      /// a batch of session data waiting for a worker to decrypt it
+      LinkDecryptQueue,
+      /// decrypting a batch of session data
+      LinkDecrypt,
+      /// decrypted session data waiting for the logic thread to handle it
+      LinkPlaintextQueue,
+      /// relay cells waiting on a path or transit hop for the next flush, timed from the oldest
+      RelayCellPending,
+      /// a batch of relay cells waiting for a worker to do their onion crypto
+      RelayCryptoQueue,
+      /// the onion crypto of a batch of relay cells, on our own paths or transit hops
+      RelayCrypto,
+      /// a received service frame waiting for a worker to verify and decrypt it
+      ServiceDecryptQueue,
+      /// verifying and decrypting a service frame
+      ServiceDecrypt,
+      /// a service frame waiting for a worker to encrypt and sign it
+      ServiceEncryptQueue,
+      /// encrypting and signing a service frame, then handing it to its path
+      ServiceEncrypt,
+      /// a link message waiting in the outbound message handler for its turn to be sent
+      OutboundQueue,
+      /// session packets waiting for a worker to encrypt and send them
+      LinkEncryptQueue,
+      /// encrypting and sending a batch of session packets
+      LinkEncrypt,
+      /// one OutboundMessageHandler::Pump
+      OutboundPump,
+      /// one Router::PumpLL
+      RouterPump,
+
+      NumStages
+    };
+
+    /// the stage's name as used in the `stage` metric label
+    const char*
+    StageName(Stage stage);
+
+#ifdef BELNET_LATENCY_TRACE
+    /// records a duration in microseconds for the stage
+    void
+    Record(Stage stage, uint64_t usec);
+
+    /// a point in time
+    class Stamp
+    {
+     public:
+      Stamp() : m_At{Clock::now()}
+      {}
+
+      /// records the time since this stamp against the stage
+      void
+      Record(Stage stage) const
+      {
+        trace::Record(
+            stage,
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_At).count());
+      }
+
+      /// records the time since this stamp against the stage and restarts the stamp, so that
+      /// consecutive stages can be timed with one stamp
+      void
+      Lap(Stage stage)
+      {
+        const auto now = Clock::now();
+        trace::Record(
+            stage, std::chrono::duration_cast<std::chrono::microseconds>(now - m_At).count());
+        m_At = now;
+      }
+
+     private:
+      using Clock = std::chrono::steady_clock;
+      Clock::time_point m_At;
+    };
+#else
+    class Stamp
+    {
+     public:
+      void
+      Record(Stage) const
+      {}
+
+      void
+      Lap(Stage)
+      {}
+    };
+#endif
+
+    /// times a scope against a stage
+    class ScopedTimer
+    {
+     public:
+      explicit ScopedTimer(Stage stage) : m_Stage{stage}
+      {}
+
+      ~ScopedTimer()
+      {
+        m_Start.Record(m_Stage);
+      }
+
+     private:
+      [[maybe_unused]] const Stage m_Stage;
+      Stamp m_Start;
+    };
+  }  // namespace trace
+}  // namespace llarp
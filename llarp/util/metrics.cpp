@@ -0,0 +1,252 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace llarp
+{
+  namespace metrics
+  {
+    size_t
+    Counter::ThisShard()
+    {
+      static thread_local const size_t shard =
+          std::hash<std::thread::id>{}(std::this_thread::get_id()) % NumShards;
+      return shard;
+    }
+
+    uint64_t
+    Counter::Value() const
+    {
+      uint64_t total = 0;
+      for (const auto& shard : m_Shards)
+        total += shard.value.load(std::memory_order_relaxed);
+      return total;
+    }
+
+    Histogram::Histogram(std::vector<uint64_t> bounds)
+        : m_Bounds{std::move(bounds)}
+        , m_Counts{std::make_unique<std::atomic<uint64_t>[]>(m_Bounds.size() + 1)}
+    {
+      if (not std::is_sorted(m_Bounds.begin(), m_Bounds.end()))
+        throw std::invalid_argument{"histogram bounds must be ascending"};
+    }
+
+    void
+    Histogram::Observe(uint64_t value)
+    {
+      const auto idx =
+          std::lower_bound(m_Bounds.begin(), m_Bounds.end(), value) - m_Bounds.begin();
+      m_Counts[idx].fetch_add(1, std::memory_order_relaxed);
+      m_Sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    Histogram::Snapshot
+    Histogram::Read() const
+    {
+      Snapshot snap;
+      snap.counts.reserve(m_Bounds.size() + 1);
+      for (size_t idx = 0; idx <= m_Bounds.size(); ++idx)
+      {
+        snap.counts.push_back(m_Counts[idx].load(std::memory_order_relaxed));
+        snap.count += snap.counts.back();
+      }
+      snap.sum = m_Sum.load(std::memory_order_relaxed);
+      return snap;
+    }
+
+    std::vector<uint64_t>
+    Histogram::ExponentialBounds(uint64_t max)
+    {
+      std::vector<uint64_t> bounds;
+      for (uint64_t bound = 1; bound < max; bound *= 2)
+        bounds.push_back(bound);
+      bounds.push_back(max);
+      return bounds;
+    }
+
+    Registry&
+    Registry::Global()
+    {
+      static Registry registry;
+      return registry;
+    }
+
+    Registry::Series&
+    Registry::GetSeries(
+        const std::string& name, const std::string& help, Type type, const Labels& labels)
+    {
+      auto& family = m_Families[name];
+      if (family.series.empty())
+      {
+        family.type = type;
+        family.help = help;
+      }
+      else if (family.type != type)
+        throw std::invalid_argument{"metric " + name + " registered with another type"};
+      for (auto& series : family.series)
+      {
+        if (series.labels == labels)
+          return series;
+      }
+      auto& series = family.series.emplace_back();
+      series.labels = labels;
+      return series;
+    }
+
+    Counter&
+    Registry::GetCounter(const std::string& name, const std::string& help, const Labels& labels)
+    {
+      std::unique_lock lock{m_Access};
+      auto& series = GetSeries(name, help, Type::Counter, labels);
+      if (not series.counter)
+        series.counter = std::make_unique<Counter>();
+      return *series.counter;
+    }
+
+    Gauge&
+    Registry::GetGauge(const std::string& name, const std::string& help, const Labels& labels)
+    {
+      std::unique_lock lock{m_Access};
+      auto& series = GetSeries(name, help, Type::Gauge, labels);
+      if (not series.gauge)
+        series.gauge = std::make_unique<Gauge>();
+      return *series.gauge;
+    }
+
+    Histogram&
+    Registry::GetHistogram(
+        const std::string& name,
+        const std::string& help,
+        std::vector<uint64_t> bounds,
+        double scale,
+        const Labels& labels)
+    {
+      std::unique_lock lock{m_Access};
+      auto& series = GetSeries(name, help, Type::Histogram, labels);
+      if (not series.histogram)
+      {
+        m_Families[name].scale = scale;
+        series.histogram = std::make_unique<Histogram>(std::move(bounds));
+      }
+      return *series.histogram;
+    }
+
+    namespace
+    {
+      /// {a="b",c="d"} with extra appended as the last label, or nothing if there are no labels
+      std::string
+      FormatLabels(const Labels& labels, const std::string& extra = "")
+      {
+        if (labels.empty() and extra.empty())
+          return "";
+        std::string out = "{";
+        for (const auto& [key, value] : labels)
+        {
+          out += key + "=\"" + value + "\",";
+        }
+        if (extra.empty())
+          out.pop_back();
+        else
+          out += extra;
+        return out + "}";
+      }
+    }  // namespace
+
+    const char*
+    Registry::TypeName(Type type)
+    {
+      switch (type)
+      {
+        case Type::Counter:
+          return "counter";
+        case Type::Gauge:
+          return "gauge";
+        case Type::Histogram:
+          return "histogram";
+      }
+      return "untyped";
+    }
+
+    std::string
+    Registry::PrometheusText() const
+    {
+      std::unique_lock lock{m_Access};
+      std::ostringstream out;
+      for (const auto& [name, family] : m_Families)
+      {
+        out << "# HELP " << name << " " << family.help << "\n";
+        out << "# TYPE " << name << " " << TypeName(family.type) << "\n";
+        for (const auto& series : family.series)
+        {
+          if (series.counter)
+            out << name << FormatLabels(series.labels) << " " << series.counter->Value() << "\n";
+          else if (series.gauge)
+            out << name << FormatLabels(series.labels) << " " << series.gauge->Value() << "\n";
+          else if (series.histogram)
+          {
+            const auto snap = series.histogram->Read();
+            const auto& bounds = series.histogram->Bounds();
+            uint64_t cumulative = 0;
+            for (size_t idx = 0; idx < snap.counts.size(); ++idx)
+            {
+              cumulative += snap.counts[idx];
+              std::ostringstream le;
+              if (idx < bounds.size())
+                le << "le=\"" << bounds[idx] * family.scale << "\"";
+              else
+                le << "le=\"+Inf\"";
+              out << name << "_bucket" << FormatLabels(series.labels, le.str()) << " "
+                  << cumulative << "\n";
+            }
+            out << name << "_sum" << FormatLabels(series.labels) << " "
+                << snap.sum * family.scale << "\n";
+            out << name << "_count" << FormatLabels(series.labels) << " " << snap.count << "\n";
+          }
+        }
+      }
+      return out.str();
+    }
+
+    util::StatusObject
+    Registry::ExtractStatus() const
+    {
+      std::unique_lock lock{m_Access};
+      auto obj = util::StatusObject::object();
+      for (const auto& [name, family] : m_Families)
+      {
+        auto values = util::StatusObject::array();
+        for (const auto& series : family.series)
+        {
+          auto labels = util::StatusObject::object();
+          for (const auto& [key, value] : series.labels)
+            labels[key] = value;
+          util::StatusObject entry{{"labels", labels}};
+          if (series.counter)
+            entry["value"] = series.counter->Value();
+          else if (series.gauge)
+            entry["value"] = series.gauge->Value();
+          else if (series.histogram)
+          {
+            const auto snap = series.histogram->Read();
+            auto bounds = util::StatusObject::array();
+            for (auto bound : series.histogram->Bounds())
+              bounds.push_back(bound * family.scale);
+            entry["bounds"] = bounds;
+            entry["counts"] = snap.counts;
+            entry["sum"] = snap.sum * family.scale;
+            entry["count"] = snap.count;
+          }
+          values.push_back(entry);
+        }
+        obj[name] = util::StatusObject{
+            {"type", TypeName(family.type)}, {"series", values}};
+      }
+      return obj;
+    }
+
+  }  // namespace metrics
+}  // namespace llarp
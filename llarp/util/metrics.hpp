@@ -0,0 +1,185 @@
+#pragma once
+
+#include "status.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llarp
+{
+  namespace metrics
+  {
+    /// label name/value pairs that tell apart the series of one metric
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /// a monotonic counter that any thread can bump without locking.  each thread adds to its own
+    /// cache line so hot counters bumped from the logic thread and the workers don't contend; the
+    /// shards are only summed when the counter is read.
+    class Counter
+    {
+     public:
+      static constexpr size_t NumShards = 16;
+
+      void
+      Inc(uint64_t n = 1)
+      {
+        m_Shards[ThisShard()].value.fetch_add(n, std::memory_order_relaxed);
+      }
+
+      uint64_t
+      Value() const;
+
+      /// the shard the calling thread adds to
+      static size_t
+      ThisShard();
+
+     private:
+      struct alignas(64) Shard
+      {
+        std::atomic<uint64_t> value{0};
+      };
+      std::array<Shard, NumShards> m_Shards;
+    };
+
+    /// a value that goes up and down
+    class Gauge
+    {
+     public:
+      void
+      Set(int64_t value)
+      {
+        m_Value.store(value, std::memory_order_relaxed);
+      }
+
+      void
+      Add(int64_t n)
+      {
+        m_Value.fetch_add(n, std::memory_order_relaxed);
+      }
+
+      int64_t
+      Value() const
+      {
+        return m_Value.load(std::memory_order_relaxed);
+      }
+
+     private:
+      std::atomic<int64_t> m_Value{0};
+    };
+
+    /// a histogram with fixed bucket bounds, e.g. of latencies in microseconds
+    class Histogram
+    {
+     public:
+      /// bounds are the inclusive upper bounds of each bucket, ascending; values above the last
+      /// bound go into an implicit +Inf bucket
+      explicit Histogram(std::vector<uint64_t> bounds);
+
+      void
+      Observe(uint64_t value);
+
+      struct Snapshot
+      {
+        /// per bucket counts, not cumulative, with the +Inf bucket last
+        std::vector<uint64_t> counts;
+        uint64_t sum = 0;
+        uint64_t count = 0;
+      };
+
+      Snapshot
+      Read() const;
+
+      const std::vector<uint64_t>&
+      Bounds() const
+      {
+        return m_Bounds;
+      }
+
+      /// exponential bounds from 1 to max, doubling each bucket
+      static std::vector<uint64_t>
+      ExponentialBounds(uint64_t max);
+
+     private:
+      const std::vector<uint64_t> m_Bounds;
+      std::unique_ptr<std::atomic<uint64_t>[]> m_Counts;
+      std::atomic<uint64_t> m_Sum{0};
+    };
+
+    /// registry of named metrics.  components look their metrics up once (registration takes a
+    /// lock) and keep the returned reference; updates after that are lock free.  metrics live as
+    /// long as the registry, so asking again for the same name and labels returns the same
+    /// metric, e.g. for every session of a link layer.
+    class Registry
+    {
+     public:
+      /// the process wide registry
+      static Registry&
+      Global();
+
+      Counter&
+      GetCounter(const std::string& name, const std::string& help, const Labels& labels = {});
+
+      Gauge&
+      GetGauge(const std::string& name, const std::string& help, const Labels& labels = {});
+
+      /// scale converts observed values into the exported unit, e.g. 1e-6 for microseconds
+      /// observed into a histogram exported in seconds
+      Histogram&
+      GetHistogram(
+          const std::string& name,
+          const std::string& help,
+          std::vector<uint64_t> bounds,
+          double scale = 1.0,
+          const Labels& labels = {});
+
+      /// all metrics in the prometheus text exposition format
+      std::string
+      PrometheusText() const;
+
+      /// all metrics as json, for rpc
+      util::StatusObject
+      ExtractStatus() const;
+
+     private:
+      enum class Type
+      {
+        Counter,
+        Gauge,
+        Histogram
+      };
+
+      struct Series
+      {
+        Labels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+      };
+
+      struct Family
+      {
+        Type type;
+        std::string help;
+        double scale = 1.0;
+        std::vector<Series> series;
+      };
+
+      static const char*
+      TypeName(Type type);
+
+      Series&
+      GetSeries(const std::string& name, const std::string& help, Type type, const Labels& labels);
+
+      mutable std::mutex m_Access;
+      std::map<std::string, Family> m_Families;
+    };
+
+  }  // namespace metrics
+}  // namespace llarp
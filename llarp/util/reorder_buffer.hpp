@@ -0,0 +1,135 @@
+#pragma once
+
+#include "time.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace llarp
+{
+  namespace util
+  {
+    /// puts messages carrying a sequence number (a `seqno` member) back in order.
+    ///
+    /// while messages arrive in order they are passed through right away.  once we see a message
+    /// that is older than one we already delivered we know the sender is striping over several
+    /// paths, and from then on messages that arrive ahead of a gap are held until the gap fills,
+    /// the hold time runs out or too many are held, whichever happens first.  a single path that
+    /// merely drops packets never pays the hold time.
+    template <typename Msg_t>
+    struct ReorderBuffer
+    {
+      using Time_t = std::chrono::milliseconds;
+
+      explicit ReorderBuffer(Time_t maxHold = 100ms, size_t maxHeld = 64)
+          : m_MaxHold{maxHold}, m_MaxHeld{maxHeld}
+      {}
+
+      /// put a message into the buffer, calling visit(Msg_t&&) for each message that is ready
+      template <typename Visit_t>
+      void
+      Put(Msg_t msg, Time_t now, Visit_t&& visit)
+      {
+        const uint64_t seqno = msg.seqno;
+        if (not m_Next)
+          m_Next = seqno;
+        if (seqno < *m_Next)
+        {
+          // late or duplicate, the gap it belonged to was already skipped
+          m_Reordering = true;
+          visit(std::move(msg));
+          return;
+        }
+        if (seqno == *m_Next)
+        {
+          visit(std::move(msg));
+          m_Next = seqno + 1;
+          Drain(visit);
+          return;
+        }
+        if (not m_Reordering)
+        {
+          // gap on what looks like a single path, don't wait for it
+          visit(std::move(msg));
+          m_Next = seqno + 1;
+          return;
+        }
+        if (m_Held.emplace(seqno, std::make_pair(std::move(msg), now)).second)
+          m_Arrivals.emplace_back(now, seqno);
+        if (m_Held.size() > m_MaxHeld)
+          SkipGap(visit);
+      }
+
+      /// release messages that have been held longer than the max hold time
+      template <typename Visit_t>
+      void
+      Expire(Time_t now, Visit_t&& visit)
+      {
+        // arrivals are in time order; entries for messages already delivered are dropped as we
+        // reach them so this stays cheap when nothing is due
+        while (not m_Arrivals.empty())
+        {
+          const auto [at, seqno] = m_Arrivals.front();
+          if (m_Held.count(seqno) == 0)
+          {
+            m_Arrivals.pop_front();
+            continue;
+          }
+          if (now - at < m_MaxHold)
+            return;
+          SkipGap(visit);
+        }
+      }
+
+      /// number of messages waiting on a gap
+      size_t
+      Held() const
+      {
+        return m_Held.size();
+      }
+
+      /// true if we have seen out of order delivery on this stream
+      bool
+      Reordering() const
+      {
+        return m_Reordering;
+      }
+
+     private:
+      template <typename Visit_t>
+      void
+      Drain(Visit_t& visit)
+      {
+        auto itr = m_Held.begin();
+        while (itr != m_Held.end() and itr->first == *m_Next)
+        {
+          visit(std::move(itr->second.first));
+          m_Next = itr->first + 1;
+          itr = m_Held.erase(itr);
+        }
+      }
+
+      /// give up on the current gap and deliver from the next held message on
+      template <typename Visit_t>
+      void
+      SkipGap(Visit_t& visit)
+      {
+        if (m_Held.empty())
+          return;
+        m_Next = m_Held.begin()->first;
+        Drain(visit);
+      }
+
+      const Time_t m_MaxHold;
+      const size_t m_MaxHeld;
+      std::optional<uint64_t> m_Next;
+      bool m_Reordering = false;
+      std::map<uint64_t, std::pair<Msg_t, Time_t>> m_Held;
+      /// when each held message arrived, oldest first
+      std::deque<std::pair<Time_t, uint64_t>> m_Arrivals;
+    };
+  }  // namespace util
+}  // namespace llarp
@@ -1,4 +1,5 @@
 #include "time.hpp"
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include "types.hpp"
@@ -19,8 +20,20 @@ namespace llarp
     const static auto started_at_system = Clock_t::now();
 
     const static auto started_at_steady = std::chrono::steady_clock::now();
+
+#ifdef BELNET_HIVE
+    std::atomic<Duration_t (*)()> time_source{nullptr};
+#endif
   }  // namespace
 
+#ifdef BELNET_HIVE
+  void
+  set_time_source(Duration_t (*source)())
+  {
+    time_source.store(source);
+  }
+#endif
+
   uint64_t
   ToMS(Duration_t ms)
   {
@@ -38,6 +51,10 @@ namespace llarp
   Duration_t
   time_now_ms()
   {
+#ifdef BELNET_HIVE
+    if (auto source = time_source.load(std::memory_order_relaxed))
+      return source();
+#endif
     auto t = uptime();
 #ifdef TESTNET_SPEED
     t /= uint64_t{TESTNET_SPEED};
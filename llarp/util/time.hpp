@@ -14,6 +14,13 @@ namespace llarp
   Duration_t
   time_now_ms();
 
+#ifdef BELNET_HIVE
+  /// make time_now_ms read source instead of the system clock, for simulated networks in the
+  /// router hive; nullptr goes back to the system clock
+  void
+  set_time_source(Duration_t (*source)());
+#endif
+
   /// get the uptime of the process
   Duration_t
   uptime();
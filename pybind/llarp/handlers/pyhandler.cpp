@@ -6,11 +6,38 @@ namespace llarp
     void
     PyHandler_Init(py::module& mod)
     {
+      py::enum_<service::ProtocolType>(mod, "ProtocolType")
+          .value("Control", service::ProtocolType::Control)
+          .value("TrafficV4", service::ProtocolType::TrafficV4)
+          .value("TrafficV6", service::ProtocolType::TrafficV6)
+          .value("Exit", service::ProtocolType::Exit)
+          .value("Auth", service::ProtocolType::Auth)
+          .value("QUIC", service::ProtocolType::QUIC);
+
       py::class_<PythonEndpoint, PythonEndpoint_ptr>(mod, "Endpoint")
           .def(py::init<std::string, Context_ptr>())
           .def("SendTo", &PythonEndpoint::SendPacket)
+          .def(
+              "SendBytes",
+              [](PythonEndpoint& ep,
+                 service::Address remote,
+                 py::bytes data,
+                 service::ProtocolType proto) {
+                const std::string str = data;
+                ep.SendPacket(remote, std::vector<byte_t>(str.begin(), str.end()), proto);
+              })
           .def("OurAddress", &PythonEndpoint::GetOurAddress)
-          .def_readwrite("GotPacket", &PythonEndpoint::handlePacket);
+          .def(
+              "QuicListen",
+              &PythonEndpoint::QuicListen,
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "QuicConnect",
+              &PythonEndpoint::QuicConnect,
+              py::call_guard<py::gil_scoped_release>())
+          .def_readwrite("GotPacket", &PythonEndpoint::handlePacket)
+          .def_readwrite("GotBytes", &PythonEndpoint::handleBytes)
+          .def_readwrite("Echo", &PythonEndpoint::echo);
     }
 
   }  // namespace handlers
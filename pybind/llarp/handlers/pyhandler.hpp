@@ -4,6 +4,9 @@
 #include <llarp/service/context.hpp>
 #include <llarp/service/endpoint.hpp>
 #include <llarp/router/abstractrouter.hpp>
+#include <llarp/quic/tunnel.hpp>
+
+#include <future>
 
 namespace llarp
 {
@@ -28,18 +31,29 @@ namespace llarp
           service::ProtocolType proto,
           uint64_t) override
       {
-        if (handlePacket)
+        // straight back without a trip through python, for load tests
+        if (echo)
+          return SendToOrQueue(tag, pktbuf, proto);
+        if (not(handlePacket or handleBytes))
+          return true;
+        service::Address addr{};
+        if (auto maybe = GetEndpointWithConvoTag(tag))
         {
-          service::Address addr{};
-          if (auto maybe = GetEndpointWithConvoTag(tag))
-          {
-            if (auto ptr = std::get_if<service::Address>(&*maybe))
-              addr = *ptr;
-            else
-              return false;
-          }
+          if (auto ptr = std::get_if<service::Address>(&*maybe))
+            addr = *ptr;
           else
             return false;
+        }
+        else
+          return false;
+        if (handleBytes)
+        {
+          py::gil_scoped_acquire gil;
+          handleBytes(
+              addr, py::bytes{reinterpret_cast<const char*>(pktbuf.base), pktbuf.sz}, proto);
+        }
+        if (handlePacket)
+        {
           std::vector<byte_t> pkt;
           pkt.resize(pktbuf.sz);
           std::copy_n(pktbuf.base, pktbuf.sz, pkt.data());
@@ -89,6 +103,13 @@ namespace llarp
 
       PacketHandler_t handlePacket;
 
+      /// like handlePacket but with the packet as python bytes, which is much cheaper to hand
+      /// over than a list
+      std::function<void(service::Address, py::bytes, service::ProtocolType)> handleBytes;
+
+      /// send every packet we get back where it came from
+      bool echo = false;
+
       void
       SendPacket(service::Address remote, std::vector<byte_t> pkt, service::ProtocolType proto)
       {
@@ -105,6 +126,52 @@ namespace llarp
       {
         return m_Identity.pub.Addr().ToString();
       }
+
+      /// accept quic tunnels to port and forward them to the tcp port on localhost; returns the
+      /// listener id
+      int
+      QuicListen(uint16_t port)
+      {
+        return CallWithTunnels([port](quic::TunnelManager& quic) {
+          return quic.listen(SockAddr{127, 0, 0, 1, huint16_t{port}});
+        });
+      }
+
+      /// open a quic tunnel to port on remote, like `belnet-quic connect`; returns the localhost
+      /// tcp port that tunnels to it
+      uint16_t
+      QuicConnect(std::string remote, uint16_t port)
+      {
+        return CallWithTunnels([remote = std::move(remote), port](quic::TunnelManager& quic) {
+          return quic.open(remote, port).first.getPort();
+        });
+      }
+
+     private:
+      /// run f with our tunnel manager on the event loop and wait for its result
+      template <typename Func>
+      auto
+      CallWithTunnels(Func f)
+      {
+        // quic needs the uv loop, which routers on a virtual network don't have
+        if (not Loop()->MaybeGetUVWLoop())
+          throw std::runtime_error{"quic tunnels need a real event loop"};
+        std::promise<decltype(f(std::declval<quic::TunnelManager&>()))> result;
+        Loop()->call([&result, &f, this]() {
+          try
+          {
+            auto* quic = GetQUICTunnel();
+            if (not quic)
+              throw std::runtime_error{"endpoint has no quic tunnel manager"};
+            result.set_value(f(*quic));
+          }
+          catch (...)
+          {
+            result.set_exception(std::current_exception());
+          }
+        });
+        return result.get_future().get();
+      }
     };
 
     using PythonEndpoint_ptr = std::shared_ptr<PythonEndpoint>;
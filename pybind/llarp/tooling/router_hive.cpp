@@ -17,6 +17,29 @@ namespace tooling
 
     py::class_<RouterHive, RouterHive_ptr>(mod, "RouterHive")
         .def(py::init<>())
+        .def("UseVirtualNetwork", &RouterHive::UseVirtualNetwork)
+        .def(
+            "SetDefaultLink",
+            [](RouterHive& hive, int64_t latencyMs, double loss, uint64_t bandwidth) {
+              if (not hive.virtualNetwork)
+                throw std::logic_error{"hive is not on a virtual network"};
+              hive.virtualNetwork->SetDefaultLink(
+                  LinkParams{std::chrono::milliseconds{latencyMs}, loss, bandwidth});
+            })
+        .def(
+            "RunFor",
+            [](RouterHive& hive, int64_t ms) {
+              py::gil_scoped_release release;
+              hive.RunFor(std::chrono::milliseconds{ms});
+            })
+        .def("Now", [](const RouterHive& hive) { return hive.Now().count(); })
+        .def(
+            "RouterCPUTime",
+            [](RouterHive& hive, const llarp::RouterID& id) -> std::optional<double> {
+              if (auto cpu = hive.RouterCPUTime(id))
+                return std::chrono::duration<double>{*cpu}.count();
+              return std::nullopt;
+            })
         .def("AddRelay", &RouterHive::AddRelay)
         .def("AddClient", &RouterHive::AddClient)
         .def("StartRelays", &RouterHive::StartRelays)
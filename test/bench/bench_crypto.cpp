@@ -0,0 +1,91 @@
+#include <crypto/crypto.hpp>
+#include <crypto/types.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+TEST_CASE("xchacha20", "[bench][crypto]")
+{
+  auto crypto = CryptoManager::instance();
+  SharedSecret key;
+  key.Randomize();
+  TunnelNonce nonce;
+  nonce.Randomize();
+
+  for (const size_t size : {64, 512, 1500})
+  {
+    std::vector<byte_t> data(size);
+    crypto->randbytes(data.data(), data.size());
+    const llarp_buffer_t buf{data};
+    BENCHMARK("xchacha20 " + std::to_string(size) + " bytes")
+    {
+      return crypto->xchacha20(buf, key, nonce);
+    };
+  }
+}
+
+TEST_CASE("Path dh", "[bench][crypto]")
+{
+  auto crypto = CryptoManager::instance();
+  SecretKey client, relay;
+  crypto->encryption_keygen(client);
+  crypto->encryption_keygen(relay);
+  TunnelNonce nonce;
+  nonce.Randomize();
+  SharedSecret shared;
+
+  BENCHMARK("dh_client")
+  {
+    return crypto->dh_client(shared, relay.toPublic(), client, nonce);
+  };
+
+  BENCHMARK("dh_server")
+  {
+    return crypto->dh_server(shared, client.toPublic(), relay, nonce);
+  };
+}
+
+TEST_CASE("Sign and verify", "[bench][crypto]")
+{
+  auto crypto = CryptoManager::instance();
+  SecretKey secret;
+  crypto->identity_keygen(secret);
+  const PubKey pk = secret.toPublic();
+  AlignedBuffer<256> data;
+  data.Randomize();
+  const llarp_buffer_t buf{data.data(), data.size()};
+  Signature sig;
+  REQUIRE(crypto->sign(sig, secret, buf));
+
+  BENCHMARK("sign")
+  {
+    return crypto->sign(sig, secret, buf);
+  };
+
+  BENCHMARK("verify")
+  {
+    return crypto->verify(pk, buf, sig);
+  };
+}
+
+TEST_CASE("Post quantum key exchange", "[bench][crypto]")
+{
+  auto crypto = CryptoManager::instance();
+  PQKeyPair keys;
+  crypto->pqe_keygen(keys);
+  const PQPubKey pk{pq_keypair_to_public(keys)};
+  PQCipherBlock block;
+  SharedSecret shared;
+  REQUIRE(crypto->pqe_encrypt(block, shared, pk));
+
+  BENCHMARK("pqe_encrypt")
+  {
+    return crypto->pqe_encrypt(block, shared, pk);
+  };
+
+  BENCHMARK("pqe_decrypt")
+  {
+    return crypto->pqe_decrypt(block, shared, pq_keypair_to_secret(keys));
+  };
+}
@@ -0,0 +1,95 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+#include <crypto/crypto_libsodium.hpp>
+#include <util/logging.hpp>
+#include <util/service_manager.hpp>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+  /// writes one json document with every benchmark's timings, in nanoseconds, for tracking
+  /// regressions between builds.  use with `belnet-bench -r json -o bench.json`.
+  struct JsonReporter : Catch::StreamingReporterBase<JsonReporter>
+  {
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string
+    getDescription()
+    {
+      return "Reports benchmark timings as a json document";
+    }
+
+    void
+    assertionStarting(const Catch::AssertionInfo&) override
+    {}
+
+    bool
+    assertionEnded(const Catch::AssertionStats& stats) override
+    {
+      if (not stats.assertionResult.isOk())
+        m_Failed += 1;
+      return true;
+    }
+
+    void
+    benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+    {
+      const auto estimate = [](const auto& est) {
+        return nlohmann::json{
+            {"point", est.point.count()},
+            {"lower", est.lower_bound.count()},
+            {"upper", est.upper_bound.count()},
+            {"confidence", est.confidence_interval}};
+      };
+      m_Results.push_back(nlohmann::json{
+          {"name", stats.info.name},
+          {"test_case", currentTestCaseInfo->name},
+          {"samples", stats.info.samples},
+          {"iterations", stats.info.iterations},
+          {"mean_ns", estimate(stats.mean)},
+          {"stddev_ns", estimate(stats.standardDeviation)},
+          {"outlier_variance", stats.outlierVariance}});
+    }
+
+    void
+    benchmarkFailed(const std::string& error) override
+    {
+      m_Failed += 1;
+      m_Errors.push_back(error);
+    }
+
+    void
+    testRunEnded(const Catch::TestRunStats& stats) override
+    {
+      nlohmann::json doc{
+          {"name", stats.runInfo.name},
+          {"benchmarks", std::move(m_Results)},
+          {"failures", m_Failed}};
+      if (not m_Errors.empty())
+        doc["errors"] = std::move(m_Errors);
+      stream << doc.dump(2) << std::endl;
+      StreamingReporterBase::testRunEnded(stats);
+    }
+
+   private:
+    nlohmann::json m_Results = nlohmann::json::array();
+    std::vector<std::string> m_Errors;
+    uint64_t m_Failed = 0;
+  };
+}  // namespace
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
+
+int
+main(int argc, char* argv[])
+{
+  llarp::sys::service_manager->disable();
+  llarp::log::reset_level(llarp::log::Level::off);
+
+  llarp::sodium::CryptoLibSodium crypto;
+  llarp::CryptoManager manager{&crypto};
+
+  return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,150 @@
+#include <constants/link_layer.hpp>
+#include <crypto/crypto.hpp>
+#include <messages/relay.hpp>
+#include <router_contact.hpp>
+#include <service/protocol.hpp>
+#include <util/bencode.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+namespace
+{
+  /// bencode msg into buf, returns the encoded size
+  template <typename Msg_t, size_t N>
+  size_t
+  Encode(const Msg_t& msg, std::array<byte_t, N>& buf)
+  {
+    llarp_buffer_t out{buf};
+    REQUIRE(msg.BEncode(&out));
+    return out.cur - out.base;
+  }
+}  // namespace
+
+TEST_CASE("RouterContact bencode", "[bench][bencode]")
+{
+  auto crypto = CryptoManager::instance();
+  SecretKey sign, encr;
+  crypto->identity_keygen(sign);
+  crypto->encryption_keygen(encr);
+  RouterContact rc;
+  rc.enckey = encr.toPublic();
+  rc.pubkey = sign.toPublic();
+  REQUIRE(rc.Sign(sign));
+
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp, out;
+  const auto size = Encode(rc, tmp);
+
+  BENCHMARK("RouterContact encode")
+  {
+    llarp_buffer_t buf{out};
+    return rc.BEncode(&buf);
+  };
+
+  BENCHMARK("RouterContact decode")
+  {
+    RouterContact decoded;
+    llarp_buffer_t buf{tmp.data(), size};
+    return decoded.BDecode(&buf);
+  };
+}
+
+TEST_CASE("ProtocolFrame bencode", "[bench][bencode]")
+{
+  service::ProtocolFrame frame;
+  frame.C.Randomize();
+  frame.D = service::ProtocolFrame::Encrypted_t{1024};
+  frame.D.Randomize();
+  frame.N.Randomize();
+  frame.Z.Randomize();
+  frame.F.Randomize();
+  frame.T.Randomize();
+
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp, out;
+  const auto size = Encode(frame, tmp);
+
+  BENCHMARK("ProtocolFrame encode")
+  {
+    llarp_buffer_t buf{out};
+    return frame.BEncode(&buf);
+  };
+
+  BENCHMARK("ProtocolFrame decode")
+  {
+    service::ProtocolFrame decoded;
+    llarp_buffer_t buf{tmp.data(), size};
+    return decoded.BDecode(&buf);
+  };
+}
+
+TEST_CASE("RelayUpstreamMessage bencode", "[bench][bencode]")
+{
+  RelayUpstreamMessage msg;
+  msg.pathid.Randomize();
+  msg.X = Encrypted<MaxRelayPayloadSize>{1024};
+  msg.X.Randomize();
+  msg.Y.Randomize();
+
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp, out;
+  const auto size = Encode(msg, tmp);
+
+  BENCHMARK("RelayUpstreamMessage encode")
+  {
+    llarp_buffer_t buf{out};
+    return msg.BEncode(&buf);
+  };
+
+  BENCHMARK("RelayUpstreamMessage decode")
+  {
+    RelayUpstreamMessage decoded;
+    llarp_buffer_t buf{tmp.data(), size};
+    // the message type key is read by the link message parser, not the message
+    return bencode_read_dict(
+        [&decoded](llarp_buffer_t* buffer, llarp_buffer_t* key) {
+          if (key == nullptr)
+            return true;
+          if (key->sz == 1 and key->startswith("a"))
+            return bencode_discard(buffer);
+          return decoded.DecodeKey(*key, buffer);
+        },
+        &buf);
+  };
+}
+
+TEST_CASE("RelayUpstreamMessage compact", "[bench][relay]")
+{
+  RelayUpstreamMessage msg;
+  msg.pathid.Randomize();
+  msg.X = Encrypted<MaxRelayPayloadSize>{1024};
+  msg.X.Randomize();
+  msg.Y.Randomize();
+
+  std::array<byte_t, MAX_LINK_MSG_SIZE> tmp, out;
+  llarp_buffer_t encoded{tmp};
+  REQUIRE(msg.EncodeCompact(&encoded));
+  encoded.sz = encoded.cur - encoded.base;
+
+  RelayCellView cell;
+  REQUIRE(cell.Decode(encoded));
+  REQUIRE(cell.type == 'u');
+  REQUIRE(cell.pathid == msg.pathid);
+  REQUIRE(cell.Y == msg.Y);
+  REQUIRE(std::equal(
+      cell.payload, cell.payload + cell.payloadSize, msg.X.data(), msg.X.data() + msg.X.size()));
+
+  BENCHMARK("RelayUpstreamMessage compact encode")
+  {
+    llarp_buffer_t buf{out};
+    return msg.EncodeCompact(&buf);
+  };
+
+  BENCHMARK("RelayUpstreamMessage compact decode")
+  {
+    RelayCellView decoded;
+    return decoded.Decode(encoded);
+  };
+}
@@ -0,0 +1,83 @@
+#include <net/ip_packet.hpp>
+#include <router_id.hpp>
+#include <util/decaying_hashset.hpp>
+#include <util/thread/queue.hpp>
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+
+TEST_CASE("IPPacket checksum update", "[bench][net]")
+{
+  std::vector<byte_t> body(512, 0x42);
+  auto pkt = net::IPPacket::make_udp(
+      net::ipv4addr_t::from_host(0x0a000001),
+      net::port_t::from_host(uint16_t{1234}),
+      net::ipv4addr_t::from_host(0x0a000002),
+      net::port_t::from_host(uint16_t{53}),
+      std::move(body));
+  const auto src = net::ipv4addr_t::from_host(0xac100001);
+  const auto dst = net::ipv4addr_t::from_host(0xac100002);
+
+  BENCHMARK("UpdateIPv4Address udp")
+  {
+    pkt.UpdateIPv4Address(src, dst);
+  };
+
+  BENCHMARK("ZeroAddresses udp")
+  {
+    pkt.ZeroAddresses();
+  };
+}
+
+TEST_CASE("DecayingHashSet", "[bench][util]")
+{
+  static constexpr size_t NumKeys = 1024;
+  std::vector<RouterID> keys(NumKeys);
+  for (auto& key : keys)
+    key.Randomize();
+
+  BENCHMARK("DecayingHashSet insert 1024")
+  {
+    util::DecayingHashSet<RouterID> set{5s};
+    for (size_t idx = 0; idx < keys.size(); ++idx)
+      set.Insert(keys[idx], llarp_time_t(idx));
+    return set.Contains(keys.back());
+  };
+
+  BENCHMARK_ADVANCED("DecayingHashSet decay half of 1024")(Catch::Benchmark::Chronometer meter)
+  {
+    std::vector<util::DecayingHashSet<RouterID>> sets(meter.runs());
+    for (auto& set : sets)
+    {
+      set.DecayInterval(5s);
+      for (size_t idx = 0; idx < keys.size(); ++idx)
+        set.Insert(keys[idx], llarp_time_t(idx));
+    }
+    const auto now = 5s + llarp_time_t(NumKeys / 2);
+    meter.measure([&sets, now](int run) { sets[run].Decay(now); });
+  };
+}
+
+TEST_CASE("thread::Queue", "[bench][util]")
+{
+  thread::Queue<int> queue{1024};
+
+  BENCHMARK("Queue push pop")
+  {
+    queue.pushBack(1);
+    return queue.popFront();
+  };
+
+  BENCHMARK("Queue push pop 64")
+  {
+    int sum = 0;
+    for (int i = 0; i < 64; ++i)
+      queue.pushBack(i);
+    for (int i = 0; i < 64; ++i)
+      sum += queue.popFront();
+    return sum;
+  };
+}
@@ -48,6 +48,35 @@ TEST_CASE("PQ crypto")
   REQUIRE(otherShared == shared);
 }
 
+TEST_CASE("xchacha20-poly1305 in place")
+{
+  llarp::sodium::CryptoLibSodium crypto;
+  SharedSecret key;
+  key.Randomize();
+  AlignedBuffer<NONCESIZE> nonce;
+  nonce.Randomize();
+  AlignedBuffer<128> plain;
+  plain.Randomize();
+  auto data = plain;
+  AlignedBuffer<AEADTAGSIZE> tag;
+  const llarp_buffer_t buf(data.data(), data.size());
+
+  REQUIRE(crypto.xchacha20_poly1305_seal(buf, key, nonce.data(), tag.data()));
+  REQUIRE(data != plain);
+
+  SECTION("Round trip")
+  {
+    REQUIRE(crypto.xchacha20_poly1305_open(buf, key, nonce.data(), tag.data()));
+    REQUIRE(data == plain);
+  }
+
+  SECTION("Mangled body")
+  {
+    data[0] ^= 1;
+    REQUIRE_FALSE(crypto.xchacha20_poly1305_open(buf, key, nonce.data(), tag.data()));
+  }
+}
+
 #ifdef HAVE_CRYPT
 
 TEST_CASE("passwd hash valid")
@@ -0,0 +1,218 @@
+#include <dht/introset_store.hpp>
+
+#include <constants/path.hpp>
+#include <llarp_test.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  service::EncryptedIntroSet
+  makeIntroSet(llarp_time_t signedAt)
+  {
+    service::EncryptedIntroSet introset;
+    introset.derivedSigningKey.Randomize();
+    introset.nounce.Randomize();
+    introset.introsetPayload.resize(64);
+    introset.signedAt = signedAt;
+    return introset;
+  }
+
+  dht::Key_t
+  locationOf(const service::EncryptedIntroSet& introset)
+  {
+    return dht::Key_t{introset.derivedSigningKey.as_array()};
+  }
+
+  dht::Key_t
+  randomKey()
+  {
+    dht::Key_t key;
+    key.Randomize();
+    return key;
+  }
+}  // namespace
+
+TEST_CASE_METHOD(test::LlarpTest<>, "IntroSetStore keeps the newest copy", "[dht][IntroSetStore]")
+{
+  dht::IntroSetStore store;
+  auto introset = makeIntroSet(1s);
+  const auto location = locationOf(introset);
+  CHECK(store.Put(introset));
+  CHECK_FALSE(store.Put(introset));
+  REQUIRE(store.Get(location));
+  CHECK(store.Get(location)->signedAt == 1s);
+
+  auto older = introset;
+  older.signedAt = 0s;
+  CHECK_FALSE(store.Put(older));
+
+  auto newer = introset;
+  newer.signedAt = 2s;
+  CHECK(store.Put(newer));
+  CHECK(store.Get(location)->signedAt == 2s);
+  CHECK(store.size() == 1);
+  CHECK_FALSE(store.Get(randomKey()));
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>, "IntroSetStore expires intro sets on time", "[dht][IntroSetStore]")
+{
+  dht::IntroSetStore store;
+  // expiring part way into an expiry bucket
+  const auto signedAt = 1003ms;
+  const auto expires = signedAt + path::default_lifetime;
+  auto introset = makeIntroSet(signedAt);
+  const auto location = locationOf(introset);
+  REQUIRE(store.Put(introset));
+
+  store.Expire(expires - 1ms);
+  CHECK(store.Get(location));
+
+  // not served past its expiry just because the rest of its bucket isn't due yet
+  store.Expire(expires);
+  CHECK_FALSE(store.Get(location));
+  CHECK(store.size() == 0);
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>,
+    "IntroSetStore keeps a newer copy past the old expiry",
+    "[dht][IntroSetStore]")
+{
+  dht::IntroSetStore store;
+  auto introset = makeIntroSet(1s);
+  const auto location = locationOf(introset);
+  REQUIRE(store.Put(introset));
+  auto newer = introset;
+  newer.signedAt = 1s + dht::IntroSetStore::ExpiryBucketWidth * 3;
+  REQUIRE(store.Put(newer));
+
+  store.Expire(introset.signedAt + path::default_lifetime);
+  CHECK(store.Get(location));
+  store.Expire(newer.signedAt + path::default_lifetime);
+  CHECK_FALSE(store.Get(location));
+}
+
+TEST_CASE_METHOD(test::LlarpTest<>, "IntroSetFilter summarises a store", "[dht][IntroSetFilter]")
+{
+  dht::IntroSetStore store;
+  std::vector<service::EncryptedIntroSet> held, other;
+  for (int idx = 0; idx < 200; ++idx)
+  {
+    held.push_back(makeIntroSet(1s));
+    REQUIRE(store.Put(held.back()));
+  }
+  for (int idx = 0; idx < 1000; ++idx)
+    other.push_back(makeIntroSet(1s));
+
+  const auto filter = store.Summary();
+  CHECK(filter.IsValid());
+  for (const auto& introset : held)
+    CHECK(filter.MaybeContains(introset));
+
+  const auto falsePositives = std::count_if(other.begin(), other.end(), [&filter](auto& i) {
+    return filter.MaybeContains(i);
+  });
+  CHECK(falsePositives < 50);
+
+  // a newer copy of something held is missing
+  auto newer = held.front();
+  newer.signedAt = 2s;
+  CHECK_FALSE(filter.MaybeContains(newer));
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>, "IntroSetFilter sizes stay within bounds", "[dht][IntroSetFilter]")
+{
+  CHECK(dht::IntroSetFilter{0}.bits.size() == dht::IntroSetFilter::MinBytes);
+  CHECK(dht::IntroSetFilter{100'000}.bits.size() == dht::IntroSetFilter::MaxBytes);
+  CHECK(dht::IntroSetFilter{1000}.bits.size() == 1000 * dht::IntroSetFilter::BitsPerElement / 8);
+
+  dht::IntroSetFilter decoded;
+  CHECK_FALSE(decoded.IsValid());
+  decoded.bits.resize(dht::IntroSetFilter::MaxBytes + 1);
+  CHECK_FALSE(decoded.IsValid());
+  decoded.bits.resize(dht::IntroSetFilter::MinBytes);
+  CHECK(decoded.IsValid());
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>, "IntroSetStore sends what a filter is missing", "[dht][IntroSetStore]")
+{
+  dht::IntroSetStore store, peer;
+  for (int idx = 0; idx < 20; ++idx)
+  {
+    const auto introset = makeIntroSet(1s);
+    REQUIRE(store.Put(introset));
+    if (idx % 2)
+      REQUIRE(peer.Put(introset));
+  }
+  const auto filter = peer.Summary();
+  const auto all = [](const auto&) { return true; };
+
+  auto missing = store.Missing(filter, all, 1'000'000);
+  CHECK(missing.size() == 10);
+  for (const auto& introset : missing)
+    CHECK_FALSE(peer.Get(locationOf(introset)));
+
+  // only what the peer wants
+  CHECK(store.Missing(filter, [](const auto&) { return false; }, 1'000'000).empty());
+
+  // and no more than fits
+  const auto some = store.Missing(filter, all, 500);
+  CHECK(some.size() > 0);
+  CHECK(some.size() < missing.size());
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>, "StorageCandidates picks the closest relays", "[dht][StorageCandidates]")
+{
+  constexpr size_t redundancy = 4;
+  std::vector<dht::Key_t> relays;
+  for (int idx = 0; idx < 300; ++idx)
+    relays.push_back(randomKey());
+  // duplicates don't count twice
+  relays.push_back(relays.front());
+  const dht::StorageCandidates candidates{relays, redundancy};
+
+  for (int round = 0; round < 100; ++round)
+  {
+    const auto location = round ? randomKey() : relays[7];
+    auto expected = relays;
+    std::sort(expected.begin(), expected.end(), [&location](const auto& a, const auto& b) {
+      return (a ^ location) < (b ^ location);
+    });
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    expected.resize(redundancy);
+
+    auto closest = candidates.Closest(location);
+    std::sort(closest.begin(), closest.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(closest == expected);
+
+    for (const auto& relay : expected)
+      CHECK(candidates.IsCandidate(location, relay));
+  }
+  CHECK(candidates.IsCandidate(relays[7], relays[7]));
+}
+
+TEST_CASE_METHOD(
+    test::LlarpTest<>,
+    "StorageCandidates with few relays uses them all",
+    "[dht][StorageCandidates]")
+{
+  const std::vector<dht::Key_t> relays{randomKey(), randomKey()};
+  const dht::StorageCandidates candidates{relays, 4};
+  const auto location = randomKey();
+  CHECK(candidates.Closest(location).size() == 2);
+  CHECK(candidates.IsCandidate(location, relays[0]));
+  CHECK(candidates.IsCandidate(location, relays[1]));
+  CHECK_FALSE(candidates.IsCandidate(location, randomKey()));
+  CHECK(dht::StorageCandidates{{}, 4}.Closest(location).empty());
+}
@@ -0,0 +1,185 @@
+#include <dht/messages/syncintro.hpp>
+
+#include <llarp_test.hpp>
+#include <util/time.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  class SyncIntroTest : public test::LlarpTest<>
+  {
+   public:
+    /// a signed intro set at a random location
+    service::EncryptedIntroSet
+    MakeIntroSet()
+    {
+      SecretKey secret;
+      CryptoManager::instance()->identity_keygen(secret);
+      PrivateKey key;
+      REQUIRE(secret.toPrivate(key));
+      service::EncryptedIntroSet introset;
+      introset.nounce.Randomize();
+      introset.introsetPayload.resize(64);
+      REQUIRE(introset.Sign(key));
+      return introset;
+    }
+
+    static dht::Key_t
+    LocationOf(const service::EncryptedIntroSet& introset)
+    {
+      return dht::Key_t{introset.derivedSigningKey.as_array()};
+    }
+
+    static dht::Key_t
+    RandomKey()
+    {
+      dht::Key_t key;
+      key.Randomize();
+      return key;
+    }
+
+    /// encodes msg the way it goes out in a dht message list and decodes it again
+    static std::vector<dht::IMessage::Ptr_t>
+    RoundTrip(const dht::IMessage& msg, bool relayed = false)
+    {
+      std::array<byte_t, 8192> tmp;
+      llarp_buffer_t buf{tmp};
+      *buf.cur++ = 'l';
+      REQUIRE(msg.BEncode(&buf));
+      *buf.cur++ = 'e';
+      buf.sz = buf.cur - buf.base;
+      buf.cur = buf.base;
+      std::vector<dht::IMessage::Ptr_t> decoded;
+      dht::DecodeMesssageList(msg.From, &buf, decoded, relayed);
+      return decoded;
+    }
+  };
+}  // namespace
+
+TEST_CASE_METHOD(SyncIntroTest, "SyncIntroSetsMessage request round trip", "[dht][SyncIntro]")
+{
+  dht::IntroSetStore store;
+  for (int idx = 0; idx < 10; ++idx)
+    store.Put(MakeIntroSet());
+  dht::SyncIntroSetsMessage request{store.Summary(), 42};
+
+  auto decoded = RoundTrip(request);
+  REQUIRE(decoded.size() == 1);
+  auto* msg = dynamic_cast<dht::SyncIntroSetsMessage*>(decoded.front().get());
+  REQUIRE(msg);
+  REQUIRE(msg->filter);
+  CHECK(msg->filter->bits == request.filter->bits);
+  CHECK(msg->filter->salt == request.filter->salt);
+  CHECK(msg->introsets.empty());
+  CHECK(msg->txid == 42);
+
+  // relays sync with each other directly, never over a path
+  CHECK(RoundTrip(request, true).empty());
+}
+
+TEST_CASE_METHOD(SyncIntroTest, "SyncIntroSetsMessage reply round trip", "[dht][SyncIntro]")
+{
+  std::vector<service::EncryptedIntroSet> introsets{MakeIntroSet(), MakeIntroSet()};
+  dht::SyncIntroSetsMessage reply{introsets, 7};
+
+  auto decoded = RoundTrip(reply);
+  REQUIRE(decoded.size() == 1);
+  auto* msg = dynamic_cast<dht::SyncIntroSetsMessage*>(decoded.front().get());
+  REQUIRE(msg);
+  CHECK_FALSE(msg->filter);
+  CHECK(msg->introsets == introsets);
+  CHECK(msg->txid == 7);
+}
+
+TEST_CASE_METHOD(SyncIntroTest, "SyncIntroSetsMessage syncs only candidates", "[dht][SyncIntro]")
+{
+  const auto now = time_now_ms();
+  const auto us = RandomKey();
+  const auto peer = RandomKey();
+
+  // with just us and the peer both are candidates for everything, a third relay at each intro
+  // set's location makes one of them not
+  std::vector<service::EncryptedIntroSet> ours, theirs;
+  std::vector<dht::Key_t> relays{us, peer};
+  for (int idx = 0; idx < 8; ++idx)
+  {
+    ours.push_back(MakeIntroSet());
+    theirs.push_back(MakeIntroSet());
+    relays.push_back(LocationOf(ours.back()));
+    relays.push_back(LocationOf(theirs.back()));
+  }
+  const dht::StorageCandidates candidates{relays, 3};
+
+  dht::IntroSetStore store;
+  for (const auto& introset : ours)
+    REQUIRE(store.Put(introset));
+
+  dht::SyncIntroSetsMessage msg{peer};
+  msg.introsets = theirs;
+  msg.filter.emplace(size_t{0});
+  msg.txid = 9;
+
+  std::vector<dht::IMessage::Ptr_t> replies;
+  REQUIRE(msg.HandleSync(store, candidates, us, now, replies));
+
+  // we store what we are a candidate for
+  for (const auto& introset : theirs)
+  {
+    const auto location = LocationOf(introset);
+    CHECK(bool(store.Get(location)) == candidates.IsCandidate(location, us));
+  }
+
+  // and send the peer what it is a candidate for and doesn't have
+  size_t expected = 0;
+  for (const auto& introset : ours)
+    expected += candidates.IsCandidate(LocationOf(introset), peer);
+  if (expected == 0)
+  {
+    CHECK(replies.empty());
+    return;
+  }
+  REQUIRE(replies.size() == 1);
+  auto* reply = dynamic_cast<dht::SyncIntroSetsMessage*>(replies.front().get());
+  REQUIRE(reply);
+  CHECK(reply->txid == 9);
+  CHECK_FALSE(reply->filter);
+  CHECK(reply->introsets.size() == expected);
+  for (const auto& introset : reply->introsets)
+    CHECK(candidates.IsCandidate(LocationOf(introset), peer));
+}
+
+TEST_CASE_METHOD(SyncIntroTest, "SyncIntroSetsMessage rejects bad syncs", "[dht][SyncIntro]")
+{
+  const auto now = time_now_ms();
+  const auto us = RandomKey();
+  const auto peer = RandomKey();
+  const dht::StorageCandidates candidates{{us, peer}, 4};
+  dht::IntroSetStore store;
+  std::vector<dht::IMessage::Ptr_t> replies;
+
+  // an intro set that doesn't verify
+  dht::SyncIntroSetsMessage tampered{peer};
+  tampered.introsets.push_back(MakeIntroSet());
+  tampered.introsets.back().introsetPayload[0] ^= 1;
+  CHECK_FALSE(tampered.HandleSync(store, candidates, us, now, replies));
+  CHECK(store.size() == 0);
+
+  // or has expired
+  dht::SyncIntroSetsMessage expired{peer};
+  expired.introsets.push_back(MakeIntroSet());
+  CHECK_FALSE(expired.HandleSync(store, candidates, us, now + 1h, replies));
+
+  // a filter of a size we never send
+  store.Put(MakeIntroSet());
+  dht::SyncIntroSetsMessage oversized{peer};
+  oversized.filter.emplace();
+  oversized.filter->bits.resize(dht::IntroSetFilter::MaxBytes + 1);
+  CHECK_FALSE(oversized.HandleSync(store, candidates, us, now, replies));
+  CHECK(replies.empty());
+}
@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+#
+# end to end throughput and latency benchmark on a local router hive.
+#
+# boots relays and two clients in this process, on loopback sockets or on the hive's virtual
+# network, then drives fixed workloads from one client to a .bdx service endpoint on the other:
+#
+#   service: packets sent to the service and echoed straight back by it
+#   quic:    tcp through quic tunnels (what `belnet-quic connect` sets up) to an echo server
+#
+# and reports throughput, packets/sec, p50/p99 round trip times and the cpu each relay used.
+# needs no external network; quic needs real sockets, so it is skipped with --virtual.
+#
+#   PYTHONPATH=build/pybind python3 test/hive/bench.py --relays 8 --duration 10 --json out.json
+
+import hive
+import pyllarp
+
+from argparse import ArgumentParser as ap
+from time import perf_counter
+import json
+import socket
+import struct
+import threading
+
+
+def percentile(values, p):
+  if not values:
+    return None
+  values = sorted(values)
+  idx = min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))
+  return values[idx]
+
+
+class Bench(object):
+
+  def __init__(self, n_relays, virtual=False, threads=4, seed=0, verbose=False):
+    self.virtual = virtual
+    self.h = hive.RouterHive(n_relays=n_relays, n_clients=2, netid="bench", shutup=not verbose,
+                             virtual=virtual, threads=threads, seed=seed)
+    self.src = None
+    self.dst = None
+    self.dstAddr = None
+
+  def Now(self):
+    if self.virtual:
+      return self.h.hive.Now() / 1000.0
+    return perf_counter()
+
+  def Sleep(self, secs):
+    # keep the event queue from growing while we run
+    self.h.hive.GetAllEvents()
+    self.h.Sleep(secs)
+
+  def Start(self):
+    self.h.Start()
+    self.Sleep(5)
+
+    contexts = []
+    self.h.hive.ForEachClient(lambda ctx: contexts.append(ctx))
+    self.src = pyllarp.Endpoint("bench-src", contexts[0])
+    self.dst = pyllarp.Endpoint("bench-dst", contexts[1])
+    self.dst.Echo = True
+    for ctx, ep in zip(contexts, (self.src, self.dst)):
+      ctx.CallSafe(lambda ctx=ctx, ep=ep: ctx.AddEndpoint(ep))
+    self.Sleep(1)
+    self.dstAddr = pyllarp.ServiceAddress(self.dst.OurAddress())
+    print("service endpoint is %s" % self.dst.OurAddress())
+
+  def Stop(self):
+    self.h.Stop()
+
+  def RelayCPU(self):
+    cpu = dict()
+    for rc in self.h.hive.GetRelayRCs():
+      secs = self.h.hive.RouterCPUTime(rc.routerID)
+      if secs is not None:
+        cpu[rc.routerID.ShortString()] = secs
+    return cpu
+
+  def Measure(self, workload, *args):
+    """run workload and add the cpu each relay used meanwhile to its results"""
+    before = self.RelayCPU()
+    # cpu time is real time, so it is measured against the wall clock even on the virtual
+    # network, where Now() is simulated time
+    started = perf_counter()
+    results = workload(*args)
+    elapsed = perf_counter() - started
+    after = self.RelayCPU()
+    used = {rid: after[rid] - before[rid] for rid in after if rid in before}
+    results["relay_cpu_seconds"] = {rid: round(secs, 3) for rid, secs in used.items()}
+    results["relay_cpu_percent"] = {
+        rid: round(100.0 * secs / elapsed, 2) for rid, secs in used.items()}
+    return results
+
+  def RunService(self, duration, size, window, rate):
+    lock = threading.Lock()
+    sent = dict()
+    rtts = []
+    stats = {"packets": 0, "bytes": 0, "lost": 0}
+    pad = b"\0" * max(0, size - 8)
+
+    def on_echo(addr, data, proto):
+      now = self.Now()
+      seq, = struct.unpack_from("!Q", data)
+      with lock:
+        at = sent.pop(seq, None)
+        if at is None:
+          return
+        rtts.append(now - at)
+        stats["packets"] += 1
+        stats["bytes"] += len(data)
+
+    self.src.GotBytes = on_echo
+    seq = 0
+
+    def send():
+      nonlocal seq
+      with lock:
+        sent[seq] = self.Now()
+      self.src.SendBytes(
+          self.dstAddr, struct.pack("!Q", seq) + pad, pyllarp.ProtocolType.TrafficV4)
+      seq += 1
+
+    # the first packets wait on the lookup and a path to the service
+    print("waiting for a path to the service")
+    deadline = self.Now() + 60
+    while stats["packets"] == 0:
+      if self.Now() > deadline:
+        raise RuntimeError("no echo from the service endpoint")
+      send()
+      self.Sleep(0.5)
+    with lock:
+      sent.clear()
+      rtts.clear()
+      stats.update(packets=0, bytes=0)
+
+    print("service workload: %d byte packets for %ds" % (size, duration))
+    start = self.Now()
+    end = start + duration
+    while self.Now() < end:
+      now = self.Now()
+      with lock:
+        # anything out this long isn't coming back
+        for old in [s for s, at in sent.items() if now - at > 5]:
+          del sent[old]
+          stats["lost"] += 1
+        inflight = len(sent)
+      if inflight < window and (rate == 0 or seq < (now - start) * rate):
+        send()
+      else:
+        self.Sleep(0.001)
+    elapsed = self.Now() - start
+    # let the last echoes in
+    self.Sleep(1)
+
+    with lock:
+      return {
+          "workload": "service",
+          "packet_size": size,
+          "seconds": round(elapsed, 3),
+          "mbps": round(stats["bytes"] * 8 / elapsed / 1e6, 3),
+          "packets_per_sec": round(stats["packets"] / elapsed, 1),
+          "lost": stats["lost"] + len(sent),
+          "rtt_p50_ms": round(percentile(rtts, 50) * 1000, 3) if rtts else None,
+          "rtt_p99_ms": round(percentile(rtts, 99) * 1000, 3) if rtts else None}
+
+  def RunQuic(self, duration, size):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.bind(("127.0.0.1", 0))
+    server.listen()
+    port = server.getsockname()[1]
+
+    def echo(conn):
+      with conn:
+        while True:
+          data = conn.recv(65536)
+          if not data:
+            return
+          conn.sendall(data)
+
+    def accept():
+      while True:
+        try:
+          conn, _ = server.accept()
+        except OSError:
+          return
+        threading.Thread(target=echo, args=(conn,), daemon=True).start()
+
+    threading.Thread(target=accept, daemon=True).start()
+
+    self.dst.QuicListen(port)
+    local = self.src.QuicConnect(str(self.dstAddr), port)
+    print("quic tunnel to the service on 127.0.0.1:%d" % local)
+
+    # round trips of small messages on their own stream
+    rtts = []
+    with socket.create_connection(("127.0.0.1", local), timeout=60) as conn:
+      conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+      msg = b"x" * 64
+
+      def ping():
+        sent = perf_counter()
+        conn.sendall(msg)
+        got = 0
+        while got < len(msg):
+          got += len(conn.recv(len(msg) - got))
+        return perf_counter() - sent
+
+      # the first one waits on the quic handshake
+      ping()
+      end = perf_counter() + min(duration, 5)
+      while perf_counter() < end:
+        rtts.append(ping())
+
+    # bulk data, counted as it comes back
+    print("quic workload: streaming for %ds" % duration)
+    received = 0
+    with socket.create_connection(("127.0.0.1", local), timeout=30) as conn:
+      block = b"\0" * size
+      done = threading.Event()
+
+      def writer():
+        while not done.is_set():
+          try:
+            conn.sendall(block)
+          except OSError:
+            return
+
+      threading.Thread(target=writer, daemon=True).start()
+      start = perf_counter()
+      while perf_counter() - start < duration:
+        try:
+          data = conn.recv(65536)
+        except socket.timeout:
+          break
+        if not data:
+          break
+        received += len(data)
+      elapsed = perf_counter() - start
+      done.set()
+    server.close()
+
+    return {
+        "workload": "quic",
+        "seconds": round(elapsed, 3),
+        "mbps": round(received * 8 / elapsed / 1e6, 3),
+        "round_trips_per_sec": round(len(rtts) / min(duration, 5), 1),
+        "rtt_p50_ms": round(percentile(rtts, 50) * 1000, 3) if rtts else None,
+        "rtt_p99_ms": round(percentile(rtts, 99) * 1000, 3) if rtts else None}
+
+
+def main():
+  parser = ap()
+  parser.add_argument('--relays', dest="relays", type=int, default=8)
+  parser.add_argument('--duration', dest="duration", type=int, default=10)
+  parser.add_argument('--packet-size', dest="packet_size", type=int, default=1024)
+  parser.add_argument('--window', dest="window", type=int, default=64,
+                      help="packets in flight to the service at most")
+  parser.add_argument('--rate', dest="rate", type=int, default=0,
+                      help="packets/sec to send to the service, 0 for as many as the window allows")
+  parser.add_argument('--no-quic', action='store_true', dest='no_quic')
+  parser.add_argument('--virtual', action='store_true', dest='virtual')
+  parser.add_argument('--threads', dest="threads", type=int, default=4)
+  parser.add_argument('--seed', dest="seed", type=int, default=0)
+  parser.add_argument('--json', dest="json", default=None, help="write the results here")
+  parser.add_argument('--verbose', action='store_true', dest='verbose')
+  args = parser.parse_args()
+
+  bench = Bench(args.relays, virtual=args.virtual, threads=args.threads, seed=args.seed,
+                verbose=args.verbose)
+  results = {"relays": args.relays, "virtual": args.virtual, "workloads": []}
+  try:
+    bench.Start()
+    results["workloads"].append(bench.Measure(
+        bench.RunService, args.duration, args.packet_size, args.window, args.rate))
+    if not (args.no_quic or args.virtual):
+      results["workloads"].append(bench.Measure(bench.RunQuic, args.duration, 16384))
+  finally:
+    bench.Stop()
+
+  print(json.dumps(results, indent=2))
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump(results, f, indent=2)
+
+
+if __name__ == '__main__':
+  main()
@@ -14,7 +14,8 @@ import traceback
 
 class RouterHive(object):
 
-  def __init__(self, n_relays=10, n_clients=10, netid="hive", shutup=True):
+  def __init__(self, n_relays=10, n_clients=10, netid="hive", shutup=True, virtual=False,
+               threads=4, seed=0):
     self._log = pyllarp.LogContext()
     self._log.shutup = shutup
     try:
@@ -26,6 +27,11 @@ class RouterHive(object):
       self.n_relays = n_relays
       self.n_clients = n_clients
 
+      # run on an in-process virtual network with a simulated clock instead of real sockets
+      self.virtual = virtual
+      self.threads = threads
+      self.seed = seed
+
       self.addrs = []
       self.events = deque()
 
@@ -112,13 +118,25 @@ class RouterHive(object):
 
     self.hive.AddClient(config)
 
+  def NewHive(self):
+    self.hive = None
+    self.hive = pyllarp.RouterHive()
+    if self.virtual:
+      self.hive.UseVirtualNetwork(self.threads, self.seed)
+
+  def Sleep(self, secs):
+    if self.virtual:
+      self.hive.RunFor(int(secs * 1000))
+    else:
+      sleep(secs)
+
   def InitFirstRC(self):
     print("Starting first router to init its RC for bootstrap")
-    self.hive = pyllarp.RouterHive()
+    self.NewHive()
     self.AddRelay(0)
     self.hive.StartRelays()
     print("sleeping 2 sec to give plenty of time to save bootstrap rc")
-    sleep(2)
+    self.Sleep(2)
 
     self.hive.StopAll()
 
@@ -128,7 +146,7 @@ class RouterHive(object):
 
     print("Resetting hive.  Creating %d relays and %d clients" % (self.n_relays, self.n_clients))
 
-    self.hive = pyllarp.RouterHive()
+    self.NewHive()
 
     for i in range(0, self.n_relays):
       self.AddRelay(i)
@@ -140,7 +158,7 @@ class RouterHive(object):
     self.hive.StartRelays()
 
     print("Sleeping 2 seconds before starting clients")
-    sleep(2)
+    self.Sleep(2)
 
     self.RCs = self.hive.GetRelayRCs()
 
@@ -172,7 +190,8 @@ class RouterHive(object):
     return rcs
 
 
-def main(n_relays=10, n_clients=10, print_each_event=True, verbose=False):
+def main(n_relays=10, n_clients=10, print_each_event=True, verbose=False, virtual=False,
+         threads=4, seed=0):
 
   running = True
 
@@ -184,7 +203,8 @@ def main(n_relays=10, n_clients=10, print_each_event=True, verbose=False):
   signal(SIGINT, handle_sigint)
 
   try:
-    hive = RouterHive(n_relays, n_clients, shutup=not verbose)
+    hive = RouterHive(n_relays, n_clients, shutup=not verbose, virtual=virtual,
+                      threads=threads, seed=seed)
     hive.Start()
 
   except Exception as err:
@@ -236,7 +256,7 @@ def main(n_relays=10, n_clients=10, print_each_event=True, verbose=False):
 
     hive.events = []
     for _ in range(100):
-      sleep(1.0 / 100)
+      hive.Sleep(1.0 / 100)
 
   print('stopping')
   hive.Stop()
@@ -252,5 +272,9 @@ if __name__ == '__main__':
   parser.add_argument('--relay-count', dest="relay_count", type=int, default=10)
   parser.add_argument('--client-count', dest="client_count", type=int, default=10)
   parser.add_argument('--verbose', action='store_true', dest='verbose')
+  parser.add_argument('--virtual', action='store_true', dest='virtual')
+  parser.add_argument('--threads', dest="threads", type=int, default=4)
+  parser.add_argument('--seed', dest="seed", type=int, default=0)
   args = parser.parse_args()
-  main(n_relays=args.relay_count, n_clients=args.client_count, print_each_event = args.print_events, verbose=args.verbose)
+  main(n_relays=args.relay_count, n_clients=args.client_count, print_each_event = args.print_events, verbose=args.verbose,
+       virtual=args.virtual, threads=args.threads, seed=args.seed)
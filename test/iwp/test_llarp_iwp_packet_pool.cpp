@@ -0,0 +1,117 @@
+#include <iwp/packet_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using llarp::iwp::PacketPool;
+
+namespace
+{
+  PacketPool::Batch_t
+  makeBatch(size_t packets, size_t sz)
+  {
+    PacketPool::Batch_t batch;
+    for (size_t idx = 0; idx < packets; ++idx)
+      batch.emplace_back(sz, 0xff);
+    return batch;
+  }
+}  // namespace
+
+TEST_CASE("PacketPool hands recycled buffers back zeroed", "[iwp][PacketPool]")
+{
+  PacketPool pool;
+  auto batch = makeBatch(1, 1024);
+  const auto* storage = batch.front().data();
+  pool.Recycle(std::move(batch));
+  CHECK(pool.Size() == 1);
+  CHECK(pool.Bytes() >= 1024);
+
+  // a smaller packet reuses the storage, zeroed like a fresh buffer
+  auto pkt = pool.Get(512);
+  CHECK(pkt.data() == storage);
+  CHECK(pkt.size() == 512);
+  CHECK(pkt.capacity() >= 1024);
+  CHECK(std::all_of(pkt.begin(), pkt.end(), [](auto b) { return b == 0; }));
+  CHECK(pool.Size() == 0);
+  CHECK(pool.Bytes() == 0);
+}
+
+TEST_CASE("PacketPool keeps at most MaxPackets buffers", "[iwp][PacketPool]")
+{
+  PacketPool pool;
+  pool.Recycle(makeBatch(PacketPool::MaxPackets - 1, 100));
+  CHECK(pool.Size() == PacketPool::MaxPackets - 1);
+
+  // only as many as fit are kept, the rest are freed with the batch
+  pool.Recycle(makeBatch(10, 100));
+  CHECK(pool.Size() == PacketPool::MaxPackets);
+  const auto bytes = pool.Bytes();
+  CHECK(bytes >= PacketPool::MaxPackets * 100);
+
+  pool.Recycle(makeBatch(10, 100));
+  CHECK(pool.Size() == PacketPool::MaxPackets);
+  CHECK(pool.Bytes() == bytes);
+}
+
+TEST_CASE("PacketPool allocates once it runs dry", "[iwp][PacketPool]")
+{
+  PacketPool pool;
+  // nothing pooled yet
+  CHECK(pool.Get(64).size() == 64);
+
+  // buffers that were moved out of a batch aren't pooled
+  auto batch = makeBatch(3, 64);
+  auto taken = std::move(batch[1]);
+  pool.Recycle(std::move(batch));
+  CHECK(pool.Size() == 2);
+
+  CHECK(pool.Get(64).capacity() >= 64);
+  CHECK(pool.Get(64).capacity() >= 64);
+  CHECK(pool.Size() == 0);
+  CHECK(pool.Bytes() == 0);
+
+  // exhausted, so the next one is a fresh zeroed buffer
+  auto fresh = pool.Get(128);
+  CHECK(fresh.size() == 128);
+  CHECK(std::all_of(fresh.begin(), fresh.end(), [](auto b) { return b == 0; }));
+  CHECK(pool.Size() == 0);
+}
+
+TEST_CASE("PacketPool keeps at most MaxBatches empty batches", "[iwp][PacketPool]")
+{
+  PacketPool pool;
+  CHECK(pool.GetBatch().capacity() == 0);
+
+  for (size_t idx = 0; idx < PacketPool::MaxBatches + 2; ++idx)
+    pool.Recycle(makeBatch(4, 16));
+
+  for (size_t idx = 0; idx < PacketPool::MaxBatches; ++idx)
+  {
+    auto batch = pool.GetBatch();
+    CHECK(batch.empty());
+    CHECK(batch.capacity() >= 4);
+  }
+  CHECK(pool.GetBatch().capacity() == 0);
+}
+
+TEST_CASE("PacketPool takes buffers back from other threads", "[iwp][PacketPool]")
+{
+  PacketPool pool;
+  std::vector<std::thread> workers;
+  for (int idx = 0; idx < 4; ++idx)
+    workers.emplace_back([&pool]() {
+      for (int round = 0; round < 100; ++round)
+        pool.Recycle(makeBatch(4, 32));
+    });
+  for (auto& worker : workers)
+    worker.join();
+  CHECK(pool.Size() == PacketPool::MaxPackets);
+
+  // and the logic thread drains exactly what was kept
+  for (size_t idx = 0; idx < PacketPool::MaxPackets; ++idx)
+    pool.Get(32);
+  CHECK(pool.Size() == 0);
+  CHECK(pool.Bytes() == 0);
+}
@@ -0,0 +1,165 @@
+#include <iwp/session.hpp>
+
+#include <crypto/crypto.hpp>
+#include <llarp_test.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+using namespace llarp::iwp;
+
+namespace
+{
+  /// our ident key, transport key, nonce and signature, as GenerateAndSendIntro lays them out
+  constexpr size_t IntroSize = PubKey::SIZE + PubKey::SIZE + TunnelNonce::SIZE + Signature::SIZE;
+  constexpr size_t IntroFlagsOffset = PacketOverhead + IntroSize;
+  /// an intro ack is the session token, then the flags the inbound side agreed to
+  constexpr size_t IntroAckFlagsOffset = PacketOverhead + 24;
+
+  class IWPSessionTest : public test::LlarpTest<>
+  {
+   public:
+    IWPSessionTest()
+    {
+      key.Randomize();
+    }
+
+    /// a signed intro from a peer that offers flags, or one that predates them
+    ILinkSession::Packet_t
+    MakeIntro(std::optional<byte_t> flags)
+    {
+      ILinkSession::Packet_t intro(IntroFlagsOffset + (flags ? 1 : 0));
+      CryptoManager::instance()->randbytes(intro.data() + PacketOverhead, IntroSize);
+      CryptoManager::instance()->identity_keygen(identity);
+      const auto pk = identity.toPublic();
+      std::copy_n(pk.data(), pk.size(), intro.data() + PacketOverhead);
+      Signature sig;
+      CryptoManager::instance()->sign(sig, identity, SignedPart(intro));
+      std::copy_n(sig.data(), sig.size(), intro.data() + IntroFlagsOffset - Signature::SIZE);
+      if (flags)
+        intro[IntroFlagsOffset] = *flags;
+      return intro;
+    }
+
+    static llarp_buffer_t
+    SignedPart(ILinkSession::Packet_t& intro)
+    {
+      return {intro.data() + PacketOverhead, IntroSize - Signature::SIZE};
+    }
+
+    bool
+    VerifyIntro(ILinkSession::Packet_t& intro)
+    {
+      Signature sig;
+      std::copy_n(intro.data() + IntroFlagsOffset - Signature::SIZE, sig.size(), sig.data());
+      return CryptoManager::instance()->verify(identity.toPublic(), SignedPart(intro), sig);
+    }
+
+    /// protects a data packet the way a session that agreed to flags does, and checks that the
+    /// remote end that agreed to the same flags gets the plaintext back
+    bool
+    RoundTrip(byte_t agreed)
+    {
+      auto pkt = CreatePacket(Command::eDATA, 64);
+      const auto plain = pkt;
+      if (agreed & IntroFlagAEAD)
+        SealPacketInPlace(pkt, key);
+      else
+        EncryptPacketInPlace(pkt, key);
+      const bool opened = agreed & IntroFlagAEAD ? OpenPacketInPlace(pkt, key)
+                                                 : DecryptPacketInPlace(pkt, key);
+      return opened
+          and std::equal(
+              pkt.begin() + PacketOverhead, pkt.end(), plain.begin() + PacketOverhead);
+    }
+
+    SharedSecret key;
+    SecretKey identity;
+  };
+}  // namespace
+
+TEST_CASE_METHOD(IWPSessionTest, "iwp intro flags negotiate what both peers accept", "[iwp]")
+{
+  // new to new: everything we offer
+  auto intro = MakeIntro(OurIntroFlags);
+  CHECK(AgreedIntroFlags(intro, IntroFlagsOffset) == OurIntroFlags);
+  CHECK(RoundTrip(AgreedIntroFlags(intro, IntroFlagsOffset)));
+
+  // a peer offering only some of ours gets only those
+  intro = MakeIntro(IntroFlagCompactRelay);
+  CHECK(AgreedIntroFlags(intro, IntroFlagsOffset) == IntroFlagCompactRelay);
+
+  // flags from a newer peer that we don't know are never agreed to
+  intro = MakeIntro(0xff);
+  CHECK(AgreedIntroFlags(intro, IntroFlagsOffset) == OurIntroFlags);
+
+  // the outbound side reads what the inbound side agreed to from the ack
+  ILinkSession::Packet_t ack(IntroAckFlagsOffset + 1);
+  ack[IntroAckFlagsOffset] = IntroFlagAEAD;
+  CHECK(AgreedIntroFlags(ack, IntroAckFlagsOffset) == IntroFlagAEAD);
+}
+
+TEST_CASE_METHOD(
+    IWPSessionTest, "iwp peers without intro flags fall back to the keyed hash", "[iwp]")
+{
+  // an old outbound peer sends a bare intro, and the inbound side agrees to nothing
+  auto intro = MakeIntro(std::nullopt);
+  REQUIRE(VerifyIntro(intro));
+  CHECK(AgreedIntroFlags(intro, IntroFlagsOffset) == 0);
+
+  // an old inbound peer acks with just the token, so the outbound side agrees to nothing
+  const ILinkSession::Packet_t ack(IntroAckFlagsOffset);
+  CHECK(AgreedIntroFlags(ack, IntroAckFlagsOffset) == 0);
+
+  CHECK(RoundTrip(0));
+}
+
+TEST_CASE_METHOD(
+    IWPSessionTest, "iwp packets only open with the protection they were sent with", "[iwp]")
+{
+  auto pkt = CreatePacket(Command::eDATA, 64);
+  auto sealed = pkt;
+  SealPacketInPlace(sealed, key);
+  CHECK_FALSE(DecryptPacketInPlace(sealed, key));
+
+  auto hashed = pkt;
+  EncryptPacketInPlace(hashed, key);
+  CHECK_FALSE(OpenPacketInPlace(hashed, key));
+
+  // tampering is caught either way
+  SealPacketInPlace(pkt, key);
+  pkt.back() ^= 1;
+  CHECK_FALSE(OpenPacketInPlace(pkt, key));
+
+  // and so are packets too small to hold anything
+  ILinkSession::Packet_t runt(PacketOverhead);
+  CHECK_FALSE(OpenPacketInPlace(runt, key));
+  CHECK_FALSE(DecryptPacketInPlace(runt, key));
+}
+
+TEST_CASE_METHOD(IWPSessionTest, "iwp intro flags can be stripped but only downgrade", "[iwp]")
+{
+  // the flags byte follows the signature and isn't covered by it, so an on path attacker can
+  // strip it or clear bits without breaking the intro
+  auto intro = MakeIntro(OurIntroFlags);
+  REQUIRE(VerifyIntro(intro));
+
+  auto stripped = intro;
+  stripped.pop_back();
+  CHECK(VerifyIntro(stripped));
+  CHECK(AgreedIntroFlags(stripped, IntroFlagsOffset) == 0);
+
+  auto cleared = intro;
+  cleared[IntroFlagsOffset] = 0;
+  CHECK(VerifyIntro(cleared));
+  CHECK(AgreedIntroFlags(cleared, IntroFlagsOffset) == 0);
+
+  // what it gets is the keyed hash protocol old peers use, not a broken session
+  CHECK(RoundTrip(AgreedIntroFlags(stripped, IntroFlagsOffset)));
+
+  // and it can't add flags we don't accept
+  auto raised = intro;
+  raised[IntroFlagsOffset] = 0xff;
+  CHECK(VerifyIntro(raised));
+  CHECK((AgreedIntroFlags(raised, IntroFlagsOffset) & ~OurIntroFlags) == 0);
+}
@@ -0,0 +1,334 @@
+#include <llarp/config/key_manager.hpp>
+#include <llarp/link/server.hpp>
+#include <llarp/link/session.hpp>
+#include <llarp/messages/relay.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace std::literals;
+
+namespace
+{
+  /// a link layer that only does what ILinkLayer does itself
+  struct TestLink final : public llarp::ILinkLayer
+  {
+    TestLink()
+        : llarp::ILinkLayer{
+            std::make_shared<llarp::KeyManager>(),
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr,
+            nullptr}
+    {}
+
+    std::shared_ptr<llarp::ILinkSession>
+    NewOutboundSession(const llarp::RouterContact&, const llarp::AddressInfo&) override
+    {
+      return nullptr;
+    }
+
+    void
+    RecvFrom(const llarp::SockAddr&, llarp::ILinkSession::Packet_t) override
+    {}
+
+    std::string_view
+    Name() const override
+    {
+      return "test";
+    }
+
+    uint16_t
+    Rank() const override
+    {
+      return 1;
+    }
+
+    void
+    AddSession(const llarp::RouterID& pk, std::shared_ptr<llarp::ILinkSession> session)
+    {
+      Lock_t lock{m_AuthedLinksMutex};
+      m_AuthedLinks.emplace(pk, std::move(session));
+    }
+  };
+
+  /// a session that counts its pumps and schedules itself with the same PumpSchedule iwp
+  /// sessions use
+  struct TestSession final : public llarp::ILinkSession,
+                             public std::enable_shared_from_this<TestSession>
+  {
+    explicit TestSession(TestLink& link) : m_Link{link}
+    {}
+
+    void
+    QueueWork()
+    {
+      m_Schedule.Schedule(m_Link, weak_from_this());
+    }
+
+    bool
+    IsScheduled() const
+    {
+      return m_Schedule.IsScheduled();
+    }
+
+    void
+    Pump() override
+    {
+      ++pumps;
+      if (onPump)
+        std::exchange(onPump, nullptr)();
+      m_Schedule.Pumped();
+    }
+
+    void Tick(llarp_time_t) override
+    {}
+
+    bool
+    SendMessageBuffer(Message_t msg, CompletionHandler, uint16_t) override
+    {
+      sent.emplace_back(std::move(msg));
+      return true;
+    }
+
+    bool
+    SupportsCompactRelay() const override
+    {
+      return compactRelay;
+    }
+
+    void
+    Start() override
+    {}
+
+    void
+    Close() override
+    {}
+
+    bool
+    SendKeepAlive() override
+    {
+      return true;
+    }
+
+    bool
+    IsEstablished() const override
+    {
+      return true;
+    }
+
+    bool
+    TimedOut(llarp_time_t) const override
+    {
+      return false;
+    }
+
+    llarp::PubKey
+    GetPubKey() const override
+    {
+      return {};
+    }
+
+    bool
+    IsInbound() const override
+    {
+      return false;
+    }
+
+    const llarp::SockAddr&
+    GetRemoteEndpoint() const override
+    {
+      return m_Remote;
+    }
+
+    llarp::RouterContact
+    GetRemoteRC() const override
+    {
+      return {};
+    }
+
+    size_t
+    SendQueueBacklog() const override
+    {
+      return 0;
+    }
+
+    llarp::ILinkLayer*
+    GetLinkLayer() const override
+    {
+      return &m_Link;
+    }
+
+    bool
+    RenegotiateSession() override
+    {
+      return true;
+    }
+
+    bool
+    ShouldPing() const override
+    {
+      return false;
+    }
+
+    llarp::SessionStats
+    GetSessionStats() const override
+    {
+      return {};
+    }
+
+    llarp::util::StatusObject
+    ExtractStatus() const override
+    {
+      return {};
+    }
+
+    void
+    HandlePlaintext() override
+    {}
+
+    int pumps = 0;
+    /// run once from the next pump
+    std::function<void()> onPump;
+    bool compactRelay = false;
+    std::vector<Message_t> sent;
+
+   private:
+    TestLink& m_Link;
+    llarp::SockAddr m_Remote;
+    llarp::PumpSchedule m_Schedule;
+  };
+}  // namespace
+
+TEST_CASE("Link layer pumps only sessions that scheduled themselves", "[link]")
+{
+  TestLink link;
+  auto busy = std::make_shared<TestSession>(link);
+  auto idle = std::make_shared<TestSession>(link);
+
+  link.Pump();
+  CHECK(busy->pumps == 0);
+  CHECK(idle->pumps == 0);
+
+  // queueing work more than once before a pump still pumps once
+  busy->QueueWork();
+  busy->QueueWork();
+  CHECK(busy->IsScheduled());
+  CHECK_FALSE(idle->IsScheduled());
+  link.Pump();
+  CHECK(busy->pumps == 1);
+  CHECK(idle->pumps == 0);
+  CHECK_FALSE(busy->IsScheduled());
+
+  // nothing new queued, nothing pumped
+  link.Pump();
+  CHECK(busy->pumps == 1);
+  CHECK(idle->pumps == 0);
+
+  idle->QueueWork();
+  link.Pump();
+  CHECK(busy->pumps == 1);
+  CHECK(idle->pumps == 1);
+}
+
+TEST_CASE("Session work queued during its own pump is taken by that pump", "[link]")
+{
+  TestLink link;
+  auto session = std::make_shared<TestSession>(link);
+
+  // the way an iwp session queues the acks and keepalives it sends from its pump
+  session->onPump = [session = session.get()]() { session->QueueWork(); };
+  session->QueueWork();
+  link.Pump();
+  CHECK(session->pumps == 1);
+  CHECK_FALSE(session->IsScheduled());
+
+  link.Pump();
+  CHECK(session->pumps == 1);
+
+  // work after the pump schedules it again
+  session->QueueWork();
+  link.Pump();
+  CHECK(session->pumps == 2);
+}
+
+TEST_CASE("Link layer defers sessions scheduled during a pump to the next one", "[link]")
+{
+  TestLink link;
+  auto first = std::make_shared<TestSession>(link);
+  auto second = std::make_shared<TestSession>(link);
+
+  first->onPump = [second = second.get()]() { second->QueueWork(); };
+  first->QueueWork();
+  link.Pump();
+  CHECK(first->pumps == 1);
+  CHECK(second->pumps == 0);
+  CHECK(second->IsScheduled());
+
+  link.Pump();
+  CHECK(first->pumps == 1);
+  CHECK(second->pumps == 1);
+
+  link.Pump();
+  CHECK(second->pumps == 1);
+}
+
+TEST_CASE("Link layer skips scheduled sessions that have gone away", "[link]")
+{
+  TestLink link;
+  auto gone = std::make_shared<TestSession>(link);
+  auto kept = std::make_shared<TestSession>(link);
+
+  gone->QueueWork();
+  kept->QueueWork();
+  gone.reset();
+  link.Pump();
+  CHECK(kept->pumps == 1);
+}
+
+TEST_CASE("Link layer bencodes relay cells for sessions without the compact framing", "[link]")
+{
+  TestLink link;
+  auto compact = std::make_shared<TestSession>(link);
+  compact->compactRelay = true;
+  auto legacy = std::make_shared<TestSession>(link);
+  llarp::RouterID compactPeer, legacyPeer;
+  compactPeer.Fill(1);
+  legacyPeer.Fill(2);
+  link.AddSession(compactPeer, compact);
+  link.AddSession(legacyPeer, legacy);
+
+  llarp::RelayDownstreamMessage msg;
+  msg.pathid.Fill(3);
+  msg.Y.Fill(4);
+  msg.X.Fill(5);
+  auto encode = [&msg](auto&& how) {
+    std::array<byte_t, MAX_LINK_MSG_SIZE> tmp;
+    llarp_buffer_t buf{tmp};
+    REQUIRE(how(&buf));
+    return llarp::ILinkSession::Message_t{tmp.data(), buf.cur};
+  };
+  const auto cell = encode([&msg](auto* buf) { return msg.EncodeCompact(buf); });
+  const auto dict = encode([&msg](auto* buf) { return msg.BEncode(buf); });
+
+  CHECK(link.SendTo(compactPeer, llarp_buffer_t{cell}, nullptr, 0));
+  CHECK(link.SendTo(legacyPeer, llarp_buffer_t{cell}, nullptr, 0));
+  REQUIRE(compact->sent.size() == 1);
+  REQUIRE(legacy->sent.size() == 1);
+  CHECK(compact->sent.front() == cell);
+  CHECK(legacy->sent.front() == dict);
+
+  // anything else goes out as it is
+  CHECK(link.SendTo(legacyPeer, llarp_buffer_t{dict}, nullptr, 0));
+  REQUIRE(legacy->sent.size() == 2);
+  CHECK(legacy->sent.back() == dict);
+
+  llarp::RouterID nobody;
+  nobody.Fill(6);
+  CHECK_FALSE(link.SendTo(nobody, llarp_buffer_t{cell}, nullptr, 0));
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <llarp/rpc/master_node_list.hpp>
+
+#include <oxenc/bt_serialize.h>
+#include <oxenmq/oxenmq.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace mocks
+{
+  /// A local stand-in for beldexd's OxenMQ rpc: answers bt-encoded `rpc.get_master_nodes`
+  /// requests with whatever master node list the test sets, the way beldexd does (raw keys,
+  /// `unchanged` when polled with the current block hash).
+  class MockBeldexd
+  {
+   public:
+    MockBeldexd() : m_Address{"ipc:///tmp/belnet-test-beldexd-" + std::to_string(::getpid())}
+    {
+      m_OMQ.add_category("rpc", oxenmq::AuthLevel::none)
+          .add_request_command(
+              "get_master_nodes", [this](oxenmq::Message& msg) { GetMasterNodes(msg); });
+      m_OMQ.listen_plain(m_Address);
+      m_OMQ.start();
+    }
+
+    const std::string&
+    address() const
+    {
+      return m_Address;
+    }
+
+    /// replaces the master node list; each call is a new block
+    void
+    SetMasterNodes(std::vector<llarp::rpc::MasterNodeList::Entry> nodes)
+    {
+      std::lock_guard lock{m_Mutex};
+      m_Nodes = std::move(nodes);
+      m_BlockHash = std::to_string(++m_Height);
+    }
+
+   private:
+    void
+    GetMasterNodes(oxenmq::Message& msg)
+    {
+      std::string poll;
+      if (not msg.data.empty())
+      {
+        oxenc::bt_dict_consumer request{msg.data[0]};
+        if (request.skip_until("poll_block_hash"))
+          poll = request.consume_string();
+      }
+
+      std::lock_guard lock{m_Mutex};
+      oxenc::bt_dict reply{{"block_hash", m_BlockHash}, {"status", "OK"}};
+      if (poll == m_BlockHash)
+        reply["unchanged"] = uint64_t{1};
+      else
+      {
+        oxenc::bt_list states;
+        for (const auto& node : m_Nodes)
+        {
+          states.push_back(oxenc::bt_dict{
+              {"active", uint64_t{node.status == llarp::MasterNodeStatus::Active}},
+              {"funded", uint64_t{node.status != llarp::MasterNodeStatus::Unfunded}},
+              {"master_node_pubkey", std::string{node.masterKey.ToView()}},
+              {"pubkey_ed25519", std::string{node.router.ToView()}},
+          });
+        }
+        reply["master_node_states"] = std::move(states);
+      }
+      msg.send_reply("200", oxenc::bt_serialize(reply));
+    }
+
+    const std::string m_Address;
+    oxenmq::OxenMQ m_OMQ;
+
+    std::mutex m_Mutex;
+    std::vector<llarp::rpc::MasterNodeList::Entry> m_Nodes;
+    uint64_t m_Height = 0;
+    std::string m_BlockHash;
+  };
+}  // namespace mocks
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <llarp/ev/ev.hpp>
+
+#include <deque>
+#include <functional>
+
+namespace mocks
+{
+  /// runs queued calls only when asked to, so tests see what is left to the event loop
+  class QueuedLoop : public llarp::EventLoop
+  {
+   public:
+    std::deque<std::function<void(void)>> calls;
+
+    /// run the calls queued so far, returning how many ran
+    size_t
+    Pump()
+    {
+      size_t ran = 0;
+      while (not calls.empty())
+      {
+        auto f = std::move(calls.front());
+        calls.pop_front();
+        f();
+        ++ran;
+      }
+      return ran;
+    }
+
+    void
+    run() override
+    {
+      Pump();
+    }
+
+    bool
+    running() const override
+    {
+      return true;
+    }
+
+    llarp_time_t
+    time_now() const override
+    {
+      return llarp_time_t{0};
+    }
+
+    void
+    call_soon(std::function<void(void)> f) override
+    {
+      calls.emplace_back(std::move(f));
+    }
+
+    void
+    call_later(llarp_time_t, std::function<void(void)> f) override
+    {
+      calls.emplace_back(std::move(f));
+    }
+
+    bool
+    add_network_interface(
+        std::shared_ptr<llarp::vpn::NetworkInterface>,
+        std::function<void(llarp::net::IPPacket)>) override
+    {
+      return false;
+    }
+
+    bool
+    add_ticker(std::function<void(void)>) override
+    {
+      return false;
+    }
+
+    void
+    stop() override
+    {}
+
+    std::shared_ptr<llarp::UDPHandle>
+    make_udp(UDPReceiveFunc) override
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<llarp::EventLoopWakeup>
+    make_waker(std::function<void()>) override
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<llarp::EventLoopRepeater>
+    make_repeater() override
+    {
+      return nullptr;
+    }
+
+    bool
+    inEventLoop() const override
+    {
+      return false;
+    }
+
+    void
+    wakeup() override
+    {}
+  };
+}  // namespace mocks
@@ -65,3 +65,26 @@ TEST_CASE("FindClosestTo returns properly ordered set", "[nodedb][dht]")
   REQUIRE(c.pubkey == results[0].pubkey);
   REQUIRE(b.pubkey == results[1].pubkey);
 }
+
+TEST_CASE("Get shares the stored rc until it is replaced", "[nodedb]")
+{
+  llarp_nodedb nodeDB{fs::current_path(), nullptr};
+
+  llarp::RouterContact rc;
+  rc.pubkey[0] = 1;
+  rc.last_updated = 1s;
+  nodeDB.Put(rc);
+
+  const auto first = nodeDB.Get(rc.pubkey);
+  REQUIRE(first);
+  REQUIRE(first == nodeDB.Get(rc.pubkey));
+  REQUIRE(*first == rc);
+
+  rc.last_updated = 2s;
+  nodeDB.PutIfNewer(rc);
+
+  // whoever held the old rc still has it
+  REQUIRE(first->last_updated == 1s);
+  REQUIRE(nodeDB.Get(rc.pubkey)->last_updated == 2s);
+  REQUIRE_FALSE(nodeDB.Get(llarp::RouterID{}));
+}
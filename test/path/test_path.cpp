@@ -1,4 +1,5 @@
 #include <path/path.hpp>
+#include <path/build_admission.hpp>
 #include <catch2/catch.hpp>
 
 using Path_t   = llarp::path::Path;
@@ -6,18 +7,18 @@ using Path_ptr = llarp::path::Path_ptr;
 using Set_t    = llarp::path::Path::UniqueEndpointSet_t;
 using RC_t     = llarp::RouterContact;
 
-static RC_t
+static llarp::RouterContact_ptr
 MakeHop(const char name)
 {
   RC_t rc;
   rc.pubkey.Fill(name);
-  return rc;
+  return std::make_shared< const RC_t >(rc);
 }
 
 static Path_ptr
 MakePath(std::vector< char > hops)
 {
-  std::vector< RC_t > pathHops;
+  std::vector< llarp::RouterContact_ptr > pathHops;
   for(const auto& hop : hops)
     pathHops.push_back(MakeHop(hop));
   return std::make_shared< Path_t >(pathHops, std::weak_ptr<llarp::path::PathSet>{}, 0, "test");
@@ -37,3 +38,145 @@ TEST_CASE("UniqueEndpointSet_t has unique endpoints", "[path]")
       set.emplace(MakePath({'d', 'c', 'b', 'a'})).second;
   REQUIRE(inserted_second);
 }
+
+TEST_CASE("LatencyEstimator tracks rtt, jitter and loss", "[path]")
+{
+  llarp::path::LatencyEstimator est;
+  REQUIRE(est.Samples() == 0);
+  REQUIRE(est.Weight() == 0.0);
+
+  est.AddSample(100ms);
+  REQUIRE(est.RTT() == 100ms);
+  REQUIRE(est.Jitter() == 50ms);
+
+  for (int i = 0; i < 64; ++i)
+    est.AddSample(100ms);
+  REQUIRE(est.RTT() == 100ms);
+  REQUIRE(est.Jitter() < 5ms);
+  REQUIRE(est.LossRatio() == 0.0);
+
+  const auto weight = est.Weight();
+  est.MarkLost();
+  REQUIRE(est.LossRatio() > 0.0);
+  REQUIRE(est.Weight() < weight);
+}
+
+TEST_CASE("LatencyEstimator weighs faster paths higher", "[path]")
+{
+  llarp::path::LatencyEstimator fast, slow;
+  for (int i = 0; i < 8; ++i)
+  {
+    fast.AddSample(50ms);
+    slow.AddSample(500ms);
+  }
+  REQUIRE(fast.Weight() > slow.Weight());
+}
+
+TEST_CASE("BuildAdmission sheds builds over a peer's rate", "[path]")
+{
+  using Admission = llarp::path::BuildAdmission;
+  Admission admission;
+  llarp::RouterID flooder, other;
+  flooder.Fill('f');
+  other.Fill('o');
+  const auto now = 1000s;
+
+  size_t admitted = 0;
+  for (int i = 0; i < 100; ++i)
+    admitted += admission.Offer(flooder, [] {}, now);
+  REQUIRE(admitted == static_cast<size_t>(Admission::PeerBuildBurst));
+  REQUIRE(admission.ShedOverRate() == 100 - admitted);
+  // other peers are unaffected
+  REQUIRE(admission.Offer(other, [] {}, now));
+  // the bucket refills over time
+  REQUIRE(admission.Offer(flooder, [] {}, now + 1s));
+}
+
+TEST_CASE("BuildAdmission doesn't charge peers for builds shed over the global rate", "[path]")
+{
+  using Admission = llarp::path::BuildAdmission;
+  Admission admission;
+  const auto now = 1000s;
+
+  // use up the global budget from many peers, each at its own burst
+  const int peers = Admission::BuildBurst / Admission::PeerBuildBurst;
+  for (int i = 0; i < peers; ++i)
+  {
+    llarp::RouterID peer;
+    peer.Fill(i);
+    for (int j = 0; j < Admission::PeerBuildBurst; ++j)
+      REQUIRE(admission.Offer(peer, [] {}, now));
+  }
+
+  llarp::RouterID late;
+  late.Fill('l');
+  for (int i = 0; i < 100; ++i)
+    REQUIRE_FALSE(admission.Offer(late, [] {}, now));
+
+  // once the global bucket refills the late peer still has its whole burst
+  const auto later = now + 50ms;
+  size_t admitted = 0;
+  for (int i = 0; i < 50; ++i)
+    admitted += admission.Offer(late, [] {}, later);
+  REQUIRE(admitted >= 49);
+}
+
+TEST_CASE("BuildAdmission serves peers round robin", "[path]")
+{
+  llarp::path::BuildAdmission admission;
+  llarp::RouterID a, b;
+  a.Fill('a');
+  b.Fill('b');
+  const auto now = 1000s;
+
+  std::vector<char> ran;
+  for (int i = 0; i < 10; ++i)
+    admission.Offer(a, [&ran] { ran.push_back('a'); }, now);
+  admission.Offer(b, [&ran] { ran.push_back('b'); }, now);
+  REQUIRE(admission.Queued() == 11);
+
+  auto batch = admission.NextBatch();
+  REQUIRE(batch.size() == 11);
+  REQUIRE(admission.Queued() == 0);
+  for (const auto& work : batch)
+    work();
+  // b's only build runs second, not behind all of a's
+  REQUIRE(ran[1] == 'b');
+}
+
+TEST_CASE("LatencyEstimator probe timeout follows rtt", "[path]")
+{
+  llarp::path::LatencyEstimator est;
+  REQUIRE(est.ProbeTimeout() == llarp::path::LatencyEstimator::DefaultProbeTimeout);
+
+  for (int i = 0; i < 64; ++i)
+    est.AddSample(3s);
+  // a path slower than the default timeout is not counted lossy just for being slow
+  REQUIRE(est.ProbeTimeout() >= 3s);
+  REQUIRE(est.ProbeTimeout() <= llarp::path::LatencyEstimator::MaxProbeTimeout);
+
+  llarp::path::LatencyEstimator fast;
+  for (int i = 0; i < 64; ++i)
+    fast.AddSample(20ms);
+  REQUIRE(fast.ProbeTimeout() == llarp::path::LatencyEstimator::MinProbeTimeout);
+}
+
+TEST_CASE("LatencyEstimator weighs paths that carried more higher", "[path]")
+{
+  llarp::path::LatencyEstimator busy, idle;
+  for (int i = 0; i < 8; ++i)
+  {
+    busy.AddSample(100ms);
+    idle.AddSample(100ms);
+  }
+  busy.AddRate(512 * 1024);
+  REQUIRE(busy.Weight() > idle.Weight());
+  // capped at twice the latency weight
+  busy.AddRate(64 * 1024 * 1024);
+  REQUIRE(busy.Weight() == Approx(idle.Weight() * 2));
+
+  // the peak decays once the path stops carrying that much
+  const auto capacity = busy.Capacity();
+  busy.AddRate(0);
+  REQUIRE(busy.Capacity() < capacity);
+}
@@ -2,6 +2,7 @@
 #include <test_util.hpp>
 
 #include <numeric>
+#include <thread>
 #include <catch2/catch.hpp>
 #include "peerstats/types.hpp"
 #include "router_contact.hpp"
@@ -116,6 +117,35 @@ TEST_CASE("Test PeerDb modifyPeerStats", "[PeerDb]")
   CHECK(stats->numPathBuilds == 42);
 }
 
+TEST_CASE("Test PeerDb merges stats modified from several threads", "[PeerDb]")
+{
+  const llarp::RouterID id = llarp::test::makeBuf<llarp::RouterID>(0xF3);
+  constexpr int numThreads = 4;
+  constexpr int numPerThread = 1000;
+
+  llarp::PeerDb db;
+  db.loadDatabase(std::nullopt);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; i++)
+  {
+    threads.emplace_back([&] {
+      for (int j = 0; j < numPerThread; j++)
+        db.modifyPeerStats(id, [](llarp::PeerStats& stats) { stats.numConnectionAttempts++; });
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  auto stats = db.getCurrentPeerStats(id);
+  REQUIRE(stats.has_value());
+  CHECK(stats->numConnectionAttempts == numThreads * numPerThread);
+
+  db.flushDatabase();
+  db.modifyPeerStats(id, [](llarp::PeerStats& stats) { stats.numConnectionAttempts++; });
+  CHECK(db.getCurrentPeerStats(id)->numConnectionAttempts == numThreads * numPerThread + 1);
+}
+
 TEST_CASE("Test PeerDb handleGossipedRC", "[PeerDb]")
 {
   const llarp::RouterID id = llarp::test::makeBuf<llarp::RouterID>(0xCA);
@@ -155,6 +185,35 @@ TEST_CASE("Test PeerDb handleGossipedRC", "[PeerDb]")
   CHECK(stats->lastRCUpdated == 11000ms);
 }
 
+TEST_CASE("Test PeerDb handleGossipedRC sees pending deltas", "[PeerDb]")
+{
+  const llarp::RouterID id = llarp::test::makeBuf<llarp::RouterID>(0xCB);
+
+  llarp::PeerDb db;
+  db.loadDatabase(std::nullopt);
+
+  // an rc we already counted, still waiting in a delta
+  llarp::PeerStats delta(id);
+  delta.numDistinctRCsReceived = 1;
+  delta.lastRCUpdated = 10s;
+  db.accumulatePeerStats(id, delta);
+
+  // reading doesn't merge, and reading twice gives the same answer
+  CHECK(db.getCurrentPeerStats(id)->numDistinctRCsReceived == 1);
+  CHECK(db.listPeerStats({id}).at(0).numDistinctRCsReceived == 1);
+
+  llarp::RouterContact rc;
+  rc.pubkey = llarp::PubKey(id);
+  rc.last_updated = 10s;
+  db.handleGossipedRC(rc, 0s);
+
+  // the same rc again is not a new one
+  auto stats = db.getCurrentPeerStats(id);
+  REQUIRE(stats.has_value());
+  CHECK(stats->numDistinctRCsReceived == 1);
+  CHECK(stats->lastRCUpdated == 10s);
+}
+
 TEST_CASE("Test PeerDb handleGossipedRC expiry calcs", "[PeerDb]")
 {
   const llarp::RouterID id = llarp::test::makeBuf<llarp::RouterID>(0xF9);
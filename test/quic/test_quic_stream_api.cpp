@@ -0,0 +1,68 @@
+#include <belnet.h>
+
+#include <catch2/catch.hpp>
+
+#include <cerrno>
+
+TEST_CASE("belnet_outbound_stream rejects bad arguments", "[libbelnet][quic]")
+{
+  belnet_stream_result result{};
+  // nowhere to put the result, nothing to do
+  belnet_outbound_stream(nullptr, "remote.bdx:80", nullptr, nullptr);
+
+  belnet_outbound_stream(&result, "remote.bdx:80", nullptr, nullptr);
+  CHECK(result.error == EHOSTDOWN);
+
+  auto* ctx = belnet_context_new();
+  REQUIRE(ctx != nullptr);
+  belnet_outbound_stream(&result, nullptr, nullptr, ctx);
+  CHECK(result.error == EINVAL);
+  // not started
+  belnet_outbound_stream(&result, "remote.bdx:80", nullptr, ctx);
+  CHECK(result.error == EHOSTDOWN);
+  belnet_context_free(ctx);
+}
+
+TEST_CASE("belnet_inbound_stream_filter rejects bad arguments", "[libbelnet][quic]")
+{
+  auto accept = [](const char*, uint16_t, void*) { return 0; };
+  CHECK(belnet_inbound_stream_filter(accept, nullptr, nullptr) == -1);
+  CHECK(belnet_inbound_stream_filter(nullptr, nullptr, nullptr) == -1);
+
+  auto* ctx = belnet_context_new();
+  REQUIRE(ctx != nullptr);
+  // not started
+  CHECK(belnet_inbound_stream_filter(accept, nullptr, ctx) == -1);
+  belnet_context_free(ctx);
+}
+
+TEST_CASE("belnet_stream_open rejects bad arguments", "[libbelnet][quic]")
+{
+  int error = 0;
+  CHECK(belnet_stream_open("remote.bdx:80", &error, nullptr) == nullptr);
+  CHECK(error == EHOSTDOWN);
+  // the error is optional
+  CHECK(belnet_stream_open("remote.bdx:80", nullptr, nullptr) == nullptr);
+
+  auto* ctx = belnet_context_new();
+  REQUIRE(ctx != nullptr);
+  CHECK(belnet_stream_open(nullptr, &error, ctx) == nullptr);
+  CHECK(error == EINVAL);
+  CHECK(belnet_stream_open("no-port", &error, ctx) == nullptr);
+  CHECK(error == EINVAL);
+  // not started
+  CHECK(belnet_stream_open("remote.bdx:80", &error, ctx) == nullptr);
+  CHECK(error == EHOSTDOWN);
+  belnet_context_free(ctx);
+}
+
+TEST_CASE("belnet stream calls reject a missing stream", "[libbelnet][quic]")
+{
+  char buf[4];
+  size_t n = 0;
+  CHECK(belnet_stream_read(nullptr, buf, sizeof(buf), &n) == EINVAL);
+  CHECK(belnet_stream_write(nullptr, buf, sizeof(buf), &n) == EINVAL);
+  CHECK(belnet_stream_poll(nullptr, BELNET_STREAM_READABLE, 0) == BELNET_STREAM_CLOSED);
+  // freeing nothing is fine
+  belnet_stream_free(nullptr);
+}
@@ -0,0 +1,168 @@
+#include <quic/stream_pipe.hpp>
+#include <mocks/queued_loop.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cerrno>
+#include <string>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  quic::bstring_view
+  AsData(std::string_view str)
+  {
+    return {reinterpret_cast<const std::byte*>(str.data()), str.size()};
+  }
+
+  /// read up to len bytes from pipe, expecting the read to succeed
+  std::string
+  Read(quic::StreamPipe& pipe, size_t len)
+  {
+    std::string buf(len, '\0');
+    size_t nread = 0;
+    REQUIRE(pipe.read(buf.data(), buf.size(), nread) == 0);
+    buf.resize(nread);
+    return buf;
+  }
+}  // namespace
+
+TEST_CASE("StreamPipe reads across chunk boundaries", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+
+  size_t nread = 1;
+  char buf[8];
+  CHECK(pipe->read(buf, sizeof(buf), nread) == EAGAIN);
+  CHECK(nread == 0);
+  CHECK_FALSE(pipe->poll(quic::StreamPipe::READABLE, 0ms) & quic::StreamPipe::READABLE);
+
+  CHECK(pipe->on_data(AsData("hello ")));
+  CHECK(pipe->on_data(AsData("stream ")));
+  CHECK(pipe->on_data(AsData("pipe")));
+  CHECK(pipe->poll(quic::StreamPipe::READABLE, 0ms) == quic::StreamPipe::READABLE);
+
+  CHECK(Read(*pipe, 3) == "hel");
+  CHECK(Read(*pipe, 5) == "lo st");
+  CHECK(Read(*pipe, 64) == "ream pipe");
+  CHECK(pipe->read(buf, sizeof(buf), nread) == EAGAIN);
+  CHECK_FALSE(pipe->poll(quic::StreamPipe::READABLE, 0ms) & quic::StreamPipe::READABLE);
+}
+
+TEST_CASE("StreamPipe reports the end of the stream after its data", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+
+  pipe->on_data(AsData("last words"));
+  size_t nread = 0;
+  char buf[4];
+
+  SECTION("finished")
+  {
+    pipe->on_close(std::nullopt);
+    CHECK(pipe->poll(0, 0ms) == quic::StreamPipe::CLOSED);
+    CHECK(Read(*pipe, 4) == "last");
+    CHECK(Read(*pipe, 64) == " words");
+    // eof, for as long as it is asked
+    CHECK(Read(*pipe, 64).empty());
+    CHECK(Read(*pipe, 64).empty());
+  }
+  SECTION("reset")
+  {
+    pipe->on_close(uint64_t{1});
+    CHECK(Read(*pipe, 64) == "last words");
+    CHECK(pipe->read(buf, sizeof(buf), nread) == ECONNRESET);
+  }
+
+  size_t nwritten = 1;
+  CHECK(pipe->write("more", 4, nwritten) == EPIPE);
+  CHECK(nwritten == 0);
+  CHECK_FALSE(pipe->poll(quic::StreamPipe::WRITABLE, 0ms) & quic::StreamPipe::WRITABLE);
+}
+
+TEST_CASE("StreamPipe holds flow control credit for a reader that falls behind", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+
+  const std::string chunk(quic::StreamPipe::MAX_PENDING_READ / 2, 'x');
+  CHECK(pipe->on_data(AsData(chunk)));
+  CHECK(pipe->on_data(AsData(chunk)));
+  // past the mark, and everything after it until the reader catches up
+  CHECK_FALSE(pipe->on_data(AsData("y")));
+  CHECK_FALSE(pipe->on_data(AsData("z")));
+  CHECK(loop->calls.empty());
+
+  CHECK(Read(*pipe, chunk.size()).size() == chunk.size());
+  // the held credit goes back from the event loop, once
+  CHECK(loop->calls.size() == 1);
+  CHECK(Read(*pipe, 1) == "x");
+  CHECK(loop->Pump() == 1);
+  CHECK(pipe->on_data(AsData("!")));
+}
+
+TEST_CASE("StreamPipe buffers writes up to its limit", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+
+  const std::string data(quic::StreamPipe::MAX_PENDING_WRITE - 10, 'w');
+  size_t nwritten = 0;
+  CHECK(pipe->write(data.data(), data.size(), nwritten) == 0);
+  CHECK(nwritten == data.size());
+  CHECK(pipe->write("0123456789abcdef", 16, nwritten) == 0);
+  CHECK(nwritten == 10);
+  CHECK(pipe->write("x", 1, nwritten) == EAGAIN);
+  CHECK(nwritten == 0);
+  CHECK_FALSE(pipe->poll(quic::StreamPipe::WRITABLE, 0ms) & quic::StreamPipe::WRITABLE);
+  // a single flush is queued, however many writes there were
+  CHECK(loop->calls.size() == 1);
+  // nothing is attached to take the data, so it stays buffered
+  loop->Pump();
+  CHECK(pipe->write("x", 1, nwritten) == EAGAIN);
+}
+
+TEST_CASE("StreamPipe close discards unread data and stops writes", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+
+  size_t nwritten = 0;
+  CHECK(pipe->poll(quic::StreamPipe::WRITABLE, 0ms) == quic::StreamPipe::WRITABLE);
+  pipe->on_data(AsData("unread"));
+  pipe->close();
+  pipe->close();
+  CHECK(pipe->write("x", 1, nwritten) == EPIPE);
+  CHECK_FALSE(pipe->poll(quic::StreamPipe::WRITABLE, 0ms) & quic::StreamPipe::WRITABLE);
+
+  size_t nread = 1;
+  char buf[8];
+  CHECK(pipe->read(buf, sizeof(buf), nread) == EAGAIN);
+  CHECK(nread == 0);
+  // data arriving after close is not kept, and the remote gets its credit back
+  CHECK(pipe->on_data(AsData("late")));
+  CHECK(pipe->read(buf, sizeof(buf), nread) == EAGAIN);
+  CHECK(loop->Pump() == 1);
+}
+
+TEST_CASE("StreamPipe rejects a null buffer", "[quic]")
+{
+  auto loop = std::make_shared<mocks::QueuedLoop>();
+  auto pipe = std::make_shared<quic::StreamPipe>(loop);
+  pipe->on_data(AsData("data"));
+
+  size_t nread = 1;
+  CHECK(pipe->read(nullptr, 4, nread) == EINVAL);
+  CHECK(nread == 0);
+  CHECK(pipe->read(nullptr, 0, nread) == 0);
+  CHECK(Read(*pipe, 4) == "data");
+
+  size_t nwritten = 1;
+  CHECK(pipe->write(nullptr, 4, nwritten) == EINVAL);
+  CHECK(nwritten == 0);
+  CHECK(pipe->write(nullptr, 0, nwritten) == 0);
+}
@@ -0,0 +1,157 @@
+#include <mocks/mock_beldexd.hpp>
+#include <llarp/router/rc_lookup_handler.hpp>
+#include <test_util.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <future>
+
+using llarp::MasterNodeStatus;
+using llarp::rpc::MasterNodeList;
+
+using namespace std::literals;
+
+namespace
+{
+  MasterNodeList::Entry
+  makeEntry(llarp::byte_t id, MasterNodeStatus status)
+  {
+    return {
+        llarp::test::makeBuf<llarp::RouterID>(id),
+        llarp::test::makeBuf<llarp::PubKey>(id + 1),
+        status};
+  }
+
+  /// fetches the master node list from beldexd the way BeldexdRpcClient does
+  std::optional<std::vector<MasterNodeList::Entry>>
+  fetch(oxenmq::OxenMQ& omq, oxenmq::ConnectionID conn, std::string& blockHash)
+  {
+    std::promise<std::string> reply;
+    omq.request(
+        conn,
+        "rpc.get_master_nodes",
+        [&reply](bool success, std::vector<std::string> data) {
+          reply.set_value(success and data.size() == 2 ? data[1] : "");
+        },
+        MasterNodeList::MakeRequest(blockHash));
+    return MasterNodeList::ParseReply(reply.get_future().get(), blockHash);
+  }
+}  // namespace
+
+TEST_CASE("Master node list syncs changes from beldexd", "[rpc][beldexd]")
+{
+  mocks::MockBeldexd beldexd;
+  oxenmq::OxenMQ omq;
+  omq.start();
+  auto conn =
+      omq.connect_remote(oxenmq::address{beldexd.address()}, [](auto) {}, [](auto, auto) {});
+
+  MasterNodeList list;
+  std::string blockHash;
+
+  beldexd.SetMasterNodes({
+      makeEntry(1, MasterNodeStatus::Active),
+      makeEntry(2, MasterNodeStatus::Active),
+      makeEntry(3, MasterNodeStatus::Decommissioned),
+  });
+  auto entries = fetch(omq, conn, blockHash);
+  REQUIRE(entries);
+  REQUIRE(entries->size() == 3);
+  CHECK(entries->at(0).masterKey == llarp::test::makeBuf<llarp::PubKey>(2));
+
+  auto update = list.Update(*entries);
+  CHECK(update.changed.size() == 3);
+  CHECK(update.removed.empty());
+
+  // polling with the current block hash gets an empty "unchanged" reply
+  CHECK_FALSE(fetch(omq, conn, blockHash));
+
+  // 1 is decommissioned, 2 is unchanged, 3 deregisters and 4 registers
+  beldexd.SetMasterNodes({
+      makeEntry(1, MasterNodeStatus::Decommissioned),
+      makeEntry(2, MasterNodeStatus::Active),
+      makeEntry(4, MasterNodeStatus::Unfunded),
+  });
+  entries = fetch(omq, conn, blockHash);
+  REQUIRE(entries);
+  update = list.Update(*entries);
+
+  using Changed = std::pair<llarp::RouterID, MasterNodeStatus>;
+  CHECK_THAT(
+      update.changed,
+      Catch::UnorderedEquals(std::vector<Changed>{
+          {llarp::test::makeBuf<llarp::RouterID>(1), MasterNodeStatus::Decommissioned},
+          {llarp::test::makeBuf<llarp::RouterID>(4), MasterNodeStatus::Unfunded}}));
+  CHECK(update.removed == std::vector{llarp::test::makeBuf<llarp::RouterID>(3)});
+  CHECK(list.size() == 3);
+  CHECK_FALSE(list.MasterKey(llarp::test::makeBuf<llarp::RouterID>(3)));
+  CHECK(list.MasterKey(llarp::test::makeBuf<llarp::RouterID>(4)));
+}
+
+TEST_CASE("Master node list resyncs whitelist drift", "[rpc][beldexd]")
+{
+  mocks::MockBeldexd beldexd;
+  oxenmq::OxenMQ omq;
+  omq.start();
+  auto conn =
+      omq.connect_remote(oxenmq::address{beldexd.address()}, [](auto) {}, [](auto, auto) {});
+
+  MasterNodeList list;
+  llarp::RCLookupHandler handler;
+  std::string blockHash;
+  const auto id = [](llarp::byte_t n) { return llarp::test::makeBuf<llarp::RouterID>(n); };
+
+  // nothing to resync before the first listing
+  CHECK_FALSE(list.Resync(handler, 0s));
+
+  beldexd.SetMasterNodes({
+      makeEntry(1, MasterNodeStatus::Active),
+      makeEntry(2, MasterNodeStatus::Active),
+      makeEntry(3, MasterNodeStatus::Decommissioned),
+  });
+  auto entries = fetch(omq, conn, blockHash);
+  REQUIRE(entries);
+  list.Apply(*entries, handler, 0s);
+  CHECK(handler.Whitelist() == std::unordered_set{id(1), id(2)});
+  CHECK(handler.IsRegistered(id(3)));
+
+  // something outside of the beldexd sync edits the whitelist
+  handler.RemoveValidRouter(id(1));
+  handler.AddValidRouter(id(9));
+
+  // a new block only applies the diff, which leaves the drift alone
+  beldexd.SetMasterNodes({
+      makeEntry(1, MasterNodeStatus::Active),
+      makeEntry(2, MasterNodeStatus::Active),
+      makeEntry(3, MasterNodeStatus::Decommissioned),
+      makeEntry(4, MasterNodeStatus::Active),
+  });
+  entries = fetch(omq, conn, blockHash);
+  REQUIRE(entries);
+  list.Apply(*entries, handler, 1min);
+  CHECK(handler.Whitelist() == std::unordered_set{id(2), id(4), id(9)});
+
+  // no new block, and a full sync isn't due yet
+  CHECK_FALSE(fetch(omq, conn, blockHash));
+  CHECK_FALSE(list.Resync(handler, MasterNodeList::FullSyncInterval - 1s));
+
+  // once it is due the whole list replaces the drifted one
+  CHECK(list.Resync(handler, MasterNodeList::FullSyncInterval));
+  CHECK(handler.Whitelist() == std::unordered_set{id(1), id(2), id(4)});
+  CHECK(handler.IsRegistered(id(3)));
+  CHECK_FALSE(handler.IsRegistered(id(9)));
+
+  // a listing arriving when a full sync is due is applied in full as well
+  handler.RemoveValidRouter(id(2));
+  beldexd.SetMasterNodes({
+      makeEntry(1, MasterNodeStatus::Active),
+      makeEntry(2, MasterNodeStatus::Active),
+      makeEntry(4, MasterNodeStatus::Unfunded),
+  });
+  entries = fetch(omq, conn, blockHash);
+  REQUIRE(entries);
+  list.Apply(*entries, handler, 2 * MasterNodeList::FullSyncInterval);
+  CHECK(handler.Whitelist() == std::unordered_set{id(1), id(2)});
+  CHECK(handler.IsRegistered(id(4)));
+  CHECK_FALSE(handler.IsRegistered(id(3)));
+}
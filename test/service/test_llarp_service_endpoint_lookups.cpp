@@ -0,0 +1,221 @@
+#include <service/endpoint_util.hpp>
+#include <service/lookup.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  /// holds lookups the way an endpoint does
+  struct Lookups : public service::ILookupHolder
+  {
+    service::PendingLookups pending;
+
+    void
+    PutLookup(service::IServiceLookup* lookup, uint64_t txid) override
+    {
+      pending[txid].reset(lookup);
+    }
+  };
+
+  struct TestLookup : public service::IServiceLookup
+  {
+    const service::Address remote;
+
+    TestLookup(Lookups* holder, uint64_t tx, service::Address addr)
+        : IServiceLookup(holder, tx, "TestLookup"), remote(std::move(addr))
+    {}
+
+    std::shared_ptr<routing::IMessage>
+    BuildRequestMessage() override
+    {
+      return nullptr;
+    }
+
+    bool
+    IsFor(EndpointBase::AddressVariant_t addr) const override
+    {
+      if (const auto* ptr = std::get_if<service::Address>(&addr))
+        return *ptr == remote;
+      return false;
+    }
+  };
+
+  /// what happens to one address's lookups in an endpoint
+  struct Fixture
+  {
+    const service::Address addr{MakeAddress(1)};
+    const RouterID relay{MakeRelay(1)};
+
+    Lookups lookups;
+    service::LookupTimes times;
+    service::HedgedLookups hedged;
+    service::PendingServiceLookups hooks;
+
+    /// how the hooks were told: nullptr if there was no path
+    std::vector<service::OutboundContext*> informed;
+    /// how many hedged lookups were sent, and whether they go out
+    size_t sends = 0;
+    bool sendWorks = true;
+
+    const service::EndpointUtil::SendIntroSetLookup_t send =
+        [this](const path::Path_ptr&, uint64_t& order, llarp_time_t) {
+          ++order;
+          ++sends;
+          return sendWorks;
+        };
+
+    Fixture()
+    {
+      hooks.emplace(addr, [this](auto, auto* ctx) { informed.push_back(ctx); });
+    }
+
+    static service::Address
+    MakeAddress(byte_t fill)
+    {
+      service::Address addr;
+      addr.Fill(fill);
+      return addr;
+    }
+
+    static RouterID
+    MakeRelay(byte_t fill)
+    {
+      RouterID relay;
+      relay.Fill(fill);
+      return relay;
+    }
+
+    /// hold lookups back for the other relays, the paths are only handed to send
+    void
+    Hedge(size_t relays)
+    {
+      hedged[addr] = service::HedgedIntroSetLookup{
+          std::vector<path::Path_ptr>(relays), 4, 10s};
+    }
+
+    void
+    Failed(const RouterID& from)
+    {
+      service::EndpointUtil::IntroSetLookupFailed(
+          addr, from, 1s, times, hedged, lookups.pending, hooks, send);
+    }
+  };
+}  // namespace
+
+TEST_CASE_METHOD(Fixture, "Failed lookup with nothing left out fails the hooks", "[lookup]")
+{
+  Failed(relay);
+  REQUIRE(informed.size() == 1);
+  CHECK(informed[0] == nullptr);
+  CHECK(hooks.empty());
+  CHECK(sends == 0);
+}
+
+TEST_CASE_METHOD(Fixture, "Failed lookup waits on the other lookups still out", "[lookup]")
+{
+  new TestLookup(&lookups, 1, addr);
+  Failed(relay);
+  CHECK(informed.empty());
+  CHECK(hooks.size() == 1);
+}
+
+TEST_CASE_METHOD(Fixture, "Failed lookup sends the hedge early", "[lookup]")
+{
+  Hedge(2);
+  Failed(relay);
+  CHECK(sends == 2);
+  CHECK(hedged.empty());
+  // the hedged lookups are out now, the hooks wait on them
+  CHECK(informed.empty());
+
+  SECTION("the hedge timer finds nothing left to send")
+  {
+    CHECK_FALSE(service::EndpointUtil::SendHedgedLookups(
+        addr, hedged, lookups.pending, hooks, send));
+    CHECK(sends == 2);
+    CHECK(informed.empty());
+  }
+}
+
+TEST_CASE_METHOD(Fixture, "Hedge that sends nothing fails the hooks", "[lookup]")
+{
+  Hedge(2);
+  sendWorks = false;
+
+  SECTION("when the hedge timer fires")
+  {
+    CHECK_FALSE(service::EndpointUtil::SendHedgedLookups(
+        addr, hedged, lookups.pending, hooks, send));
+  }
+  SECTION("when a lookup fails first")
+  {
+    Failed(relay);
+  }
+  CHECK(sends == 2);
+  CHECK(hedged.empty());
+  REQUIRE(informed.size() == 1);
+  CHECK(informed[0] == nullptr);
+  CHECK(hooks.empty());
+}
+
+TEST_CASE_METHOD(Fixture, "Hedge that sends nothing waits on lookups still out", "[lookup]")
+{
+  Hedge(1);
+  sendWorks = false;
+  new TestLookup(&lookups, 1, addr);
+  CHECK_FALSE(
+      service::EndpointUtil::SendHedgedLookups(addr, hedged, lookups.pending, hooks, send));
+  CHECK(informed.empty());
+}
+
+TEST_CASE_METHOD(Fixture, "Hedge sends continue the relay order", "[lookup]")
+{
+  Hedge(3);
+  CHECK(service::EndpointUtil::SendHedgedLookups(addr, hedged, lookups.pending, hooks, send));
+  CHECK(sends == 3);
+  CHECK(informed.empty());
+}
+
+TEST_CASE_METHOD(Fixture, "Answered lookup cancels the rest for its address", "[lookup]")
+{
+  const auto other = MakeAddress(2);
+  Hedge(2);
+  new TestLookup(&lookups, 1, addr);
+  new TestLookup(&lookups, 2, addr);
+  new TestLookup(&lookups, 3, other);
+
+  service::EndpointUtil::IntroSetLookupAnswered(
+      addr, relay, 100ms, 1s, times, hedged, lookups.pending);
+  CHECK(hedged.empty());
+  REQUIRE(lookups.pending.size() == 1);
+  CHECK(lookups.pending.count(3));
+  CHECK(times.Expected(relay) == 100ms);
+
+  // the hedge timer fires after the answer came
+  CHECK_FALSE(
+      service::EndpointUtil::SendHedgedLookups(addr, hedged, lookups.pending, hooks, send));
+  CHECK(sends == 0);
+  CHECK(informed.empty());
+}
+
+TEST_CASE_METHOD(Fixture, "Relay that keeps finding nothing backs off", "[lookup]")
+{
+  const auto answering = MakeRelay(2);
+  service::EndpointUtil::IntroSetLookupAnswered(
+      addr, answering, 300ms, 1s, times, hedged, lookups.pending);
+  const auto hedgeDelay = times.HedgeDelay();
+
+  auto before = times.Expected(relay);
+  for (uint32_t idx = 0; idx < service::LookupTimes::MaxFailures; ++idx)
+  {
+    Failed(relay);
+    CHECK(times.Expected(relay) > before);
+    before = times.Expected(relay);
+  }
+  CHECK(times.Expected(relay) > times.Expected(answering));
+  // its quick "not found" replies are not response times
+  CHECK(times.HedgeDelay() == hedgeDelay);
+}
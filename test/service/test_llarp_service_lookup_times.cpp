@@ -0,0 +1,110 @@
+#include <service/lookup_times.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace llarp;
+using namespace std::literals;
+
+namespace
+{
+  RouterID
+  MakeRelay(byte_t fill)
+  {
+    RouterID relay;
+    relay.Fill(fill);
+    return relay;
+  }
+}  // namespace
+
+TEST_CASE("LookupTimes expects the default of relays it has not heard from", "[lookup]")
+{
+  service::LookupTimes times;
+  CHECK(times.Expected(MakeRelay(1)) == service::LookupTimes::DefaultResponseTime);
+  CHECK(times.HedgeDelay() >= service::LookupTimes::MinHedgeDelay);
+  CHECK(times.HedgeDelay() <= service::LookupTimes::MaxHedgeDelay);
+}
+
+TEST_CASE("LookupTimes smooths answers per relay", "[lookup]")
+{
+  service::LookupTimes times;
+  const auto fast = MakeRelay(1);
+  const auto slow = MakeRelay(2);
+
+  times.Answered(fast, 100ms, 1s);
+  times.Answered(slow, 2s, 1s);
+  CHECK(times.Expected(fast) == 100ms);
+  CHECK(times.Expected(slow) == 2s);
+
+  // one outlier moves the estimate an eighth of the way
+  times.Answered(fast, 900ms, 2s);
+  CHECK(times.Expected(fast) == 200ms);
+}
+
+TEST_CASE("LookupTimes hedge delay follows answers within bounds", "[lookup]")
+{
+  const auto relay = MakeRelay(1);
+  SECTION("steady fast answers hedge as early as allowed")
+  {
+    service::LookupTimes times;
+    for (int idx = 0; idx < 50; ++idx)
+      times.Answered(relay, 50ms, 1s);
+    CHECK(times.HedgeDelay() == service::LookupTimes::MinHedgeDelay);
+  }
+  SECTION("steady answers hedge a little after they usually come")
+  {
+    service::LookupTimes times;
+    for (int idx = 0; idx < 50; ++idx)
+      times.Answered(relay, 600ms, 1s);
+    CHECK(times.HedgeDelay() >= 600ms);
+    CHECK(times.HedgeDelay() < 700ms);
+  }
+  SECTION("slow answers hedge no later than allowed")
+  {
+    service::LookupTimes times;
+    for (int idx = 0; idx < 50; ++idx)
+      times.Answered(relay, 10s, 1s);
+    CHECK(times.HedgeDelay() == service::LookupTimes::MaxHedgeDelay);
+  }
+}
+
+TEST_CASE("LookupTimes backs off failing relays", "[lookup]")
+{
+  service::LookupTimes times;
+  const auto relay = MakeRelay(1);
+  const auto other = MakeRelay(2);
+  times.Answered(relay, 200ms, 1s);
+  times.Answered(other, 300ms, 1s);
+  const auto hedgeDelay = times.HedgeDelay();
+
+  times.Failed(relay, 2s);
+  CHECK(times.Expected(relay) == 400ms);
+  times.Failed(relay, 3s);
+  CHECK(times.Expected(relay) == 800ms);
+  for (int idx = 0; idx < 10; ++idx)
+    times.Failed(relay, 4s);
+  CHECK(times.Expected(relay) == 200ms * (1 << service::LookupTimes::MaxFailures));
+
+  // failures are not response times
+  CHECK(times.HedgeDelay() == hedgeDelay);
+  CHECK(times.Expected(other) == 300ms);
+
+  // and are forgiven once the relay answers again
+  times.Answered(relay, 200ms, 5s);
+  CHECK(times.Expected(relay) == 200ms);
+}
+
+TEST_CASE("LookupTimes forgets relays it has not heard from", "[lookup]")
+{
+  service::LookupTimes times;
+  const auto answered = MakeRelay(1);
+  const auto failed = MakeRelay(2);
+  times.Answered(answered, 100ms, 1s);
+  times.Failed(failed, 10min);
+
+  times.Decay(1s + service::LookupTimes::ForgetAfter);
+  CHECK(times.Expected(answered) == service::LookupTimes::DefaultResponseTime);
+  CHECK(times.Expected(failed) == 2 * service::LookupTimes::DefaultResponseTime);
+
+  times.Decay(10min + service::LookupTimes::ForgetAfter);
+  CHECK(times.Expected(failed) == service::LookupTimes::DefaultResponseTime);
+}
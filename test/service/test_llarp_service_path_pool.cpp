@@ -0,0 +1,73 @@
+#include <service/path_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using llarp::RouterID;
+using llarp::service::SpareDemand;
+
+namespace
+{
+  RouterID
+  MakeRouter(byte_t id)
+  {
+    RouterID router;
+    router.Fill(id);
+    return router;
+  }
+
+  const auto accept_all = [](const RouterID&) { return true; };
+}  // namespace
+
+TEST_CASE("SpareDemand builds to the most recently wanted router", "[path-pool]")
+{
+  SpareDemand demand;
+  const auto a = MakeRouter('a');
+  const auto b = MakeRouter('b');
+  REQUIRE_FALSE(demand.Next(accept_all));
+
+  demand.Want(a, llarp::path::ePathRoleOutboundHS, 1s);
+  demand.Want(b, llarp::path::ePathRoleSVC, 2s);
+  auto next = demand.Next(accept_all);
+  REQUIRE(next);
+  REQUIRE(next->first == b);
+  REQUIRE(next->second == llarp::path::ePathRoleSVC);
+
+  // b already has its spare
+  next = demand.Next([&b](const RouterID& router) { return router != b; });
+  REQUIRE(next);
+  REQUIRE(next->first == a);
+}
+
+TEST_CASE("SpareDemand forgets routers", "[path-pool]")
+{
+  SpareDemand demand;
+  const auto a = MakeRouter('a');
+  demand.Want(a, llarp::path::ePathRoleOutboundHS, 0s);
+  demand.Expire(SpareDemand::DemandTimeout - 1s);
+  REQUIRE(demand.Wanted(a));
+  demand.Expire(SpareDemand::DemandTimeout);
+  REQUIRE_FALSE(demand.Wanted(a));
+
+  // only the most recent ones are kept
+  for (size_t n = 0; n <= SpareDemand::MaxDemandTargets; ++n)
+    demand.Want(MakeRouter(n), llarp::path::ePathRoleOutboundHS, llarp_time_t{n + 1});
+  REQUIRE(demand.Size() == SpareDemand::MaxDemandTargets);
+  REQUIRE_FALSE(demand.Wanted(MakeRouter(0)));
+  REQUIRE(demand.Wanted(MakeRouter(SpareDemand::MaxDemandTargets)));
+}
+
+TEST_CASE("SpareDemand counts first connections as cold, not misses", "[path-pool]")
+{
+  SpareDemand demand;
+  const auto a = MakeRouter('a');
+
+  demand.Taken(false, {a});
+  demand.Want(a, llarp::path::ePathRoleOutboundHS, 0s);
+  REQUIRE(demand.cold == 1);
+  REQUIRE(demand.misses == 0);
+
+  demand.Taken(false, {a});
+  REQUIRE(demand.misses == 1);
+  demand.Taken(true, {a});
+  REQUIRE(demand.hits == 1);
+}
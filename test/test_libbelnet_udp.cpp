@@ -0,0 +1,307 @@
+#include <belnet.h>
+#include <llarp/belnet_udp.hpp>
+#include <mocks/queued_loop.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+TEST_CASE("belnet_udp_send_queue_new rejects bad arguments", "[libbelnet]")
+{
+  REQUIRE(belnet_udp_send_queue_new(1, 16, nullptr) == nullptr);
+
+  auto* ctx = belnet_context_new();
+  REQUIRE(ctx != nullptr);
+  REQUIRE(belnet_udp_send_queue_new(1, 0, ctx) == nullptr);
+  // too large to allocate, we get null back instead of an exception
+  REQUIRE(belnet_udp_send_queue_new(1, SIZE_MAX, ctx) == nullptr);
+  // no socket is bound, so there is nothing to send from
+  REQUIRE(belnet_udp_send_queue_new(1, 16, ctx) == nullptr);
+  belnet_context_free(ctx);
+}
+
+TEST_CASE("belnet_udp_send_queue_push rejects a missing queue or flow", "[libbelnet]")
+{
+  belnet_udp_flowinfo remote{};
+  const char data[1] = {0};
+  REQUIRE(belnet_udp_send_queue_push(nullptr, &remote, data, sizeof(data)) == EINVAL);
+  REQUIRE(belnet_udp_send_queue_push(nullptr, nullptr, data, sizeof(data)) == EINVAL);
+  // freeing nothing is fine
+  belnet_udp_send_queue_free(nullptr);
+}
+
+namespace
+{
+  using llarp::libbelnet::UDPHandler;
+  using llarp::libbelnet::UDPSendQueue;
+
+  /// endpoint that sends by recording what it was asked to send
+  struct SendingEndpoint : public llarp::EndpointBase
+  {
+    llarp::EventLoop_ptr loop = std::make_shared<mocks::QueuedLoop>();
+    std::vector<size_t> sent;
+
+    mocks::QueuedLoop&
+    Queued()
+    {
+      return static_cast<mocks::QueuedLoop&>(*loop);
+    }
+
+    void
+    SRVRecordsChanged() override
+    {}
+
+    std::optional<SendStat>
+    GetStatFor(AddressVariant_t) const override
+    {
+      return std::nullopt;
+    }
+
+    std::unordered_set<AddressVariant_t>
+    AllRemoteEndpoints() const override
+    {
+      return {};
+    }
+
+    AddressVariant_t
+    LocalAddress() const override
+    {
+      return llarp::service::Address{};
+    }
+
+    llarp::quic::TunnelManager*
+    GetQUICTunnel() override
+    {
+      return nullptr;
+    }
+
+    std::optional<AddressVariant_t>
+    GetEndpointWithConvoTag(llarp::service::ConvoTag) const override
+    {
+      return std::nullopt;
+    }
+
+    std::optional<llarp::service::ConvoTag>
+    GetBestConvoTagFor(AddressVariant_t) const override
+    {
+      return llarp::service::ConvoTag{};
+    }
+
+    bool
+    RemoteSupports(llarp::service::ConvoTag, llarp::service::ProtocolType) const override
+    {
+      return true;
+    }
+
+    bool
+    EnsurePathTo(
+        AddressVariant_t,
+        std::function<void(std::optional<llarp::service::ConvoTag>)>,
+        llarp_time_t) override
+    {
+      return false;
+    }
+
+    void
+    LookupNameAsync(
+        std::string, std::function<void(std::optional<AddressVariant_t>)>) override
+    {}
+
+    const llarp::EventLoop_ptr&
+    Loop() override
+    {
+      return loop;
+    }
+
+    bool
+    SendToOrQueue(
+        llarp::service::ConvoTag,
+        const llarp_buffer_t& payload,
+        llarp::service::ProtocolType) override
+    {
+      sent.push_back(payload.sz);
+      return true;
+    }
+
+    void
+    LookupServiceAsync(
+        std::string, std::string, std::function<void(std::vector<llarp::dns::SRVData>)>) override
+    {}
+
+    void
+    MarkAddressOutbound(AddressVariant_t) override
+    {}
+  };
+
+  llarp::service::Address
+  MakeAddress(byte_t fill)
+  {
+    llarp::service::Address addr;
+    addr.Fill(fill);
+    return addr;
+  }
+
+  llarp::net::IPPacket
+  MakeDatagram(std::string_view payload)
+  {
+    return llarp::net::IPPacket::make_udp(
+        llarp::SockAddr{"10.0.0.1:4000"},
+        llarp::SockAddr{"10.0.0.2:53"},
+        std::vector<byte_t>{payload.begin(), payload.end()});
+  }
+
+  /// what the hooks of a batched socket were called with
+  struct Received
+  {
+    std::shared_ptr<UDPHandler> socket;
+    /// datagrams of each batched receive call
+    std::vector<std::vector<std::string>> batches;
+    size_t timedOut = 0;
+  };
+
+  int
+  AcceptFlow(void* user, const belnet_udp_flowinfo*, void** flow_userdata, int* timeout)
+  {
+    *flow_userdata = user;
+    *timeout = 30;
+    return 0;
+  }
+
+  void
+  RecvBatch(
+      const belnet_udp_flowinfo* remote,
+      const belnet_udp_datagram* pkts,
+      size_t num,
+      void* flow_userdata)
+  {
+    auto* received = static_cast<Received*>(flow_userdata);
+    auto& batch = received->batches.emplace_back();
+    for (size_t idx = 0; idx < num; ++idx)
+    {
+      CHECK(pkts[idx].remote == remote);
+      batch.emplace_back(pkts[idx].data, pkts[idx].len);
+    }
+    // the hook may call back into the socket, which takes the socket's lock
+    received->socket->ExpireOldFlows();
+  }
+
+  void
+  FlowTimedOut(const belnet_udp_flowinfo*, void* flow_userdata)
+  {
+    ++static_cast<Received*>(flow_userdata)->timedOut;
+  }
+
+  std::shared_ptr<UDPHandler>
+  MakeSocket(const std::shared_ptr<SendingEndpoint>& ep, Received* received = nullptr)
+  {
+    return std::make_shared<UDPHandler>(
+        1,
+        llarp::net::port_t::from_host(53),
+        &AcceptFlow,
+        nullptr,
+        &RecvBatch,
+        &FlowTimedOut,
+        received,
+        ep);
+  }
+
+  belnet_udp_flowinfo
+  MakeFlow(int socket_id, byte_t fill)
+  {
+    belnet_udp_flowinfo flow{};
+    flow.socket_id = socket_id;
+    const auto host = MakeAddress(fill).ToString();
+    std::copy_n(
+        host.data(), std::min(host.size(), sizeof(flow.remote_host) - 1), flow.remote_host);
+    flow.remote_port = 53;
+    return flow;
+  }
+}  // namespace
+
+TEST_CASE("Batched udp socket delivers a burst in one call per flow", "[libbelnet]")
+{
+  auto ep = std::make_shared<SendingEndpoint>();
+  Received received;
+  received.socket = MakeSocket(ep, &received);
+  auto& socket = *received.socket;
+
+  socket.HandlePacketFrom(MakeAddress(1), MakeDatagram("one"));
+  socket.HandlePacketFrom(MakeAddress(1), MakeDatagram("two"));
+  socket.HandlePacketFrom(MakeAddress(2), MakeDatagram("other"));
+  socket.HandlePacketFrom(MakeAddress(1), MakeDatagram("three"));
+  // nothing is delivered until the event loop gets to the one flush queued for the burst
+  CHECK(received.batches.empty());
+  REQUIRE(ep->Queued().calls.size() == 1);
+
+  CHECK(ep->Queued().Pump() == 1);
+  REQUIRE(received.batches.size() == 2);
+  std::sort(received.batches.begin(), received.batches.end());
+  CHECK(received.batches[0] == std::vector<std::string>{"one", "two", "three"});
+  CHECK(received.batches[1] == std::vector<std::string>{"other"});
+
+  // the next packet queues the next flush
+  socket.HandlePacketFrom(MakeAddress(2), MakeDatagram("again"));
+  CHECK(ep->Queued().Pump() == 1);
+  REQUIRE(received.batches.size() == 3);
+  CHECK(received.batches[2] == std::vector<std::string>{"again"});
+
+  socket.Close();
+  CHECK(received.timedOut == 2);
+}
+
+TEST_CASE("Udp send queue sends what was pushed in one drain", "[libbelnet]")
+{
+  auto ep = std::make_shared<SendingEndpoint>();
+  auto socket = MakeSocket(ep);
+  auto queue = std::make_shared<UDPSendQueue>(socket, ep->loop, 4);
+  const auto remote = MakeFlow(socket->m_SocketID, 1);
+  const char data[] = "datagram";
+
+  for (int idx = 0; idx < 4; ++idx)
+    REQUIRE(queue->Push(&remote, data, sizeof(data)) == 0);
+  CHECK(queue->Push(&remote, data, sizeof(data)) == EAGAIN);
+  CHECK(ep->sent.empty());
+  CHECK(ep->Queued().calls.size() == 1);
+
+  CHECK(ep->Queued().Pump() == 1);
+  CHECK(ep->sent.size() == 4);
+
+  // room again once drained
+  CHECK(queue->Push(&remote, data, sizeof(data)) == 0);
+  CHECK(ep->Queued().Pump() == 1);
+  CHECK(ep->sent.size() == 5);
+
+  const auto elsewhere = MakeFlow(socket->m_SocketID + 1, 1);
+  CHECK(queue->Push(&elsewhere, data, sizeof(data)) == EHOSTUNREACH);
+  CHECK(queue->Push(&remote, nullptr, sizeof(data)) == EINVAL);
+  CHECK(queue->Push(&remote, data, 0) == EINVAL);
+  CHECK(ep->Queued().calls.empty());
+}
+
+TEST_CASE("Closing a udp socket drops the datagrams queued on it", "[libbelnet]")
+{
+  auto ep = std::make_shared<SendingEndpoint>();
+  auto socket = MakeSocket(ep);
+  auto queue = std::make_shared<UDPSendQueue>(socket, ep->loop, 4);
+  const auto remote = MakeFlow(socket->m_SocketID, 1);
+  const char data[] = "datagram";
+
+  REQUIRE(queue->Push(&remote, data, sizeof(data)) == 0);
+  REQUIRE(queue->Push(&remote, data, sizeof(data)) == 0);
+
+  SECTION("closed")
+  {
+    socket->Close();
+  }
+  SECTION("gone")
+  {
+    socket.reset();
+  }
+  CHECK(ep->Queued().Pump() == 1);
+  CHECK(ep->sent.empty());
+  CHECK(queue->Push(&remote, data, sizeof(data)) == EBADF);
+}
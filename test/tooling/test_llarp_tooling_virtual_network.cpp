@@ -0,0 +1,182 @@
+#include <tooling/virtual_network.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+
+using namespace tooling;
+using namespace std::literals;
+
+namespace
+{
+  /// a udp socket on loop that remembers when its datagrams arrived
+  struct Receiver
+  {
+    std::shared_ptr<llarp::UDPHandle> udp;
+    std::vector<llarp_time_t> arrivals;
+
+    Receiver(VirtualLoop& loop, const llarp::SockAddr& addr)
+    {
+      udp = loop.make_udp([this, &loop](auto&, auto, auto) {
+        arrivals.push_back(loop.time_now());
+      });
+      REQUIRE(udp->listen(addr));
+    }
+  };
+
+  /// sends count datagrams of size bytes from udp to dest in one go on loop
+  void
+  SendOnLoop(
+      VirtualLoop& loop,
+      std::shared_ptr<llarp::UDPHandle> udp,
+      llarp::SockAddr dest,
+      size_t count,
+      size_t size = 100)
+  {
+    loop.call_soon([udp, dest, count, size] {
+      std::vector<byte_t> data(size);
+      for (size_t idx = 0; idx < count; ++idx)
+        udp->send(dest, llarp_buffer_t{data});
+    });
+  }
+}  // namespace
+
+TEST_CASE("VirtualNetwork delivers datagrams after the link latency", "[tooling][VirtualNetwork]")
+{
+  VirtualNetwork net{2, 1};
+  net.SetDefaultLink(LinkParams{20ms});
+  auto sender = net.MakeLoop();
+  auto receiver = net.MakeLoop();
+  const llarp::SockAddr dest{"127.0.0.1:5000"};
+  Receiver recv{*receiver, dest};
+  auto udp = sender->make_udp([](auto&, auto, auto) {});
+
+  const auto start = net.Now();
+  CHECK(llarp::time_now_ms() == start);
+  SendOnLoop(*sender, udp, dest, 3);
+  net.RunFor(100ms);
+
+  CHECK(net.Now() == start + 100ms);
+  CHECK(llarp::time_now_ms() == net.Now());
+  CHECK(recv.arrivals == std::vector<llarp_time_t>(3, start + 20ms));
+  CHECK(net.Delivered() == 3);
+  CHECK(net.Dropped() == 0);
+
+  SECTION("per link parameters override the default")
+  {
+    net.SetLink(*udp->LocalAddr(), dest, LinkParams{50ms, 1});
+    SendOnLoop(*sender, udp, dest, 5);
+    net.RunFor(100ms);
+    CHECK(recv.arrivals.size() == 3);
+    CHECK(net.Dropped() == 5);
+  }
+
+  SECTION("datagrams to nobody are dropped")
+  {
+    SendOnLoop(*sender, udp, llarp::SockAddr{"127.0.0.1:5001"}, 2);
+    net.RunFor(100ms);
+    CHECK(net.Dropped() == 2);
+  }
+}
+
+TEST_CASE("VirtualNetwork queues datagrams behind each other", "[tooling][VirtualNetwork]")
+{
+  VirtualNetwork net{1};
+  // 100 byte datagrams take 100us each at 1MB/s
+  net.SetDefaultLink(LinkParams{5ms, 0, 1'000'000});
+  auto sender = net.MakeLoop();
+  auto receiver = net.MakeLoop();
+  const llarp::SockAddr dest{"127.0.0.1:5000"};
+  Receiver recv{*receiver, dest};
+  auto udp = sender->make_udp([](auto&, auto, auto) {});
+
+  const auto start = net.Now();
+  SendOnLoop(*sender, udp, dest, 25);
+  net.RunFor(100ms);
+
+  REQUIRE(recv.arrivals.size() == 25);
+  // each datagram arrives at the first millisecond after it is off the link
+  CHECK(recv.arrivals.front() == start + 5ms + 1ms);
+  CHECK(recv.arrivals[9] == start + 5ms + 1ms);
+  CHECK(recv.arrivals[10] == start + 5ms + 2ms);
+  CHECK(recv.arrivals.back() == start + 5ms + 3ms);
+}
+
+TEST_CASE("VirtualNetwork runs timers in simulated time", "[tooling][VirtualNetwork]")
+{
+  VirtualNetwork net{2};
+  auto loop = net.MakeLoop();
+  const auto start = net.Now();
+
+  std::vector<std::pair<int, llarp_time_t>> fired;
+  loop->call_later(30ms, [&] { fired.emplace_back(3, llarp::time_now_ms()); });
+  loop->call_later(10ms, [&] { fired.emplace_back(1, llarp::time_now_ms()); });
+  loop->call_later(10ms, [&] {
+    fired.emplace_back(2, llarp::time_now_ms());
+    loop->call_later(5ms, [&] { fired.emplace_back(4, llarp::time_now_ms()); });
+  });
+
+  net.RunFor(1h);
+  CHECK(net.Now() == start + 1h);
+  const std::vector<std::pair<int, llarp_time_t>> expected{
+      {1, start + 10ms}, {2, start + 10ms}, {4, start + 15ms}, {3, start + 30ms}};
+  CHECK(fired == expected);
+}
+
+TEST_CASE("VirtualNetwork owns the clock while it exists", "[tooling][VirtualNetwork]")
+{
+  llarp_time_t simulated;
+  {
+    VirtualNetwork net{1};
+    CHECK_THROWS_AS(VirtualNetwork{1}, std::logic_error);
+    net.RunFor(24h);
+    simulated = net.Now();
+    CHECK(llarp::time_now_ms() == simulated);
+  }
+  CHECK(llarp::time_now_ms() < simulated - 23h);
+  // and it can be set up again
+  VirtualNetwork net{1};
+  CHECK(llarp::time_now_ms() == net.Now());
+}
+
+TEST_CASE("VirtualNetwork runs a thousand loops on a few threads", "[tooling][VirtualNetwork]")
+{
+  constexpr size_t NumLoops = 1000;
+  VirtualNetwork net{4, 7};
+  net.SetDefaultLink(LinkParams{15ms, 0.01});
+
+  std::vector<std::shared_ptr<VirtualLoop>> loops;
+  std::vector<std::shared_ptr<llarp::UDPHandle>> sockets;
+  std::vector<std::shared_ptr<llarp::EventLoopRepeater>> repeaters;
+  std::vector<uint64_t> received(NumLoops);
+  for (size_t idx = 0; idx < NumLoops; ++idx)
+  {
+    loops.push_back(net.MakeLoop());
+    sockets.push_back(loops.back()->make_udp(
+        [&received, idx](auto&, auto, auto) { ++received[idx]; }));
+    REQUIRE(sockets.back()->listen(llarp::SockAddr{"127.0.0.1", llarp::huint16_t{
+        static_cast<uint16_t>(10000 + idx)}}));
+  }
+  // every loop pings the next few every 100ms, like relays keeping their sessions alive
+  for (size_t idx = 0; idx < NumLoops; ++idx)
+  {
+    repeaters.push_back(loops[idx]->make_repeater());
+    repeaters.back()->start(100ms, [udp = sockets[idx], &sockets, idx] {
+      std::array<byte_t, 200> data{};
+      for (size_t peer = 1; peer <= 8; ++peer)
+        udp->send(*sockets[(idx + peer) % NumLoops]->LocalAddr(), llarp_buffer_t{data});
+    });
+  }
+
+  // long enough for the 20th round to arrive, not for a 21st
+  net.RunFor(2s + 50ms);
+
+  const uint64_t sent = NumLoops * 8 * 20;
+  CHECK(net.Delivered() + net.Dropped() == sent);
+  CHECK(net.Dropped() > sent / 200);
+  CHECK(net.Dropped() < sent / 50);
+  uint64_t total = 0;
+  for (const auto count : received)
+    total += count;
+  CHECK(total == net.Delivered());
+}
@@ -0,0 +1,55 @@
+#include <util/latency_trace.hpp>
+#include <util/metrics.hpp>
+#include <catch2/catch.hpp>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+using llarp::trace::Stage;
+
+TEST_CASE("latency trace stages have distinct names", "[trace]")
+{
+  std::set<std::string> names;
+  for (size_t idx = 0; idx < static_cast<size_t>(Stage::NumStages); ++idx)
+  {
+    const std::string name = llarp::trace::StageName(static_cast<Stage>(idx));
+    REQUIRE(name != "unknown");
+    REQUIRE(names.emplace(name).second);
+  }
+  REQUIRE(std::string{llarp::trace::StageName(Stage::NumStages)} == "unknown");
+}
+
+#ifdef BELNET_LATENCY_TRACE
+TEST_CASE("latency trace stamps record into the stage histogram", "[trace]")
+{
+  auto& hist = llarp::metrics::Registry::Global().GetHistogram(
+      "belnet_hot_path_latency_seconds",
+      "time spent queued or working in each stage of the packet hot path",
+      llarp::metrics::Histogram::ExponentialBounds(1 << 20),
+      1e-6,
+      {{"stage", llarp::trace::StageName(Stage::OutboundQueue)}});
+  const auto before = hist.Read();
+
+  llarp::trace::Stamp stamp;
+  std::this_thread::sleep_for(std::chrono::milliseconds{2});
+  stamp.Lap(Stage::OutboundQueue);
+  stamp.Record(Stage::OutboundQueue);
+
+  const auto after = hist.Read();
+  REQUIRE(after.count == before.count + 2);
+  // the first lap covers the sleep, the second starts where the lap ended
+  REQUIRE(after.sum - before.sum >= 2000);
+  REQUIRE(after.sum - before.sum < 1000000);
+}
+#else
+TEST_CASE("latency trace stamps are free when tracing is off", "[trace]")
+{
+  static_assert(std::is_empty_v<llarp::trace::Stamp>);
+  llarp::trace::Stamp stamp;
+  stamp.Lap(Stage::OutboundQueue);
+  stamp.Record(Stage::OutboundQueue);
+  llarp::trace::ScopedTimer timer{Stage::RouterPump};
+}
+#endif
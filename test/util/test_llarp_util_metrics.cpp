@@ -0,0 +1,47 @@
+#include <util/metrics.hpp>
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using llarp::metrics::Histogram;
+using llarp::metrics::Registry;
+
+TEST_CASE("metrics counter sums every thread's increments", "[metrics]")
+{
+  Registry registry;
+  auto& counter = registry.GetCounter("test_total", "test counter");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < 1000; ++j)
+        counter.Inc();
+    });
+  for (auto& thread : threads)
+    thread.join();
+  REQUIRE(counter.Value() == 4000);
+  REQUIRE(&registry.GetCounter("test_total", "test counter") == &counter);
+  REQUIRE(&registry.GetCounter("test_total", "test counter", {{"kind", "other"}}) != &counter);
+}
+
+TEST_CASE("metrics histogram buckets and text export", "[metrics]")
+{
+  Registry registry;
+  auto& hist = registry.GetHistogram("test_seconds", "test histogram", {10, 100}, 0.001);
+  hist.Observe(5);
+  hist.Observe(10);
+  hist.Observe(50);
+  hist.Observe(500);
+  const auto snap = hist.Read();
+  REQUIRE(snap.counts == std::vector<uint64_t>{2, 1, 1});
+  REQUIRE(snap.count == 4);
+  REQUIRE(snap.sum == 565);
+
+  const auto text = registry.PrometheusText();
+  REQUIRE(text.find("# TYPE test_seconds histogram") != std::string::npos);
+  REQUIRE(text.find("test_seconds_bucket{le=\"0.1\"} 3") != std::string::npos);
+  REQUIRE(text.find("test_seconds_bucket{le=\"+Inf\"} 4") != std::string::npos);
+  REQUIRE(text.find("test_seconds_count 4") != std::string::npos);
+
+  REQUIRE_THROWS(registry.GetGauge("test_seconds", "wrong type"));
+}
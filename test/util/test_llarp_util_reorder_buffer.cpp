@@ -0,0 +1,117 @@
+#include <util/reorder_buffer.hpp>
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+namespace
+{
+  struct Msg
+  {
+    uint64_t seqno;
+  };
+
+  struct Collector
+  {
+    std::vector<uint64_t> got;
+
+    void
+    operator()(Msg&& msg)
+    {
+      got.push_back(msg.seqno);
+    }
+  };
+}  // namespace
+
+TEST_CASE("ReorderBuffer passes in order messages through", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf;
+  Collector out;
+  for (uint64_t n = 5; n < 10; ++n)
+    buf.Put(Msg{n}, 0s, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{5, 6, 7, 8, 9});
+  REQUIRE(buf.Held() == 0);
+  REQUIRE(not buf.Reordering());
+}
+
+TEST_CASE("ReorderBuffer does not hold on gaps until reordering is seen", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf;
+  Collector out;
+  buf.Put(Msg{0}, 0s, std::ref(out));
+  buf.Put(Msg{2}, 0s, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{0, 2});
+  buf.Put(Msg{1}, 0s, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{0, 2, 1});
+  REQUIRE(buf.Reordering());
+}
+
+TEST_CASE("ReorderBuffer reorders striped messages", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf{100ms};
+  Collector out;
+  buf.Put(Msg{1}, 0s, std::ref(out));
+  buf.Put(Msg{0}, 0s, std::ref(out));
+  out.got.clear();
+
+  buf.Put(Msg{4}, 10ms, std::ref(out));
+  buf.Put(Msg{3}, 10ms, std::ref(out));
+  REQUIRE(out.got.empty());
+  REQUIRE(buf.Held() == 2);
+  buf.Put(Msg{2}, 20ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{2, 3, 4});
+  REQUIRE(buf.Held() == 0);
+}
+
+TEST_CASE("ReorderBuffer skips gaps after the hold time", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf{100ms};
+  Collector out;
+  buf.Put(Msg{1}, 0s, std::ref(out));
+  buf.Put(Msg{0}, 0s, std::ref(out));
+  out.got.clear();
+
+  buf.Put(Msg{3}, 10ms, std::ref(out));
+  buf.Expire(50ms, std::ref(out));
+  REQUIRE(out.got.empty());
+  buf.Expire(110ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{3});
+  buf.Put(Msg{2}, 120ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{3, 2});
+}
+
+TEST_CASE("ReorderBuffer skips gaps when too many are held", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf{1s, 2};
+  Collector out;
+  buf.Put(Msg{1}, 0s, std::ref(out));
+  buf.Put(Msg{0}, 0s, std::ref(out));
+  out.got.clear();
+
+  buf.Put(Msg{3}, 0s, std::ref(out));
+  buf.Put(Msg{4}, 0s, std::ref(out));
+  REQUIRE(out.got.empty());
+  buf.Put(Msg{6}, 0s, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{3, 4});
+  REQUIRE(buf.Held() == 1);
+}
+
+TEST_CASE("ReorderBuffer hold time counts from the oldest message still held", "[reorder-buffer]")
+{
+  llarp::util::ReorderBuffer<Msg> buf{100ms};
+  Collector out;
+  buf.Put(Msg{1}, 0s, std::ref(out));
+  buf.Put(Msg{0}, 0s, std::ref(out));
+  out.got.clear();
+
+  // 3 waits on 2 from 0ms, 6 waits on 4 and 5 from 50ms
+  buf.Put(Msg{3}, 0s, std::ref(out));
+  buf.Put(Msg{6}, 50ms, std::ref(out));
+  buf.Put(Msg{2}, 60ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{2, 3});
+  // 3 was delivered, so nothing is due until 6 has waited the full hold time
+  buf.Expire(120ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{2, 3});
+  buf.Expire(150ms, std::ref(out));
+  REQUIRE(out.got == std::vector<uint64_t>{2, 3, 6});
+  REQUIRE(buf.Held() == 0);
+}